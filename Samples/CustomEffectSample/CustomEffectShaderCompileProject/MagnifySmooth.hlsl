@@ -1,5 +1,5 @@
 #define D2D_INPUT_COUNT 1 
-#define D2D_INPUT0_SIMPLE 
+#define D2D_INPUT0_COMPLEX 
 
 #include "d2d1effecthelpers.hlsli"
 
@@ -0,0 +1,134 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "pch.h"
+#include "BatchRenderer.h"
+#include "CpuRenderPlan.h"
+#include "Extras\WicImageCodec.h"
+#include "BatchPipeline.h"
+#include <memory>
+#include <vector>
+#include <ppltasks.h>
+
+using namespace CustomNativeEffects;
+using namespace Platform;
+using namespace Lumia::Imaging;
+using namespace Lumia::Imaging::Extras::Detail;
+using namespace Windows::Foundation;
+using namespace Windows::Foundation::Collections;
+using namespace Windows::Storage::Streams;
+
+BatchRenderer::BatchRenderer(IImageProvider^ effect) :
+	m_effect(effect),
+	m_maximumInFlight(static_cast<int32>(BatchPipeline::Options().MaximumInFlight))
+{
+	if (!CpuRenderPlan::IsSupported(effect))
+	{
+		throw ref new InvalidArgumentException("effect");
+	}
+}
+
+IImageProvider^ BatchRenderer::Effect::get()
+{
+	return m_effect;
+}
+
+int32 BatchRenderer::MaximumInFlight::get()
+{
+	return m_maximumInFlight.load();
+}
+
+void BatchRenderer::MaximumInFlight::set(int32 value)
+{
+	if (value < 1)
+	{
+		throw ref new InvalidArgumentException("MaximumInFlight");
+	}
+
+	m_maximumInFlight.store(value);
+}
+
+IAsyncActionWithProgress<uint32>^ BatchRenderer::RenderAsync(IVectorView<IRandomAccessStream^>^ sources, IVectorView<IRandomAccessStream^>^ targets, Guid encoderId)
+{
+	if (sources == nullptr)
+	{
+		throw ref new InvalidArgumentException("sources");
+	}
+
+	if (targets == nullptr || targets->Size != sources->Size)
+	{
+		throw ref new InvalidArgumentException("targets");
+	}
+
+	if (sources->Size > INT32_MAX)
+	{
+		throw ref new OutOfBoundsException("sources");
+	}
+
+	// Shared by every image, and read once for the whole batch.
+	std::shared_ptr<CpuRenderPlan> plan(CpuRenderPlan::Create(m_effect));
+
+	BatchPipeline::Options options;
+	options.MaximumInFlight = static_cast<uint32_t>(m_maximumInFlight.load());
+
+	// Copied so that the batch is not affected by later changes to the
+	// caller's collections.
+	auto sourceStreams = std::make_shared<std::vector<IRandomAccessStream^>>(begin(sources), end(sources));
+	auto targetStreams = std::make_shared<std::vector<IRandomAccessStream^>>(begin(targets), end(targets));
+	const GUID encoder = encoderId;
+
+	return concurrency::create_async([plan, options, sourceStreams, targetStreams, encoder](concurrency::progress_reporter<uint32> reporter, concurrency::cancellation_token token)
+	{
+		CancellationToken cancellation;
+		auto registration = token.register_callback([&cancellation]()
+		{
+			cancellation.Cancel();
+		});
+
+		BatchPipeline::Options batchOptions = options;
+		batchOptions.Cancellation = &cancellation;
+
+		RowBands::Options bandOptions = RowBands::GetDefaultOptions();
+		std::atomic<uint32> completedCount(0);
+
+		bool isComplete;
+
+		try
+		{
+			isComplete = BatchPipeline::Run(static_cast<int32_t>(sourceStreams->size()), [&](int32_t item, BatchFrame& frame)
+			{
+				WicImageCodec::Reader reader((*sourceStreams)[item]);
+				frame.Resize(static_cast<int32_t>(reader.GetWidth()), static_cast<int32_t>(reader.GetHeight()));
+				reader.ReadRows(0, reader.GetHeight(), frame.GetPixels(), frame.GetPitch());
+
+				// The stages are pointwise, so they run in place.
+				plan->GetStage().ProcessRows(frame.GetRows(), 0, frame.GetHeight(), frame.GetPixels(), frame.GetPitch(), bandOptions);
+
+				WicImageCodec::Writer writer((*targetStreams)[item], encoder, reader.GetWidth(), reader.GetHeight());
+				writer.WriteRows(reader.GetHeight(), frame.GetPixels(), frame.GetPitch());
+				writer.Commit();
+
+				reporter.report(++completedCount);
+			}, batchOptions);
+		}
+		catch (...)
+		{
+			token.deregister_callback(registration);
+			throw;
+		}
+
+		token.deregister_callback(registration);
+
+		if (!isComplete)
+		{
+			concurrency::cancel_current_task();
+		}
+	});
+}
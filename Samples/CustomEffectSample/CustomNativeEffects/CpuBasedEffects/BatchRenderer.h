@@ -0,0 +1,62 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <atomic>
+
+namespace CustomNativeEffects {
+
+	using namespace Lumia::Imaging;
+
+	// Renders many encoded images through one CPU effect.
+	//
+	// Rendering a batch through the imaging SDK clones the effect, creates a
+	// worker, grows its buffers and builds its tables for every image. This
+	// renderer builds the effect's parameters and lookup tables once per batch,
+	// and reuses one frame buffer per image in flight. Several images are in
+	// flight at a time, so one can be decoded while another is processed and a
+	// third is encoded, and memory is bounded by MaximumInFlight whatever the
+	// number of images.
+	public ref class BatchRenderer sealed
+	{
+	public:
+		// effect is a PointwiseChainEffect or a ColorLookupEffect. Its source is
+		// not used; the images come from the streams passed to RenderAsync.
+		BatchRenderer(IImageProvider^ effect);
+
+		property IImageProvider^ Effect
+		{
+			IImageProvider^ get();
+		}
+
+		// Images decoded, processed or encoded at the same time. 4 by default.
+		property int32 MaximumInFlight
+		{
+			int32 get();
+			void set(int32 value);
+		}
+
+		// Decodes the first frame of every source, renders it through the effect
+		// and encodes the result into the target with the same index. encoderId
+		// identifies the encoder, for example
+		// Windows::Graphics::Imaging::BitmapEncoder::JpegEncoderId. Progress is
+		// the number of images completed. The effect's properties are read when
+		// the render starts. Canceling the action stops it before the next image.
+		Windows::Foundation::IAsyncActionWithProgress<uint32>^ RenderAsync(
+			Windows::Foundation::Collections::IVectorView<Windows::Storage::Streams::IRandomAccessStream^>^ sources,
+			Windows::Foundation::Collections::IVectorView<Windows::Storage::Streams::IRandomAccessStream^>^ targets,
+			Platform::Guid encoderId);
+
+	private:
+		IImageProvider^ m_effect;
+		std::atomic<int32> m_maximumInFlight;
+	};
+}
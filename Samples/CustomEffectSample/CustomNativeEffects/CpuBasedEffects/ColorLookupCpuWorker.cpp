@@ -0,0 +1,89 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "pch.h"
+#include "ColorLookupCpuWorker.h"
+#include "Extras\CustomEffectMemoryPressure.h"
+
+using namespace Lumia::Imaging;
+using namespace Lumia::Imaging::Workers::Cpu;
+using namespace Microsoft::WRL;
+using namespace Platform;
+using namespace CustomNativeEffects;
+using namespace Windows::Foundation;
+using namespace Windows::Storage::Streams;
+
+ColorLookupCpuWorker::ColorLookupCpuWorker(ColorLookupEffect^ configuration) :
+	m_configuration(configuration),
+	m_state(GetStatePool().Acquire()),
+	m_sourceBuffer(m_state->SourceBuffer),
+	m_targetBuffer(m_state->TargetBuffer),
+	m_applyRow(ColorLutKernel::GetRowFunction()),
+	m_bandOptions(RowBands::GetDefaultOptions())
+{
+}
+
+ColorLookupCpuWorker::~ColorLookupCpuWorker()
+{
+	// The renderer releases the worker once the render has completed.
+	GetStatePool().Release(std::move(m_state));
+}
+
+WorkerStatePool<ColorLookupCpuWorker::State>& ColorLookupCpuWorker::GetStatePool()
+{
+	static WorkerStatePool<State>* pool = new WorkerStatePool<State>();
+	Extras::Detail::CustomEffectMemoryPressure::EnsureSubscribed();
+	return *pool;
+}
+
+void ColorLookupCpuWorker::Prepare(CpuImageWorkerParameters parameters)
+{
+	m_sourceBuffer.EnsureCapacity(parameters.SourceBufferLength);
+	m_targetBuffer.EnsureCapacity(parameters.TargetBufferLength);
+}
+
+void ColorLookupCpuWorker::Process(CpuImageWorkerRectangle rectangle)
+{
+	const CpuWorkerRegion region = Extras::Detail::GetCpuWorkerRegion(m_sourceBuffer, m_targetBuffer, rectangle);
+
+	// The effect keeps the table alive for as long as the worker holds it.
+	const ColorLut3D* lut = m_configuration->GetLut().get();
+	auto applyRow = m_applyRow;
+
+	RowBands::ForEach(region, m_bandOptions, [lut, applyRow](const CpuWorkerRegion& band)
+	{
+		ColorLutKernel::ApplyRegion(band, *lut, applyRow);
+	});
+}
+
+void ColorLookupCpuWorker::Configuration::set(IImageProvider^ value)
+{
+	m_configuration = safe_cast<ColorLookupEffect^>(value);
+}
+
+IImageProvider^ ColorLookupCpuWorker::Configuration::get()
+{
+	return m_configuration;
+}
+
+IBuffer^ ColorLookupCpuWorker::SourceBuffer::get()
+{
+	return m_sourceBuffer.GetBuffer();
+}
+
+IBuffer^ ColorLookupCpuWorker::TargetBuffer::get()
+{
+	return m_targetBuffer.GetBuffer();
+}
+
+ColorMode ColorLookupCpuWorker::ColorMode::get()
+{
+	return Lumia::Imaging::ColorMode::Bgra8888;
+}
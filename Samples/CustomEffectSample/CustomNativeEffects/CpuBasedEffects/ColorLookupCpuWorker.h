@@ -0,0 +1,79 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include "ColorLookupEffect.h"
+#include <memory>
+#include "Extras\CustomEffectCxBuffer.h"
+#include "ColorLutKernel.h"
+#include "RowBands.h"
+#include "WorkerStatePool.h"
+
+namespace CustomNativeEffects {
+
+	namespace {
+		namespace MW = Microsoft::WRL;
+		namespace LI = Lumia::Imaging;
+		namespace LIWC = Lumia::Imaging::Workers::Cpu;
+		namespace WF = Windows::Foundation;
+		namespace WSS = Windows::Storage::Streams;
+	}
+
+	public ref class ColorLookupCpuWorker sealed : LIWC::ICpuImageWorker
+	{
+	public:
+		ColorLookupCpuWorker(ColorLookupEffect^ configuration);
+		virtual ~ColorLookupCpuWorker();
+
+		virtual void Prepare(LIWC::CpuImageWorkerParameters parameters);
+
+		virtual void Process(LIWC::CpuImageWorkerRectangle rectangle);
+
+		virtual property LI::ColorMode ColorMode
+		{
+			LI::ColorMode get();
+		}
+
+		virtual property WSS::IBuffer^ SourceBuffer
+		{
+			WSS::IBuffer^ get();
+		}
+
+		virtual property WSS::IBuffer^ TargetBuffer
+		{
+			WSS::IBuffer^ get();
+		}
+
+		virtual property LI::IImageProvider^ Configuration
+		{
+			LI::IImageProvider^ get();
+			void set(LI::IImageProvider^ value);
+		}
+
+	private:
+		// Kept in a WorkerStatePool between renders so that the next worker
+		// starts with buffers that have already grown to the image size.
+		struct State
+		{
+			LI::Extras::Detail::CustomEffectCxBuffer SourceBuffer;
+			LI::Extras::Detail::CustomEffectCxBuffer TargetBuffer;
+		};
+
+		static WorkerStatePool<State>& GetStatePool();
+
+		ColorLookupEffect^ m_configuration;
+		std::unique_ptr<State> m_state;
+		LI::Extras::Detail::CustomEffectCxBuffer& m_sourceBuffer;
+		LI::Extras::Detail::CustomEffectCxBuffer& m_targetBuffer;
+		ColorLutKernel::RowFunction m_applyRow;
+		RowBands::Options m_bandOptions;
+	};
+}
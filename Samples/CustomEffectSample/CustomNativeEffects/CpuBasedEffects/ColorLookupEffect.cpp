@@ -0,0 +1,135 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "pch.h"
+#include "ColorLookupEffect.h"
+#include "ColorLookupCpuWorker.h"
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using namespace CustomNativeEffects;
+using namespace Platform;
+using namespace Lumia::Imaging;
+using namespace Concurrency;
+
+static ColorLookupEffect::SharedLut LoadCube(String^ cube)
+{
+	if (cube == nullptr)
+	{
+		throw ref new Platform::InvalidArgumentException("cube");
+	}
+
+	// Keywords and numbers are ASCII; anything else can only be part of a
+	// title or a comment.
+	std::string text;
+	text.reserve(cube->Length());
+
+	for (const wchar_t* character = cube->Data(); character != cube->Data() + cube->Length(); ++character)
+	{
+		text.push_back(*character < 0x80 ? static_cast<char>(*character) : '?');
+	}
+
+	std::istringstream stream(text);
+
+	try
+	{
+		return std::make_shared<const ColorLut3D>(ColorLut3D::LoadCube(stream));
+	}
+	catch (const std::invalid_argument&)
+	{
+		throw ref new Platform::InvalidArgumentException("cube");
+	}
+}
+
+ColorLookupEffect::ColorLookupEffect(String^ cube) :
+	m_lut(LoadCube(cube))
+{
+}
+
+ColorLookupEffect::ColorLookupEffect(const SharedLut& lut) :
+	m_lut(lut)
+{
+}
+
+int32 ColorLookupEffect::LookupTableSize::get()
+{
+	return m_lut->GetSize();
+}
+
+const ColorLookupEffect::SharedLut& ColorLookupEffect::GetLut()
+{
+	return m_lut;
+}
+
+IImageProvider2^ ColorLookupEffect::Clone()
+{
+	critical_section::scoped_lock lock(m_criticalSection);
+
+	auto clone = ref new ColorLookupEffect(m_lut);
+	clone->m_source = m_source->Clone();
+	return clone;
+}
+
+RenderOptions ColorLookupEffect::SupportedRenderOptions::get()
+{
+	return RenderOptions::Cpu;
+}
+
+Workers::IImageWorker^ ColorLookupEffect::CreateImageWorker(Workers::IImageWorkerRequest^ imageWorkerRequest)
+{
+	if(imageWorkerRequest->RenderOptions == RenderOptions::Cpu)
+	{
+		return ref new ColorLookupCpuWorker(this);
+	}
+
+	return nullptr;
+}
+
+IImageProvider^ ColorLookupEffect::Source::get()
+{
+	concurrency::critical_section::scoped_lock lock(m_criticalSection);
+	return m_source;
+}
+
+void ColorLookupEffect::Source::set(IImageProvider^ value)
+{
+	concurrency::critical_section::scoped_lock lock(m_criticalSection);
+	m_source = safe_cast<IImageProvider2^>(value);
+}
+
+uint32 ColorLookupEffect::SourceCount::get()
+{
+	return 1;
+}
+
+void ColorLookupEffect::GetSources(Platform::WriteOnlyArray<IImageProvider2^>^ sources)
+{
+	if(SourceCount > sources->Length)
+	{
+		throw ref new Platform::InvalidArgumentException("sources");
+	}
+
+	concurrency::critical_section::scoped_lock lock(m_criticalSection);
+
+	sources[0] = m_source;
+}
+
+void ColorLookupEffect::SetSource(uint32 sourceIndex, IImageProvider2^ source)
+{
+	if(sourceIndex >= SourceCount)
+	{
+		throw ref new Platform::InvalidArgumentException("sourceIndex");
+	}
+
+	concurrency::critical_section::scoped_lock lock(m_criticalSection);
+
+	m_source = source;
+}
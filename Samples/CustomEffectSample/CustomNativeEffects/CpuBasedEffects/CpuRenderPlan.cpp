@@ -0,0 +1,62 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "pch.h"
+#include "CpuRenderPlan.h"
+#include "ColorLookupEffect.h"
+#include "PointwiseChainEffect.h"
+
+using namespace CustomNativeEffects;
+using namespace Platform;
+using namespace Lumia::Imaging;
+
+CpuRenderPlan::CpuRenderPlan()
+{
+}
+
+bool CpuRenderPlan::IsSupported(IImageProvider^ effect)
+{
+	return dynamic_cast<PointwiseChainEffect^>(effect) != nullptr || dynamic_cast<ColorLookupEffect^>(effect) != nullptr;
+}
+
+std::unique_ptr<CpuRenderPlan> CpuRenderPlan::Create(IImageProvider^ effect)
+{
+	if (!IsSupported(effect))
+	{
+		throw ref new InvalidArgumentException("effect");
+	}
+
+	std::unique_ptr<CpuRenderPlan> plan(new CpuRenderPlan);
+
+	if (auto lookup = dynamic_cast<ColorLookupEffect^>(effect))
+	{
+		plan->m_lut = lookup->GetLut();
+		plan->m_stage.reset(new ColorLutStripStage(*plan->m_lut));
+		return plan;
+	}
+
+	auto chainEffect = safe_cast<PointwiseChainEffect^>(effect);
+	uint64_t versions[PointwiseChain::MaximumStages] = {};
+	chainEffect->BuildChain(plan->m_chain, plan->m_parameters, versions);
+
+	const int32 lookupTableSize = chainEffect->LookupTableSize;
+
+	if (lookupTableSize != 0)
+	{
+		plan->m_lut = ColorLutCache::GetInstance().GetLut(plan->m_chain, lookupTableSize);
+		plan->m_stage.reset(new ColorLutStripStage(*plan->m_lut));
+	}
+	else
+	{
+		plan->m_stage.reset(new PointwiseStripStage(plan->m_chain));
+	}
+
+	return plan;
+}
@@ -0,0 +1,68 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <memory>
+#include "ColorLutCache.h"
+#include "PointwiseChain.h"
+#include "PointwiseChainEffect.h"
+#include "StripPipeline.h"
+
+namespace CustomNativeEffects {
+
+	// The CPU math of a PointwiseChainEffect or ColorLookupEffect, built from
+	// its properties once, for renderers outside the imaging SDK that apply
+	// one configuration to many rows or images.
+	//
+	// Later property changes do not affect a plan. Its stage is pointwise, so
+	// it may run in place, and several threads may run it at once. The chain
+	// refers to the parameters next to it, so a plan never moves.
+	class CpuRenderPlan final
+	{
+	public:
+		// Throws InvalidArgumentException if effect is neither of the supported
+		// effects.
+		static std::unique_ptr<CpuRenderPlan> Create(Lumia::Imaging::IImageProvider^ effect);
+
+		// True if effect is one of the effects Create supports.
+		static bool IsSupported(Lumia::Imaging::IImageProvider^ effect);
+
+		CpuRenderPlan(const CpuRenderPlan&) = delete;
+
+		CpuRenderPlan& operator=(const CpuRenderPlan&) = delete;
+
+		StripStage& GetStage() const
+		{
+			return *m_stage;
+		}
+
+		// The stages the effect is made of.
+		const PointwiseChain* GetChain() const
+		{
+			return &m_chain;
+		}
+
+		// The lookup table to use instead of the chain, or nullptr if there is
+		// none.
+		const ColorLut3D* GetLut() const
+		{
+			return m_lut.get();
+		}
+
+	private:
+		CpuRenderPlan();
+
+		PointwiseChain m_chain;
+		PointwiseChainEffect::StageParameters m_parameters;
+		ColorLutCache::SharedLut m_lut;
+		std::unique_ptr<StripStage> m_stage;
+	};
+}
@@ -10,6 +10,7 @@
 //*********************************************************
 #include "pch.h"
 #include "CustomGrayscaleCpuWorker.h"
+#include "Extras\CustomEffectMemoryPressure.h"
 
 
 using namespace Lumia::Imaging;
@@ -21,12 +22,26 @@ using namespace Windows::Foundation;
 using namespace Windows::Storage::Streams;
 
 CustomGrayscaleCpuWorker::CustomGrayscaleCpuWorker(CustomGrayscaleEffect^ configuration) :
-	m_configuration(configuration)
+	m_configuration(configuration),
+	m_state(GetStatePool().Acquire()),
+	m_sourceBuffer(m_state->SourceBuffer),
+	m_targetBuffer(m_state->TargetBuffer),
+	m_convertRow(GrayscaleKernel::GetRowFunction()),
+	m_bandOptions(RowBands::GetDefaultOptions())
 {
 }
 
 CustomGrayscaleCpuWorker::~CustomGrayscaleCpuWorker()
 {
+	// The renderer releases the worker once the render has completed.
+	GetStatePool().Release(std::move(m_state));
+}
+
+WorkerStatePool<CustomGrayscaleCpuWorker::State>& CustomGrayscaleCpuWorker::GetStatePool()
+{
+	static WorkerStatePool<State>* pool = new WorkerStatePool<State>();
+	Extras::Detail::CustomEffectMemoryPressure::EnsureSubscribed();
+	return *pool;
 }
 
 void CustomGrayscaleCpuWorker::Prepare(CpuImageWorkerParameters parameters)
@@ -37,30 +52,14 @@ void CustomGrayscaleCpuWorker::Prepare(CpuImageWorkerParameters parameters)
 
 void CustomGrayscaleCpuWorker::Process(CpuImageWorkerRectangle rectangle)
 {
-	int red = 0;
-	int green = 0;
-	int blue = 0;
+	const CpuWorkerRegion region = Extras::Detail::GetCpuWorkerRegion(m_sourceBuffer, m_targetBuffer, rectangle);
 
-	const uint32* sourcePixels = m_sourceBuffer.GetData() + rectangle.SourceStartIndex;
-	uint32* targetPixels = m_targetBuffer.GetData();
+	auto convertRow = m_convertRow;
 
-	for(int y = 0; y < rectangle.Height; ++y)
+	RowBands::ForEach(region, m_bandOptions, [convertRow](const CpuWorkerRegion& band)
 	{
-		for(int x = 0; x < rectangle.Width; ++x)
-		{
-			UINT32 pixel = sourcePixels[x];
-
-			red = (pixel >> 16) & 0x000000FF;
-			green = (pixel >> 8) & 0x000000FF;
-			blue = (pixel)& 0x000000FF;
-		
-			int average = (int)(0.0722 * blue + 0.7152 * green + 0.2126 * red); // weighted average component
-			targetPixels[x] = 0xff000000 | average | (average << 8) | (average << 16); // use average for each color component			
-		}
-
-		sourcePixels += rectangle.SourcePitch;
-		targetPixels += rectangle.Width;
-	}	
+		GrayscaleKernel::ConvertRegion(band, convertRow);
+	});
 }
 
 void CustomGrayscaleCpuWorker::Configuration::set(IImageProvider^ value)
@@ -13,7 +13,11 @@
 #pragma once
 
 #include "CustomGrayscaleEffect.h"
+#include <memory>
 #include "Extras\CustomEffectCxBuffer.h"
+#include "GrayscaleKernel.h"
+#include "RowBands.h"
+#include "WorkerStatePool.h"
 
 namespace CustomNativeEffects {
 
@@ -57,11 +61,24 @@ namespace CustomNativeEffects {
 		}
 
 	private:
+		// Kept in a WorkerStatePool between renders so that the next worker
+		// starts with buffers that have already grown to the image size.
+		struct State
+		{
+			LI::Extras::Detail::CustomEffectCxBuffer SourceBuffer;
+			LI::Extras::Detail::CustomEffectCxBuffer TargetBuffer;
+		};
+
+		static WorkerStatePool<State>& GetStatePool();
+
 		void UpdateParameters();
 
 		CustomGrayscaleEffect^ m_configuration;
-		LI::Extras::Detail::CustomEffectCxBuffer m_sourceBuffer;
-		LI::Extras::Detail::CustomEffectCxBuffer m_targetBuffer;
+		std::unique_ptr<State> m_state;
+		LI::Extras::Detail::CustomEffectCxBuffer& m_sourceBuffer;
+		LI::Extras::Detail::CustomEffectCxBuffer& m_targetBuffer;
 		CustomGrayscaleEffect::Properties m_properties;
+		GrayscaleKernel::RowFunction m_convertRow;
+		RowBands::Options m_bandOptions;
 	};
 }
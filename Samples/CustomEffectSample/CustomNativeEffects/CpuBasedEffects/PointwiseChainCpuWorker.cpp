@@ -0,0 +1,125 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "pch.h"
+#include "PointwiseChainCpuWorker.h"
+#include "Extras\CustomEffectMemoryPressure.h"
+#include <algorithm>
+
+using namespace Lumia::Imaging;
+using namespace Lumia::Imaging::Workers::Cpu;
+using namespace Platform;
+using namespace CustomNativeEffects;
+using namespace Windows::Storage::Streams;
+
+PointwiseChainCpuWorker::PointwiseChainCpuWorker(PointwiseChainEffect^ configuration) :
+	m_configuration(configuration),
+	m_state(GetStatePool().Acquire()),
+	m_sourceBuffer(m_state->SourceBuffer),
+	m_targetBuffer(m_state->TargetBuffer),
+	m_stageVersions(),
+	m_applyLut(ColorLutKernel::GetRowFunction()),
+	m_bandOptions(RowBands::GetDefaultOptions())
+{
+}
+
+PointwiseChainCpuWorker::~PointwiseChainCpuWorker()
+{
+	// The renderer releases the worker once the render has completed.
+	GetStatePool().Release(std::move(m_state));
+}
+
+WorkerStatePool<PointwiseChainCpuWorker::State>& PointwiseChainCpuWorker::GetStatePool()
+{
+	static WorkerStatePool<State>* pool = new WorkerStatePool<State>();
+	Extras::Detail::CustomEffectMemoryPressure::EnsureSubscribed();
+	return *pool;
+}
+
+void PointwiseChainCpuWorker::Prepare(CpuImageWorkerParameters parameters)
+{
+	m_sourceBuffer.EnsureCapacity(parameters.SourceBufferLength);
+	m_targetBuffer.EnsureCapacity(parameters.TargetBufferLength);
+
+	UpdateLut(UpdateChain());
+}
+
+void PointwiseChainCpuWorker::Process(CpuImageWorkerRectangle rectangle)
+{
+	const CpuWorkerRegion region = Extras::Detail::GetCpuWorkerRegion(m_sourceBuffer, m_targetBuffer, rectangle);
+
+	if (m_lut)
+	{
+		const ColorLut3D* lut = m_lut.get();
+		auto applyLut = m_applyLut;
+
+		RowBands::ForEach(region, m_bandOptions, [lut, applyLut](const CpuWorkerRegion& band)
+		{
+			ColorLutKernel::ApplyRegion(band, *lut, applyLut);
+		});
+
+		return;
+	}
+
+	const PointwiseChain* chain = &m_chain;
+
+	RowBands::ForEach(region, m_bandOptions, [chain](const CpuWorkerRegion& band)
+	{
+		chain->ApplyRegion(band);
+	});
+}
+
+bool PointwiseChainCpuWorker::UpdateChain()
+{
+	return m_configuration->BuildChain(m_chain, m_state->Parameters, m_stageVersions);
+}
+
+void PointwiseChainCpuWorker::UpdateLut(bool chainChanged)
+{
+	const int32 size = m_configuration->LookupTableSize;
+
+	if (size == 0)
+	{
+		m_lut.reset();
+		return;
+	}
+
+	if (!m_lut || chainChanged || m_lut->GetSize() != size)
+	{
+		m_lut = ColorLutCache::GetInstance().GetLut(m_chain, size);
+	}
+}
+
+void PointwiseChainCpuWorker::Configuration::set(IImageProvider^ value)
+{
+	m_configuration = safe_cast<PointwiseChainEffect^>(value);
+	std::fill(std::begin(m_stageVersions), std::end(m_stageVersions), 0);
+	m_lut.reset();
+}
+
+IImageProvider^ PointwiseChainCpuWorker::Configuration::get()
+{
+	return m_configuration;
+}
+
+IBuffer^ PointwiseChainCpuWorker::SourceBuffer::get()
+{
+	return m_sourceBuffer.GetBuffer();
+}
+
+IBuffer^ PointwiseChainCpuWorker::TargetBuffer::get()
+{
+	return m_targetBuffer.GetBuffer();
+}
+
+ColorMode PointwiseChainCpuWorker::ColorMode::get()
+{
+	return Lumia::Imaging::ColorMode::Bgra8888;
+}
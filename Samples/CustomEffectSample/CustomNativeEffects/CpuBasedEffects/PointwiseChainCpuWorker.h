@@ -0,0 +1,91 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include "PointwiseChainEffect.h"
+#include <memory>
+#include "Extras\CustomEffectCxBuffer.h"
+#include "ColorLutCache.h"
+#include "ColorLutKernel.h"
+#include "PointwiseChain.h"
+#include "RowBands.h"
+#include "WorkerStatePool.h"
+
+namespace CustomNativeEffects {
+
+	namespace {
+		namespace LI = Lumia::Imaging;
+		namespace LIWC = Lumia::Imaging::Workers::Cpu;
+		namespace WSS = Windows::Storage::Streams;
+	}
+
+	public ref class PointwiseChainCpuWorker sealed : LIWC::ICpuImageWorker
+	{
+	public:
+		PointwiseChainCpuWorker(PointwiseChainEffect^ configuration);
+		virtual ~PointwiseChainCpuWorker();
+
+		virtual void Prepare(LIWC::CpuImageWorkerParameters parameters);
+
+		virtual void Process(LIWC::CpuImageWorkerRectangle rectangle);
+
+		virtual property LI::ColorMode ColorMode
+		{
+			LI::ColorMode get();
+		}
+
+		virtual property WSS::IBuffer^ SourceBuffer
+		{
+			WSS::IBuffer^ get();
+		}
+
+		virtual property WSS::IBuffer^ TargetBuffer
+		{
+			WSS::IBuffer^ get();
+		}
+
+		virtual property LI::IImageProvider^ Configuration
+		{
+			LI::IImageProvider^ get();
+			void set(LI::IImageProvider^ value);
+		}
+
+	private:
+		// Kept in a WorkerStatePool between renders, with the parameter storage
+		// of every stage. Which effect properties the parameters were built
+		// from is tracked by the worker, since versions are per effect.
+		struct State
+		{
+			LI::Extras::Detail::CustomEffectCxBuffer SourceBuffer;
+			LI::Extras::Detail::CustomEffectCxBuffer TargetBuffer;
+			PointwiseChainEffect::StageParameters Parameters;
+		};
+
+		static WorkerStatePool<State>& GetStatePool();
+
+		// Rebuilds the parameters of the stages whose properties changed, and
+		// the chain that runs them. Returns true if any stage changed.
+		bool UpdateChain();
+
+		// Picks up the lookup table for the chain, if the effect asks for one.
+		void UpdateLut(bool chainChanged);
+
+		PointwiseChainEffect^ m_configuration;
+		std::unique_ptr<State> m_state;
+		LI::Extras::Detail::CustomEffectCxBuffer& m_sourceBuffer;
+		LI::Extras::Detail::CustomEffectCxBuffer& m_targetBuffer;
+		uint64_t m_stageVersions[PointwiseChain::MaximumStages];
+		PointwiseChain m_chain;
+		ColorLutCache::SharedLut m_lut;
+		ColorLutKernel::RowFunction m_applyLut;
+		RowBands::Options m_bandOptions;
+	};
+}
@@ -0,0 +1,229 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "pch.h"
+#include "PointwiseChainEffect.h"
+#include "PointwiseChainCpuWorker.h"
+#include "ColorLut3D.h"
+#include "PointwiseChain.h"
+#include "PixelShaderEffectsWithTexture\SplitToneLookupCache.h"
+#include <algorithm>
+
+using namespace CustomNativeEffects;
+using namespace Platform;
+using namespace Lumia::Imaging;
+
+PointwiseChainEffect::PointwiseChainEffect(IImageProvider^ effect) :
+	m_effect(safe_cast<IImageProvider2^>(effect)),
+	m_lookupTableSize(0)
+{
+	IImageProvider^ link = effect;
+
+	for (;;)
+	{
+		Stage stage = {};
+
+		if ((stage.Grayscale = dynamic_cast<CustomGrayscaleEffect^>(link)) != nullptr)
+		{
+			stage.Kind = StageKind::Grayscale;
+			link = stage.Grayscale->Source;
+		}
+		else if ((stage.Saturation = dynamic_cast<Direct2DSaturationEffect^>(link)) != nullptr)
+		{
+			stage.Kind = StageKind::Saturation;
+			link = stage.Saturation->Source;
+		}
+		else if ((stage.SplitTone = dynamic_cast<SplitToneEffect^>(link)) != nullptr)
+		{
+			stage.Kind = StageKind::SplitTone;
+			link = stage.SplitTone->Source;
+		}
+		else
+		{
+			break;
+		}
+
+		if (m_stages.size() == PointwiseChain::MaximumStages)
+		{
+			throw ref new InvalidArgumentException("effect");
+		}
+
+		m_stages.push_back(stage);
+	}
+
+	if (m_stages.empty())
+	{
+		throw ref new InvalidArgumentException("effect");
+	}
+
+	// Walked from the outside in, applied from the inside out.
+	std::reverse(m_stages.begin(), m_stages.end());
+}
+
+IImageProvider^ PointwiseChainEffect::Effect::get()
+{
+	return m_effect;
+}
+
+uint32 PointwiseChainEffect::StageCount::get()
+{
+	return static_cast<uint32>(m_stages.size());
+}
+
+int32 PointwiseChainEffect::LookupTableSize::get()
+{
+	return m_lookupTableSize.load();
+}
+
+void PointwiseChainEffect::LookupTableSize::set(int32 value)
+{
+	if (value != 0 && (value < ColorLut3D::MinimumSize || value > ColorLut3D::LargeSize))
+	{
+		throw ref new InvalidArgumentException("LookupTableSize");
+	}
+
+	m_lookupTableSize.store(value);
+}
+
+const std::vector<PointwiseChainEffect::Stage>& PointwiseChainEffect::GetStages()
+{
+	return m_stages;
+}
+
+bool PointwiseChainEffect::BuildChain(PointwiseChain& chain, StageParameters& parameters, uint64_t (&versions)[PointwiseChain::MaximumStages])
+{
+	bool changed = false;
+
+	chain.Clear();
+
+	for (size_t i = 0; i < m_stages.size(); ++i)
+	{
+		const Stage& stage = m_stages[i];
+
+		switch (stage.Kind)
+		{
+		case StageKind::Grayscale:
+			chain.AddGrayscale();
+			break;
+
+		case StageKind::Saturation:
+		{
+			auto snapshot = stage.Saturation->GetProperties();
+
+			if (snapshot.Version != versions[i])
+			{
+				SaturationKernel::BuildMatrix(static_cast<float>(snapshot.Value.m_level), parameters.Matrices[i]);
+				versions[i] = snapshot.Version;
+				changed = true;
+			}
+
+			chain.AddSaturation(parameters.Matrices[i]);
+			break;
+		}
+
+		case StageKind::SplitTone:
+		{
+			auto snapshot = stage.SplitTone->GetProperties();
+			std::unique_ptr<SplitToneKernel::Adjustments>& adjustments = parameters.Adjustments[i];
+
+			if (!adjustments || snapshot.Version != versions[i])
+			{
+				if (!adjustments)
+				{
+					adjustments.reset(new SplitToneKernel::Adjustments);
+				}
+
+				const SplitToneEffect::Properties& properties = snapshot.Value;
+				auto lookupTable = SplitToneLookupCache::GetInstance().GetLookupTable(properties.m_highHue, properties.m_highShift, properties.m_lowHue, properties.m_lowShift);
+				SplitToneKernel::BuildAdjustments(*lookupTable, *adjustments);
+				versions[i] = snapshot.Version;
+				changed = true;
+			}
+
+			chain.AddSplitTone(*adjustments);
+			break;
+		}
+		}
+	}
+
+	return changed;
+}
+
+IImageConsumer2^ PointwiseChainEffect::GetInnermostEffect()
+{
+	const Stage& stage = m_stages.front();
+
+	switch (stage.Kind)
+	{
+	case StageKind::Grayscale:
+		return stage.Grayscale;
+	case StageKind::Saturation:
+		return stage.Saturation;
+	default:
+		return stage.SplitTone;
+	}
+}
+
+IImageProvider2^ PointwiseChainEffect::Clone()
+{
+	auto clone = ref new PointwiseChainEffect(m_effect->Clone());
+	clone->m_lookupTableSize.store(m_lookupTableSize.load());
+	return clone;
+}
+
+RenderOptions PointwiseChainEffect::SupportedRenderOptions::get()
+{
+	return RenderOptions::Cpu;
+}
+
+Workers::IImageWorker^ PointwiseChainEffect::CreateImageWorker(Workers::IImageWorkerRequest^ imageWorkerRequest)
+{
+	if(imageWorkerRequest->RenderOptions == RenderOptions::Cpu)
+	{
+		return ref new PointwiseChainCpuWorker(this);
+	}
+
+	return nullptr;
+}
+
+IImageProvider^ PointwiseChainEffect::Source::get()
+{
+	return GetInnermostEffect()->Source;
+}
+
+void PointwiseChainEffect::Source::set(IImageProvider^ value)
+{
+	GetInnermostEffect()->Source = value;
+}
+
+uint32 PointwiseChainEffect::SourceCount::get()
+{
+	return 1;
+}
+
+void PointwiseChainEffect::GetSources(Platform::WriteOnlyArray<IImageProvider2^>^ sources)
+{
+	if(SourceCount > sources->Length)
+	{
+		throw ref new Platform::InvalidArgumentException("sources");
+	}
+
+	GetInnermostEffect()->GetSources(sources);
+}
+
+void PointwiseChainEffect::SetSource(uint32 sourceIndex, IImageProvider2^ source)
+{
+	if(sourceIndex >= SourceCount)
+	{
+		throw ref new Platform::InvalidArgumentException("sourceIndex");
+	}
+
+	GetInnermostEffect()->SetSource(sourceIndex, source);
+}
@@ -0,0 +1,174 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "CustomGrayscaleEffect.h"
+#include "PointwiseChain.h"
+#include "PixelShaderEffectsWithTexture\SplitToneEffect.h"
+#include "WrapDirect2DEffects\Direct2DSaturationEffect.h"
+
+#pragma warning(push)
+#pragma warning(disable: 4973)
+
+namespace CustomNativeEffects {
+
+	using namespace Lumia::Imaging;
+
+	// Renders a chain of per-pixel effects on the CPU in a single pass.
+	//
+	// Pass the outermost effect of a chain built from CustomGrayscaleEffect,
+	// Direct2DSaturationEffect and SplitToneEffect, for example a split tone
+	// whose source is a saturation whose source is a grayscale. Every link down
+	// to the first effect of another type becomes a stage; that effect is the
+	// chain's source. Rendering this effect gives the same pixels as rendering
+	// the outermost effect, but reads the source and writes the target once
+	// instead of once per effect.
+	//
+	// The stages are fixed when the chain is created. Properties of the wrapped
+	// effects can still be changed and are picked up by the next render, and
+	// setting this effect's source sets the source of the innermost stage.
+	public ref class PointwiseChainEffect sealed : IImageProvider2, IImageConsumer2
+	{
+	internal:
+		enum class StageKind
+		{
+			Grayscale,
+			Saturation,
+			SplitTone
+		};
+
+		// One wrapped effect; only the handle of its kind is set.
+		struct Stage
+		{
+			StageKind Kind;
+			CustomGrayscaleEffect^ Grayscale;
+			Direct2DSaturationEffect^ Saturation;
+			SplitToneEffect^ SplitTone;
+		};
+
+	public:
+		PointwiseChainEffect(IImageProvider^ effect);
+
+		// The outermost effect the chain was created from.
+		property IImageProvider^ Effect
+		{
+			IImageProvider^ get();
+		}
+
+		property uint32 StageCount
+		{
+			uint32 get();
+		}
+
+		// When not 0, the chain is compiled into a 3D lookup table with this many
+		// nodes per axis, and every pixel costs one tetrahedral lookup however
+		// many stages there are. Tables are cached across renders by parameter
+		// hash. 33 is within 2 levels of running the stages for nearly all
+		// colors; use 65 for smoother results, or 0 to run the stages exactly.
+		// Must be 0 or between 2 and 65. Default 0.
+		property int32 LookupTableSize
+		{
+			int32 get();
+			void set(int32 value);
+		}
+
+#pragma region IImageConsumer implementation
+
+		virtual property IImageProvider^ Source
+		{
+			IImageProvider^ get();
+			void set(IImageProvider^ value);
+		}
+
+#pragma endregion
+
+#pragma region IImageConsumer2 implementation
+
+		virtual property uint32 SourceCount
+		{
+			uint32 get();
+		}
+
+		virtual void GetSources(Platform::WriteOnlyArray<IImageProvider2^>^ sources);
+
+		virtual void SetSource(uint32 sourceIndex, IImageProvider2^ source);
+
+#pragma endregion
+
+#pragma region IImageProvider implementation
+
+		virtual Windows::Foundation::IAsyncAction^ PreloadAsync()
+		{
+			throw ref new Platform::NotImplementedException();
+		}
+
+		virtual Windows::Foundation::IAsyncOperation<Bitmap^>^ GetBitmapAsync(Bitmap^ bitmap, OutputOption outputOption)
+		{
+			throw ref new Platform::NotImplementedException();
+		}
+
+		virtual Windows::Foundation::IAsyncOperation<ImageProviderInfo^>^ GetInfoAsync()
+		{
+			throw ref new Platform::NotImplementedException();
+		}
+
+		virtual bool Lock(RenderRequest^ renderRequest)
+		{
+			throw ref new Platform::NotImplementedException();
+		}
+
+#pragma endregion
+
+#pragma region IImageProvider2 implementation
+
+		virtual property RenderOptions SupportedRenderOptions
+		{
+			RenderOptions get();
+		}
+
+		virtual IImageProvider2^ Clone();
+
+		virtual Workers::IImageWorker^ CreateImageWorker(Workers::IImageWorkerRequest^ imageWorkerRequest);
+
+#pragma endregion
+
+	internal:
+		// The stages in the order they are applied, innermost effect first.
+		const std::vector<Stage>& GetStages();
+
+		// Kernel parameters for every stage. A chain built from them refers to
+		// them, so they must not move while the chain is in use.
+		struct StageParameters
+		{
+			SaturationKernel::Matrix Matrices[PointwiseChain::MaximumStages];
+			std::unique_ptr<SplitToneKernel::Adjustments> Adjustments[PointwiseChain::MaximumStages];
+		};
+
+		// Rebuilds chain from the stages' current properties. versions holds the
+		// property version each stage's parameters were last built from; stages
+		// whose properties are still at that version keep them, and zeroed
+		// versions build every stage. Returns true if any parameters were
+		// rebuilt.
+		bool BuildChain(PointwiseChain& chain, StageParameters& parameters, uint64_t (&versions)[PointwiseChain::MaximumStages]);
+
+	private:
+		IImageConsumer2^ GetInnermostEffect();
+
+		IImageProvider2^ m_effect;
+		std::vector<Stage> m_stages;
+		std::atomic<int32> m_lookupTableSize;
+	};
+}
+
+#pragma warning(pop)
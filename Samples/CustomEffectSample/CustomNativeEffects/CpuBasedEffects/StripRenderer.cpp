@@ -0,0 +1,155 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "pch.h"
+#include "StripRenderer.h"
+#include "CpuRenderPlan.h"
+#include "Extras\WicImageCodec.h"
+#include "StripPipeline.h"
+#include <memory>
+#include <ppltasks.h>
+
+using namespace CustomNativeEffects;
+using namespace Platform;
+using namespace Lumia::Imaging;
+using namespace Lumia::Imaging::Extras::Detail;
+using namespace Windows::Foundation;
+using namespace Windows::Storage::Streams;
+
+namespace {
+
+	class WicStripSource final : public StripSource
+	{
+	public:
+		explicit WicStripSource(WicImageCodec::Reader& reader) :
+			m_reader(reader)
+		{
+		}
+
+		virtual void ReadRows(int32_t firstRow, int32_t rowCount, uint32_t* pixels, int32_t pitch) override
+		{
+			m_reader.ReadRows(firstRow, rowCount, pixels, pitch);
+		}
+
+	private:
+		WicImageCodec::Reader& m_reader;
+	};
+
+	class WicStripSink final : public StripSink
+	{
+	public:
+		explicit WicStripSink(WicImageCodec::Writer& writer) :
+			m_writer(writer)
+		{
+		}
+
+		virtual void WriteRows(int32_t firstRow, int32_t rowCount, const uint32_t* pixels, int32_t pitch) override
+		{
+			UNREFERENCED_PARAMETER(firstRow);
+
+			m_writer.WriteRows(rowCount, pixels, pitch);
+		}
+
+	private:
+		WicImageCodec::Writer& m_writer;
+	};
+
+	void Render(const CpuRenderPlan& plan, int32_t stripRows, IRandomAccessStream^ source, IRandomAccessStream^ target, const GUID& encoderId, const CancellationToken& cancellation)
+	{
+		WicImageCodec::Reader reader(source);
+		WicImageCodec::Writer writer(target, encoderId, reader.GetWidth(), reader.GetHeight());
+		WicStripSource stripSource(reader);
+		WicStripSink stripSink(writer);
+
+		StripPipeline::Options options;
+		options.StripRows = stripRows;
+		options.Bands = RowBands::GetDefaultOptions();
+		options.Bands.Cancellation = &cancellation;
+
+		StripStage* stage = &plan.GetStage();
+
+		if (!StripPipeline::Run(static_cast<int32_t>(reader.GetWidth()), static_cast<int32_t>(reader.GetHeight()), stripSource, &stage, 1, stripSink, options))
+		{
+			concurrency::cancel_current_task();
+		}
+
+		writer.Commit();
+	}
+}
+
+StripRenderer::StripRenderer(IImageProvider^ effect) :
+	m_effect(effect),
+	m_stripRows(0)
+{
+	if (!CpuRenderPlan::IsSupported(effect))
+	{
+		throw ref new InvalidArgumentException("effect");
+	}
+}
+
+IImageProvider^ StripRenderer::Effect::get()
+{
+	return m_effect;
+}
+
+int32 StripRenderer::StripRows::get()
+{
+	return m_stripRows.load();
+}
+
+void StripRenderer::StripRows::set(int32 value)
+{
+	if (value < 0)
+	{
+		throw ref new InvalidArgumentException("StripRows");
+	}
+
+	m_stripRows.store(value);
+}
+
+IAsyncAction^ StripRenderer::RenderAsync(IRandomAccessStream^ source, IRandomAccessStream^ target, Guid encoderId)
+{
+	if (source == nullptr)
+	{
+		throw ref new InvalidArgumentException("source");
+	}
+
+	if (target == nullptr)
+	{
+		throw ref new InvalidArgumentException("target");
+	}
+
+	// The parameters are read now, so later property changes do not affect
+	// this render.
+	std::shared_ptr<CpuRenderPlan> plan(CpuRenderPlan::Create(m_effect));
+	const int32 stripRows = m_stripRows.load();
+	const GUID encoder = encoderId;
+
+	return concurrency::create_async([plan, stripRows, source, target, encoder](concurrency::cancellation_token token)
+	{
+		CancellationToken cancellation;
+		auto registration = token.register_callback([&cancellation]()
+		{
+			cancellation.Cancel();
+		});
+
+		try
+		{
+			Render(*plan, stripRows, source, target, encoder, cancellation);
+		}
+		catch (...)
+		{
+			token.deregister_callback(registration);
+			throw;
+		}
+
+		token.deregister_callback(registration);
+	});
+}
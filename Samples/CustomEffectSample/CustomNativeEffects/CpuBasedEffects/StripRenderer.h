@@ -0,0 +1,58 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <atomic>
+
+namespace CustomNativeEffects {
+
+	using namespace Lumia::Imaging;
+
+	// Renders an encoded image through a CPU effect strip by strip, for images
+	// too large to decode into memory at once.
+	//
+	// Renderers of the imaging SDK hand CPU workers the whole source and target
+	// image. This renderer decodes the source a strip of rows at a time with
+	// the Windows Imaging Component, runs the effect on the strip and passes it
+	// to the encoder, so its own memory depends on the image width and
+	// StripRows but not on the image height. Whether the codecs decode and
+	// encode incrementally as well is up to the codec; JPEG, PNG and TIFF do.
+	public ref class StripRenderer sealed
+	{
+	public:
+		// effect is a PointwiseChainEffect or a ColorLookupEffect. Its source is
+		// not used; the image comes from the stream passed to RenderAsync.
+		StripRenderer(IImageProvider^ effect);
+
+		property IImageProvider^ Effect
+		{
+			IImageProvider^ get();
+		}
+
+		// Output rows per strip, or 0 to size strips so that every rendering
+		// thread gets one band of rows per strip. 0 by default.
+		property int32 StripRows
+		{
+			int32 get();
+			void set(int32 value);
+		}
+
+		// Decodes the first frame of source, renders it through the effect and
+		// encodes the result into target. encoderId identifies the encoder, for
+		// example Windows::Graphics::Imaging::BitmapEncoder::JpegEncoderId.
+		// Canceling the action stops the render at the next band.
+		Windows::Foundation::IAsyncAction^ RenderAsync(Windows::Storage::Streams::IRandomAccessStream^ source, Windows::Storage::Streams::IRandomAccessStream^ target, Platform::Guid encoderId);
+
+	private:
+		IImageProvider^ m_effect;
+		std::atomic<int32> m_stripRows;
+	};
+}
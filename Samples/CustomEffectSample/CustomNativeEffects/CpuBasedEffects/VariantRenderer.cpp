@@ -0,0 +1,174 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "pch.h"
+#include "VariantRenderer.h"
+#include "CpuRenderPlan.h"
+#include "VariantPass.h"
+#include <MemoryBuffer.h>
+#include <memory>
+#include <vector>
+#include <ppltasks.h>
+
+using namespace CustomNativeEffects;
+using namespace Microsoft::WRL;
+using namespace Platform;
+using namespace Platform::Collections;
+using namespace Lumia::Imaging;
+using namespace Windows::Foundation;
+using namespace Windows::Foundation::Collections;
+using namespace Windows::Graphics::Imaging;
+
+namespace {
+
+	// The pixels of a locked SoftwareBitmap, until the lock is closed.
+	class LockedPixels final
+	{
+	public:
+		LockedPixels(SoftwareBitmap^ bitmap, BitmapBufferAccessMode mode) :
+			m_buffer(bitmap->LockBuffer(mode)),
+			m_reference(m_buffer->CreateReference()),
+			m_pixels(nullptr),
+			m_pitch(0),
+			m_tailPixels(0)
+		{
+			ComPtr<IMemoryBufferByteAccess> byteAccess;
+			__abi_ThrowIfFailed(reinterpret_cast<IInspectable*>(m_reference)->QueryInterface(IID_PPV_ARGS(&byteAccess)));
+
+			BYTE* data;
+			UINT32 capacity;
+			__abi_ThrowIfFailed(byteAccess->GetBuffer(&data, &capacity));
+
+			const BitmapPlaneDescription plane = m_buffer->GetPlaneDescription(0);
+			const int64_t end = plane.StartIndex + static_cast<int64_t>(plane.Height - 1) * plane.Stride + static_cast<int64_t>(plane.Width) * sizeof(uint32_t);
+
+			m_pixels = reinterpret_cast<uint32_t*>(data + plane.StartIndex);
+			m_pitch = plane.Stride / sizeof(uint32_t);
+			m_tailPixels = static_cast<int32_t>((capacity - end) / sizeof(uint32_t));
+		}
+
+		~LockedPixels()
+		{
+			delete m_reference;
+			delete m_buffer;
+		}
+
+		LockedPixels(const LockedPixels&) = delete;
+
+		LockedPixels& operator=(const LockedPixels&) = delete;
+
+		uint32_t* GetPixels() const
+		{
+			return m_pixels;
+		}
+
+		int32_t GetPitch() const
+		{
+			return m_pitch;
+		}
+
+		int32_t GetTailPixels() const
+		{
+			return m_tailPixels;
+		}
+
+	private:
+		BitmapBuffer^ m_buffer;
+		IMemoryBufferReference^ m_reference;
+		uint32_t* m_pixels;
+		int32_t m_pitch;
+		int32_t m_tailPixels;
+	};
+
+	typedef std::vector<std::unique_ptr<CpuRenderPlan>> PlanList;
+}
+
+VariantRenderer::VariantRenderer(IIterable<IImageProvider^>^ variants)
+{
+	if (variants == nullptr)
+	{
+		throw ref new InvalidArgumentException("variants");
+	}
+
+	auto list = ref new Vector<IImageProvider^>(begin(variants), end(variants));
+
+	if (list->Size == 0 || list->Size > static_cast<uint32>(VariantPass::MaximumVariants))
+	{
+		throw ref new InvalidArgumentException("variants");
+	}
+
+	for (IImageProvider^ variant : list)
+	{
+		if (!CpuRenderPlan::IsSupported(variant))
+		{
+			throw ref new InvalidArgumentException("variants");
+		}
+	}
+
+	m_variants = list->GetView();
+}
+
+IVectorView<IImageProvider^>^ VariantRenderer::Variants::get()
+{
+	return m_variants;
+}
+
+IAsyncOperation<IVectorView<SoftwareBitmap^>^>^ VariantRenderer::RenderAsync(SoftwareBitmap^ source)
+{
+	if (source == nullptr)
+	{
+		throw ref new InvalidArgumentException("source");
+	}
+
+	auto plans = std::make_shared<PlanList>();
+
+	for (IImageProvider^ variant : m_variants)
+	{
+		plans->push_back(CpuRenderPlan::Create(variant));
+	}
+
+	return concurrency::create_async([plans, source]() -> IVectorView<SoftwareBitmap^>^
+	{
+		SoftwareBitmap^ bgraSource = source->BitmapPixelFormat == BitmapPixelFormat::Bgra8 ? source : SoftwareBitmap::Convert(source, BitmapPixelFormat::Bgra8, source->BitmapAlphaMode);
+
+		const int32_t width = bgraSource->PixelWidth;
+		const int32_t height = bgraSource->PixelHeight;
+
+		auto targets = ref new Vector<SoftwareBitmap^>();
+		std::vector<std::unique_ptr<LockedPixels>> targetPixels;
+		std::vector<VariantPass::Variant> variants(plans->size());
+
+		for (size_t i = 0; i < plans->size(); ++i)
+		{
+			auto target = ref new SoftwareBitmap(BitmapPixelFormat::Bgra8, width, height, bgraSource->BitmapAlphaMode);
+			targets->Append(target);
+			targetPixels.emplace_back(new LockedPixels(target, BitmapBufferAccessMode::Write));
+
+			const CpuRenderPlan& plan = *(*plans)[i];
+			variants[i].Chain = plan.GetChain();
+			variants[i].Lut = plan.GetLut();
+			variants[i].TargetPixels = targetPixels[i]->GetPixels();
+			variants[i].TargetPitch = targetPixels[i]->GetPitch();
+			variants[i].TargetTailPixels = targetPixels[i]->GetTailPixels();
+		}
+
+		{
+			LockedPixels sourcePixels(bgraSource, BitmapBufferAccessMode::Read);
+			const VariantPass::SourceImage image = { sourcePixels.GetPixels(), sourcePixels.GetPitch(), width, height, sourcePixels.GetTailPixels() };
+
+			VariantPass::Apply(image, variants.data(), static_cast<int32_t>(variants.size()), RowBands::GetDefaultOptions());
+		}
+
+		// The bitmaps can only be used once their locks are closed.
+		targetPixels.clear();
+
+		return targets->GetView();
+	});
+}
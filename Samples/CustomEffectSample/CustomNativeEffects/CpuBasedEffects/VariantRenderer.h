@@ -0,0 +1,44 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+namespace CustomNativeEffects {
+
+	using namespace Lumia::Imaging;
+
+	// Renders one image through several variants of a CPU effect in a single
+	// pass, for example a grid of previews of a split tone effect with
+	// different hues, or of a saturation effect with different levels.
+	//
+	// Rendering each variant on its own reads the whole source once per
+	// variant. This renderer reads each small tile of the source once and
+	// writes it through every variant while it is still in the cache.
+	public ref class VariantRenderer sealed
+	{
+	public:
+		// Every variant is a PointwiseChainEffect or a ColorLookupEffect. Their
+		// sources are not used; the image is passed to RenderAsync.
+		VariantRenderer(Windows::Foundation::Collections::IIterable<IImageProvider^>^ variants);
+
+		property Windows::Foundation::Collections::IVectorView<IImageProvider^>^ Variants
+		{
+			Windows::Foundation::Collections::IVectorView<IImageProvider^>^ get();
+		}
+
+		// Renders source through every variant, returning one BGRA8 bitmap per
+		// variant in the same order. source is converted to BGRA8 first if
+		// needed. The variants' properties are read when the render starts.
+		Windows::Foundation::IAsyncOperation<Windows::Foundation::Collections::IVectorView<Windows::Graphics::Imaging::SoftwareBitmap^>^>^ RenderAsync(Windows::Graphics::Imaging::SoftwareBitmap^ source);
+
+	private:
+		Windows::Foundation::Collections::IVectorView<IImageProvider^>^ m_variants;
+	};
+}
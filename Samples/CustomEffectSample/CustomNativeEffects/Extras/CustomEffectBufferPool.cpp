@@ -0,0 +1,68 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+
+#include "pch.h"
+#include "CustomEffectBufferPool.h"
+#include "CustomEffectNativeBuffer.h"
+
+using namespace Lumia::Imaging::Extras::Detail;
+using namespace Windows::Storage::Streams;
+
+CustomEffectBufferPool& CustomEffectBufferPool::GetInstance()
+{
+	static CustomEffectBufferPool instance;
+	return instance;
+}
+
+CustomEffectBufferPool::CustomEffectBufferPool() :
+	m_pool(CustomNativeEffects::BufferPool::GetInstance())
+{
+}
+
+IBuffer^ CustomEffectBufferPool::Acquire(uint32 requiredLength)
+{
+	return CustomEffectNativeBuffer::CreatePooled(requiredLength);
+}
+
+void CustomEffectBufferPool::Trim()
+{
+	m_pool.Trim();
+}
+
+void CustomEffectBufferPool::TrimIdle()
+{
+	m_pool.TrimIdle();
+}
+
+uint64_t CustomEffectBufferPool::GetMemoryCap() const
+{
+	return m_pool.GetMemoryCap();
+}
+
+void CustomEffectBufferPool::SetMemoryCap(uint64_t bytes)
+{
+	m_pool.SetMemoryCap(bytes);
+}
+
+std::chrono::milliseconds CustomEffectBufferPool::GetIdleTimeout() const
+{
+	return m_pool.GetIdleTimeout();
+}
+
+void CustomEffectBufferPool::SetIdleTimeout(std::chrono::milliseconds timeout)
+{
+	m_pool.SetIdleTimeout(timeout);
+}
+
+CustomEffectBufferPool::Statistics CustomEffectBufferPool::GetStatistics() const
+{
+	return m_pool.GetStatistics();
+}
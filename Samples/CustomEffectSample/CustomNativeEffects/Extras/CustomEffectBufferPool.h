@@ -0,0 +1,71 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include "AlignedBuffer.h"
+#include "BufferPool.h"
+
+namespace Lumia { namespace Imaging { namespace Extras {
+
+	namespace Detail {
+
+		// IBuffer front end of the process-wide CustomNativeEffects::BufferPool shared
+		// by every CustomEffectCxBuffer.
+		//
+		// Buffers handed out here return to the pool by themselves once their last
+		// reference is released; see CustomEffectNativeBuffer.
+		class CustomEffectBufferPool final
+		{
+		public:
+			typedef CustomNativeEffects::BufferPool::Statistics Statistics;
+
+			static CustomEffectBufferPool& GetInstance();
+
+			CustomEffectBufferPool(const CustomEffectBufferPool&) = delete;
+
+			CustomEffectBufferPool& operator=(const CustomEffectBufferPool&) = delete;
+
+			// Every buffer the pool hands out starts on an Alignment-byte boundary and is
+			// followed by TailPadding bytes that may be read and written past Capacity.
+			static const uint32 Alignment = CustomNativeEffects::AlignedBuffer::DefaultAlignment;
+			static const uint32 TailPadding = CustomNativeEffects::AlignedBuffer::DefaultTailPadding;
+
+			// Returns a buffer whose Capacity is at least requiredLength. The Length of the
+			// returned buffer is unspecified.
+			Windows::Storage::Streams::IBuffer^ Acquire(uint32 requiredLength);
+
+			// Drops every idle buffer.
+			void Trim();
+
+			// Drops the buffers that have been idle for longer than the idle timeout.
+			void TrimIdle();
+
+			// Upper bound for the bytes held by idle buffers. Default 256 MB.
+			uint64_t GetMemoryCap() const;
+			void SetMemoryCap(uint64_t bytes);
+
+			// How long a buffer may stay idle before TrimIdle drops it. Default 30 seconds.
+			std::chrono::milliseconds GetIdleTimeout() const;
+			void SetIdleTimeout(std::chrono::milliseconds timeout);
+
+			Statistics GetStatistics() const;
+
+		private:
+			CustomEffectBufferPool();
+
+			CustomNativeEffects::BufferPool& m_pool;
+		};
+	}
+
+}}}
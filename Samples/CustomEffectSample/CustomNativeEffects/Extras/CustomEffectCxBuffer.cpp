@@ -21,6 +21,8 @@
 
 #include "pch.h"
 #include "CustomEffectCxBuffer.h"
+#include "CustomEffectBufferPool.h"
+#include "CustomEffectNativeBuffer.h"
 
 using namespace Lumia::Imaging::Extras::Detail;
 
@@ -28,7 +30,9 @@ static uint32* GetBufferData(Windows::Storage::Streams::IBufferByteAccess* buffe
 static Microsoft::WRL::ComPtr<Windows::Storage::Streams::IBufferByteAccess> GetBufferByteAccess(IInspectable* buffer);
 
 CustomEffectCxBuffer::CustomEffectCxBuffer() :
-	m_bufferData(nullptr)
+	m_bufferData(nullptr),
+	m_pitch(0),
+	m_isExternal(false)
 {
 }
 
@@ -37,13 +41,22 @@ void CustomEffectCxBuffer::Clear()
 	m_bufferData = nullptr;
 	m_bufferByteAccess = nullptr;
 	m_buffer = nullptr;
+	m_pitch = 0;
+	m_isExternal = false;
 }
 
 void CustomEffectCxBuffer::EnsureCapacity(uint32 requiredLength)
 {
+	if(m_isExternal && requiredLength > m_buffer->Capacity)
+	{
+		throw ref new Platform::OutOfBoundsException("requiredLength");
+	}
+
 	if(!m_buffer || requiredLength > m_buffer->Capacity)
 	{
-		m_buffer = ref new Windows::Storage::Streams::Buffer(requiredLength);
+		Clear();
+
+		m_buffer = CustomEffectBufferPool::GetInstance().Acquire(requiredLength);
 		m_bufferByteAccess = GetBufferByteAccess(reinterpret_cast<IInspectable*>(m_buffer));
 		m_bufferData = GetBufferData(m_bufferByteAccess.Get());
 	}
@@ -51,6 +64,58 @@ void CustomEffectCxBuffer::EnsureCapacity(uint32 requiredLength)
 	m_buffer->Length = requiredLength;
 }
 
+void CustomEffectCxBuffer::Attach(const ExternalPixelMemory& memory)
+{
+	if(!memory.Data || memory.Pitch % sizeof(uint32) != 0 || memory.Length % sizeof(uint32) != 0)
+	{
+		throw ref new Platform::InvalidArgumentException("memory");
+	}
+
+	Clear();
+
+	m_buffer = CustomEffectNativeBuffer::CreateExternal(static_cast<byte*>(memory.Data), memory.Length, memory.Release);
+	m_bufferByteAccess = GetBufferByteAccess(reinterpret_cast<IInspectable*>(m_buffer));
+	m_bufferData = GetBufferData(m_bufferByteAccess.Get());
+	m_pitch = memory.Pitch;
+	m_isExternal = true;
+}
+
+CustomNativeEffects::CpuWorkerRegion Lumia::Imaging::Extras::Detail::GetCpuWorkerRegion(const CustomEffectCxBuffer& source, const CustomEffectCxBuffer& target, Lumia::Imaging::Workers::Cpu::CpuImageWorkerRectangle rectangle)
+{
+	using CustomNativeEffects::CpuWorkerRegion;
+
+	if(source.GetPitch() != 0 && source.GetPitch() != static_cast<uint32>(rectangle.SourcePitch))
+	{
+		throw ref new Platform::InvalidArgumentException("rectangle");
+	}
+
+	if(target.GetPitch() != 0 && target.GetPitch() != static_cast<uint32>(rectangle.Width))
+	{
+		throw ref new Platform::InvalidArgumentException("rectangle");
+	}
+
+	const int32_t sourceEnd = rectangle.SourceStartIndex + (rectangle.Height - 1) * rectangle.SourcePitch + rectangle.Width;
+	const int32_t targetEnd = rectangle.Height * rectangle.Width;
+
+	CpuWorkerRegion region = CpuWorkerRegion::Create(
+		source.GetData() + rectangle.SourceStartIndex, rectangle.SourcePitch, static_cast<int32_t>(source.GetPaddedPixelCount()) - sourceEnd,
+		target.GetData(), rectangle.Width, static_cast<int32_t>(target.GetPaddedPixelCount()) - targetEnd,
+		rectangle.Width, rectangle.Height);
+
+	if(region.TargetTailPixels < 0)
+	{
+		throw ref new Platform::OutOfBoundsException("rectangle");
+	}
+
+	// Attached memory past the target pixels belongs to the caller.
+	if(target.IsExternal())
+	{
+		region.TargetTailPixels = 0;
+	}
+
+	return region;
+}
+
 static uint32* GetBufferData(Windows::Storage::Streams::IBufferByteAccess* bufferByteAccess)
 {
 	uint32* bufferData = nullptr;
@@ -23,11 +23,32 @@
 
 #include <wrl.h>
 #include <robuffer.h>
+#include <functional>
+#include "CustomEffectBufferPool.h"
+#include "CpuWorkerRegion.h"
 
 namespace Lumia { namespace Imaging { namespace Extras {
 
 	namespace Detail {
 
+		// Pixel memory owned by the caller. Pitch is the distance between rows in
+		// bytes; 0 means the rows are packed. Release is called once the memory is no
+		// longer referenced, and may be empty if the caller manages the lifetime itself.
+		struct ExternalPixelMemory
+		{
+			ExternalPixelMemory() :
+				Data(nullptr),
+				Length(0),
+				Pitch(0)
+			{
+			}
+
+			void* Data;
+			uint32 Length;
+			uint32 Pitch;
+			std::function<void()> Release;
+		};
+
 		class CustomEffectCxBuffer final
 		{
 		public:
@@ -41,10 +62,35 @@ namespace Lumia { namespace Imaging { namespace Extras {
 
 			CustomEffectCxBuffer& operator=(CustomEffectCxBuffer&&) = delete;
 
+			// Drops this buffer's reference. Pooled memory goes back to CustomEffectBufferPool
+			// once the renderer has released the IBuffer as well.
 			void Clear();
 
+			// Makes the buffer at least requiredLength bytes long. Growing takes a buffer
+			// from CustomEffectBufferPool and drops the previous one as Clear does; the
+			// contents are not preserved.
+			//
+			// When external memory is attached it is never replaced: a request that does
+			// not fit throws OutOfBoundsException instead of silently copying.
 			void EnsureCapacity(uint32 requiredLength);
 
+			// Uses the caller's memory as this buffer, without copying, until the next
+			// Attach or Clear.
+			void Attach(const ExternalPixelMemory& memory);
+
+			bool IsExternal() const
+			{
+				return m_isExternal;
+			}
+
+			// Row pitch of attached memory in pixels, or 0 if the rows are packed.
+			// Unlike pooled memory, attached memory has no tail padding, and any gap
+			// between rows belongs to the caller.
+			uint32 GetPitch() const
+			{
+				return m_pitch / sizeof(uint32);
+			}
+
 			Windows::Storage::Streams::IBuffer^ GetBuffer() const
 			{
 				return m_buffer;
@@ -60,11 +106,35 @@ namespace Lumia { namespace Imaging { namespace Extras {
 				return m_buffer->Length;
 			}
 
+			// Number of pixels that may be touched from GetData(), including the pool's
+			// tail padding. Kernels may read and write up to here without a scalar epilogue.
+			uint32 GetPaddedPixelCount() const
+			{
+				if (!m_buffer)
+				{
+					return 0;
+				}
+
+				return (m_buffer->Capacity + (m_isExternal ? 0 : CustomEffectBufferPool::TailPadding)) / sizeof(uint32);
+			}
+
 		private:
 			Windows::Storage::Streams::IBuffer^ m_buffer;
 			Microsoft::WRL::ComPtr<Windows::Storage::Streams::IBufferByteAccess> m_bufferByteAccess;
 			uint32* m_bufferData;
+			uint32 m_pitch;
+			bool m_isExternal;
 		};
+
+		// The region a CPU worker processes for rectangle, from source into target.
+		// Target rows are packed, as the renderer reads them, and the tail past the
+		// last target pixel only counts for pooled memory.
+		//
+		// Throws InvalidArgumentException if source is attached memory whose pitch
+		// is not the rectangle's source pitch, or target is attached memory whose
+		// pitch is not the rectangle's width, and OutOfBoundsException if target is
+		// too small for the rectangle.
+		CustomNativeEffects::CpuWorkerRegion GetCpuWorkerRegion(const CustomEffectCxBuffer& source, const CustomEffectCxBuffer& target, Lumia::Imaging::Workers::Cpu::CpuImageWorkerRectangle rectangle);
 	}
 
 }}}
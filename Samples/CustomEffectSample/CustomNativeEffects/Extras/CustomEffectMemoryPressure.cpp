@@ -0,0 +1,49 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+
+#include "pch.h"
+#include "CustomEffectMemoryPressure.h"
+#include "CustomEffectBufferPool.h"
+#include "ColorLutCache.h"
+#include "PixelShaderEffectsWithTexture\SplitToneLookupCache.h"
+#include "WorkerStatePool.h"
+#include <mutex>
+
+using namespace Lumia::Imaging::Extras::Detail;
+using namespace Platform;
+using namespace Windows::Foundation;
+using namespace Windows::System;
+
+void CustomEffectMemoryPressure::EnsureSubscribed()
+{
+	static std::once_flag subscribed;
+
+	std::call_once(subscribed, []
+	{
+		MemoryManager::AppMemoryUsageIncreased += ref new EventHandler<Object^>([](Object^, Object^)
+		{
+			const AppMemoryUsageLevel level = MemoryManager::AppMemoryUsageLevel;
+
+			if (level == AppMemoryUsageLevel::High || level == AppMemoryUsageLevel::OverLimit)
+			{
+				Trim();
+			}
+		});
+	});
+}
+
+void CustomEffectMemoryPressure::Trim()
+{
+	CustomNativeEffects::WorkerStatePoolBase::TrimAll();
+	CustomEffectBufferPool::GetInstance().Trim();
+	CustomNativeEffects::ColorLutCache::GetInstance().Clear();
+	CustomNativeEffects::SplitToneLookupCache::GetInstance().Clear();
+}
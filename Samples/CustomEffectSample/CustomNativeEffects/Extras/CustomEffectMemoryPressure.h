@@ -0,0 +1,34 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+
+#pragma once
+
+namespace Lumia { namespace Imaging { namespace Extras {
+
+	namespace Detail {
+
+		// Drops the idle memory the effects keep between renders, meaning pooled
+		// worker state, pooled pixel buffers, cached 3D lookup tables and cached
+		// split tone tables and bitmaps, once the app's memory usage level
+		// becomes high.
+		class CustomEffectMemoryPressure final
+		{
+		public:
+			// Subscribes to MemoryManager::AppMemoryUsageIncreased the first time
+			// it is called. Any later call does nothing.
+			static void EnsureSubscribed();
+
+			// Drops the idle memory right away.
+			static void Trim();
+		};
+	}
+
+}}}
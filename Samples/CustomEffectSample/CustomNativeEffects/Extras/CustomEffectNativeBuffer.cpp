@@ -0,0 +1,124 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+
+#include "pch.h"
+#include "CustomEffectNativeBuffer.h"
+#include "BufferPool.h"
+
+using namespace Lumia::Imaging::Extras::Detail;
+using namespace Microsoft::WRL;
+
+CustomEffectNativeBuffer::CustomEffectNativeBuffer() :
+	m_length(0),
+	m_returnToPool(false),
+	m_isReadOnly(false)
+{
+}
+
+CustomEffectNativeBuffer::~CustomEffectNativeBuffer()
+{
+	if (m_returnToPool)
+	{
+		CustomNativeEffects::BufferPool::GetInstance().Release(std::move(m_block));
+	}
+}
+
+Windows::Storage::Streams::IBuffer^ CustomEffectNativeBuffer::Create(CustomNativeEffects::AlignedBuffer&& block, bool returnToPool, bool isReadOnly)
+{
+	ComPtr<CustomEffectNativeBuffer> buffer = Make<CustomEffectNativeBuffer>();
+	if (!buffer)
+	{
+		__abi_ThrowIfFailed(E_OUTOFMEMORY);
+	}
+
+	buffer->m_length = block.IsExternal() ? block.GetCapacity() : 0;
+	buffer->m_block = std::move(block);
+	buffer->m_returnToPool = returnToPool;
+	buffer->m_isReadOnly = isReadOnly;
+
+	return reinterpret_cast<Windows::Storage::Streams::IBuffer^>(static_cast<ABI::Windows::Storage::Streams::IBuffer*>(buffer.Get()));
+}
+
+Windows::Storage::Streams::IBuffer^ CustomEffectNativeBuffer::CreatePooled(uint32 requiredLength)
+{
+	return Create(CustomNativeEffects::BufferPool::GetInstance().Acquire(requiredLength), true, false);
+}
+
+Windows::Storage::Streams::IBuffer^ CustomEffectNativeBuffer::CreateExternal(byte* externalData, uint32 capacity, std::function<void()> release)
+{
+	if (!externalData)
+	{
+		__abi_ThrowIfFailed(E_POINTER);
+	}
+
+	return Create(CustomNativeEffects::AlignedBuffer::Wrap(externalData, capacity, std::move(release)), false, false);
+}
+
+Windows::Storage::Streams::IBuffer^ CustomEffectNativeBuffer::CreateReadOnly(const byte* data, uint32 length)
+{
+	if (!data)
+	{
+		__abi_ThrowIfFailed(E_POINTER);
+	}
+
+	// AlignedBuffer and IBufferByteAccess only deal in byte*. Nothing in this
+	// class writes to the block, and Buffer's callers must not either.
+	return Create(CustomNativeEffects::AlignedBuffer::Wrap(const_cast<byte*>(data), length, nullptr), false, true);
+}
+
+IFACEMETHODIMP CustomEffectNativeBuffer::get_Capacity(UINT32* value)
+{
+	if (!value)
+	{
+		return E_POINTER;
+	}
+
+	*value = m_block.GetCapacity();
+	return S_OK;
+}
+
+IFACEMETHODIMP CustomEffectNativeBuffer::get_Length(UINT32* value)
+{
+	if (!value)
+	{
+		return E_POINTER;
+	}
+
+	*value = m_length;
+	return S_OK;
+}
+
+IFACEMETHODIMP CustomEffectNativeBuffer::put_Length(UINT32 value)
+{
+	if (m_isReadOnly && value != m_length)
+	{
+		return E_ACCESSDENIED;
+	}
+
+	if (value > m_block.GetCapacity())
+	{
+		return E_INVALIDARG;
+	}
+
+	m_length = value;
+	return S_OK;
+}
+
+IFACEMETHODIMP CustomEffectNativeBuffer::Buffer(byte** value)
+{
+	if (!value)
+	{
+		return E_POINTER;
+	}
+
+	*value = m_block.GetData();
+	return S_OK;
+}
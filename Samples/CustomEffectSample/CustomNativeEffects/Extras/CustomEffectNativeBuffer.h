@@ -0,0 +1,93 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+
+#pragma once
+
+#include <wrl.h>
+#include <robuffer.h>
+#include <windows.storage.streams.h>
+#include <functional>
+#include "AlignedBuffer.h"
+
+namespace Lumia { namespace Imaging { namespace Extras {
+
+	namespace Detail {
+
+		// IBuffer implementation over a CustomNativeEffects::AlignedBuffer.
+		//
+		// Windows::Storage::Streams::Buffer makes no promise about where its bytes
+		// start. Pooled buffers start on a 64-byte boundary and have 64 bytes of tail
+		// padding after Capacity that may be read and written freely, which lets SIMD
+		// kernels run full vectors past the last pixel. They go back to
+		// CustomNativeEffects::BufferPool once the last reference is released, so a
+		// buffer the renderer still holds is never handed to another worker.
+		//
+		// It can also wrap memory owned by the caller without copying it. The caller's
+		// release callback runs once the last reference to the buffer goes away, which
+		// may be after the worker that wrapped it has been destroyed.
+		//
+		// Read-only buffers wrap constant data such as embedded shader bytecode. Their
+		// Length always equals their Capacity and cannot be changed. IBufferByteAccess
+		// has no read-only form, so Buffer still returns a byte* to the constant data,
+		// which usually lives in read-only pages: writing through it is undefined
+		// behavior and typically an access violation.
+		class CustomEffectNativeBuffer final :
+			public Microsoft::WRL::RuntimeClass<
+				Microsoft::WRL::RuntimeClassFlags<Microsoft::WRL::WinRtClassicComMix>,
+				ABI::Windows::Storage::Streams::IBuffer,
+				Windows::Storage::Streams::IBufferByteAccess>
+		{
+			InspectableClass(L"Lumia.Imaging.Extras.Detail.CustomEffectNativeBuffer", BaseTrust)
+
+		public:
+			CustomEffectNativeBuffer();
+
+			virtual ~CustomEffectNativeBuffer();
+
+			// Returns a buffer from CustomNativeEffects::BufferPool whose Capacity is at
+			// least requiredLength.
+			static Windows::Storage::Streams::IBuffer^ CreatePooled(uint32 requiredLength);
+
+			// Wraps capacity bytes at externalData. The memory must stay valid until release is called.
+			static Windows::Storage::Streams::IBuffer^ CreateExternal(byte* externalData, uint32 capacity, std::function<void()> release);
+
+			// Wraps length bytes of constant data. The data must outlive every reference
+			// to the buffer. Only hand the buffer to consumers that never write through
+			// Buffer, such as the renderer reading a worker's PixelShader.
+			static Windows::Storage::Streams::IBuffer^ CreateReadOnly(const byte* data, uint32 length);
+
+#pragma region IBuffer implementation
+
+			IFACEMETHODIMP get_Capacity(UINT32* value) override;
+
+			IFACEMETHODIMP get_Length(UINT32* value) override;
+
+			IFACEMETHODIMP put_Length(UINT32 value) override;
+
+#pragma endregion
+
+#pragma region IBufferByteAccess implementation
+
+			IFACEMETHODIMP Buffer(byte** value) override;
+
+#pragma endregion
+
+		private:
+			static Windows::Storage::Streams::IBuffer^ Create(CustomNativeEffects::AlignedBuffer&& block, bool returnToPool, bool isReadOnly);
+
+			CustomNativeEffects::AlignedBuffer m_block;
+			UINT32 m_length;
+			bool m_returnToPool;
+			bool m_isReadOnly;
+		};
+	}
+
+}}}
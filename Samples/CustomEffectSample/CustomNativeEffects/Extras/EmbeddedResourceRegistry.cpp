@@ -0,0 +1,77 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+
+#include "pch.h"
+#include "EmbeddedResourceRegistry.h"
+#include "CustomEffectNativeBuffer.h"
+
+using namespace Lumia::Imaging::Extras::Detail;
+using namespace Windows::Storage::Streams;
+
+EmbeddedResourceRegistry& EmbeddedResourceRegistry::GetInstance()
+{
+	static EmbeddedResourceRegistry instance;
+	return instance;
+}
+
+EmbeddedResourceRegistry::EmbeddedResourceRegistry()
+{
+}
+
+IBuffer^ EmbeddedResourceRegistry::GetBuffer(const GUID& id, const byte* data, uint32 length)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (const Entry* entry = FindLocked(id))
+	{
+		if (entry->Data != data)
+		{
+			throw ref new Platform::InvalidArgumentException("data");
+		}
+
+		if (entry->Length != length)
+		{
+			throw ref new Platform::InvalidArgumentException("length");
+		}
+
+		return entry->Buffer;
+	}
+
+	Entry entry;
+	entry.Id = id;
+	entry.Data = data;
+	entry.Length = length;
+	entry.Buffer = CustomEffectNativeBuffer::CreateReadOnly(data, length);
+
+	m_entries.push_back(entry);
+	return entry.Buffer;
+}
+
+IBuffer^ EmbeddedResourceRegistry::FindBuffer(const GUID& id) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	const Entry* entry = FindLocked(id);
+	return entry ? entry->Buffer : nullptr;
+}
+
+const EmbeddedResourceRegistry::Entry* EmbeddedResourceRegistry::FindLocked(const GUID& id) const
+{
+	for (const Entry& entry : m_entries)
+	{
+		if (IsEqualGUID(entry.Id, id))
+		{
+			return &entry;
+		}
+	}
+
+	return nullptr;
+}
@@ -0,0 +1,64 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+namespace Lumia { namespace Imaging { namespace Extras {
+
+	namespace Detail {
+
+		// Process-wide, read-only IBuffer views of data compiled into the
+		// component, such as the shader bytecode arrays in the .hlsl.h headers.
+		//
+		// A view wraps the static array itself without copying it, so handing a
+		// shader to a worker costs the same regardless of the shader's size. Each
+		// view is created the first time its id is asked for and shared by every
+		// later caller.
+		class EmbeddedResourceRegistry final
+		{
+		public:
+			static EmbeddedResourceRegistry& GetInstance();
+
+			EmbeddedResourceRegistry(const EmbeddedResourceRegistry&) = delete;
+
+			EmbeddedResourceRegistry& operator=(const EmbeddedResourceRegistry&) = delete;
+
+			// Returns the view registered for id, creating it over length bytes at
+			// data on the first call. data must have static storage duration.
+			// Throws InvalidArgumentException if a view for id already exists over
+			// different data or a different length.
+			Windows::Storage::Streams::IBuffer^ GetBuffer(const GUID& id, const byte* data, uint32 length);
+
+			// Returns the view registered for id, or nullptr if there is none yet.
+			Windows::Storage::Streams::IBuffer^ FindBuffer(const GUID& id) const;
+
+		private:
+			struct Entry
+			{
+				GUID Id;
+				const byte* Data;
+				uint32 Length;
+				Windows::Storage::Streams::IBuffer^ Buffer;
+			};
+
+			EmbeddedResourceRegistry();
+
+			const Entry* FindLocked(const GUID& id) const;
+
+			mutable std::mutex m_mutex;
+			std::vector<Entry> m_entries;
+		};
+	}
+
+}}}
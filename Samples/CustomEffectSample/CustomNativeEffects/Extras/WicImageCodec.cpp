@@ -0,0 +1,114 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+
+#include "pch.h"
+#include "WicImageCodec.h"
+#include <mutex>
+
+using namespace Lumia::Imaging::Extras::Detail;
+using namespace Microsoft::WRL;
+using namespace Platform;
+using namespace Windows::Storage::Streams;
+
+static void ThrowIfFailed(HRESULT hr)
+{
+	__abi_ThrowIfFailed(hr);
+}
+
+IWICImagingFactory* WicImageCodec::GetFactory()
+{
+	static std::once_flag created;
+	static IWICImagingFactory* factory;
+
+	std::call_once(created, []
+	{
+		// Kept for the lifetime of the process.
+		ThrowIfFailed(CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&factory)));
+	});
+
+	return factory;
+}
+
+WicImageCodec::Reader::Reader(IRandomAccessStream^ stream) :
+	m_width(0),
+	m_height(0)
+{
+	IWICImagingFactory* factory = GetFactory();
+
+	ComPtr<IStream> sourceStream;
+	ComPtr<IWICBitmapDecoder> decoder;
+	ComPtr<IWICBitmapFrameDecode> frame;
+	ThrowIfFailed(CreateStreamOverRandomAccessStream(reinterpret_cast<IUnknown*>(stream), IID_PPV_ARGS(&sourceStream)));
+	ThrowIfFailed(factory->CreateDecoderFromStream(sourceStream.Get(), nullptr, WICDecodeMetadataCacheOnDemand, &decoder));
+	ThrowIfFailed(decoder->GetFrame(0, &frame));
+	ThrowIfFailed(WICConvertBitmapSource(GUID_WICPixelFormat32bppBGRA, frame.Get(), &m_bitmap));
+	ThrowIfFailed(m_bitmap->GetSize(&m_width, &m_height));
+
+	if (m_width > INT32_MAX || m_height > INT32_MAX)
+	{
+		throw ref new OutOfBoundsException("stream");
+	}
+}
+
+void WicImageCodec::Reader::ReadRows(uint32 firstRow, uint32 rowCount, uint32* pixels, uint32 pitch)
+{
+	const WICRect rect = { 0, static_cast<INT>(firstRow), static_cast<INT>(m_width), static_cast<INT>(rowCount) };
+	const UINT stride = pitch * sizeof(uint32);
+
+	ThrowIfFailed(m_bitmap->CopyPixels(&rect, stride, stride * rowCount, reinterpret_cast<BYTE*>(pixels)));
+}
+
+WicImageCodec::Writer::Writer(IRandomAccessStream^ stream, const GUID& encoderId, uint32 width, uint32 height) :
+	m_width(width),
+	m_isConverting(false)
+{
+	IWICImagingFactory* factory = GetFactory();
+
+	ComPtr<IWICComponentInfo> componentInfo;
+	ComPtr<IWICBitmapEncoderInfo> encoderInfo;
+	ThrowIfFailed(factory->CreateComponentInfo(encoderId, &componentInfo));
+	ThrowIfFailed(componentInfo.As(&encoderInfo));
+	ThrowIfFailed(encoderInfo->CreateInstance(&m_encoder));
+
+	ThrowIfFailed(CreateStreamOverRandomAccessStream(reinterpret_cast<IUnknown*>(stream), IID_PPV_ARGS(&m_stream)));
+	ThrowIfFailed(m_encoder->Initialize(m_stream.Get(), WICBitmapEncoderNoCache));
+	ThrowIfFailed(m_encoder->CreateNewFrame(&m_frame, nullptr));
+	ThrowIfFailed(m_frame->Initialize(nullptr));
+	ThrowIfFailed(m_frame->SetSize(width, height));
+
+	WICPixelFormatGUID format = GUID_WICPixelFormat32bppBGRA;
+	ThrowIfFailed(m_frame->SetPixelFormat(&format));
+	m_isConverting = format != GUID_WICPixelFormat32bppBGRA;
+}
+
+void WicImageCodec::Writer::WriteRows(uint32 rowCount, const uint32* pixels, uint32 pitch)
+{
+	const UINT stride = pitch * sizeof(uint32);
+	BYTE* data = reinterpret_cast<BYTE*>(const_cast<uint32*>(pixels));
+
+	if (!m_isConverting)
+	{
+		ThrowIfFailed(m_frame->WritePixels(rowCount, stride, stride * rowCount, data));
+		return;
+	}
+
+	// Successive WriteSource calls append rows, like WritePixels does.
+	ComPtr<IWICBitmap> rows;
+	ThrowIfFailed(GetFactory()->CreateBitmapFromMemory(m_width, rowCount, GUID_WICPixelFormat32bppBGRA, stride, stride * rowCount, data, &rows));
+	ThrowIfFailed(m_frame->WriteSource(rows.Get(), nullptr));
+}
+
+void WicImageCodec::Writer::Commit()
+{
+	ThrowIfFailed(m_frame->Commit());
+	ThrowIfFailed(m_encoder->Commit());
+	ThrowIfFailed(m_stream->Commit(STGC_DEFAULT));
+}
@@ -0,0 +1,78 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+
+#pragma once
+
+#include <wrl/client.h>
+
+namespace Lumia { namespace Imaging { namespace Extras {
+
+	namespace Detail {
+
+		// Decodes and encodes BGRA8888 images in streams with the Windows Imaging
+		// Component, a range of rows at a time, for renderers that bypass the
+		// imaging SDK's own codecs.
+		class WicImageCodec final
+		{
+		public:
+			// The first frame of the image in stream, converted to BGRA8888.
+			class Reader final
+			{
+			public:
+				explicit Reader(Windows::Storage::Streams::IRandomAccessStream^ stream);
+
+				uint32 GetWidth() const
+				{
+					return m_width;
+				}
+
+				uint32 GetHeight() const
+				{
+					return m_height;
+				}
+
+				// Copies rowCount rows starting at firstRow, pitch pixels apart.
+				void ReadRows(uint32 firstRow, uint32 rowCount, uint32* pixels, uint32 pitch);
+
+			private:
+				Microsoft::WRL::ComPtr<IWICBitmapSource> m_bitmap;
+				uint32 m_width;
+				uint32 m_height;
+			};
+
+			// A single frame image written into stream by the encoder with the class
+			// encoderId, as in Windows::Graphics::Imaging::BitmapEncoder. Rows must
+			// be written top to bottom, and are converted if the encoder does not
+			// take BGRA8888.
+			class Writer final
+			{
+			public:
+				Writer(Windows::Storage::Streams::IRandomAccessStream^ stream, const GUID& encoderId, uint32 width, uint32 height);
+
+				void WriteRows(uint32 rowCount, const uint32* pixels, uint32 pitch);
+
+				// Finishes the image once every row has been written.
+				void Commit();
+
+			private:
+				Microsoft::WRL::ComPtr<IStream> m_stream;
+				Microsoft::WRL::ComPtr<IWICBitmapEncoder> m_encoder;
+				Microsoft::WRL::ComPtr<IWICBitmapFrameEncode> m_frame;
+				uint32 m_width;
+				bool m_isConverting;
+			};
+
+			// The process-wide factory. WIC factories are free-threaded.
+			static IWICImagingFactory* GetFactory();
+		};
+	}
+
+}}}
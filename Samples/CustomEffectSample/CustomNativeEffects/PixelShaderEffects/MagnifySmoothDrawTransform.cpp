@@ -0,0 +1,102 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "pch.h"
+#include "MagnifySmoothDrawTransform.h"
+
+using namespace CustomNativeEffects;
+
+MagnifySmoothDrawTransform::MagnifySmoothDrawTransform(const GUID& shaderId) :
+	m_shaderId(shaderId),
+	m_parameters(),
+	m_inputRect()
+{
+}
+
+HRESULT MagnifySmoothDrawTransform::SetParameters(const MagnifySmoothMath::Parameters& parameters)
+{
+	if (!m_parameters.Update(parameters) || !m_drawInfo)
+	{
+		return S_OK;
+	}
+
+	return m_parameters.Upload(*m_drawInfo.Get());
+}
+
+IFACEMETHODIMP_(UINT32) MagnifySmoothDrawTransform::GetInputCount() const
+{
+	return 1;
+}
+
+IFACEMETHODIMP MagnifySmoothDrawTransform::MapOutputRectToInputRects(const D2D1_RECT_L* outputRect, D2D1_RECT_L* inputRects, UINT32 inputRectsCount) const
+{
+	UNREFERENCED_PARAMETER(outputRect);
+
+	if (inputRectsCount != 1)
+	{
+		return E_INVALIDARG;
+	}
+
+	inputRects[0] = m_inputRect;
+	return S_OK;
+}
+
+IFACEMETHODIMP MagnifySmoothDrawTransform::MapInputRectsToOutputRect(const D2D1_RECT_L* inputRects, const D2D1_RECT_L* inputOpaqueSubRects, UINT32 inputRectCount, D2D1_RECT_L* outputRect, D2D1_RECT_L* outputOpaqueSubRect)
+{
+	UNREFERENCED_PARAMETER(inputOpaqueSubRects);
+
+	if (inputRectCount != 1)
+	{
+		return E_INVALIDARG;
+	}
+
+	m_inputRect = inputRects[0];
+
+	*outputRect = GetInfluenceRect();
+	*outputOpaqueSubRect = D2D1::RectL(0, 0, 0, 0);
+	return S_OK;
+}
+
+IFACEMETHODIMP MagnifySmoothDrawTransform::MapInvalidRect(UINT32 inputIndex, D2D1_RECT_L invalidInputRect, D2D1_RECT_L* invalidOutputRect) const
+{
+	UNREFERENCED_PARAMETER(invalidInputRect);
+
+	if (inputIndex != 0)
+	{
+		return E_INVALIDARG;
+	}
+
+	// Any input pixel may be magnified anywhere inside the ellipse.
+	*invalidOutputRect = GetInfluenceRect();
+	return S_OK;
+}
+
+IFACEMETHODIMP MagnifySmoothDrawTransform::SetDrawInfo(ID2D1DrawInfo* drawInfo)
+{
+	m_drawInfo = drawInfo;
+
+	HRESULT hr = m_drawInfo->SetPixelShader(m_shaderId, D2D1_PIXEL_OPTIONS_NONE);
+
+	if (SUCCEEDED(hr))
+	{
+		m_parameters.Invalidate();
+		hr = m_parameters.Upload(*m_drawInfo.Get());
+	}
+
+	return hr;
+}
+
+D2D1_RECT_L MagnifySmoothDrawTransform::GetInfluenceRect() const
+{
+	const MagnifySmoothMath::PixelRect inputRect = { m_inputRect.left, m_inputRect.top, m_inputRect.right, m_inputRect.bottom };
+	const MagnifySmoothMath::PixelRect rect = MagnifySmoothMath::GetInfluenceRect(m_parameters.GetValue(), inputRect);
+
+	return D2D1::RectL(rect.Left, rect.Top, rect.Right, rect.Bottom);
+}
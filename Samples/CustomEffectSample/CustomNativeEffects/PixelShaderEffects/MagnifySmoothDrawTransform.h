@@ -0,0 +1,55 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include "MagnifySmoothMath.h"
+#include "ParameterCache.h"
+
+namespace CustomNativeEffects {
+
+	// Draw transform running MagnifySmooth.hlsl over the influence ellipse only.
+	//
+	// The output rectangle is the bounding box of the ellipse, so Direct2D does
+	// not shade the rest of the image; MagnifySmoothEffectDirect2DWorker blends
+	// the result over the unchanged input. The shader normalizes positions to
+	// the whole input, which is therefore what every output rectangle maps to.
+	class MagnifySmoothDrawTransform final : public Microsoft::WRL::RuntimeClass<Microsoft::WRL::RuntimeClassFlags<Microsoft::WRL::ClassicCom>, ID2D1DrawTransform>
+	{
+	public:
+		explicit MagnifySmoothDrawTransform(const GUID& shaderId);
+
+		// Updates the shader constants and the rectangles derived from them. The
+		// constant buffer is only uploaded when the parameters differ from the
+		// ones last uploaded.
+		HRESULT SetParameters(const MagnifySmoothMath::Parameters& parameters);
+
+		// ID2D1TransformNode
+		IFACEMETHODIMP_(UINT32) GetInputCount() const override;
+
+		// ID2D1Transform
+		IFACEMETHODIMP MapOutputRectToInputRects(const D2D1_RECT_L* outputRect, D2D1_RECT_L* inputRects, UINT32 inputRectsCount) const override;
+		IFACEMETHODIMP MapInputRectsToOutputRect(const D2D1_RECT_L* inputRects, const D2D1_RECT_L* inputOpaqueSubRects, UINT32 inputRectCount, D2D1_RECT_L* outputRect, D2D1_RECT_L* outputOpaqueSubRect) override;
+		IFACEMETHODIMP MapInvalidRect(UINT32 inputIndex, D2D1_RECT_L invalidInputRect, D2D1_RECT_L* invalidOutputRect) const override;
+
+		// ID2D1DrawTransform
+		IFACEMETHODIMP SetDrawInfo(ID2D1DrawInfo* drawInfo) override;
+
+	private:
+		// Pixels of the input rectangle inside the influence ellipse's bounding
+		// box, or the whole input rectangle if the parameters do not bound it.
+		D2D1_RECT_L GetInfluenceRect() const;
+
+		GUID m_shaderId;
+		ParameterCache<MagnifySmoothMath::Parameters> m_parameters;
+		D2D1_RECT_L m_inputRect;
+		Microsoft::WRL::ComPtr<ID2D1DrawInfo> m_drawInfo;
+	};
+}
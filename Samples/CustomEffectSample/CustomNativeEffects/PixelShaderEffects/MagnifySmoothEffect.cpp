@@ -10,6 +10,7 @@
 //*********************************************************
 #include "pch.h"
 #include "MagnifySmoothEffect.h"
+#include "MagnifySmoothEffectCpuWorker.h"
 #include "MagnifySmoothEffectDirect2DWorker.h"
 
 using namespace Concurrency;
@@ -30,68 +31,67 @@ MagnifySmoothEffect::MagnifySmoothEffect()
 
 double MagnifySmoothEffect::OuterRadius::get()
 {
-	return m_properties.m_outerRadius;
+	return m_properties.Get().m_outerRadius;
 }
 
 void MagnifySmoothEffect::OuterRadius::set(double value)
 {
-	critical_section::scoped_lock lock(m_criticalSection);
-	m_properties.m_outerRadius = value;
+	m_properties.Modify([value](Properties& properties) { properties.m_outerRadius = value; });
 }
 
 double MagnifySmoothEffect::InnerRadius::get()
 {
-	return m_properties.m_innerRadius;
+	return m_properties.Get().m_innerRadius;
 }
 
 void MagnifySmoothEffect::InnerRadius::set(double value)
 {
-	critical_section::scoped_lock lock(m_criticalSection);
-	m_properties.m_innerRadius = value;
+	m_properties.Modify([value](Properties& properties) { properties.m_innerRadius = value; });
 }
 
 double MagnifySmoothEffect::MagnificationAmount::get()
 {
-	return m_properties.m_magnificationAmount;
+	return m_properties.Get().m_magnificationAmount;
 }
 
 void MagnifySmoothEffect::MagnificationAmount::set(double value)
 {
-	critical_section::scoped_lock lock(m_criticalSection);
-	m_properties.m_magnificationAmount = value;
+	m_properties.Modify([value](Properties& properties) { properties.m_magnificationAmount = value; });
 }
 
 double MagnifySmoothEffect::HorizontalPosition::get()
 {
-	return m_properties.m_horizontalPosition;
+	return m_properties.Get().m_horizontalPosition;
 }
 
 void MagnifySmoothEffect::HorizontalPosition::set(double value)
 {
-	critical_section::scoped_lock lock(m_criticalSection);
-	m_properties.m_horizontalPosition = value;
+	m_properties.Modify([value](Properties& properties) { properties.m_horizontalPosition = value; });
 }
 
 double MagnifySmoothEffect::VerticalPosition::get()
 {
-	return m_properties.m_verticalPosition;
+	return m_properties.Get().m_verticalPosition;
 }
 
 void MagnifySmoothEffect::VerticalPosition::set(double value)
 {
-	critical_section::scoped_lock lock(m_criticalSection);
-	m_properties.m_verticalPosition = value;
+	m_properties.Modify([value](Properties& properties) { properties.m_verticalPosition = value; });
 }
 
 double MagnifySmoothEffect::AspectRatio::get()
 {
-	return m_properties.m_aspectRatio;
+	return m_properties.Get().m_aspectRatio;
 }
 
 void MagnifySmoothEffect::AspectRatio::set(double value)
 {
-	critical_section::scoped_lock lock(m_criticalSection);
-	m_properties.m_aspectRatio = value;
+	m_properties.Modify([value](Properties& properties) { properties.m_aspectRatio = value; });
+}
+
+VersionedProperties<MagnifySmoothEffect::Properties>::Snapshot MagnifySmoothEffect::GetProperties()
+{
+	return m_properties.Read();
 }
 
 IImageProvider2^ MagnifySmoothEffect::Clone()
@@ -104,14 +104,14 @@ IImageProvider2^ MagnifySmoothEffect::Clone()
 	}
 
 	auto clone = ref new MagnifySmoothEffect();
-	clone->m_properties = m_properties;
+	clone->m_properties.Set(m_properties.Get());
 	clone->m_source = m_source->Clone();
 	return clone;
 }
 
 RenderOptions MagnifySmoothEffect::SupportedRenderOptions::get()
 {
-	return RenderOptions::Gpu;
+	return RenderOptions::Cpu | RenderOptions::Gpu;
 }
 
 Workers::IImageWorker^ MagnifySmoothEffect::CreateImageWorker(Workers::IImageWorkerRequest^ imageWorkerRequest)
@@ -120,6 +120,8 @@ Workers::IImageWorker^ MagnifySmoothEffect::CreateImageWorker(Workers::IImageWor
 
 	switch (imageWorkerRequest->RenderOptions)
 	{
+	case RenderOptions::Cpu:
+		return ref new MagnifySmoothEffectCpuWorker(this);
 	case RenderOptions::Gpu:
 		return ref new MagnifySmoothEffectDirect2DWorker(this);
 	default:
@@ -10,6 +10,8 @@
 //*********************************************************
 #pragma once
 
+#include "VersionedProperties.h"
+
 #pragma warning(push)
 #pragma warning(disable: 4973)
 
@@ -131,10 +133,16 @@ namespace CustomNativeEffects {
 
 #pragma endregion
 
+	internal:
+		// All properties as one consistent snapshot, read without a lock. The
+		// version changes whenever a property is set, so workers can skip
+		// updating their parameters when it is the one they last saw.
+		VersionedProperties<Properties>::Snapshot GetProperties();
+
 	private:
 		concurrency::critical_section m_criticalSection;
 		IImageProvider2^ m_source;
-		Properties m_properties;
+		VersionedProperties<Properties> m_properties;
 	};
 }
 
@@ -0,0 +1,133 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "pch.h"
+#include "MagnifySmoothEffectCpuWorker.h"
+#include "Extras\CustomEffectMemoryPressure.h"
+
+using namespace Lumia::Imaging;
+using namespace Lumia::Imaging::Workers::Cpu;
+using namespace Platform;
+using namespace CustomNativeEffects;
+using namespace Windows::Storage::Streams;
+
+MagnifySmoothEffectCpuWorker::MagnifySmoothEffectCpuWorker(MagnifySmoothEffect^ configuration) :
+	m_configuration(configuration),
+	m_state(GetStatePool().Acquire()),
+	m_sourceBuffer(m_state->SourceBuffer),
+	m_targetBuffer(m_state->TargetBuffer),
+	m_parameters(),
+	m_propertiesVersion(0),
+	m_renderRow(MagnifySmoothKernel::GetRowFunction()),
+	m_bandOptions(RowBands::GetDefaultOptions()),
+	m_imageProcessed(false)
+{
+}
+
+MagnifySmoothEffectCpuWorker::~MagnifySmoothEffectCpuWorker()
+{
+	// The renderer releases the worker once the render has completed.
+	GetStatePool().Release(std::move(m_state));
+}
+
+WorkerStatePool<MagnifySmoothEffectCpuWorker::State>& MagnifySmoothEffectCpuWorker::GetStatePool()
+{
+	static WorkerStatePool<State>* pool = new WorkerStatePool<State>();
+	Extras::Detail::CustomEffectMemoryPressure::EnsureSubscribed();
+	return *pool;
+}
+
+void MagnifySmoothEffectCpuWorker::Prepare(CpuImageWorkerParameters parameters)
+{
+	m_sourceBuffer.EnsureCapacity(parameters.SourceBufferLength);
+	m_targetBuffer.EnsureCapacity(parameters.TargetBufferLength);
+	m_imageProcessed = false;
+
+	UpdateParameters();
+}
+
+void MagnifySmoothEffectCpuWorker::Process(CpuImageWorkerRectangle rectangle)
+{
+	// A rectangle that is only part of the image would be magnified around
+	// its own center.
+	if (m_imageProcessed || rectangle.SourceStartIndex != 0)
+	{
+		throw ref new InvalidArgumentException("rectangle");
+	}
+
+	m_imageProcessed = true;
+
+	const CpuWorkerRegion region = Extras::Detail::GetCpuWorkerRegion(m_sourceBuffer, m_targetBuffer, rectangle);
+
+	if (region.Width <= 0 || region.Height <= 0)
+	{
+		return;
+	}
+
+	// Every band samples from the whole image, not just its own rows.
+	const MagnifySmoothKernel::SourceImage source = { region.SourcePixels, region.SourcePitch, region.Width, region.Height, 0 };
+
+	const uint32_t* firstTargetRow = region.TargetPixels;
+	const int32_t targetPitch = region.TargetPitch;
+	const MagnifySmoothMath::Parameters parameters = m_parameters;
+	auto renderRow = m_renderRow;
+
+	RowBands::ForEach(region, m_bandOptions, [source, firstTargetRow, targetPitch, parameters, renderRow](const CpuWorkerRegion& band)
+	{
+		const int32_t firstRow = static_cast<int32_t>((band.TargetPixels - firstTargetRow) / targetPitch);
+		MagnifySmoothKernel::RenderRegion(band, firstRow, parameters, source, renderRow);
+	});
+}
+
+void MagnifySmoothEffectCpuWorker::UpdateParameters()
+{
+	auto snapshot = m_configuration->GetProperties();
+
+	if (snapshot.Version == m_propertiesVersion)
+	{
+		return;
+	}
+
+	const MagnifySmoothEffect::Properties& properties = snapshot.Value;
+
+	m_parameters.InnerRadius = static_cast<float>(properties.m_innerRadius);
+	m_parameters.OuterRadius = static_cast<float>(properties.m_outerRadius);
+	m_parameters.MagnificationAmount = static_cast<float>(properties.m_magnificationAmount);
+	m_parameters.HorizontalPosition = static_cast<float>(properties.m_horizontalPosition);
+	m_parameters.VerticalPosition = static_cast<float>(properties.m_verticalPosition);
+	m_parameters.AspectRatio = static_cast<float>(properties.m_aspectRatio);
+	m_propertiesVersion = snapshot.Version;
+}
+
+void MagnifySmoothEffectCpuWorker::Configuration::set(IImageProvider^ value)
+{
+	m_configuration = safe_cast<MagnifySmoothEffect^>(value);
+	m_propertiesVersion = 0;
+}
+
+IImageProvider^ MagnifySmoothEffectCpuWorker::Configuration::get()
+{
+	return m_configuration;
+}
+
+IBuffer^ MagnifySmoothEffectCpuWorker::SourceBuffer::get()
+{
+	return m_sourceBuffer.GetBuffer();
+}
+
+IBuffer^ MagnifySmoothEffectCpuWorker::TargetBuffer::get()
+{
+	return m_targetBuffer.GetBuffer();
+}
+
+ColorMode MagnifySmoothEffectCpuWorker::ColorMode::get()
+{
+	return Lumia::Imaging::ColorMode::Bgra8888;
+}
@@ -0,0 +1,95 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include "MagnifySmoothEffect.h"
+#include <memory>
+#include "Extras\CustomEffectCxBuffer.h"
+#include "MagnifySmoothKernel.h"
+#include "RowBands.h"
+#include "WorkerStatePool.h"
+
+namespace CustomNativeEffects {
+
+	namespace {
+		namespace LI = Lumia::Imaging;
+		namespace LIWC = Lumia::Imaging::Workers::Cpu;
+		namespace WSS = Windows::Storage::Streams;
+	}
+
+	// Renders MagnifySmoothEffect without a GPU. Positions and radii are
+	// normalized to the image, so the renderer has to pass the whole image to
+	// Process as one rectangle: Process throws InvalidArgumentException for a
+	// rectangle that does not start at the first source pixel, or for a second
+	// rectangle after Prepare. The image is sampled as a whole while the target
+	// rows are split into parallel bands. Only pixels inside the influence
+	// ellipse are resampled; the rest are copied.
+	ref class MagnifySmoothEffectCpuWorker sealed : LIWC::ICpuImageWorker
+	{
+	internal:
+		MagnifySmoothEffectCpuWorker(MagnifySmoothEffect^ configuration);
+
+	public:
+		virtual ~MagnifySmoothEffectCpuWorker();
+
+#pragma region ICpuImageWorker implementation
+
+		virtual void Prepare(LIWC::CpuImageWorkerParameters parameters);
+
+		virtual void Process(LIWC::CpuImageWorkerRectangle rectangle);
+
+		virtual property LI::ColorMode ColorMode
+		{
+			LI::ColorMode get();
+		}
+
+		virtual property WSS::IBuffer^ SourceBuffer
+		{
+			WSS::IBuffer^ get();
+		}
+
+		virtual property WSS::IBuffer^ TargetBuffer
+		{
+			WSS::IBuffer^ get();
+		}
+
+		virtual property LI::IImageProvider^ Configuration
+		{
+			LI::IImageProvider^ get();
+			void set(LI::IImageProvider^ value);
+		}
+
+#pragma endregion
+
+	private:
+		// Kept in a WorkerStatePool between renders so that the next worker
+		// starts with buffers that have already grown to the image size.
+		struct State
+		{
+			LI::Extras::Detail::CustomEffectCxBuffer SourceBuffer;
+			LI::Extras::Detail::CustomEffectCxBuffer TargetBuffer;
+		};
+
+		static WorkerStatePool<State>& GetStatePool();
+
+		void UpdateParameters();
+
+		MagnifySmoothEffect^ m_configuration;
+		std::unique_ptr<State> m_state;
+		LI::Extras::Detail::CustomEffectCxBuffer& m_sourceBuffer;
+		LI::Extras::Detail::CustomEffectCxBuffer& m_targetBuffer;
+		MagnifySmoothMath::Parameters m_parameters;
+		uint64_t m_propertiesVersion;
+		MagnifySmoothKernel::RowFunction m_renderRow;
+		RowBands::Options m_bandOptions;
+		bool m_imageProcessed;
+	};
+}
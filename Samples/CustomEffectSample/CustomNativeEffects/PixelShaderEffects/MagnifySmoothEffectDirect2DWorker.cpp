@@ -34,6 +34,7 @@ static void ThrowIfFailed(HRESULT hr)
 }
 
 MagnifySmoothEffectDirect2DWorker::MagnifySmoothEffectDirect2DWorker(MagnifySmoothEffect^ configuration) :
+	m_propertiesVersion(0),
 	m_configuration(configuration)
 {
 
@@ -44,45 +45,68 @@ void MagnifySmoothEffectDirect2DWorker::Initialize(Platform::IntPtr effectContex
 	m_effectContext = reinterpret_cast<ID2D1EffectContext*>(static_cast<void*>(effectContextUnk));
 	m_transformGraph = reinterpret_cast<ID2D1TransformGraph*>(static_cast<void*>(transformGraphUnk));
 
-	ThrowIfFailed(
-		m_effectContext->LoadPixelShader(GUID_MagnifySmoothShader, g_D2D_ENTRY, ARRAYSIZE(g_D2D_ENTRY))
-		);
+	// Every worker on the same device shares the loaded shader.
+	if (!m_effectContext->IsShaderLoaded(GUID_MagnifySmoothShader))
+	{
+		ThrowIfFailed(
+			m_effectContext->LoadPixelShader(GUID_MagnifySmoothShader, g_D2D_ENTRY, ARRAYSIZE(g_D2D_ENTRY))
+			);
+	}
 
-	m_shaderDrawTransform = Direct2DShaderDrawTransformFactory::CreateShaderDrawTransform(1, GUID_MagnifySmoothShader, Direct2DPixelOptions::TrivialSampling);
+	m_drawTransform = Make<MagnifySmoothDrawTransform>(GUID_MagnifySmoothShader);
+
+	if (!m_drawTransform)
+	{
+		throw ref new OutOfMemoryException();
+	}
 
-	// IShaderDrawTransform implements the COM interface ID2D1TransformNode. 
-	// Set it up as the only transform node in the transform graph.
-	ComPtr<IUnknown> shaderDrawTransformUnknown = reinterpret_cast<IUnknown*>(m_shaderDrawTransform);
+	// The shader only covers the influence ellipse. Its output replaces the
+	// input there, and the input passes through unchanged everywhere else.
+	D2D1_BLEND_DESCRIPTION replace =
+	{
+		D2D1_BLEND_ONE, D2D1_BLEND_ZERO, D2D1_BLEND_OPERATION_ADD,
+		D2D1_BLEND_ONE, D2D1_BLEND_ZERO, D2D1_BLEND_OPERATION_ADD,
+		{ 1.0f, 1.0f, 1.0f, 1.0f }
+	};
 
 	ThrowIfFailed(
-		shaderDrawTransformUnknown.As(&m_shaderDrawTransformNode)
+		m_effectContext->CreateBlendTransform(2, &replace, &m_blendTransform)
 		);
 
-	m_transformGraph->SetSingleTransformNode(m_shaderDrawTransformNode.Get());
+	ThrowIfFailed(m_transformGraph->AddNode(m_blendTransform.Get()));
+	ThrowIfFailed(m_transformGraph->AddNode(m_drawTransform.Get()));
+	ThrowIfFailed(m_transformGraph->ConnectToEffectInput(0, m_blendTransform.Get(), 0));
+	ThrowIfFailed(m_transformGraph->ConnectToEffectInput(0, m_drawTransform.Get(), 0));
+	ThrowIfFailed(m_transformGraph->ConnectNode(m_drawTransform.Get(), m_blendTransform.Get(), 1));
+	ThrowIfFailed(m_transformGraph->SetOutputNode(m_blendTransform.Get()));
 }
 
 void MagnifySmoothEffectDirect2DWorker::PrepareForRender(uint32 changeType)
 {
-	if (changeType == D2D1_CHANGE_TYPE_NONE)
+	UNREFERENCED_PARAMETER(changeType);
+
+	// The draw transform keeps its parameters across graph and context
+	// changes, so only a new property version needs to reach it, and it
+	// uploads them only if they differ from the last ones.
+	auto snapshot = m_configuration->GetProperties();
+
+	if (snapshot.Version == m_propertiesVersion)
 	{
 		return;
 	}
 
-	m_constantBuffer.AspectRatio = safe_cast<float>(m_configuration->AspectRatio);
-	m_constantBuffer.HorizontalPosition = safe_cast<float>(m_configuration->HorizontalPosition);
-	m_constantBuffer.InnerRadius = safe_cast<float>(m_configuration->InnerRadius);
-	m_constantBuffer.MagnificationAmount = safe_cast<float>(m_configuration->MagnificationAmount);
-	m_constantBuffer.OuterRadius = safe_cast<float>(m_configuration->OuterRadius);
-	m_constantBuffer.VerticalPosition = safe_cast<float>(m_configuration->VerticalPosition);
-
+	const MagnifySmoothEffect::Properties& properties = snapshot.Value;
 
-	ComPtr<ID2D1DrawInfo> d2dDrawInfo;
-
-	ThrowIfFailed(
-		reinterpret_cast<IInspectable*>(m_shaderDrawTransform->DrawInfo)->QueryInterface(IID_PPV_ARGS(&d2dDrawInfo))
-		);
+	MagnifySmoothMath::Parameters constantBuffer;
+	constantBuffer.AspectRatio = static_cast<float>(properties.m_aspectRatio);
+	constantBuffer.HorizontalPosition = static_cast<float>(properties.m_horizontalPosition);
+	constantBuffer.InnerRadius = static_cast<float>(properties.m_innerRadius);
+	constantBuffer.MagnificationAmount = static_cast<float>(properties.m_magnificationAmount);
+	constantBuffer.OuterRadius = static_cast<float>(properties.m_outerRadius);
+	constantBuffer.VerticalPosition = static_cast<float>(properties.m_verticalPosition);
 
-	d2dDrawInfo->SetPixelShaderConstantBuffer(reinterpret_cast<const BYTE*>(&m_constantBuffer), sizeof(m_constantBuffer));
+	ThrowIfFailed(m_drawTransform->SetParameters(constantBuffer));
+	m_propertiesVersion = snapshot.Version;
 }
 
 void MagnifySmoothEffectDirect2DWorker::SetGraph(Platform::IntPtr transformGraphUnk)
@@ -99,6 +123,7 @@ uint32 MagnifySmoothEffectDirect2DWorker::InputCount::get()
 void MagnifySmoothEffectDirect2DWorker::Configuration::set(IImageProvider^ configuration)
 {
 	m_configuration = safe_cast<MagnifySmoothEffect^>(configuration);
+	m_propertiesVersion = 0;
 }
 
 IImageProvider^ MagnifySmoothEffectDirect2DWorker::Configuration::get()
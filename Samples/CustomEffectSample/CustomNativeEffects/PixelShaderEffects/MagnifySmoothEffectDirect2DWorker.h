@@ -11,6 +11,8 @@
 #pragma once
 
 #include "MagnifySmoothEffect.h"
+#include "MagnifySmoothDrawTransform.h"
+#include "MagnifySmoothMath.h"
 
 namespace CustomNativeEffects {
 
@@ -65,23 +67,13 @@ namespace CustomNativeEffects {
 #pragma endregion
 
 	private:
-		struct
-		{
-			float InnerRadius;
-			float OuterRadius;
-			float MagnificationAmount;
-			float HorizontalPosition;
-			float VerticalPosition;
-			float AspectRatio;		
-
-		} m_constantBuffer;
+		uint64_t m_propertiesVersion;
 
 		MagnifySmoothEffect^ m_configuration;
 		MW::ComPtr<ID2D1EffectContext> m_effectContext;
 		MW::ComPtr<ID2D1TransformGraph> m_transformGraph;
-		LIWD::IDirect2DShaderDrawTransform^ m_shaderDrawTransform;
-		MW::ComPtr<ID2D1TransformNode> m_shaderDrawTransformNode;
-	
+		MW::ComPtr<MagnifySmoothDrawTransform> m_drawTransform;
+		MW::ComPtr<ID2D1BlendTransform> m_blendTransform;
 	};
 }
 
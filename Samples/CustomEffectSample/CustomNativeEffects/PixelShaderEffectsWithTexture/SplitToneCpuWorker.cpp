@@ -0,0 +1,114 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "pch.h"
+#include "SplitToneCpuWorker.h"
+#include "Extras\CustomEffectMemoryPressure.h"
+#include "SplitToneLookupCache.h"
+
+using namespace Lumia::Imaging;
+using namespace Lumia::Imaging::Workers::Cpu;
+using namespace Platform;
+using namespace CustomNativeEffects;
+using namespace Windows::Storage::Streams;
+
+SplitToneCpuWorker::SplitToneCpuWorker(SplitToneEffect^ configuration) :
+	m_configuration(configuration),
+	m_state(GetStatePool().Acquire()),
+	m_sourceBuffer(m_state->SourceBuffer),
+	m_targetBuffer(m_state->TargetBuffer),
+	m_propertiesVersion(0),
+	m_applyRow(SplitToneKernel::GetRowFunction()),
+	m_bandOptions(RowBands::GetDefaultOptions())
+{
+}
+
+SplitToneCpuWorker::~SplitToneCpuWorker()
+{
+	// The renderer releases the worker once the render has completed.
+	GetStatePool().Release(std::move(m_state));
+}
+
+WorkerStatePool<SplitToneCpuWorker::State>& SplitToneCpuWorker::GetStatePool()
+{
+	static WorkerStatePool<State>* pool = new WorkerStatePool<State>();
+	Extras::Detail::CustomEffectMemoryPressure::EnsureSubscribed();
+	return *pool;
+}
+
+void SplitToneCpuWorker::Prepare(CpuImageWorkerParameters parameters)
+{
+	m_sourceBuffer.EnsureCapacity(parameters.SourceBufferLength);
+	m_targetBuffer.EnsureCapacity(parameters.TargetBufferLength);
+
+	SetupAdjustments();
+}
+
+void SplitToneCpuWorker::Process(CpuImageWorkerRectangle rectangle)
+{
+	const CpuWorkerRegion region = Extras::Detail::GetCpuWorkerRegion(m_sourceBuffer, m_targetBuffer, rectangle);
+
+	const SplitToneKernel::Adjustments* adjustments = &m_state->Adjustments;
+	auto applyRow = m_applyRow;
+
+	RowBands::ForEach(region, m_bandOptions, [adjustments, applyRow](const CpuWorkerRegion& band)
+	{
+		SplitToneKernel::ApplyRegion(band, *adjustments, applyRow);
+	});
+}
+
+void SplitToneCpuWorker::SetupAdjustments()
+{
+	auto snapshot = m_configuration->GetProperties();
+
+	if (snapshot.Version == m_propertiesVersion)
+		return;
+
+	const SplitToneEffect::Properties& properties = snapshot.Value;
+	const SplitToneEffect::Properties& adjusted = m_state->AdjustedProperties;
+
+	if (!m_state->HasAdjustments ||
+		properties.m_highHue != adjusted.m_highHue || properties.m_highShift != adjusted.m_highShift ||
+		properties.m_lowHue != adjusted.m_lowHue || properties.m_lowShift != adjusted.m_lowShift)
+	{
+		auto lookupTable = SplitToneLookupCache::GetInstance().GetLookupTable(properties.m_highHue, properties.m_highShift, properties.m_lowHue, properties.m_lowShift);
+		SplitToneKernel::BuildAdjustments(*lookupTable, m_state->Adjustments);
+		m_state->AdjustedProperties = properties;
+		m_state->HasAdjustments = true;
+	}
+
+	m_propertiesVersion = snapshot.Version;
+}
+
+void SplitToneCpuWorker::Configuration::set(IImageProvider^ value)
+{
+	m_configuration = safe_cast<SplitToneEffect^>(value);
+	m_propertiesVersion = 0;
+}
+
+IImageProvider^ SplitToneCpuWorker::Configuration::get()
+{
+	return m_configuration;
+}
+
+IBuffer^ SplitToneCpuWorker::SourceBuffer::get()
+{
+	return m_sourceBuffer.GetBuffer();
+}
+
+IBuffer^ SplitToneCpuWorker::TargetBuffer::get()
+{
+	return m_targetBuffer.GetBuffer();
+}
+
+ColorMode SplitToneCpuWorker::ColorMode::get()
+{
+	return Lumia::Imaging::ColorMode::Bgra8888;
+}
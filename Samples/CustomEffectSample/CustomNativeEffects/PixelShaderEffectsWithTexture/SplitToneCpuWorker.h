@@ -0,0 +1,98 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include "SplitToneEffect.h"
+#include <memory>
+#include "Extras\CustomEffectCxBuffer.h"
+#include "RowBands.h"
+#include "SplitToneKernel.h"
+#include "WorkerStatePool.h"
+
+namespace CustomNativeEffects {
+
+	namespace {
+		namespace LI = Lumia::Imaging;
+		namespace LIWC = Lumia::Imaging::Workers::Cpu;
+		namespace WSS = Windows::Storage::Streams;
+	}
+
+	// Renders SplitToneEffect without a GPU. The lookup table is the one the
+	// Direct2D worker uploads, taken from SplitToneLookupCache; see
+	// SplitToneKernel.h for how the result compares with the pixel shader.
+	ref class SplitToneCpuWorker sealed : LIWC::ICpuImageWorker
+	{
+	internal:
+		SplitToneCpuWorker(SplitToneEffect^ configuration);
+
+	public:
+		virtual ~SplitToneCpuWorker();
+
+#pragma region ICpuImageWorker implementation
+
+		virtual void Prepare(LIWC::CpuImageWorkerParameters parameters);
+
+		virtual void Process(LIWC::CpuImageWorkerRectangle rectangle);
+
+		virtual property LI::ColorMode ColorMode
+		{
+			LI::ColorMode get();
+		}
+
+		virtual property WSS::IBuffer^ SourceBuffer
+		{
+			WSS::IBuffer^ get();
+		}
+
+		virtual property WSS::IBuffer^ TargetBuffer
+		{
+			WSS::IBuffer^ get();
+		}
+
+		virtual property LI::IImageProvider^ Configuration
+		{
+			LI::IImageProvider^ get();
+			void set(LI::IImageProvider^ value);
+		}
+
+#pragma endregion
+
+	private:
+		// Kept in a WorkerStatePool between renders, together with the
+		// properties the adjustments were built for, so that the next worker
+		// rendering the same split tone reuses them.
+		struct State
+		{
+			State() :
+				HasAdjustments(false)
+			{
+			}
+
+			LI::Extras::Detail::CustomEffectCxBuffer SourceBuffer;
+			LI::Extras::Detail::CustomEffectCxBuffer TargetBuffer;
+			SplitToneKernel::Adjustments Adjustments;
+			SplitToneEffect::Properties AdjustedProperties;
+			bool HasAdjustments;
+		};
+
+		static WorkerStatePool<State>& GetStatePool();
+
+		void SetupAdjustments();
+
+		SplitToneEffect^ m_configuration;
+		std::unique_ptr<State> m_state;
+		LI::Extras::Detail::CustomEffectCxBuffer& m_sourceBuffer;
+		LI::Extras::Detail::CustomEffectCxBuffer& m_targetBuffer;
+		uint64_t m_propertiesVersion;
+		SplitToneKernel::RowFunction m_applyRow;
+		RowBands::Options m_bandOptions;
+	};
+}
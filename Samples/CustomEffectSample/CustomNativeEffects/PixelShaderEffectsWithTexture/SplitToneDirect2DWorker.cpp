@@ -12,7 +12,8 @@
 #include "SplitToneDirect2DWorker.h"
 #include "SplitToneEffect.h"
 #include "SplitTonePixelShader.hlsl.h"
-#include "SplitToneLookups.h"
+#include "SplitToneLookupCache.h"
+#include "Extras\EmbeddedResourceRegistry.h"
 #include <robuffer.h>
 
 using namespace Lumia::Imaging::Adjustments;
@@ -29,18 +30,12 @@ static void ThrowIfFailed(HRESULT hr)
 	__abi_ThrowIfFailed(hr);
 }
 
-IBuffer^ CreateBufferFromArray(const uint8* data, uint32 dataLength)
-{
-	auto dataWriter = ref new DataWriter();
-	ArrayReference<uint8, 1> shaderArray((uint8*)data, dataLength);
-	dataWriter->WriteBytes(shaderArray);
-	return dataWriter->DetachBuffer();
-}
-
 SplitToneDirect2DWorker::SplitToneDirect2DWorker(SplitToneEffect^ configuration) :
-	m_configuration(configuration)
+	m_configuration(configuration),
+	m_propertiesVersion(0)
 {
-	m_pixelShaderBuffer = CreateBufferFromArray((const uint8*)g_main, ARRAYSIZE(g_main));
+	// A view of g_main itself, shared by every worker.
+	m_pixelShaderBuffer = Lumia::Imaging::Extras::Detail::EmbeddedResourceRegistry::GetInstance().GetBuffer(GUID_SplitToneShader, g_main, ARRAYSIZE(g_main));
 }
 
 uint32 SplitToneDirect2DWorker::InputCount::get()
@@ -77,21 +72,20 @@ void SplitToneDirect2DWorker::GetPixelShaderResourceTextureOptions(Platform::Wri
 
 void SplitToneDirect2DWorker::SetupSplitToneBitmap()
 {
-	if(m_splitToneBitmap)
-		return;
-
-	SplitToneLookups::LookupTable lookupTable;
-	SplitToneLookups splitToneLookups;
-	splitToneLookups.Generate(m_configuration->HighlightsHue, m_configuration->HighlightsSaturation, m_configuration->ShadowsHue, m_configuration->ShadowsSaturation, lookupTable);
+	auto snapshot = m_configuration->GetProperties();
 
-	auto lookupsBuffer = CreateBufferFromArray((const uint8*)lookupTable.data(), sizeof(uint32) * lookupTable.size());
+	if(m_splitToneBitmap && snapshot.Version == m_propertiesVersion)
+		return;
 
-	m_splitToneBitmap = ref new Bitmap(Windows::Foundation::Size(256, 2), ColorMode::Bgra8888, 256 * sizeof(uint32), lookupsBuffer);
+	const SplitToneEffect::Properties& properties = snapshot.Value;
+	m_splitToneBitmap = SplitToneLookupCache::GetInstance().GetBitmap(properties.m_highHue, properties.m_highShift, properties.m_lowHue, properties.m_lowShift);
+	m_propertiesVersion = snapshot.Version;
 }
 
 void SplitToneDirect2DWorker::Configuration::set(IImageProvider^ configuration)
 {
 	m_configuration = safe_cast<SplitToneEffect^>(configuration);
+	m_splitToneBitmap = nullptr;
 }
 
 IImageProvider^ SplitToneDirect2DWorker::Configuration::get()
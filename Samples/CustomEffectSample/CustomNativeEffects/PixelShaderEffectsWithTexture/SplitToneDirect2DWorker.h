@@ -67,6 +67,7 @@ namespace CustomNativeEffects {
 		void SetupSplitToneBitmap();
 
 		SplitToneEffect^ m_configuration;
+		uint64_t m_propertiesVersion;
 		Bitmap^ m_splitToneBitmap;
 		WSS::IBuffer^ m_pixelShaderBuffer;
 	};
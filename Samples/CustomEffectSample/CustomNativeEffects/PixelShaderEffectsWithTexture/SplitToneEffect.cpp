@@ -10,6 +10,7 @@
 //*********************************************************
 #include "pch.h"
 #include "SplitToneEffect.h"
+#include "SplitToneCpuWorker.h"
 #include "SplitToneDirect2DWorker.h"
 
 using namespace CustomNativeEffects;
@@ -24,20 +25,17 @@ SplitToneEffect::SplitToneEffect()
 
 int32 SplitToneEffect::HighlightsHue::get()
 {
-	critical_section::scoped_lock lock(m_criticalSection);
-	return m_properties.m_highHue;
+	return m_properties.Get().m_highHue;
 }
 
 void SplitToneEffect::HighlightsHue::set(int32 value)
 {
-	critical_section::scoped_lock lock(m_criticalSection);
-	m_properties.m_highHue = value;
+	m_properties.Modify([value](Properties& properties) { properties.m_highHue = value; });
 }
 
 int32 SplitToneEffect::HighlightsSaturation::get()
 {
-	critical_section::scoped_lock lock(m_criticalSection);
-	return m_properties.m_highShift;
+	return m_properties.Get().m_highShift;
 }
 
 void SplitToneEffect::HighlightsSaturation::set(int32 value)
@@ -47,26 +45,22 @@ void SplitToneEffect::HighlightsSaturation::set(int32 value)
 		throw ref new Platform::InvalidArgumentException("HighlightsSaturation");
 	}
 
-	critical_section::scoped_lock lock(m_criticalSection);
-	m_properties.m_highShift = value;
+	m_properties.Modify([value](Properties& properties) { properties.m_highShift = value; });
 }
 
 int32 SplitToneEffect::ShadowsHue::get()
 {
-	critical_section::scoped_lock lock(m_criticalSection);
-	return m_properties.m_lowHue;
+	return m_properties.Get().m_lowHue;
 }
 
 void SplitToneEffect::ShadowsHue::set(int32 value)
 {
-	critical_section::scoped_lock lock(m_criticalSection);
-	m_properties.m_lowHue = value;
+	m_properties.Modify([value](Properties& properties) { properties.m_lowHue = value; });
 }
 
 int32 SplitToneEffect::ShadowsSaturation::get()
 {
-	critical_section::scoped_lock lock(m_criticalSection);
-	return m_properties.m_lowShift;
+	return m_properties.Get().m_lowShift;
 }
 
 void SplitToneEffect::ShadowsSaturation::set(int32 value)
@@ -76,8 +70,12 @@ void SplitToneEffect::ShadowsSaturation::set(int32 value)
 		throw ref new Platform::InvalidArgumentException("ShadowsSaturation");
 	}
 
-	critical_section::scoped_lock lock(m_criticalSection);
-	m_properties.m_lowShift = value;
+	m_properties.Modify([value](Properties& properties) { properties.m_lowShift = value; });
+}
+
+VersionedProperties<SplitToneEffect::Properties>::Snapshot SplitToneEffect::GetProperties()
+{
+	return m_properties.Read();
 }
 
 IImageProvider2^ SplitToneEffect::Clone()
@@ -85,14 +83,14 @@ IImageProvider2^ SplitToneEffect::Clone()
 	critical_section::scoped_lock lock(m_criticalSection);
 
 	auto clone = ref new SplitToneEffect();
-	clone->m_properties = m_properties; 
+	clone->m_properties.Set(m_properties.Get());
 	clone->m_source = m_source->Clone();
 	return clone;
 }
 
 RenderOptions SplitToneEffect::SupportedRenderOptions::get()
 {
-	return RenderOptions::Gpu;
+	return RenderOptions::Cpu | RenderOptions::Gpu;
 }
 
 Workers::IImageWorker^ SplitToneEffect::CreateImageWorker(Workers::IImageWorkerRequest^ imageWorkerRequest)
@@ -101,7 +99,8 @@ Workers::IImageWorker^ SplitToneEffect::CreateImageWorker(Workers::IImageWorkerR
 
 	switch(imageWorkerRequest->RenderOptions)
 	{
-	
+	case RenderOptions::Cpu:
+		return ref new SplitToneCpuWorker(this);
 	case RenderOptions::Gpu:
 		return ref new SplitToneDirect2DWorker(this);
 	default:
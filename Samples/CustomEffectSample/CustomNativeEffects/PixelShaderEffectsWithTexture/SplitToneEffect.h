@@ -10,6 +10,8 @@
 //*********************************************************
 #pragma once
 
+#include "VersionedProperties.h"
+
 #pragma warning(push)
 #pragma warning(disable: 4973)
 
@@ -127,10 +129,13 @@ namespace CustomNativeEffects {
 		const int32 MinSaturation = 0;
 		const int32 MaxSaturation = 100;
 
+		// All properties as one consistent snapshot, read without a lock.
+		VersionedProperties<Properties>::Snapshot GetProperties();
+
 	private:		
 		concurrency::critical_section m_criticalSection;		
 		IImageProvider2^ m_source;	
-		Properties m_properties;
+		VersionedProperties<Properties> m_properties;
 	};
 }
 
@@ -0,0 +1,95 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "pch.h"
+#include "SplitToneLookupCache.h"
+#include "SplitToneLookups.h"
+#include "Extras\CustomEffectMemoryPressure.h"
+#include "Extras\CustomEffectNativeBuffer.h"
+
+using namespace Lumia::Imaging;
+using namespace Lumia::Imaging::Extras::Detail;
+using namespace CustomNativeEffects;
+
+static const size_t DefaultCapacity = 64;
+
+SplitToneLookupCache& SplitToneLookupCache::GetInstance()
+{
+	static SplitToneLookupCache instance;
+	CustomEffectMemoryPressure::EnsureSubscribed();
+	return instance;
+}
+
+SplitToneLookupCache::SplitToneLookupCache() :
+	m_lookupTables(DefaultCapacity),
+	m_bitmaps(DefaultCapacity)
+{
+}
+
+SplitToneLookupCache::SharedLookupTable SplitToneLookupCache::GetLookupTable(const SplitToneTable::Parameters& parameters)
+{
+	return m_lookupTables.GetOrCreate(parameters, [&parameters]()
+	{
+		auto lookupTable = std::make_shared<SplitToneTable::LookupTable>();
+
+		SplitToneLookups splitToneLookups;
+		splitToneLookups.Generate(parameters.HighlightsHue, parameters.HighlightsSaturation, parameters.ShadowsHue, parameters.ShadowsSaturation, *lookupTable);
+
+		return SharedLookupTable(lookupTable);
+	});
+}
+
+SplitToneLookupCache::SharedLookupTable SplitToneLookupCache::GetLookupTable(int32 highlightsHue, int32 highlightsSaturation, int32 shadowsHue, int32 shadowsSaturation)
+{
+	return GetLookupTable(SplitToneTable::Normalize(highlightsHue, highlightsSaturation, shadowsHue, shadowsSaturation));
+}
+
+Bitmap^ SplitToneLookupCache::GetBitmap(int32 highlightsHue, int32 highlightsSaturation, int32 shadowsHue, int32 shadowsSaturation)
+{
+	const SplitToneTable::Parameters parameters = SplitToneTable::Normalize(highlightsHue, highlightsSaturation, shadowsHue, shadowsSaturation);
+
+	return m_bitmaps.GetOrCreate(parameters, [this, &parameters]()
+	{
+		SharedLookupTable lookupTable = GetLookupTable(parameters);
+
+		// The buffer keeps the table alive for as long as the bitmap needs it.
+		auto data = reinterpret_cast<byte*>(const_cast<uint32_t*>(lookupTable->data()));
+		auto lookupsBuffer = CustomEffectNativeBuffer::CreateExternal(data, static_cast<uint32>(sizeof(uint32) * lookupTable->size()), [lookupTable]() {});
+
+		return ref new Bitmap(Windows::Foundation::Size(256, 2), ColorMode::Bgra8888, 256 * sizeof(uint32), lookupsBuffer);
+	});
+}
+
+size_t SplitToneLookupCache::GetCapacity() const
+{
+	return m_lookupTables.GetCapacity();
+}
+
+void SplitToneLookupCache::SetCapacity(size_t capacity)
+{
+	m_lookupTables.SetCapacity(capacity);
+	m_bitmaps.SetCapacity(capacity);
+}
+
+void SplitToneLookupCache::Clear()
+{
+	m_lookupTables.Clear();
+	m_bitmaps.Clear();
+}
+
+SplitToneLookupCache::Statistics SplitToneLookupCache::GetLookupTableStatistics() const
+{
+	return m_lookupTables.GetStatistics();
+}
+
+SplitToneLookupCache::Statistics SplitToneLookupCache::GetBitmapStatistics() const
+{
+	return m_bitmaps.GetStatistics();
+}
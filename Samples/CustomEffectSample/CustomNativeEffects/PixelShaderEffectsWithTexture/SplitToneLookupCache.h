@@ -0,0 +1,58 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <memory>
+#include "LruCache.h"
+#include "SplitToneTable.h"
+
+namespace CustomNativeEffects {
+
+	// Process-wide cache of split tone lookup tables and of the 256x2 bitmaps the
+	// pixel shader samples, keyed on the normalized effect parameters.
+	//
+	// Workers rendering with the same hues and saturations share one immutable
+	// table and one bitmap instead of generating and uploading their own. The
+	// bitmaps wrap the cached tables without copying them and must not be written to.
+	class SplitToneLookupCache final
+	{
+	public:
+		typedef std::shared_ptr<const SplitToneTable::LookupTable> SharedLookupTable;
+		typedef LruCache<SplitToneTable::Parameters, SharedLookupTable, SplitToneTable::ParametersHash>::Statistics Statistics;
+
+		static SplitToneLookupCache& GetInstance();
+
+		SplitToneLookupCache();
+
+		SplitToneLookupCache(const SplitToneLookupCache&) = delete;
+
+		SplitToneLookupCache& operator=(const SplitToneLookupCache&) = delete;
+
+		SharedLookupTable GetLookupTable(int32 highlightsHue, int32 highlightsSaturation, int32 shadowsHue, int32 shadowsSaturation);
+
+		Lumia::Imaging::Bitmap^ GetBitmap(int32 highlightsHue, int32 highlightsSaturation, int32 shadowsHue, int32 shadowsSaturation);
+
+		// Number of parameter combinations kept, for tables and bitmaps each. Default 64.
+		size_t GetCapacity() const;
+		void SetCapacity(size_t capacity);
+
+		void Clear();
+
+		Statistics GetLookupTableStatistics() const;
+		Statistics GetBitmapStatistics() const;
+
+	private:
+		SharedLookupTable GetLookupTable(const SplitToneTable::Parameters& parameters);
+
+		LruCache<SplitToneTable::Parameters, SharedLookupTable, SplitToneTable::ParametersHash> m_lookupTables;
+		LruCache<SplitToneTable::Parameters, Lumia::Imaging::Bitmap^, SplitToneTable::ParametersHash> m_bitmaps;
+	};
+}
@@ -10,29 +10,37 @@
 //*********************************************************
 #include "pch.h"
 #include "SplitToneLookups.h"
-#include "ImageProcessingUtils.h"
+#include <cmath>
 
 using namespace Lumia::Imaging::Adjustments;
 using namespace CustomNativeEffects;
-using namespace ImageProcessingUtils;
 
-#define MIN_SHIFT 0
-#define MAX_SHIFT 100
+SplitToneLookups::SplitToneLookups()
+{
 
+}
 
-SplitToneLookups::SplitToneLookups()
+void SplitToneLookups::CopyCurveDeltas(Curve^ curve, SplitToneTable::CurveDeltas& deltas)
 {
+	auto curveValues = curve->Values;
 
+	for (int i = 0; i < 256; i++)
+	{
+		deltas[i] = curveValues[i] - i;
+	}
 }
 
-void SplitToneLookups::FillChannelLookup(int* lookup, Curve^ negativeCurve, Curve^ positiveCurve, int color)
+void SplitToneLookups::ScaleCurveDeltas(const SplitToneTable::CurveDeltas& deltas, int32 saturation, SplitToneTable::CurveDeltas& scaledDeltas)
 {
-	auto negativeValues = negativeCurve->Values;
-	auto positiveValues = positiveCurve->Values;
+	if (saturation >= SplitToneTable::MaximumSaturation)
+	{
+		scaledDeltas = deltas;
+		return;
+	}
 
 	for (int i = 0; i < 256; i++)
 	{
-		lookup[i] = i + (negativeValues[i] * (255 - color) + positiveValues[i] * color) / 255;
+		scaledDeltas[i] = static_cast<int32>(std::lround(deltas[i] * saturation / 100.0));
 	}
 }
 
@@ -128,95 +136,32 @@ Curve^ SplitToneLookups::CreateNegativeHighlightsCurve()
 	return curve;
 }
 
-void SplitToneLookups::Generate(int32 highlightsHue, int32 highlightsSaturation, int32 shadowsHue, int32 shadowsSaturation, LookupTable& lookupTable)
-{	
-	shadowsHue %= 360;
-	highlightsHue %= 360;
-
-	shadowsHue += (shadowsHue < 0) ? 360 : 0;
-	highlightsHue += (highlightsHue < 0) ? 360 : 0;
-
-	shadowsSaturation = SAT(shadowsSaturation, MIN_SHIFT, MAX_SHIFT);
-	highlightsSaturation = SAT(highlightsSaturation, MIN_SHIFT, MAX_SHIFT);
-
-	// Generate the curve lookup arrays
-	auto highPositiveCurve = CreatePositiveHighlightsCurve();
-	auto highNegativeCurve = CreateNegativeHighlightsCurve();
-	auto lowPositiveCurve = CreatePositiveShadowsCurve();
-	auto lowNegativeCurve = CreateNegativeShadowsCurve();
-
-	auto identityCurve = ref new Curve();
-
-	// Convert the values in the curve lookups into deltas
-	Curve::Subtract(highPositiveCurve, identityCurve, highPositiveCurve);
-	Curve::Subtract(highNegativeCurve, identityCurve, highNegativeCurve);
-	Curve::Subtract(lowPositiveCurve, identityCurve, lowPositiveCurve);
-	Curve::Subtract(lowNegativeCurve, identityCurve, lowNegativeCurve);
+const SplitToneTable::ToneDeltas& SplitToneLookups::GetBaseDeltas()
+{
+	static const SplitToneTable::ToneDeltas deltas = CreateBaseDeltas();
+	return deltas;
+}
 
-	// Adjust the curve lookups based on the highlights shift
-	if (highlightsSaturation < 100)
-	{
-		Curve::Multiply(highPositiveCurve, highlightsSaturation / 100.0, highPositiveCurve);
-		Curve::Multiply(highNegativeCurve, highlightsSaturation / 100.0, highNegativeCurve);
-	}
+SplitToneTable::ToneDeltas SplitToneLookups::CreateBaseDeltas()
+{
+	SplitToneTable::ToneDeltas deltas;
+	CopyCurveDeltas(CreatePositiveHighlightsCurve(), deltas.PositiveHighlights);
+	CopyCurveDeltas(CreateNegativeHighlightsCurve(), deltas.NegativeHighlights);
+	CopyCurveDeltas(CreatePositiveShadowsCurve(), deltas.PositiveShadows);
+	CopyCurveDeltas(CreateNegativeShadowsCurve(), deltas.NegativeShadows);
+	return deltas;
+}
 
-	// Adjust the curve lookups based on the shadows shift
-	if (shadowsSaturation < 100)
-	{
-		Curve::Multiply(lowPositiveCurve, shadowsSaturation / 100.0, lowPositiveCurve);
-		Curve::Multiply(lowNegativeCurve, shadowsSaturation / 100.0, lowNegativeCurve);
-	}
+void SplitToneLookups::Generate(int32 highlightsHue, int32 highlightsSaturation, int32 shadowsHue, int32 shadowsSaturation, LookupTable& lookupTable)
+{
+	const SplitToneTable::Parameters parameters = SplitToneTable::Normalize(highlightsHue, highlightsSaturation, shadowsHue, shadowsSaturation);
+	const SplitToneTable::ToneDeltas& baseDeltas = GetBaseDeltas();
 
-	// Extract the channel values of the shift colors
-	int lowColor = HueToRgb(shadowsHue);
-	int highColor = HueToRgb(highlightsHue);
-	int highRed = (highColor >> 16) & 0x000000FF;
-	int highGreen = (highColor >> 8) & 0x000000FF;
-	int highBlue = highColor & 0x000000FF;
-	int lowRed = (lowColor >> 16) & 0x000000FF;
-	int lowGreen = (lowColor >> 8) & 0x000000FF;
-	int lowBlue = lowColor & 0x000000FF;
-
-	//// Generate the channel lookups
-	FillChannelLookup(m_highReds, highNegativeCurve, highPositiveCurve, highRed);
-	FillChannelLookup(m_highGreens, highNegativeCurve, highPositiveCurve, highGreen);
-	FillChannelLookup(m_highBlues, highNegativeCurve, highPositiveCurve, highBlue);
-	FillChannelLookup(m_lowReds, lowNegativeCurve, lowPositiveCurve, lowRed);
-	FillChannelLookup(m_lowGreens, lowNegativeCurve, lowPositiveCurve, lowGreen);
-	FillChannelLookup(m_lowBlues, lowNegativeCurve, lowPositiveCurve, lowBlue);
-
-	// Turn the lookup arrays into arrays of deltas
-	for (int i = 0; i < 256; i++)
-	{
-		auto lowR = m_lowReds[i] - i;
-		auto lowG = m_lowGreens[i] - i;
-		auto lowB = m_lowBlues[i] - i;
-		auto highR = m_highReds[i] - i;
-		auto highG = m_highGreens[i] - i;
-		auto highB = m_highBlues[i] - i;
-
-		// Since the 8 bit per color format is unsigned, bias by 128.
-		// This will be subtracted in the shader.
-		lowR = 128 + lowR;
-		lowG = 128 + lowG;
-		lowB = 128 + lowB;
-		highR = 128 + highR;
-		highG = 128 + highG;
-		highB = 128 + highB;
-
-		lowR = MIN(255, MAX(0, lowR));
-		lowG = MIN(255, MAX(0, lowG));
-		lowB = MIN(255, MAX(0, lowB));
-		highR = MIN(255, MAX(0, highR));
-		highG = MIN(255, MAX(0, highG));
-		highB = MIN(255, MAX(0, highB));
-
-		uint32 lowRgb = (lowR << 16) | (lowG << 8) | lowB;
-		uint32 highRgb = (highR << 16) | (highG << 8) | highB;
-
-		// add all values in array with offset
-		lookupTable[i] = lowRgb;
-		lookupTable[i + 256] = highRgb;
-	}
+	SplitToneTable::ToneDeltas deltas;
+	ScaleCurveDeltas(baseDeltas.PositiveHighlights, parameters.HighlightsSaturation, deltas.PositiveHighlights);
+	ScaleCurveDeltas(baseDeltas.NegativeHighlights, parameters.HighlightsSaturation, deltas.NegativeHighlights);
+	ScaleCurveDeltas(baseDeltas.PositiveShadows, parameters.ShadowsSaturation, deltas.PositiveShadows);
+	ScaleCurveDeltas(baseDeltas.NegativeShadows, parameters.ShadowsSaturation, deltas.NegativeShadows);
 
+	SplitToneTable::Generate(deltas, parameters.HighlightsHue, parameters.ShadowsHue, lookupTable);
 }
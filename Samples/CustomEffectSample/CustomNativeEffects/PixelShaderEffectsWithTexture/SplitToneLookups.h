@@ -10,29 +10,31 @@
 //*********************************************************
 #pragma once
 
+#include "SplitToneTable.h"
+
 namespace CustomNativeEffects {
 
+	// Evaluates the split tone base curves with the Lumia Imaging SDK's Curve class
+	// once per process, scales them by the saturations and builds the lookup table
+	// with SplitToneTable.
 	class SplitToneLookups final
 	{
 	public:
 
 		SplitToneLookups();
-		
-		typedef std::array<uint32, 2*256> LookupTable;
-	    void Generate(_In_ const int32 highlightsHue, int32 highlightsSaturation, int32 shadowsHue, int32 shadowsSaturation, LookupTable& lookupTable);
-	
-	private:
-		 void FillChannelLookup(int* lookup, Lumia::Imaging::Adjustments::Curve^ negativeCurve, Lumia::Imaging::Adjustments::Curve^ positiveCurve, int color);
-		 Lumia::Imaging::Adjustments::Curve^ CreatePositiveShadowsCurve();
-		 Lumia::Imaging::Adjustments::Curve^ CreateNegativeShadowsCurve();
-		 Lumia::Imaging::Adjustments::Curve^ CreatePositiveHighlightsCurve();
-		 Lumia::Imaging::Adjustments::Curve^ CreateNegativeHighlightsCurve();
 
-		 int m_highReds[256];
-		 int m_highGreens[256];
-		 int m_highBlues[256];
-		 int m_lowReds[256];
-		 int m_lowGreens[256];
-		 int m_lowBlues[256];	
+		typedef SplitToneTable::LookupTable LookupTable;
+		void Generate(_In_ const int32 highlightsHue, int32 highlightsSaturation, int32 shadowsHue, int32 shadowsSaturation, LookupTable& lookupTable);
+
+	private:
+		// The base curves never change, so their deltas are evaluated once per process.
+		static const SplitToneTable::ToneDeltas& GetBaseDeltas();
+		static SplitToneTable::ToneDeltas CreateBaseDeltas();
+		static void CopyCurveDeltas(Lumia::Imaging::Adjustments::Curve^ curve, SplitToneTable::CurveDeltas& deltas);
+		static void ScaleCurveDeltas(const SplitToneTable::CurveDeltas& deltas, int32 saturation, SplitToneTable::CurveDeltas& scaledDeltas);
+		static Lumia::Imaging::Adjustments::Curve^ CreatePositiveShadowsCurve();
+		static Lumia::Imaging::Adjustments::Curve^ CreateNegativeShadowsCurve();
+		static Lumia::Imaging::Adjustments::Curve^ CreatePositiveHighlightsCurve();
+		static Lumia::Imaging::Adjustments::Curve^ CreateNegativeHighlightsCurve();
 	};
 }
@@ -25,13 +25,17 @@ Direct2DSaturationEffect::Direct2DSaturationEffect()
 
 double Direct2DSaturationEffect::Level::get()
 {
-	return m_properties.m_level;
+	return m_properties.Get().m_level;
 }
 
 void Direct2DSaturationEffect::Level::set(double value)
 {
-	critical_section::scoped_lock lock(m_criticalSection);
-	m_properties.m_level = value;
+	m_properties.Modify([value](Properties& properties) { properties.m_level = value; });
+}
+
+VersionedProperties<Direct2DSaturationEffect::Properties>::Snapshot Direct2DSaturationEffect::GetProperties()
+{
+	return m_properties.Read();
 }
 
 
@@ -45,7 +49,7 @@ IImageProvider2^ Direct2DSaturationEffect::Clone()
 	}
 
 	auto clone = ref new Direct2DSaturationEffect();
-	clone->m_properties = m_properties;
+	clone->m_properties.Set(m_properties.Get());
 	clone->m_source = m_source->Clone();
 	return clone;
 }
@@ -10,6 +10,8 @@
 //*********************************************************
 #pragma once
 
+#include "VersionedProperties.h"
+
 #pragma warning(push)
 #pragma warning(disable: 4973)
 
@@ -91,12 +93,15 @@ namespace CustomNativeEffects {
 
 #pragma endregion
 
+	internal:
+		// All properties as one consistent snapshot, read without a lock.
+		VersionedProperties<Properties>::Snapshot GetProperties();
 
 	private:
 		concurrency::critical_section m_criticalSection;
 		IImageProvider2^ m_source;
 
-		Properties m_properties;
+		VersionedProperties<Properties> m_properties;
 	};
 }
 
@@ -28,7 +28,8 @@ static void ThrowIfFailed(HRESULT hr)
 }
 
 Direct2DSaturationEffectDirect2DWorker::Direct2DSaturationEffectDirect2DWorker(Direct2DSaturationEffect^ configuration) :
-	m_configuration(configuration)
+	m_configuration(configuration),
+	m_propertiesVersion(0)
 {
 
 }
@@ -51,18 +52,34 @@ void Direct2DSaturationEffectDirect2DWorker::Initialize(Platform::IntPtr effectC
 		);	
 
 	m_transformGraph->SetSingleTransformNode(m_shaderDrawTransformNode.Get());
+
+	// The new effect has none of the values set on a previous one.
+	m_level.Invalidate();
+	m_propertiesVersion = 0;
 }
 
 void Direct2DSaturationEffectDirect2DWorker::PrepareForRender(uint32 changeType)
 {
-	if (changeType == D2D1_CHANGE_TYPE_NONE)
+	UNREFERENCED_PARAMETER(changeType);
+
+	auto snapshot = m_configuration->GetProperties();
+
+	if (snapshot.Version == m_propertiesVersion)
 	{
 		return;
-	}	
+	}
 
-	ThrowIfFailed(
-		m_d2dSaturationEffect->SetValue(D2D1_SATURATION_PROP_SATURATION, (float)m_configuration->Level)
-		);
+	// A new version may still carry the level that was last set.
+	if (m_level.Update((float)snapshot.Value.m_level))
+	{
+		ThrowIfFailed(
+			m_d2dSaturationEffect->SetValue(D2D1_SATURATION_PROP_SATURATION, m_level.GetValue())
+			);
+
+		m_level.MarkUploaded();
+	}
+
+	m_propertiesVersion = snapshot.Version;
 }
 
 void Direct2DSaturationEffectDirect2DWorker::SetGraph(Platform::IntPtr transformGraphUnk)
@@ -79,6 +96,7 @@ uint32 Direct2DSaturationEffectDirect2DWorker::InputCount::get()
 void Direct2DSaturationEffectDirect2DWorker::Configuration::set(IImageProvider^ configuration)
 {
 	m_configuration = safe_cast<Direct2DSaturationEffect^>(configuration);
+	m_propertiesVersion = 0;
 }
 
 IImageProvider^ Direct2DSaturationEffectDirect2DWorker::Configuration::get()
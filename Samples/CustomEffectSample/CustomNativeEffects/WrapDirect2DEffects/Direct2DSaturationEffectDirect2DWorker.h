@@ -11,6 +11,7 @@
 #pragma once
 
 #include "Direct2DSaturationEffect.h"
+#include "ParameterCache.h"
 
 namespace CustomNativeEffects {
 
@@ -67,6 +68,8 @@ namespace CustomNativeEffects {
 	private:
 	
 		Direct2DSaturationEffect^ m_configuration;
+		uint64_t m_propertiesVersion;
+		ParameterCache<float> m_level;
 		MW::ComPtr<ID2D1EffectContext> m_effectContext;
 		MW::ComPtr<ID2D1TransformGraph> m_transformGraph;
 		LIWD::IDirect2DShaderDrawTransform^ m_shaderDrawTransform;
@@ -0,0 +1,163 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "AlignedBuffer.h"
+#include <atomic>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#else
+#include <cstdlib>
+#endif
+
+using namespace CustomNativeEffects;
+
+static std::atomic<uint64_t> s_allocationCount(0);
+static std::atomic<uint64_t> s_allocationBytes(0);
+
+static void* AllocateAligned(size_t size, size_t alignment)
+{
+#if defined(_MSC_VER)
+	return _aligned_malloc(size, alignment);
+#else
+	void* memory = nullptr;
+	const size_t posixAlignment = alignment < sizeof(void*) ? sizeof(void*) : alignment;
+	return posix_memalign(&memory, posixAlignment, size) == 0 ? memory : nullptr;
+#endif
+}
+
+static void FreeAligned(void* memory)
+{
+#if defined(_MSC_VER)
+	_aligned_free(memory);
+#else
+	free(memory);
+#endif
+}
+
+AlignedBuffer::AllocationStatistics AlignedBuffer::GetAllocationStatistics()
+{
+	AllocationStatistics statistics;
+	statistics.Count = s_allocationCount.load(std::memory_order_relaxed);
+	statistics.Bytes = s_allocationBytes.load(std::memory_order_relaxed);
+	return statistics;
+}
+
+AlignedBuffer::AlignedBuffer() :
+	m_data(nullptr),
+	m_capacity(0),
+	m_tailPadding(0),
+	m_ownsData(false)
+{
+}
+
+AlignedBuffer::AlignedBuffer(uint32_t capacity, uint32_t alignment, uint32_t tailPadding) :
+	m_data(nullptr),
+	m_capacity(0),
+	m_tailPadding(0),
+	m_ownsData(false)
+{
+	if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+	{
+		throw std::invalid_argument("alignment");
+	}
+
+	const size_t allocationSize = static_cast<size_t>(capacity) + tailPadding;
+
+	m_data = static_cast<uint8_t*>(AllocateAligned(allocationSize > 0 ? allocationSize : 1, alignment));
+	if (!m_data)
+	{
+		throw std::bad_alloc();
+	}
+
+	s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+	s_allocationBytes.fetch_add(allocationSize, std::memory_order_relaxed);
+
+	m_capacity = capacity;
+	m_tailPadding = tailPadding;
+	m_ownsData = true;
+}
+
+AlignedBuffer::AlignedBuffer(AlignedBuffer&& other) :
+	m_data(other.m_data),
+	m_capacity(other.m_capacity),
+	m_tailPadding(other.m_tailPadding),
+	m_ownsData(other.m_ownsData),
+	m_release(std::move(other.m_release))
+{
+	other.m_data = nullptr;
+	other.m_capacity = 0;
+	other.m_tailPadding = 0;
+	other.m_ownsData = false;
+	other.m_release = nullptr;
+}
+
+AlignedBuffer& AlignedBuffer::operator=(AlignedBuffer&& other)
+{
+	if (this != &other)
+	{
+		Reset();
+
+		m_data = other.m_data;
+		m_capacity = other.m_capacity;
+		m_tailPadding = other.m_tailPadding;
+		m_ownsData = other.m_ownsData;
+		m_release = std::move(other.m_release);
+
+		other.m_data = nullptr;
+		other.m_capacity = 0;
+		other.m_tailPadding = 0;
+		other.m_ownsData = false;
+		other.m_release = nullptr;
+	}
+
+	return *this;
+}
+
+AlignedBuffer::~AlignedBuffer()
+{
+	Reset();
+}
+
+AlignedBuffer AlignedBuffer::Wrap(void* data, uint32_t capacity, std::function<void()> release)
+{
+	if (!data && capacity > 0)
+	{
+		throw std::invalid_argument("data");
+	}
+
+	AlignedBuffer buffer;
+	buffer.m_data = static_cast<uint8_t*>(data);
+	buffer.m_capacity = capacity;
+	buffer.m_release = std::move(release);
+	return buffer;
+}
+
+void AlignedBuffer::Reset()
+{
+	if (m_ownsData)
+	{
+		FreeAligned(m_data);
+	}
+	else if (m_release)
+	{
+		auto release = std::move(m_release);
+		m_release = nullptr;
+		release();
+	}
+
+	m_data = nullptr;
+	m_capacity = 0;
+	m_tailPadding = 0;
+	m_ownsData = false;
+}
@@ -0,0 +1,91 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace CustomNativeEffects {
+
+	// Move-only block of pixel memory.
+	//
+	// An owned buffer starts on an Alignment-byte boundary and is followed by
+	// TailPadding bytes past GetCapacity() that may be read and written freely,
+	// so SIMD kernels can run full vectors past the last pixel. A wrapped buffer
+	// refers to memory owned by the caller; its release callback runs when the
+	// buffer is reset or destroyed.
+	class AlignedBuffer final
+	{
+	public:
+		static const uint32_t DefaultAlignment = 64;
+		static const uint32_t DefaultTailPadding = 64;
+
+		// Owned buffers allocated since the process started, and their total
+		// size including tail padding. Wrapped buffers are not counted.
+		struct AllocationStatistics
+		{
+			uint64_t Count;
+			uint64_t Bytes;
+		};
+
+		static AllocationStatistics GetAllocationStatistics();
+
+		AlignedBuffer();
+
+		// Throws std::bad_alloc if the memory cannot be allocated and
+		// std::invalid_argument if alignment is not a power of two.
+		explicit AlignedBuffer(uint32_t capacity, uint32_t alignment = DefaultAlignment, uint32_t tailPadding = DefaultTailPadding);
+
+		AlignedBuffer(AlignedBuffer&& other);
+
+		AlignedBuffer& operator=(AlignedBuffer&& other);
+
+		AlignedBuffer(const AlignedBuffer&) = delete;
+
+		AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+
+		~AlignedBuffer();
+
+		// Wraps capacity bytes at data without copying them. The memory must stay
+		// valid until release is called.
+		static AlignedBuffer Wrap(void* data, uint32_t capacity, std::function<void()> release);
+
+		// Frees owned memory or calls the release callback of wrapped memory.
+		void Reset();
+
+		uint8_t* GetData() const
+		{
+			return m_data;
+		}
+
+		uint32_t GetCapacity() const
+		{
+			return m_capacity;
+		}
+
+		uint32_t GetTailPadding() const
+		{
+			return m_tailPadding;
+		}
+
+		bool IsExternal() const
+		{
+			return m_data != nullptr && !m_ownsData;
+		}
+
+	private:
+		uint8_t* m_data;
+		uint32_t m_capacity;
+		uint32_t m_tailPadding;
+		bool m_ownsData;
+		std::function<void()> m_release;
+	};
+}
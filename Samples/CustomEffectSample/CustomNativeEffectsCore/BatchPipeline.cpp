@@ -0,0 +1,180 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "BatchPipeline.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace CustomNativeEffects;
+
+namespace {
+
+	const int32_t PitchPixels = AlignedBuffer::DefaultAlignment / sizeof(uint32_t);
+}
+
+BatchFrame::BatchFrame() :
+	m_width(0),
+	m_height(0),
+	m_pitch(0),
+	m_allocationCount(0)
+{
+}
+
+void BatchFrame::Resize(int32_t width, int32_t height)
+{
+	if (width < 0 || height < 0)
+	{
+		throw std::invalid_argument("BatchFrame::Resize");
+	}
+
+	const int32_t pitch = static_cast<int32_t>((static_cast<int64_t>(width) + PitchPixels - 1) / PitchPixels * PitchPixels);
+	const uint64_t bytes = static_cast<uint64_t>(pitch) * height * sizeof(uint32_t);
+
+	if (bytes > UINT32_MAX - AlignedBuffer::DefaultTailPadding)
+	{
+		throw std::length_error("BatchFrame::Resize");
+	}
+
+	if (bytes > m_buffer.GetCapacity())
+	{
+		m_buffer.Reset();
+		m_buffer = AlignedBuffer(static_cast<uint32_t>(bytes));
+		++m_allocationCount;
+	}
+
+	m_width = width;
+	m_height = height;
+	m_pitch = pitch;
+}
+
+StripRows BatchFrame::GetRows() const
+{
+	StripRows rows;
+	rows.Pixels = GetPixels();
+	rows.Pitch = m_pitch;
+	rows.FirstRow = 0;
+	rows.RowCount = m_height;
+	rows.Width = m_width;
+	rows.ImageHeight = m_height;
+	return rows;
+}
+
+CpuWorkerRegion BatchFrame::GetRegion() const
+{
+	// Every row, the last one included, may be overrun into its padding.
+	return CpuWorkerRegion::Create(
+		GetPixels(), m_pitch, m_pitch - m_width,
+		GetPixels(), m_pitch, m_pitch - m_width,
+		m_width, m_height);
+}
+
+bool BatchPipeline::Run(int32_t itemCount, const ItemFunction& renderItem, const Options& options, Statistics* statistics)
+{
+	if (itemCount < 0)
+	{
+		throw std::invalid_argument("BatchPipeline::Run");
+	}
+
+	const uint32_t workerCount = static_cast<uint32_t>(std::max<int64_t>(std::min<int64_t>(options.MaximumInFlight, itemCount), 1));
+
+	std::vector<BatchFrame> frames(workerCount);
+	std::atomic<int32_t> nextItem(0);
+	std::atomic<int32_t> completedCount(0);
+	std::atomic<bool> isFailed(false);
+	std::exception_ptr error;
+	std::mutex errorMutex;
+
+	auto work = [&](uint32_t worker)
+	{
+		BatchFrame& frame = frames[worker];
+
+		for (;;)
+		{
+			if (isFailed.load(std::memory_order_relaxed) || (options.Cancellation && options.Cancellation->IsCanceled()))
+			{
+				return;
+			}
+
+			const int32_t item = nextItem.fetch_add(1, std::memory_order_relaxed);
+
+			if (item >= itemCount)
+			{
+				return;
+			}
+
+			try
+			{
+				renderItem(item, frame);
+				completedCount.fetch_add(1, std::memory_order_relaxed);
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock(errorMutex);
+
+				if (!error)
+				{
+					error = std::current_exception();
+				}
+
+				isFailed.store(true, std::memory_order_relaxed);
+				return;
+			}
+		}
+	};
+
+	// The calling thread is the first worker.
+	std::vector<std::thread> threads;
+	threads.reserve(workerCount - 1);
+
+	try
+	{
+		for (uint32_t worker = 1; worker < workerCount; ++worker)
+		{
+			threads.emplace_back(work, worker);
+		}
+	}
+	catch (...)
+	{
+		// Without enough threads the batch still completes, just with fewer
+		// images in flight.
+	}
+
+	work(0);
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	if (statistics)
+	{
+		*statistics = Statistics();
+		statistics->CompletedCount = completedCount.load();
+		statistics->WorkerCount = static_cast<uint32_t>(threads.size()) + 1;
+
+		for (const BatchFrame& frame : frames)
+		{
+			statistics->FrameAllocations += frame.GetAllocationCount();
+			statistics->FrameBytes += frame.GetCapacity();
+		}
+	}
+
+	if (error)
+	{
+		std::rethrow_exception(error);
+	}
+
+	return nextItem.load() >= itemCount;
+}
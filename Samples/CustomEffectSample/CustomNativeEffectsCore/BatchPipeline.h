@@ -0,0 +1,124 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include "AlignedBuffer.h"
+#include "CpuWorkerRegion.h"
+#include "StripPipeline.h"
+#include "TileScheduler.h"
+
+namespace CustomNativeEffects {
+
+	// Pixel memory a batch worker reuses from image to image. It only grows,
+	// so a batch of similar images allocates once per worker.
+	class BatchFrame final
+	{
+	public:
+		BatchFrame();
+
+		// Makes room for width x height BGRA8888 pixels, with every row padded to
+		// a whole number of cache lines. Throws std::length_error if the frame
+		// would not fit in 4 GB.
+		void Resize(int32_t width, int32_t height);
+
+		uint32_t* GetPixels() const
+		{
+			return reinterpret_cast<uint32_t*>(m_buffer.GetData());
+		}
+
+		int32_t GetWidth() const
+		{
+			return m_width;
+		}
+
+		int32_t GetHeight() const
+		{
+			return m_height;
+		}
+
+		int32_t GetPitch() const
+		{
+			return m_pitch;
+		}
+
+		uint32_t GetCapacity() const
+		{
+			return m_buffer.GetCapacity();
+		}
+
+		// How often Resize had to allocate.
+		uint32_t GetAllocationCount() const
+		{
+			return m_allocationCount;
+		}
+
+		// Every row of the frame, for stages that run in place.
+		StripRows GetRows() const;
+
+		// The frame as an in-place region, source and target being the same.
+		CpuWorkerRegion GetRegion() const;
+
+	private:
+		AlignedBuffer m_buffer;
+		int32_t m_width;
+		int32_t m_height;
+		int32_t m_pitch;
+		uint32_t m_allocationCount;
+	};
+
+	// Renders a batch of images with one effect configuration.
+	//
+	// Up to MaximumInFlight workers each take the next image, and decode,
+	// process and encode it into their own BatchFrame. While one worker waits
+	// for a codec, the others keep the processor busy, so decoding, processing
+	// and encoding of different images overlap, and memory is bounded by the
+	// number of frames instead of the number of images. Processing within an
+	// image still splits into bands on the TileScheduler.
+	namespace BatchPipeline {
+
+		struct Options
+		{
+			Options() :
+				MaximumInFlight(4),
+				Cancellation(nullptr)
+			{
+			}
+
+			// Images decoded, processed or encoded at the same time, and so the
+			// number of frames. 0 is treated as 1.
+			uint32_t MaximumInFlight;
+
+			// Checked before every image, if set.
+			const CancellationToken* Cancellation;
+		};
+
+		struct Statistics
+		{
+			int32_t CompletedCount;
+			uint32_t WorkerCount;
+			uint32_t FrameAllocations;
+			uint64_t FrameBytes;
+		};
+
+		// Renders the image with the given index into frame, which holds
+		// whatever the worker's previous image left in it.
+		typedef std::function<void(int32_t item, BatchFrame& frame)> ItemFunction;
+
+		// Calls renderItem once for every item in [0, itemCount), each on one of
+		// the workers, and returns once every call has returned. Returns false if
+		// canceled before every item had started. The first exception thrown by
+		// renderItem is rethrown once the other workers have finished their
+		// current item; the items not started by then are skipped.
+		bool Run(int32_t itemCount, const ItemFunction& renderItem, const Options& options, Statistics* statistics = nullptr);
+	}
+}
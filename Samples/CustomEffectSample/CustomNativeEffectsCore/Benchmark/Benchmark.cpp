@@ -0,0 +1,424 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "Benchmark.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+using namespace CustomNativeEffects;
+using namespace CustomNativeEffects::Benchmark;
+using namespace CpuFeatures;
+
+// Every allocation through the global operator new, from any thread. The
+// array and nothrow forms call this one, so replacing it counts them as well.
+static std::atomic<uint64_t> s_newCount(0);
+static std::atomic<uint64_t> s_newBytes(0);
+
+void* operator new(std::size_t size)
+{
+	s_newCount.fetch_add(1, std::memory_order_relaxed);
+	s_newBytes.fetch_add(size, std::memory_order_relaxed);
+
+	void* memory = std::malloc(size > 0 ? size : 1);
+	if (!memory)
+	{
+		throw std::bad_alloc();
+	}
+
+	return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+std::vector<ImageSize> Benchmark::GetStandardSizes()
+{
+	return
+	{
+		{ "thumbnail", 160, 120 },
+		{ "vga", 640, 480 },
+		{ "1080p", 1920, 1080 },
+		{ "12mp", 4032, 3024 },
+		{ "50mp", 8192, 6144 }
+	};
+}
+
+AllocationCounters Benchmark::GetAllocationCounters()
+{
+	const AlignedBuffer::AllocationStatistics aligned = AlignedBuffer::GetAllocationStatistics();
+
+	AllocationCounters counters;
+	counters.Count = s_newCount.load(std::memory_order_relaxed) + aligned.Count;
+	counters.Bytes = s_newBytes.load(std::memory_order_relaxed) + aligned.Bytes;
+	return counters;
+}
+
+std::unique_ptr<TileScheduler> Benchmark::CreateScheduler(uint32_t threads, RowBands::Options& options)
+{
+	options = RowBands::GetDefaultOptions();
+	options.Scheduler = nullptr;
+
+	if (threads <= 1)
+	{
+		options.MinimumParallelPixels = UINT32_MAX;
+		return nullptr;
+	}
+
+	TileScheduler::Options schedulerOptions;
+	schedulerOptions.WorkerCount = threads - 1;
+
+	std::unique_ptr<TileScheduler> scheduler(new TileScheduler(schedulerOptions));
+	options.Scheduler = scheduler.get();
+	return scheduler;
+}
+
+typedef std::chrono::steady_clock Clock;
+
+static double TimeBatch(const std::function<void()>& run, uint64_t batchSize)
+{
+	const Clock::time_point start = Clock::now();
+
+	for (uint64_t i = 0; i < batchSize; ++i)
+	{
+		run();
+	}
+
+	return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+Result Benchmark::Measure(const Case& benchmarkCase, const Configuration& configuration, const Workload& workload, double minimumSeconds, uint32_t minimumBatches)
+{
+	workload.Run();
+
+	// Doubles the batch until it is long enough to time, then scales it to
+	// a tenth of the minimum time.
+	const double targetNanoseconds = minimumSeconds * 1e9 / 10.0;
+	uint64_t batchSize = 1;
+	double batchNanoseconds = TimeBatch(workload.Run, batchSize);
+
+	while (batchNanoseconds < targetNanoseconds / 10.0 && batchSize < (1ull << 40))
+	{
+		batchSize *= 2;
+		batchNanoseconds = TimeBatch(workload.Run, batchSize);
+	}
+
+	if (batchNanoseconds < targetNanoseconds)
+	{
+		batchSize = static_cast<uint64_t>(std::ceil(batchSize * targetNanoseconds / std::max(batchNanoseconds, 1.0)));
+	}
+
+	std::vector<double> samples;
+	double totalNanoseconds = 0.0;
+	uint64_t iterations = 0;
+	uint64_t allocations = 0;
+	uint64_t allocatedBytes = 0;
+
+	while (totalNanoseconds < minimumSeconds * 1e9 || samples.size() < minimumBatches)
+	{
+		const AllocationCounters before = GetAllocationCounters();
+		const double nanoseconds = TimeBatch(workload.Run, batchSize);
+		const AllocationCounters after = GetAllocationCounters();
+
+		allocations += after.Count - before.Count;
+		allocatedBytes += after.Bytes - before.Bytes;
+
+		samples.push_back(nanoseconds / batchSize);
+		totalNanoseconds += nanoseconds;
+		iterations += batchSize;
+	}
+
+	std::sort(samples.begin(), samples.end());
+
+	Result result;
+	result.Case = benchmarkCase.Name;
+	result.Unit = benchmarkCase.Unit;
+	result.Size = (benchmarkCase.Varies & Case::Sizes) ? configuration.Size.Name : std::string();
+	result.Width = (benchmarkCase.Varies & Case::Sizes) ? configuration.Size.Width : 0;
+	result.Height = (benchmarkCase.Varies & Case::Sizes) ? configuration.Size.Height : 0;
+	result.Threads = configuration.Threads;
+	result.InstructionSet = (benchmarkCase.Varies & Case::InstructionSets) ? GetName(configuration.InstructionSet) : "";
+	result.Items = workload.Items;
+	result.Iterations = iterations;
+	result.MedianNanoseconds = samples[samples.size() / 2];
+	result.MinimumNanoseconds = samples.front();
+	result.NanosecondsPerItem = workload.Items > 0 ? result.MedianNanoseconds / workload.Items : 0.0;
+	result.ItemsPerSecond = result.MedianNanoseconds > 0.0 ? workload.Items * 1e9 / result.MedianNanoseconds : 0.0;
+	result.BytesPerItem = workload.BytesPerItem;
+
+	result.Allocations = static_cast<double>(allocations) / iterations;
+	result.AllocatedBytes = static_cast<double>(allocatedBytes) / iterations;
+
+	return result;
+}
+
+TestImage::TestImage(int32_t width, int32_t height, uint32_t seed) :
+	m_width(width),
+	m_height(height)
+{
+	const uint64_t bytes = static_cast<uint64_t>(width) * height * sizeof(uint32_t);
+	if (width <= 0 || height <= 0 || bytes > UINT32_MAX - AlignedBuffer::DefaultTailPadding)
+	{
+		throw std::invalid_argument("size");
+	}
+
+	m_buffer = AlignedBuffer(static_cast<uint32_t>(bytes));
+
+	// Smooth gradients with noise on top, so that lookups and interpolations
+	// touch the whole range instead of one cache line of their tables.
+	uint32_t state = seed | 1;
+	uint32_t* pixels = GetPixels();
+
+	for (int32_t y = 0; y < height; ++y)
+	{
+		for (int32_t x = 0; x < width; ++x)
+		{
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+
+			const uint32_t blue = (static_cast<uint32_t>(x) * 255 / width + (state & 0x3f)) & 0xff;
+			const uint32_t green = (static_cast<uint32_t>(y) * 255 / height + ((state >> 8) & 0x3f)) & 0xff;
+			const uint32_t red = (state >> 16) & 0xff;
+
+			pixels[static_cast<intptr_t>(y) * width + x] = 0xff000000 | (red << 16) | (green << 8) | blue;
+		}
+	}
+}
+
+uint32_t* TestImage::GetPixels() const
+{
+	return reinterpret_cast<uint32_t*>(m_buffer.GetData());
+}
+
+int32_t TestImage::GetWidth() const
+{
+	return m_width;
+}
+
+int32_t TestImage::GetHeight() const
+{
+	return m_height;
+}
+
+int32_t TestImage::GetPitch() const
+{
+	return m_width;
+}
+
+int32_t TestImage::GetTailPixels() const
+{
+	return static_cast<int32_t>(m_buffer.GetTailPadding() / sizeof(uint32_t));
+}
+
+MachineInfo Benchmark::GetMachineInfo(double minimumSeconds)
+{
+	MachineInfo machine;
+
+#if defined(__clang__)
+	machine.Compiler = std::string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+	machine.Compiler = std::string("gcc ") + __VERSION__;
+#elif defined(_MSC_VER)
+	machine.Compiler = "msvc " + std::to_string(_MSC_FULL_VER);
+#else
+	machine.Compiler = "unknown";
+#endif
+
+#if defined(_M_X64) || defined(__x86_64__)
+	machine.Architecture = "x64";
+#elif defined(_M_IX86) || defined(__i386__)
+	machine.Architecture = "x86";
+#elif defined(_M_ARM64) || defined(__aarch64__)
+	machine.Architecture = "arm64";
+#elif defined(_M_ARM) || defined(__arm__)
+	machine.Architecture = "arm";
+#else
+	machine.Architecture = "unknown";
+#endif
+
+	machine.PreferredInstructionSet = GetName(GetPreferredInstructionSet());
+	machine.HardwareThreads = std::thread::hardware_concurrency();
+	machine.MinimumSeconds = minimumSeconds;
+
+	return machine;
+}
+
+static std::string EscapeJson(const std::string& text)
+{
+	std::string escaped;
+
+	for (char c : text)
+	{
+		if (c == '"' || c == '\\')
+		{
+			escaped += '\\';
+			escaped += c;
+		}
+		else if (static_cast<unsigned char>(c) < 0x20)
+		{
+			char code[8];
+			std::snprintf(code, sizeof(code), "\\u%04x", static_cast<unsigned char>(c));
+			escaped += code;
+		}
+		else
+		{
+			escaped += c;
+		}
+	}
+
+	return escaped;
+}
+
+static bool IsPixelUnit(const Result& result)
+{
+	return result.Unit == "pixel";
+}
+
+void Benchmark::WriteJson(std::ostream& stream, const MachineInfo& machine, const std::vector<Result>& results)
+{
+	std::ostringstream text;
+	text << std::setprecision(6);
+
+	text << "{\n";
+	text << "  \"machine\": {\n";
+	text << "    \"compiler\": \"" << EscapeJson(machine.Compiler) << "\",\n";
+	text << "    \"architecture\": \"" << machine.Architecture << "\",\n";
+	text << "    \"preferred_isa\": \"" << machine.PreferredInstructionSet << "\",\n";
+	text << "    \"hardware_threads\": " << machine.HardwareThreads << ",\n";
+	text << "    \"min_time_seconds\": " << machine.MinimumSeconds << "\n";
+	text << "  },\n";
+	text << "  \"results\": [";
+
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const Result& result = results[i];
+
+		text << (i == 0 ? "\n" : ",\n");
+		text << "    { \"case\": \"" << EscapeJson(result.Case) << "\"";
+		text << ", \"unit\": \"" << EscapeJson(result.Unit) << "\"";
+		text << ", \"size\": \"" << EscapeJson(result.Size) << "\"";
+		text << ", \"width\": " << result.Width;
+		text << ", \"height\": " << result.Height;
+		text << ", \"threads\": " << result.Threads;
+		text << ", \"isa\": \"" << EscapeJson(result.InstructionSet) << "\"";
+		text << ", \"items\": " << result.Items;
+		text << ", \"iterations\": " << result.Iterations;
+		text << ", \"median_ns\": " << result.MedianNanoseconds;
+		text << ", \"min_ns\": " << result.MinimumNanoseconds;
+		text << ", \"ns_per_item\": " << result.NanosecondsPerItem;
+		text << ", \"items_per_second\": " << result.ItemsPerSecond;
+
+		if (IsPixelUnit(result))
+		{
+			text << ", \"megapixels_per_second\": " << result.ItemsPerSecond / 1e6;
+			text << ", \"ns_per_pixel\": " << result.NanosecondsPerItem;
+		}
+		else
+		{
+			text << ", \"megapixels_per_second\": null, \"ns_per_pixel\": null";
+		}
+
+		text << ", \"bytes_per_item\": " << result.BytesPerItem;
+		text << ", \"gigabytes_per_second\": " << result.BytesPerItem * result.ItemsPerSecond / 1e9;
+		text << ", \"allocations\": " << result.Allocations;
+		text << ", \"allocated_bytes\": " << result.AllocatedBytes;
+		text << " }";
+	}
+
+	text << (results.empty() ? "]\n" : "\n  ]\n");
+	text << "}\n";
+
+	stream << text.str();
+}
+
+void Benchmark::WriteCsv(std::ostream& stream, const std::vector<Result>& results)
+{
+	std::ostringstream text;
+	text << std::setprecision(6);
+
+	text << "case,unit,size,width,height,threads,isa,items,iterations,median_ns,min_ns,ns_per_item,items_per_second,"
+		"megapixels_per_second,ns_per_pixel,bytes_per_item,gigabytes_per_second,allocations,allocated_bytes\n";
+
+	for (const Result& result : results)
+	{
+		text << result.Case << ',' << result.Unit << ',' << result.Size << ',' << result.Width << ',' << result.Height << ','
+			<< result.Threads << ',' << result.InstructionSet << ',' << result.Items << ',' << result.Iterations << ','
+			<< result.MedianNanoseconds << ',' << result.MinimumNanoseconds << ',' << result.NanosecondsPerItem << ','
+			<< result.ItemsPerSecond << ',';
+
+		if (IsPixelUnit(result))
+		{
+			text << result.ItemsPerSecond / 1e6 << ',' << result.NanosecondsPerItem;
+		}
+		else
+		{
+			text << ',';
+		}
+
+		text << ',' << result.BytesPerItem << ',' << result.BytesPerItem * result.ItemsPerSecond / 1e9 << ','
+			<< result.Allocations << ',' << result.AllocatedBytes << '\n';
+	}
+
+	stream << text.str();
+}
+
+void Benchmark::WriteTable(std::ostream& stream, const std::vector<Result>& results)
+{
+	std::ostringstream text;
+
+	text << std::left << std::setw(24) << "case" << std::setw(8) << "isa" << std::setw(11) << "size" << std::right
+		<< std::setw(8) << "threads" << std::setw(16) << "rate" << std::setw(12) << "ns/item" << std::setw(10) << "B/item"
+		<< std::setw(10) << "allocs" << '\n';
+
+	for (const Result& result : results)
+	{
+		std::ostringstream rate;
+		rate << std::fixed << std::setprecision(1);
+
+		if (IsPixelUnit(result))
+		{
+			rate << result.ItemsPerSecond / 1e6 << " MP/s";
+		}
+		else if (result.Unit == "call")
+		{
+			rate << std::setprecision(0) << result.ItemsPerSecond << " /s";
+		}
+		else
+		{
+			rate << result.ItemsPerSecond / 1e6 << " M/s";
+		}
+
+		text << std::left << std::setw(24) << result.Case << std::setw(8) << result.InstructionSet << std::setw(11) << result.Size
+			<< std::right << std::setw(8) << result.Threads << std::setw(16) << rate.str()
+			<< std::fixed << std::setprecision(3) << std::setw(12) << result.NanosecondsPerItem
+			<< std::setprecision(1) << std::setw(10) << result.BytesPerItem
+			<< std::setprecision(2) << std::setw(10) << result.Allocations << '\n';
+
+		text.unsetf(std::ios::floatfield);
+	}
+
+	stream << text.str();
+}
@@ -0,0 +1,192 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "AlignedBuffer.h"
+#include "CpuFeatures.h"
+#include "RowBands.h"
+#include "TileScheduler.h"
+
+namespace CustomNativeEffects {
+
+	namespace Benchmark {
+
+		struct ImageSize
+		{
+			std::string Name;
+			int32_t Width;
+			int32_t Height;
+		};
+
+		// Thumbnail to 50 megapixels.
+		std::vector<ImageSize> GetStandardSizes();
+
+		// One point of the size x threads x instruction set matrix.
+		struct Configuration
+		{
+			ImageSize Size;
+			uint32_t Threads;
+			CpuFeatures::InstructionSet InstructionSet;
+
+			// Band options that run on exactly Threads threads: the caller alone
+			// for 1, otherwise the caller and Threads - 1 pool threads.
+			RowBands::Options Bands;
+		};
+
+		// What one iteration of a case does, for turning times into rates.
+		struct Workload
+		{
+			Workload() :
+				Items(0),
+				BytesPerItem(0.0)
+			{
+			}
+
+			// The measured call. Empty if the case does not run in the
+			// configuration, for example because the processor lacks the
+			// instruction set.
+			std::function<void()> Run;
+
+			// Units of the case processed by one call of Run.
+			uint64_t Items;
+
+			// Bytes of memory read and written per item, not counting tables.
+			double BytesPerItem;
+		};
+
+		// A benchmark case. Setup allocates and fills everything the case needs
+		// outside the measured time and returns the call to measure.
+		struct Case
+		{
+			enum Dimensions : uint32_t
+			{
+				None = 0,
+				Sizes = 1,
+				Threads = 2,
+				InstructionSets = 4,
+				All = Sizes | Threads | InstructionSets
+			};
+
+			std::string Name;
+
+			// "pixel" for image kernels, "value" for the batch helpers that work
+			// on arrays of numbers and "call" for setup work like table
+			// generation.
+			std::string Unit;
+
+			// The parts of the configuration the case depends on. The others are
+			// fixed to no size, one thread and the preferred instruction set, so
+			// the case runs once per combination of the ones it does use.
+			uint32_t Varies;
+
+			std::function<Workload(const Configuration&)> Setup;
+		};
+
+		// Every kernel and worker path in CustomNativeEffectsCore.
+		std::vector<Case> GetKernelCases();
+
+		// Totals of the global operator new and AlignedBuffer allocations made
+		// by every thread since the process started.
+		struct AllocationCounters
+		{
+			uint64_t Count;
+			uint64_t Bytes;
+		};
+
+		AllocationCounters GetAllocationCounters();
+
+		struct Result
+		{
+			std::string Case;
+			std::string Unit;
+			std::string Size;
+			int32_t Width;
+			int32_t Height;
+			uint32_t Threads;
+			std::string InstructionSet;
+
+			uint64_t Items;
+			uint64_t Iterations;
+
+			// Per iteration, over the batches of iterations timed.
+			double MedianNanoseconds;
+			double MinimumNanoseconds;
+
+			double NanosecondsPerItem;
+			double ItemsPerSecond;
+			double BytesPerItem;
+
+			// Per iteration, averaged over the measured iterations.
+			double Allocations;
+			double AllocatedBytes;
+		};
+
+		// Runs workload.Run once to warm caches and tables, then times batches
+		// of calls until at least minimumSeconds have passed and at least
+		// minimumBatches batches were timed. Batches are sized so each takes
+		// about a tenth of minimumSeconds, which keeps the timer resolution out
+		// of the results for calls of a few hundred nanoseconds.
+		Result Measure(const Case& benchmarkCase, const Configuration& configuration, const Workload& workload, double minimumSeconds, uint32_t minimumBatches);
+
+		// Pool threads for a configuration. Threads - 1 workers, or none for a
+		// single thread, in which case the options keep every band on the
+		// calling thread. The other band options keep the workers' defaults, so
+		// images below MinimumParallelPixels stay on one thread as they do in
+		// the effects.
+		std::unique_ptr<TileScheduler> CreateScheduler(uint32_t threads, RowBands::Options& options);
+
+		// Pixel memory with a deterministic, non-uniform test pattern. The pitch
+		// equals the width and the buffer's tail padding is reported as tail
+		// pixels so the kernels can take their vector paths on every row.
+		class TestImage final
+		{
+		public:
+			TestImage(int32_t width, int32_t height, uint32_t seed);
+
+			uint32_t* GetPixels() const;
+			int32_t GetWidth() const;
+			int32_t GetHeight() const;
+			int32_t GetPitch() const;
+			int32_t GetTailPixels() const;
+
+		private:
+			AlignedBuffer m_buffer;
+			int32_t m_width;
+			int32_t m_height;
+		};
+
+		struct MachineInfo
+		{
+			std::string Compiler;
+			std::string Architecture;
+			std::string PreferredInstructionSet;
+			uint32_t HardwareThreads;
+			double MinimumSeconds;
+		};
+
+		MachineInfo GetMachineInfo(double minimumSeconds);
+
+		// Machine-readable reports, one record per result. Rates that do not
+		// apply to a result's unit, such as megapixels per second for a "call",
+		// are null in JSON and empty in CSV.
+		void WriteJson(std::ostream& stream, const MachineInfo& machine, const std::vector<Result>& results);
+		void WriteCsv(std::ostream& stream, const std::vector<Result>& results);
+
+		// Aligned columns for reading on a terminal.
+		void WriteTable(std::ostream& stream, const std::vector<Result>& results);
+	}
+}
@@ -0,0 +1,424 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "Benchmark.h"
+#include <cctype>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+using namespace CustomNativeEffects;
+using namespace CustomNativeEffects::Benchmark;
+using namespace CpuFeatures;
+
+static const char Usage[] =
+	"Usage: CustomNativeEffectsBenchmark [options]\n"
+	"\n"
+	"  --help                 Print this text and exit.\n"
+	"  --list                 Print the case names and exit.\n"
+	"  --filter=NAMES         Comma-separated substrings; runs the cases whose name\n"
+	"                         contains one of them. Default: every case.\n"
+	"  --sizes=SIZES          Comma-separated size names or WIDTHxHEIGHT.\n"
+	"                         Names: thumbnail, vga, 1080p, 12mp, 50mp. Default: all.\n"
+	"  --threads=COUNTS       Comma-separated thread counts. Default: 1 and the\n"
+	"                         number of hardware threads.\n"
+	"  --isa=SETS             Comma-separated instruction sets: scalar, sse2, avx2,\n"
+	"                         neon. Default: every one the processor supports.\n"
+	"  --min-time=SECONDS     Minimum measured time per result. Default: 0.25.\n"
+	"  --min-batches=COUNT    Minimum timed batches per result. Default: 5.\n"
+	"  --format=FORMAT        table, csv or json. Default: table.\n"
+	"  --output=FILE          Writes the report to FILE instead of standard output.\n";
+
+struct Arguments
+{
+	Arguments() :
+		Help(false),
+		List(false),
+		MinimumSeconds(0.25),
+		MinimumBatches(5),
+		Format("table")
+	{
+	}
+
+	bool Help;
+	bool List;
+	std::vector<std::string> Filters;
+	std::vector<ImageSize> Sizes;
+	std::vector<uint32_t> Threads;
+	std::vector<InstructionSet> InstructionSets;
+	double MinimumSeconds;
+	uint32_t MinimumBatches;
+	std::string Format;
+	std::string Output;
+};
+
+static std::vector<std::string> Split(const std::string& text)
+{
+	std::vector<std::string> parts;
+	std::istringstream stream(text);
+	std::string part;
+
+	while (std::getline(stream, part, ','))
+	{
+		if (!part.empty())
+		{
+			parts.push_back(part);
+		}
+	}
+
+	return parts;
+}
+
+static std::string ToLower(std::string text)
+{
+	for (char& c : text)
+	{
+		c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+	}
+
+	return text;
+}
+
+static bool ParseSize(const std::string& text, ImageSize& size)
+{
+	for (const ImageSize& standard : GetStandardSizes())
+	{
+		if (ToLower(text) == standard.Name)
+		{
+			size = standard;
+			return true;
+		}
+	}
+
+	int width = 0;
+	int height = 0;
+	char separator = 0;
+	std::istringstream stream(text);
+
+	if (!(stream >> width >> separator >> height) || (separator != 'x' && separator != 'X') || !stream.eof() || width <= 0 || height <= 0)
+	{
+		return false;
+	}
+
+	size.Name = text;
+	size.Width = width;
+	size.Height = height;
+	return true;
+}
+
+static bool ParseInstructionSet(const std::string& text, InstructionSet& instructionSet)
+{
+	const InstructionSet all[] = { InstructionSet::Scalar, InstructionSet::Sse2, InstructionSet::Avx2, InstructionSet::Neon };
+
+	for (InstructionSet candidate : all)
+	{
+		if (ToLower(text) == ToLower(GetName(candidate)))
+		{
+			instructionSet = candidate;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static bool ParseArguments(int argc, char* argv[], Arguments& arguments)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string argument = argv[i];
+		const size_t equals = argument.find('=');
+		const std::string name = argument.substr(0, equals);
+		const std::string value = (equals == std::string::npos) ? std::string() : argument.substr(equals + 1);
+
+		if (name == "--help")
+		{
+			arguments.Help = true;
+		}
+		else if (name == "--list")
+		{
+			arguments.List = true;
+		}
+		else if (name == "--filter")
+		{
+			arguments.Filters = Split(value);
+		}
+		else if (name == "--sizes")
+		{
+			arguments.Sizes.clear();
+
+			for (const std::string& part : Split(value))
+			{
+				ImageSize size;
+				if (!ParseSize(part, size))
+				{
+					std::cerr << "Unknown size: " << part << "\n";
+					return false;
+				}
+
+				arguments.Sizes.push_back(size);
+			}
+		}
+		else if (name == "--threads")
+		{
+			arguments.Threads.clear();
+
+			for (const std::string& part : Split(value))
+			{
+				const long threads = std::strtol(part.c_str(), nullptr, 10);
+				if (threads <= 0 || threads > 1024)
+				{
+					std::cerr << "Invalid thread count: " << part << "\n";
+					return false;
+				}
+
+				arguments.Threads.push_back(static_cast<uint32_t>(threads));
+			}
+		}
+		else if (name == "--isa")
+		{
+			arguments.InstructionSets.clear();
+
+			const std::vector<std::string> parts = Split(value);
+			for (const std::string& part : parts)
+			{
+				InstructionSet instructionSet;
+				if (!ParseInstructionSet(part, instructionSet))
+				{
+					std::cerr << "Unknown instruction set: " << part << "\n";
+					return false;
+				}
+
+				if (!IsSupported(instructionSet))
+				{
+					std::cerr << "Skipping " << GetName(instructionSet) << ", which this processor does not support.\n";
+					continue;
+				}
+
+				arguments.InstructionSets.push_back(instructionSet);
+			}
+
+			if (!parts.empty() && arguments.InstructionSets.empty())
+			{
+				std::cerr << "None of the instruction sets is supported.\n";
+				return false;
+			}
+		}
+		else if (name == "--min-time")
+		{
+			arguments.MinimumSeconds = std::strtod(value.c_str(), nullptr);
+			if (!(arguments.MinimumSeconds > 0.0))
+			{
+				std::cerr << "Invalid minimum time: " << value << "\n";
+				return false;
+			}
+		}
+		else if (name == "--min-batches")
+		{
+			const long batches = std::strtol(value.c_str(), nullptr, 10);
+			if (batches <= 0)
+			{
+				std::cerr << "Invalid batch count: " << value << "\n";
+				return false;
+			}
+
+			arguments.MinimumBatches = static_cast<uint32_t>(batches);
+		}
+		else if (name == "--format")
+		{
+			if (value != "table" && value != "csv" && value != "json")
+			{
+				std::cerr << "Unknown format: " << value << "\n";
+				return false;
+			}
+
+			arguments.Format = value;
+		}
+		else if (name == "--output")
+		{
+			arguments.Output = value;
+		}
+		else
+		{
+			std::cerr << "Unknown option: " << argument << "\n";
+			return false;
+		}
+	}
+
+	if (arguments.Sizes.empty())
+	{
+		arguments.Sizes = GetStandardSizes();
+	}
+
+	if (arguments.Threads.empty())
+	{
+		const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+
+		arguments.Threads.push_back(1);
+		if (hardwareThreads > 1)
+		{
+			arguments.Threads.push_back(hardwareThreads);
+		}
+	}
+
+	if (arguments.InstructionSets.empty())
+	{
+		const InstructionSet all[] = { InstructionSet::Scalar, InstructionSet::Sse2, InstructionSet::Avx2, InstructionSet::Neon };
+
+		for (InstructionSet instructionSet : all)
+		{
+			if (IsSupported(instructionSet))
+			{
+				arguments.InstructionSets.push_back(instructionSet);
+			}
+		}
+	}
+
+	return true;
+}
+
+static bool IsSelected(const Case& benchmarkCase, const std::vector<std::string>& filters)
+{
+	if (filters.empty())
+	{
+		return true;
+	}
+
+	for (const std::string& filter : filters)
+	{
+		if (benchmarkCase.Name.find(filter) != std::string::npos)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Runs one case over every combination of the dimensions it varies. The
+// others stay at one value: no size, one thread and the preferred
+// instruction set.
+static void RunCase(const Case& benchmarkCase, const Arguments& arguments, std::vector<Result>& results)
+{
+	const std::vector<ImageSize> noSize = { ImageSize{ std::string(), 0, 0 } };
+	const std::vector<uint32_t> oneThread = { 1 };
+	const std::vector<InstructionSet> preferred = { GetPreferredInstructionSet() };
+
+	const std::vector<ImageSize>& sizes = (benchmarkCase.Varies & Case::Sizes) ? arguments.Sizes : noSize;
+	const std::vector<uint32_t>& threadCounts = (benchmarkCase.Varies & Case::Threads) ? arguments.Threads : oneThread;
+	const std::vector<InstructionSet>& instructionSets = (benchmarkCase.Varies & Case::InstructionSets) ? arguments.InstructionSets : preferred;
+
+	for (const ImageSize& size : sizes)
+	{
+		for (uint32_t threads : threadCounts)
+		{
+			Configuration configuration;
+			configuration.Size = size;
+			configuration.Threads = threads;
+
+			std::unique_ptr<TileScheduler> scheduler = CreateScheduler(threads, configuration.Bands);
+
+			for (InstructionSet instructionSet : instructionSets)
+			{
+				configuration.InstructionSet = instructionSet;
+
+				Workload workload = benchmarkCase.Setup(configuration);
+				if (!workload.Run)
+				{
+					continue;
+				}
+
+				Result result = Measure(benchmarkCase, configuration, workload, arguments.MinimumSeconds, arguments.MinimumBatches);
+
+				std::cerr << result.Case << ' ' << result.InstructionSet << ' ' << result.Size << ' ' << result.Threads << "t: "
+					<< result.NanosecondsPerItem << " ns/" << result.Unit << "\n";
+
+				results.push_back(std::move(result));
+			}
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Arguments arguments;
+	if (!ParseArguments(argc, argv, arguments))
+	{
+		std::cerr << "\n" << Usage;
+		return 1;
+	}
+
+	if (arguments.Help)
+	{
+		std::cout << Usage;
+		return 0;
+	}
+
+	const std::vector<Case> cases = GetKernelCases();
+
+	if (arguments.List)
+	{
+		for (const Case& benchmarkCase : cases)
+		{
+			std::cout << benchmarkCase.Name << "\n";
+		}
+
+		return 0;
+	}
+
+	std::vector<Result> results;
+
+	try
+	{
+		for (const Case& benchmarkCase : cases)
+		{
+			if (IsSelected(benchmarkCase, arguments.Filters))
+			{
+				RunCase(benchmarkCase, arguments, results);
+			}
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "Benchmark failed: " << e.what() << "\n";
+		return 1;
+	}
+
+	std::ofstream file;
+	if (!arguments.Output.empty())
+	{
+		file.open(arguments.Output, std::ios::out | std::ios::trunc);
+		if (!file)
+		{
+			std::cerr << "Cannot write " << arguments.Output << "\n";
+			return 1;
+		}
+	}
+
+	std::ostream& stream = arguments.Output.empty() ? std::cout : file;
+
+	if (arguments.Format == "json")
+	{
+		WriteJson(stream, GetMachineInfo(arguments.MinimumSeconds), results);
+	}
+	else if (arguments.Format == "csv")
+	{
+		WriteCsv(stream, results);
+	}
+	else
+	{
+		WriteTable(stream, results);
+	}
+
+	return stream ? 0 : 1;
+}
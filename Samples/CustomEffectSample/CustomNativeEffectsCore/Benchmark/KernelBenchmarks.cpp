@@ -0,0 +1,542 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "Benchmark.h"
+#include "BufferPool.h"
+#include "ColorLut3D.h"
+#include "ColorLutKernel.h"
+#include "GrayscaleKernel.h"
+#include "ImageProcessingBatch.h"
+#include "MagnifySmoothKernel.h"
+#include "PointwiseChain.h"
+#include "SaturationKernel.h"
+#include "SplitToneKernel.h"
+#include "SplitToneTable.h"
+#include "VariantPass.h"
+
+using namespace CustomNativeEffects;
+using namespace CustomNativeEffects::Benchmark;
+using namespace CpuFeatures;
+
+namespace {
+
+	// Source and target of one size. Consecutive configurations share the
+	// size, so the pair is kept until a case asks for another one instead of
+	// filling 50 megapixels again for every thread count and instruction set.
+	struct ImagePair
+	{
+		ImagePair(int32_t width, int32_t height) :
+			Source(width, height, 0x2545f491),
+			Target(width, height, 0x9e3779b9)
+		{
+		}
+
+		TestImage Source;
+		TestImage Target;
+	};
+
+	std::shared_ptr<ImagePair> GetImagePair(const ImageSize& size)
+	{
+		static std::shared_ptr<ImagePair> s_images;
+
+		if (!s_images || s_images->Source.GetWidth() != size.Width || s_images->Source.GetHeight() != size.Height)
+		{
+			s_images = nullptr;
+			s_images = std::make_shared<ImagePair>(size.Width, size.Height);
+		}
+
+		return s_images;
+	}
+
+	CpuWorkerRegion GetRegion(const TestImage& source, const TestImage& target)
+	{
+		return CpuWorkerRegion::Create(
+			source.GetPixels(), source.GetPitch(), source.GetTailPixels(),
+			target.GetPixels(), target.GetPitch(), target.GetTailPixels(),
+			source.GetWidth(), source.GetHeight());
+	}
+
+	// Runs processBand over the whole image the way the CPU workers' Process
+	// does, through RowBands on the configuration's threads.
+	Workload CreateBandWorkload(const Configuration& configuration, double bytesPerPixel, std::shared_ptr<const void> state, RowBands::BandFunction processBand)
+	{
+		std::shared_ptr<ImagePair> images = GetImagePair(configuration.Size);
+		const CpuWorkerRegion region = GetRegion(images->Source, images->Target);
+		const RowBands::Options bands = configuration.Bands;
+
+		Workload workload;
+		workload.Run = [images, state, region, bands, processBand]()
+		{
+			RowBands::ForEach(region, bands, processBand);
+		};
+		workload.Items = static_cast<uint64_t>(region.Width) * region.Height;
+		workload.BytesPerItem = bytesPerPixel;
+		return workload;
+	}
+
+	// The parameters of the effect-level cases. Mid-range values, so no
+	// stage degenerates into a copy.
+	const float Saturation = 1.4f;
+	const int32_t HighlightsHue = 40;
+	const int32_t HighlightsSaturation = 60;
+	const int32_t ShadowsHue = 220;
+	const int32_t ShadowsSaturation = 40;
+
+	// Stand-ins for the split tone base curves, which the component evaluates
+	// with the Lumia Imaging SDK: smooth lifts and drops of up to 64 levels,
+	// scaled by the saturations above.
+	const SplitToneTable::ToneDeltas& GetToneDeltas()
+	{
+		static const SplitToneTable::ToneDeltas deltas = []()
+		{
+			SplitToneTable::ToneDeltas toneDeltas;
+
+			for (int32_t i = 0; i < 256; ++i)
+			{
+				const int32_t bump = i * (255 - i) / 255;
+				toneDeltas.PositiveHighlights[i] = bump * HighlightsSaturation / 100;
+				toneDeltas.NegativeHighlights[i] = -bump / 2 * HighlightsSaturation / 100;
+				toneDeltas.PositiveShadows[i] = bump * ShadowsSaturation / 100;
+				toneDeltas.NegativeShadows[i] = -bump / 2 * ShadowsSaturation / 100;
+			}
+
+			return toneDeltas;
+		}();
+
+		return deltas;
+	}
+
+	std::shared_ptr<SplitToneKernel::Adjustments> BuildSplitToneAdjustments()
+	{
+		SplitToneTable::LookupTable lookupTable;
+		SplitToneTable::Generate(GetToneDeltas(), HighlightsHue, ShadowsHue, lookupTable);
+
+		auto adjustments = std::make_shared<SplitToneKernel::Adjustments>();
+		SplitToneKernel::BuildAdjustments(lookupTable, *adjustments);
+		return adjustments;
+	}
+
+	// Saturation followed by split tone, the chain the sample app builds most.
+	struct ChainState
+	{
+		SaturationKernel::Matrix Matrix;
+		std::shared_ptr<SplitToneKernel::Adjustments> Adjustments;
+		PointwiseChain Chain;
+	};
+
+	std::shared_ptr<ChainState> CreateChain(InstructionSet instructionSet, float saturation)
+	{
+		const SaturationKernel::RowFunction saturate = SaturationKernel::GetRowFunction(instructionSet);
+		const SplitToneKernel::RowFunction splitTone = SplitToneKernel::GetRowFunction(instructionSet);
+		if (!saturate || !splitTone)
+		{
+			return nullptr;
+		}
+
+		auto state = std::make_shared<ChainState>();
+		SaturationKernel::BuildMatrix(saturation, state->Matrix);
+		state->Adjustments = BuildSplitToneAdjustments();
+		state->Chain.AddSaturation(state->Matrix, saturate);
+		state->Chain.AddSplitTone(*state->Adjustments, splitTone);
+		return state;
+	}
+
+	Workload CreateGrayscale(const Configuration& configuration)
+	{
+		const GrayscaleKernel::RowFunction convertRow = GrayscaleKernel::GetRowFunction(configuration.InstructionSet);
+		if (!convertRow)
+		{
+			return Workload();
+		}
+
+		return CreateBandWorkload(configuration, 8.0, nullptr, [convertRow](const CpuWorkerRegion& band)
+		{
+			GrayscaleKernel::ConvertRegion(band, convertRow);
+		});
+	}
+
+	Workload CreateSaturation(const Configuration& configuration)
+	{
+		const SaturationKernel::RowFunction applyRow = SaturationKernel::GetRowFunction(configuration.InstructionSet);
+		if (!applyRow)
+		{
+			return Workload();
+		}
+
+		auto matrix = std::make_shared<SaturationKernel::Matrix>();
+		SaturationKernel::BuildMatrix(Saturation, *matrix);
+
+		const SaturationKernel::Matrix* parameters = matrix.get();
+		return CreateBandWorkload(configuration, 8.0, matrix, [parameters, applyRow](const CpuWorkerRegion& band)
+		{
+			SaturationKernel::ApplyRegion(band, *parameters, applyRow);
+		});
+	}
+
+	Workload CreateSplitTone(const Configuration& configuration)
+	{
+		const SplitToneKernel::RowFunction applyRow = SplitToneKernel::GetRowFunction(configuration.InstructionSet);
+		if (!applyRow)
+		{
+			return Workload();
+		}
+
+		auto adjustments = BuildSplitToneAdjustments();
+
+		const SplitToneKernel::Adjustments* parameters = adjustments.get();
+		return CreateBandWorkload(configuration, 8.0, adjustments, [parameters, applyRow](const CpuWorkerRegion& band)
+		{
+			SplitToneKernel::ApplyRegion(band, *parameters, applyRow);
+		});
+	}
+
+	Workload CreatePointwiseChain(const Configuration& configuration)
+	{
+		auto state = CreateChain(configuration.InstructionSet, Saturation);
+		if (!state)
+		{
+			return Workload();
+		}
+
+		const PointwiseChain* chain = &state->Chain;
+		return CreateBandWorkload(configuration, 8.0, state, [chain](const CpuWorkerRegion& band)
+		{
+			chain->ApplyRegion(band);
+		});
+	}
+
+	Workload CreateColorLut(const Configuration& configuration, int32_t size)
+	{
+		const ColorLutKernel::RowFunction applyRow = ColorLutKernel::GetRowFunction(configuration.InstructionSet);
+		auto chain = CreateChain(configuration.InstructionSet, Saturation);
+		if (!applyRow || !chain)
+		{
+			return Workload();
+		}
+
+		auto lut = std::make_shared<ColorLut3D>(size);
+		lut->Compile(chain->Chain);
+
+		const ColorLut3D* parameters = lut.get();
+		return CreateBandWorkload(configuration, 8.0, lut, [parameters, applyRow](const CpuWorkerRegion& band)
+		{
+			ColorLutKernel::ApplyRegion(band, *parameters, applyRow);
+		});
+	}
+
+	Workload CreateMagnifySmooth(const Configuration& configuration)
+	{
+		const MagnifySmoothKernel::RowFunction renderRow = MagnifySmoothKernel::GetRowFunction(configuration.InstructionSet);
+		if (!renderRow)
+		{
+			return Workload();
+		}
+
+		// The default lens of MagnifySmoothEffect, centred.
+		MagnifySmoothMath::Parameters parameters;
+		parameters.InnerRadius = 0.2f;
+		parameters.OuterRadius = 0.35f;
+		parameters.MagnificationAmount = 2.0f;
+		parameters.HorizontalPosition = 0.5f;
+		parameters.VerticalPosition = 0.5f;
+		parameters.AspectRatio = 1.0f;
+
+		std::shared_ptr<ImagePair> images = GetImagePair(configuration.Size);
+		const MagnifySmoothKernel::SourceImage source = { images->Source.GetPixels(), images->Source.GetPitch(), images->Source.GetWidth(), images->Source.GetHeight(), 0 };
+		const uint32_t* firstTargetRow = images->Target.GetPixels();
+		const int32_t targetPitch = images->Target.GetPitch();
+
+		return CreateBandWorkload(configuration, 8.0, nullptr, [source, firstTargetRow, targetPitch, parameters, renderRow](const CpuWorkerRegion& band)
+		{
+			const int32_t firstRow = static_cast<int32_t>((band.TargetPixels - firstTargetRow) / targetPitch);
+			MagnifySmoothKernel::RenderRegion(band, firstRow, parameters, source, renderRow);
+		});
+	}
+
+	// Four saturation variants of one source, the shape of an effect gallery.
+	Workload CreateVariantPass(const Configuration& configuration)
+	{
+		const int32_t VariantCount = 4;
+
+		struct State
+		{
+			std::shared_ptr<ChainState> Chains[VariantCount];
+			std::vector<TestImage> Targets;
+			VariantPass::Variant Variants[VariantCount];
+		};
+
+		auto state = std::make_shared<State>();
+		std::shared_ptr<ImagePair> images = GetImagePair(configuration.Size);
+
+		for (int32_t i = 0; i < VariantCount; ++i)
+		{
+			state->Chains[i] = CreateChain(configuration.InstructionSet, 0.5f + 0.5f * i);
+			if (!state->Chains[i])
+			{
+				return Workload();
+			}
+
+			state->Targets.emplace_back(configuration.Size.Width, configuration.Size.Height, 0x85ebca6b + i);
+		}
+
+		for (int32_t i = 0; i < VariantCount; ++i)
+		{
+			state->Variants[i].Chain = &state->Chains[i]->Chain;
+			state->Variants[i].TargetPixels = state->Targets[i].GetPixels();
+			state->Variants[i].TargetPitch = state->Targets[i].GetPitch();
+			state->Variants[i].TargetTailPixels = state->Targets[i].GetTailPixels();
+		}
+
+		VariantPass::SourceImage source;
+		source.Pixels = images->Source.GetPixels();
+		source.Pitch = images->Source.GetPitch();
+		source.Width = images->Source.GetWidth();
+		source.Height = images->Source.GetHeight();
+		source.TailPixels = images->Source.GetTailPixels();
+
+		const RowBands::Options bands = configuration.Bands;
+
+		Workload workload;
+		workload.Run = [images, state, source, bands]()
+		{
+			VariantPass::Apply(source, state->Variants, VariantCount, bands);
+		};
+		workload.Items = static_cast<uint64_t>(source.Width) * source.Height;
+		workload.BytesPerItem = 4.0 * (1 + VariantCount);
+		return workload;
+	}
+
+	// ImageProcessingBatch over one image's worth of values, in a
+	// single call as the table generators use it.
+	struct UtilsState
+	{
+		explicit UtilsState(uint32_t count) :
+			Values(count),
+			Bounds(count),
+			Bytes(count),
+			Result(count),
+			ByteResult(count)
+		{
+			uint32_t state = 0x6c8e9cf5;
+
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				state ^= state << 13;
+				state ^= state >> 17;
+				state ^= state << 5;
+
+				Values[i] = static_cast<int32_t>(state % (3 * 255 * 255)) - 255 * 255;
+				Bounds[i] = static_cast<int32_t>((state >> 7) % 512) - 128;
+				Bytes[i] = static_cast<uint8_t>(state >> 24);
+			}
+		}
+
+		std::vector<int32_t> Values;
+		std::vector<int32_t> Bounds;
+		std::vector<uint8_t> Bytes;
+		std::vector<int32_t> Result;
+		std::vector<uint8_t> ByteResult;
+	};
+
+	enum class UtilsFunction
+	{
+		Sat255,
+		Div255,
+		MultiplyDiv255,
+		Luma,
+		Clamp,
+		Max,
+		MaxRgb
+	};
+
+	Workload CreateUtils(const Configuration& configuration, UtilsFunction function)
+	{
+		const ImageProcessingBatch::Functions* functions = ImageProcessingBatch::GetFunctions(configuration.InstructionSet);
+		if (!functions)
+		{
+			return Workload();
+		}
+
+		std::shared_ptr<ImagePair> images = GetImagePair(configuration.Size);
+		const uint32_t count = static_cast<uint32_t>(images->Source.GetWidth()) * images->Source.GetHeight();
+		auto state = std::make_shared<UtilsState>(count);
+		const uint32_t* pixels = images->Source.GetPixels();
+
+		Workload workload;
+		workload.Items = count;
+
+		switch (function)
+		{
+		case UtilsFunction::Sat255:
+			workload.Run = [functions, state, count]() { functions->Sat255(state->Values.data(), state->ByteResult.data(), count); };
+			workload.BytesPerItem = 5.0;
+			break;
+		case UtilsFunction::Div255:
+			workload.Run = [functions, state, count]() { functions->Div255(state->Values.data(), state->Result.data(), count); };
+			workload.BytesPerItem = 8.0;
+			break;
+		case UtilsFunction::MultiplyDiv255:
+			workload.Run = [functions, state, count]() { functions->MultiplyDiv255(state->Bytes.data(), state->Bytes.data(), state->ByteResult.data(), count); };
+			workload.BytesPerItem = 3.0;
+			break;
+		case UtilsFunction::Luma:
+			workload.Run = [functions, state, images, pixels, count]() { functions->Luma(pixels, state->ByteResult.data(), count); };
+			workload.BytesPerItem = 5.0;
+			break;
+		case UtilsFunction::Clamp:
+			workload.Run = [functions, state, count]() { functions->Clamp(state->Values.data(), state->Result.data(), count, 0, 255 * 255); };
+			workload.BytesPerItem = 8.0;
+			break;
+		case UtilsFunction::Max:
+			workload.Run = [functions, state, count]() { functions->Max(state->Values.data(), state->Bounds.data(), state->Result.data(), count); };
+			workload.BytesPerItem = 12.0;
+			break;
+		case UtilsFunction::MaxRgb:
+			workload.Run = [functions, state, images, pixels, count]() { functions->MaxRgb(pixels, state->ByteResult.data(), count); };
+			workload.BytesPerItem = 5.0;
+			break;
+		}
+
+		return workload;
+	}
+
+	// The table step of SplitToneLookups::Generate in the component, which runs
+	// once per parameter change after the SDK has evaluated the curves. The
+	// hues step on every call so no result is served from a cache.
+	Workload CreateSplitToneTable(const Configuration&)
+	{
+		auto lookupTable = std::make_shared<SplitToneTable::LookupTable>();
+		auto hue = std::make_shared<int32_t>(0);
+
+		Workload workload;
+		workload.Run = [lookupTable, hue]()
+		{
+			*hue = (*hue + 7) % 360;
+			SplitToneTable::Generate(GetToneDeltas(), *hue, 359 - *hue, *lookupTable);
+		};
+		workload.Items = 1;
+		workload.BytesPerItem = sizeof(SplitToneTable::LookupTable);
+		return workload;
+	}
+
+	Workload CreateSplitToneAdjustments(const Configuration&)
+	{
+		auto lookupTable = std::make_shared<SplitToneTable::LookupTable>();
+		auto adjustments = std::make_shared<SplitToneKernel::Adjustments>();
+		SplitToneTable::Generate(GetToneDeltas(), HighlightsHue, ShadowsHue, *lookupTable);
+
+		Workload workload;
+		workload.Run = [lookupTable, adjustments]()
+		{
+			SplitToneKernel::BuildAdjustments(*lookupTable, *adjustments);
+		};
+		workload.Items = 1;
+		workload.BytesPerItem = sizeof(SplitToneKernel::Adjustments);
+		return workload;
+	}
+
+	Workload CreateColorLutCompile(const Configuration& configuration)
+	{
+		auto chain = CreateChain(configuration.InstructionSet, Saturation);
+		auto lut = std::make_shared<ColorLut3D>(ColorLut3D::DefaultSize);
+
+		Workload workload;
+		workload.Run = [chain, lut]()
+		{
+			lut->Compile(chain->Chain);
+		};
+		workload.Items = 1;
+		workload.BytesPerItem = static_cast<double>(ColorLut3D::DefaultSize) * ColorLut3D::DefaultSize * ColorLut3D::DefaultSize * sizeof(ColorLut3D::Entry);
+		return workload;
+	}
+
+	// CustomEffectCxBuffer::EnsureCapacity takes its buffers from the pool
+	// the component wraps around BufferPool. A worker that is created per
+	// render acquires on Prepare and releases on destruction, so this is the
+	// steady-state cost of a render's pixel buffer.
+	Workload CreateBufferPool(const Configuration& configuration)
+	{
+		auto pool = std::make_shared<BufferPool>();
+		const uint32_t length = static_cast<uint32_t>(configuration.Size.Width) * configuration.Size.Height * sizeof(uint32_t);
+
+		pool->Release(pool->Acquire(length));
+
+		Workload workload;
+		workload.Run = [pool, length]()
+		{
+			pool->Release(pool->Acquire(length));
+		};
+		workload.Items = 1;
+		return workload;
+	}
+
+	// The same buffer without the pool, which is what every render paid
+	// before buffers were pooled.
+	Workload CreateAlignedBuffer(const Configuration& configuration)
+	{
+		const uint32_t length = static_cast<uint32_t>(configuration.Size.Width) * configuration.Size.Height * sizeof(uint32_t);
+
+		Workload workload;
+		workload.Run = [length]()
+		{
+			AlignedBuffer buffer(length);
+		};
+		workload.Items = 1;
+		return workload;
+	}
+
+	Case MakeCase(const char* name, const char* unit, uint32_t varies, std::function<Workload(const Configuration&)> setup)
+	{
+		Case benchmarkCase;
+		benchmarkCase.Name = name;
+		benchmarkCase.Unit = unit;
+		benchmarkCase.Varies = varies;
+		benchmarkCase.Setup = std::move(setup);
+		return benchmarkCase;
+	}
+}
+
+std::vector<Case> Benchmark::GetKernelCases()
+{
+	const uint32_t Image = Case::All;
+	const uint32_t SingleThreaded = Case::Sizes | Case::InstructionSets;
+
+	std::vector<Case> cases;
+
+	// Pixel kernels, each driven the way its CPU worker's Process drives it.
+	cases.push_back(MakeCase("grayscale", "pixel", Image, CreateGrayscale));
+	cases.push_back(MakeCase("saturation", "pixel", Image, CreateSaturation));
+	cases.push_back(MakeCase("split-tone", "pixel", Image, CreateSplitTone));
+	cases.push_back(MakeCase("pointwise-chain", "pixel", Image, CreatePointwiseChain));
+	cases.push_back(MakeCase("color-lut-33", "pixel", Image, [](const Configuration& configuration) { return CreateColorLut(configuration, ColorLut3D::DefaultSize); }));
+	cases.push_back(MakeCase("color-lut-65", "pixel", Image, [](const Configuration& configuration) { return CreateColorLut(configuration, ColorLut3D::LargeSize); }));
+	cases.push_back(MakeCase("magnify-smooth", "pixel", Image, CreateMagnifySmooth));
+	cases.push_back(MakeCase("variant-pass-4", "pixel", Image, CreateVariantPass));
+
+	// ImageProcessingUtils batch helpers.
+	cases.push_back(MakeCase("utils-sat255", "value", SingleThreaded, [](const Configuration& configuration) { return CreateUtils(configuration, UtilsFunction::Sat255); }));
+	cases.push_back(MakeCase("utils-div255", "value", SingleThreaded, [](const Configuration& configuration) { return CreateUtils(configuration, UtilsFunction::Div255); }));
+	cases.push_back(MakeCase("utils-multiply-div255", "value", SingleThreaded, [](const Configuration& configuration) { return CreateUtils(configuration, UtilsFunction::MultiplyDiv255); }));
+	cases.push_back(MakeCase("utils-clamp", "value", SingleThreaded, [](const Configuration& configuration) { return CreateUtils(configuration, UtilsFunction::Clamp); }));
+	cases.push_back(MakeCase("utils-max", "value", SingleThreaded, [](const Configuration& configuration) { return CreateUtils(configuration, UtilsFunction::Max); }));
+	cases.push_back(MakeCase("utils-luma", "pixel", SingleThreaded, [](const Configuration& configuration) { return CreateUtils(configuration, UtilsFunction::Luma); }));
+	cases.push_back(MakeCase("utils-max-rgb", "pixel", SingleThreaded, [](const Configuration& configuration) { return CreateUtils(configuration, UtilsFunction::MaxRgb); }));
+
+	// Per-parameter-change setup work.
+	cases.push_back(MakeCase("split-tone-table", "call", Case::None, CreateSplitToneTable));
+	cases.push_back(MakeCase("split-tone-adjustments", "call", Case::None, CreateSplitToneAdjustments));
+	cases.push_back(MakeCase("color-lut-compile", "call", Case::None, CreateColorLutCompile));
+
+	// Per-render buffer setup.
+	cases.push_back(MakeCase("buffer-pool", "call", Case::Sizes, CreateBufferPool));
+	cases.push_back(MakeCase("aligned-buffer", "call", Case::Sizes, CreateAlignedBuffer));
+
+	return cases;
+}
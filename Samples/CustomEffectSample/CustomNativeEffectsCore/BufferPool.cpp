@@ -0,0 +1,303 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "BufferPool.h"
+#include <algorithm>
+#include <utility>
+
+using namespace CustomNativeEffects;
+
+BufferPool& BufferPool::GetInstance()
+{
+	static BufferPool* instance = new BufferPool();
+	return *instance;
+}
+
+BufferPool::BufferPool() :
+	m_stopping(false),
+	m_memoryCap(256ull * 1024 * 1024),
+	m_idleTimeout(30000),
+	m_statistics()
+{
+}
+
+BufferPool::~BufferPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+
+	m_trimCondition.notify_all();
+
+	if (m_trimThread.joinable())
+	{
+		m_trimThread.join();
+	}
+}
+
+uint32_t BufferPool::GetClassCapacity(uint32_t length)
+{
+	if (length <= (1u << MinimumClassShift))
+	{
+		return 1u << MinimumClassShift;
+	}
+
+	if (length > (1u << MaximumClassShift))
+	{
+		return length;
+	}
+
+	uint32_t capacity = length - 1;
+	capacity |= capacity >> 1;
+	capacity |= capacity >> 2;
+	capacity |= capacity >> 4;
+	capacity |= capacity >> 8;
+	capacity |= capacity >> 16;
+	return capacity + 1;
+}
+
+uint32_t BufferPool::GetClassIndex(uint32_t capacity)
+{
+	if (capacity == 0 || (capacity & (capacity - 1)) != 0)
+	{
+		return ClassCount;
+	}
+
+	uint32_t shift = 0;
+	while ((1u << shift) < capacity)
+	{
+		++shift;
+	}
+
+	if (shift < MinimumClassShift || shift > MaximumClassShift)
+	{
+		return ClassCount;
+	}
+
+	return shift - MinimumClassShift;
+}
+
+AlignedBuffer BufferPool::Acquire(uint32_t requiredLength)
+{
+	const uint32_t capacity = GetClassCapacity(requiredLength);
+	const uint32_t classIndex = GetClassIndex(capacity);
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (classIndex < ClassCount && !m_classes[classIndex].empty())
+		{
+			// Most recently released first; it is the most likely to still be resident.
+			AlignedBuffer buffer = std::move(m_classes[classIndex].back().Buffer);
+			m_classes[classIndex].pop_back();
+
+			m_statistics.Hits++;
+			m_statistics.BuffersHeld--;
+			m_statistics.BytesHeld -= capacity;
+			return buffer;
+		}
+
+		m_statistics.Misses++;
+	}
+
+	return AlignedBuffer(capacity);
+}
+
+void BufferPool::Release(AlignedBuffer&& buffer)
+{
+	AlignedBuffer released = std::move(buffer);
+
+	if (!released.GetData() || released.IsExternal())
+	{
+		return;
+	}
+
+	const uint32_t capacity = released.GetCapacity();
+	const uint32_t classIndex = GetClassIndex(capacity);
+
+	if (classIndex >= ClassCount || released.GetTailPadding() != AlignedBuffer::DefaultTailPadding)
+	{
+		return;
+	}
+
+	std::vector<AlignedBuffer> evicted;
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_statistics.Releases++;
+
+	if (capacity > m_memoryCap)
+	{
+		m_statistics.Evictions++;
+		return;
+	}
+
+	while (m_statistics.BytesHeld + capacity > m_memoryCap)
+	{
+		EvictOldestLocked(evicted);
+	}
+
+	Entry entry = { std::move(released), Clock::now() };
+	m_classes[classIndex].push_back(std::move(entry));
+
+	m_statistics.BuffersHeld++;
+	m_statistics.BytesHeld += capacity;
+
+	if (!m_trimThread.joinable())
+	{
+		m_trimThread = std::thread([this] { TrimIdlePeriodically(); });
+	}
+	else if (m_statistics.BuffersHeld == 1)
+	{
+		m_trimCondition.notify_one();
+	}
+}
+
+void BufferPool::Trim()
+{
+	std::vector<Entry> evicted[ClassCount];
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	for (uint32_t i = 0; i < ClassCount; ++i)
+	{
+		m_statistics.Evictions += m_classes[i].size();
+		evicted[i].swap(m_classes[i]);
+	}
+
+	m_statistics.BuffersHeld = 0;
+	m_statistics.BytesHeld = 0;
+}
+
+void BufferPool::TrimIdle()
+{
+	std::vector<AlignedBuffer> evicted;
+	std::lock_guard<std::mutex> lock(m_mutex);
+	TrimIdleLocked(Clock::now(), evicted);
+}
+
+void BufferPool::TrimIdlePeriodically()
+{
+	std::vector<AlignedBuffer> evicted;
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	while (!m_stopping)
+	{
+		if (m_statistics.BuffersHeld == 0)
+		{
+			m_trimCondition.wait(lock);
+			continue;
+		}
+
+		m_trimCondition.wait_for(lock, std::max(m_idleTimeout / 2, std::chrono::milliseconds(1)));
+		TrimIdleLocked(Clock::now(), evicted);
+
+		if (!evicted.empty())
+		{
+			lock.unlock();
+			evicted.clear();
+			lock.lock();
+		}
+	}
+}
+
+void BufferPool::TrimIdleLocked(Clock::time_point now, std::vector<AlignedBuffer>& evicted)
+{
+	for (uint32_t i = 0; i < ClassCount; ++i)
+	{
+		auto& entries = m_classes[i];
+		const uint64_t capacity = 1ull << (i + MinimumClassShift);
+
+		// Entries are appended on release, so the idle ones form a prefix.
+		auto firstActive = entries.begin();
+		while (firstActive != entries.end() && now - firstActive->ReleaseTime > m_idleTimeout)
+		{
+			++firstActive;
+		}
+
+		const uint64_t count = static_cast<uint64_t>(firstActive - entries.begin());
+		for (auto entry = entries.begin(); entry != firstActive; ++entry)
+		{
+			evicted.push_back(std::move(entry->Buffer));
+		}
+
+		entries.erase(entries.begin(), firstActive);
+
+		m_statistics.Evictions += count;
+		m_statistics.BuffersHeld -= count;
+		m_statistics.BytesHeld -= count * capacity;
+	}
+}
+
+void BufferPool::EvictOldestLocked(std::vector<AlignedBuffer>& evicted)
+{
+	uint32_t oldestClass = ClassCount;
+
+	for (uint32_t i = 0; i < ClassCount; ++i)
+	{
+		if (!m_classes[i].empty() &&
+			(oldestClass == ClassCount || m_classes[i].front().ReleaseTime < m_classes[oldestClass].front().ReleaseTime))
+		{
+			oldestClass = i;
+		}
+	}
+
+	if (oldestClass == ClassCount)
+	{
+		return;
+	}
+
+	evicted.push_back(std::move(m_classes[oldestClass].front().Buffer));
+	m_classes[oldestClass].erase(m_classes[oldestClass].begin());
+
+	m_statistics.Evictions++;
+	m_statistics.BuffersHeld--;
+	m_statistics.BytesHeld -= 1ull << (oldestClass + MinimumClassShift);
+}
+
+uint64_t BufferPool::GetMemoryCap() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_memoryCap;
+}
+
+void BufferPool::SetMemoryCap(uint64_t bytes)
+{
+	std::vector<AlignedBuffer> evicted;
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_memoryCap = bytes;
+
+	while (m_statistics.BytesHeld > m_memoryCap)
+	{
+		EvictOldestLocked(evicted);
+	}
+}
+
+std::chrono::milliseconds BufferPool::GetIdleTimeout() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_idleTimeout;
+}
+
+void BufferPool::SetIdleTimeout(std::chrono::milliseconds timeout)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_idleTimeout = timeout;
+	}
+
+	m_trimCondition.notify_all();
+}
+
+BufferPool::Statistics BufferPool::GetStatistics() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_statistics;
+}
@@ -0,0 +1,116 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "AlignedBuffer.h"
+
+namespace CustomNativeEffects {
+
+	// Process-wide pool of AlignedBuffers.
+	//
+	// Buffers are handed out in power-of-two size classes so that a buffer released
+	// by one worker or render can be reused by the next one asking for a similar size.
+	// Idle buffers are kept up to a memory cap and dropped once they have been idle
+	// longer than the idle timeout. A trimming thread, started when the pool first
+	// holds a buffer, checks for idle buffers every half timeout so they are freed
+	// even if the pool is not used again. Evicted buffers are freed after the pool's
+	// lock is released. Every buffer uses the default alignment and tail padding of
+	// AlignedBuffer.
+	class BufferPool final
+	{
+	public:
+		struct Statistics
+		{
+			uint64_t Hits;
+			uint64_t Misses;
+			uint64_t Releases;
+			uint64_t Evictions;
+			uint64_t BytesHeld;
+			uint64_t BuffersHeld;
+		};
+
+		// Never destroyed, like TileScheduler::GetDefault, so buffers released by
+		// other static objects at exit still find it.
+		static BufferPool& GetInstance();
+
+		BufferPool();
+
+		~BufferPool();
+
+		BufferPool(const BufferPool&) = delete;
+
+		BufferPool& operator=(const BufferPool&) = delete;
+
+		// Returns a buffer whose capacity is at least requiredLength.
+		AlignedBuffer Acquire(uint32_t requiredLength);
+
+		// Takes the buffer back for reuse. Wrapped buffers and buffers that do not
+		// match a size class are reset instead.
+		void Release(AlignedBuffer&& buffer);
+
+		// Drops every idle buffer.
+		void Trim();
+
+		// Drops the buffers that have been idle for longer than the idle timeout.
+		void TrimIdle();
+
+		// Upper bound for the bytes held by idle buffers. Default 256 MB.
+		uint64_t GetMemoryCap() const;
+		void SetMemoryCap(uint64_t bytes);
+
+		// How long a buffer may stay idle before TrimIdle drops it. Default 30 seconds.
+		std::chrono::milliseconds GetIdleTimeout() const;
+		void SetIdleTimeout(std::chrono::milliseconds timeout);
+
+		Statistics GetStatistics() const;
+
+		// Capacity of the size class used for the given length.
+		static uint32_t GetClassCapacity(uint32_t length);
+
+	private:
+		typedef std::chrono::steady_clock Clock;
+
+		struct Entry
+		{
+			AlignedBuffer Buffer;
+			Clock::time_point ReleaseTime;
+		};
+
+		// Size classes from 4 KB (2^12) to 2 GB (2^31). Larger requests are not pooled.
+		static const uint32_t MinimumClassShift = 12;
+		static const uint32_t MaximumClassShift = 31;
+		static const uint32_t ClassCount = MaximumClassShift - MinimumClassShift + 1;
+
+		static uint32_t GetClassIndex(uint32_t capacity);
+
+		// Move the evicted buffers to evicted, which the callers declare before
+		// taking the lock so the memory is freed after the lock is released.
+		void EvictOldestLocked(std::vector<AlignedBuffer>& evicted);
+		void TrimIdleLocked(Clock::time_point now, std::vector<AlignedBuffer>& evicted);
+
+		void TrimIdlePeriodically();
+
+		mutable std::mutex m_mutex;
+		std::condition_variable m_trimCondition;
+		std::thread m_trimThread;
+		bool m_stopping;
+		std::vector<Entry> m_classes[ClassCount];
+		uint64_t m_memoryCap;
+		std::chrono::milliseconds m_idleTimeout;
+		Statistics m_statistics;
+	};
+}
@@ -0,0 +1,888 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+
+#include "ColorConversion.h"
+#include "HueTable.h"
+#include "ImageProcessingUtils.h"
+
+#if defined(CPUFEATURES_X86)
+#include <emmintrin.h>
+#include <immintrin.h>
+#elif defined(CPUFEATURES_NEON)
+#include <arm_neon.h>
+#endif
+
+using namespace CustomNativeEffects;
+using namespace CustomNativeEffects::CpuFeatures;
+using namespace ImageProcessingUtils;
+
+// All divisions below have a dividend below 2^24 and a divisor of at most 510,
+// so a correctly rounded float division truncates to the integer quotient. The
+// vector implementations rely on this to divide in float.
+namespace ScalarConversion
+{
+	static inline void GetChannels(uint32_t pixel, int32_t& r, int32_t& g, int32_t& b)
+	{
+		r = (pixel >> 16) & 0xFF;
+		g = (pixel >> 8) & 0xFF;
+		b = pixel & 0xFF;
+	}
+
+	// Hue in quarter degrees of the channel with the largest value. The offset
+	// of up to 60 degrees from that channel's hue is rounded half away from zero.
+	static inline int32_t GetHue(int32_t r, int32_t g, int32_t b, int32_t max, int32_t delta)
+	{
+		if (delta == 0)
+		{
+			return 0;
+		}
+
+		int32_t base;
+		int32_t difference;
+
+		if (max == r)
+		{
+			base = 0;
+			difference = g - b;
+		}
+		else if (max == g)
+		{
+			base = 480;
+			difference = b - r;
+		}
+		else
+		{
+			base = 960;
+			difference = r - g;
+		}
+
+		const int32_t offset = (480 * ABS(difference) + delta) / (2 * delta);
+		const int32_t hue = base + ((difference < 0) ? -offset : offset);
+
+		return (hue < 0) ? hue + HueTable::Size : hue;
+	}
+
+	// Scales the pure color of the hue by chroma and adds the minimum channel value.
+	static inline uint32_t GetPixel(uint32_t pixel, int32_t hue, int32_t chroma, int32_t minimum)
+	{
+		const uint32_t pureColor = HueTable::Lookup(hue);
+
+		const int32_t r = minimum + DIV255(chroma * static_cast<int32_t>((pureColor >> 16) & 0xFF));
+		const int32_t g = minimum + DIV255(chroma * static_cast<int32_t>((pureColor >> 8) & 0xFF));
+		const int32_t b = minimum + DIV255(chroma * static_cast<int32_t>(pureColor & 0xFF));
+
+		return (pixel & 0xFF000000u) | static_cast<uint32_t>((r << 16) | (g << 8) | b);
+	}
+
+	static void RgbToHsv(const uint32_t* pixels, uint16_t* hue, uint8_t* saturation, uint8_t* value, uint32_t count)
+	{
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			int32_t r, g, b;
+			GetChannels(pixels[i], r, g, b);
+
+			const int32_t max = MAX(r, g, b);
+			const int32_t delta = max - MIN(r, g, b);
+
+			hue[i] = static_cast<uint16_t>(GetHue(r, g, b, max, delta));
+			saturation[i] = static_cast<uint8_t>((max == 0) ? 0 : (delta * 255 + max / 2) / max);
+			value[i] = static_cast<uint8_t>(max);
+		}
+	}
+
+	static void HsvToRgb(const uint16_t* hue, const uint8_t* saturation, const uint8_t* value, uint32_t* pixels, uint32_t count)
+	{
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const int32_t chroma = DIV255(value[i] * saturation[i]);
+			pixels[i] = GetPixel(pixels[i], hue[i], chroma, value[i] - chroma);
+		}
+	}
+
+	static void RgbToHsl(const uint32_t* pixels, uint16_t* hue, uint8_t* saturation, uint8_t* lightness, uint32_t count)
+	{
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			int32_t r, g, b;
+			GetChannels(pixels[i], r, g, b);
+
+			const int32_t max = MAX(r, g, b);
+			const int32_t min = MIN(r, g, b);
+			const int32_t delta = max - min;
+			const int32_t sum = max + min;
+
+			// Chroma relative to the largest chroma possible at this lightness.
+			const int32_t range = (sum <= 255) ? sum : 510 - sum;
+
+			hue[i] = static_cast<uint16_t>(GetHue(r, g, b, max, delta));
+			saturation[i] = static_cast<uint8_t>((delta == 0) ? 0 : (delta * 255 + range / 2) / range);
+			lightness[i] = static_cast<uint8_t>((sum + 1) >> 1);
+		}
+	}
+
+	static void HslToRgb(const uint16_t* hue, const uint8_t* saturation, const uint8_t* lightness, uint32_t* pixels, uint32_t count)
+	{
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const int32_t l = lightness[i];
+			const int32_t chroma = DIV255((255 - ABS(2 * l - 255)) * saturation[i]);
+
+			// chroma is at most 2 * l, and l + chroma / 2 is at most 255.
+			pixels[i] = GetPixel(pixels[i], hue[i], chroma, l - (chroma >> 1));
+		}
+	}
+
+	static const ColorConversion::Functions Functions =
+	{
+		RgbToHsv, HsvToRgb, RgbToHsl, HslToRgb
+	};
+}
+
+#if defined(CPUFEATURES_X86)
+
+// Four pixels per register, one per 32-bit lane. Instead of looking the pure
+// color up in HueTable, the vector versions evaluate HueTable::Entry, which has
+// no branches. SSE2 has no 32-bit min, max or multiply; all values multiplied
+// or compared here fit in the low 16 bits of a lane, where the 16-bit
+// instructions give the same result.
+namespace Sse2Conversion
+{
+	static inline __m128i Select(__m128i mask, __m128i ifTrue, __m128i ifFalse)
+	{
+		return _mm_or_si128(_mm_and_si128(mask, ifTrue), _mm_andnot_si128(mask, ifFalse));
+	}
+
+	static inline __m128i Multiply(__m128i a, __m128i b)
+	{
+		return _mm_madd_epi16(a, b);
+	}
+
+	// Also correct for small negative a: the high half of the lane becomes 0.
+	static inline __m128i Max(__m128i a, __m128i b)
+	{
+		return _mm_max_epi16(a, b);
+	}
+
+	static inline __m128i Min(__m128i a, __m128i b)
+	{
+		return _mm_min_epi16(a, b);
+	}
+
+	static inline __m128i Abs(__m128i x)
+	{
+		const __m128i sign = _mm_srai_epi32(x, 31);
+		return _mm_sub_epi32(_mm_xor_si128(x, sign), sign);
+	}
+
+	static inline __m128i Divide(__m128i dividend, __m128i divisor)
+	{
+		return _mm_cvttps_epi32(_mm_div_ps(_mm_cvtepi32_ps(dividend), _mm_cvtepi32_ps(divisor)));
+	}
+
+	static inline __m128i Div255(__m128i x)
+	{
+		return _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(_mm_srli_epi32(x, 8), x), _mm_set1_epi32(1)), 8);
+	}
+
+	static inline __m128i Ramp(__m128i x)
+	{
+		x = Min(Max(x, _mm_setzero_si128()), _mm_set1_epi32(240));
+		return _mm_srli_epi32(Multiply(x, _mm_set1_epi32(17)), 4);
+	}
+
+	static inline void GetChannels(__m128i pixels, __m128i& r, __m128i& g, __m128i& b)
+	{
+		const __m128i mask = _mm_set1_epi32(0xFF);
+
+		r = _mm_and_si128(_mm_srli_epi32(pixels, 16), mask);
+		g = _mm_and_si128(_mm_srli_epi32(pixels, 8), mask);
+		b = _mm_and_si128(pixels, mask);
+	}
+
+	// A delta of 0 needs no special case: the red branch is taken with a
+	// difference of 0, and the divisor is kept at 1 or more.
+	static inline __m128i GetHue(__m128i r, __m128i g, __m128i b, __m128i max, __m128i delta)
+	{
+		const __m128i isRed = _mm_cmpeq_epi32(max, r);
+		const __m128i isGreen = _mm_andnot_si128(isRed, _mm_cmpeq_epi32(max, g));
+		const __m128i isBlue = _mm_andnot_si128(_mm_or_si128(isRed, isGreen), _mm_set1_epi32(-1));
+
+		const __m128i base = _mm_or_si128(_mm_and_si128(isGreen, _mm_set1_epi32(480)), _mm_and_si128(isBlue, _mm_set1_epi32(960)));
+		const __m128i difference = Select(isRed, _mm_sub_epi32(g, b), Select(isGreen, _mm_sub_epi32(b, r), _mm_sub_epi32(r, g)));
+
+		const __m128i dividend = _mm_add_epi32(Multiply(Abs(difference), _mm_set1_epi32(480)), delta);
+		const __m128i divisor = Max(_mm_add_epi32(delta, delta), _mm_set1_epi32(1));
+		const __m128i offset = Divide(dividend, divisor);
+
+		const __m128i sign = _mm_srai_epi32(difference, 31);
+		const __m128i hue = _mm_add_epi32(base, _mm_sub_epi32(_mm_xor_si128(offset, sign), sign));
+
+		return _mm_add_epi32(hue, _mm_and_si128(_mm_srai_epi32(hue, 31), _mm_set1_epi32(HueTable::Size)));
+	}
+
+	static inline __m128i GetPixels(__m128i pixels, __m128i hue, __m128i chroma, __m128i minimum)
+	{
+		const __m128i pureRed = Ramp(_mm_sub_epi32(Abs(_mm_sub_epi32(hue, _mm_set1_epi32(720))), _mm_set1_epi32(240)));
+		const __m128i pureGreen = Ramp(_mm_sub_epi32(_mm_set1_epi32(480), Abs(_mm_sub_epi32(hue, _mm_set1_epi32(480)))));
+		const __m128i pureBlue = Ramp(_mm_sub_epi32(_mm_set1_epi32(480), Abs(_mm_sub_epi32(hue, _mm_set1_epi32(960)))));
+
+		const __m128i r = _mm_add_epi32(minimum, Div255(Multiply(chroma, pureRed)));
+		const __m128i g = _mm_add_epi32(minimum, Div255(Multiply(chroma, pureGreen)));
+		const __m128i b = _mm_add_epi32(minimum, Div255(Multiply(chroma, pureBlue)));
+
+		const __m128i rgb = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(r, 16), _mm_slli_epi32(g, 8)), b);
+		return _mm_or_si128(_mm_and_si128(pixels, _mm_set1_epi32(static_cast<int>(0xFF000000u))), rgb);
+	}
+
+	static inline __m128i Load(const void* source)
+	{
+		return _mm_loadu_si128(static_cast<const __m128i*>(source));
+	}
+
+	static inline void Store(void* target, __m128i value)
+	{
+		_mm_storeu_si128(static_cast<__m128i*>(target), value);
+	}
+
+	static inline void LoadWords(const uint16_t* source, __m128i& low, __m128i& high)
+	{
+		const __m128i words = Load(source);
+		low = _mm_unpacklo_epi16(words, _mm_setzero_si128());
+		high = _mm_unpackhi_epi16(words, _mm_setzero_si128());
+	}
+
+	static inline void LoadBytes(const uint8_t* source, __m128i& low, __m128i& high)
+	{
+		const __m128i words = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(source)), _mm_setzero_si128());
+		low = _mm_unpacklo_epi16(words, _mm_setzero_si128());
+		high = _mm_unpackhi_epi16(words, _mm_setzero_si128());
+	}
+
+	static inline void StoreWords(uint16_t* target, __m128i low, __m128i high)
+	{
+		Store(target, _mm_packs_epi32(low, high));
+	}
+
+	static inline void StoreBytes(uint8_t* target, __m128i low, __m128i high)
+	{
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(target), _mm_packus_epi16(_mm_packs_epi32(low, high), _mm_setzero_si128()));
+	}
+
+	static void RgbToHsv(const uint32_t* pixels, uint16_t* hue, uint8_t* saturation, uint8_t* value, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m128i h[2];
+			__m128i s[2];
+			__m128i v[2];
+
+			for (int half = 0; half < 2; ++half)
+			{
+				__m128i r, g, b;
+				GetChannels(Load(pixels + i + 4 * half), r, g, b);
+
+				const __m128i max = Max(Max(r, g), b);
+				const __m128i delta = _mm_sub_epi32(max, Min(Min(r, g), b));
+
+				h[half] = GetHue(r, g, b, max, delta);
+				s[half] = Divide(_mm_add_epi32(Multiply(delta, _mm_set1_epi32(255)), _mm_srli_epi32(max, 1)), Max(max, _mm_set1_epi32(1)));
+				v[half] = max;
+			}
+
+			StoreWords(hue + i, h[0], h[1]);
+			StoreBytes(saturation + i, s[0], s[1]);
+			StoreBytes(value + i, v[0], v[1]);
+		}
+
+		ScalarConversion::RgbToHsv(pixels + i, hue + i, saturation + i, value + i, count - i);
+	}
+
+	static void HsvToRgb(const uint16_t* hue, const uint8_t* saturation, const uint8_t* value, uint32_t* pixels, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m128i h[2];
+			__m128i s[2];
+			__m128i v[2];
+
+			LoadWords(hue + i, h[0], h[1]);
+			LoadBytes(saturation + i, s[0], s[1]);
+			LoadBytes(value + i, v[0], v[1]);
+
+			for (int half = 0; half < 2; ++half)
+			{
+				const __m128i chroma = Div255(Multiply(v[half], s[half]));
+				uint32_t* target = pixels + i + 4 * half;
+
+				Store(target, GetPixels(Load(target), h[half], chroma, _mm_sub_epi32(v[half], chroma)));
+			}
+		}
+
+		ScalarConversion::HsvToRgb(hue + i, saturation + i, value + i, pixels + i, count - i);
+	}
+
+	static void RgbToHsl(const uint32_t* pixels, uint16_t* hue, uint8_t* saturation, uint8_t* lightness, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m128i h[2];
+			__m128i s[2];
+			__m128i l[2];
+
+			for (int half = 0; half < 2; ++half)
+			{
+				__m128i r, g, b;
+				GetChannels(Load(pixels + i + 4 * half), r, g, b);
+
+				const __m128i max = Max(Max(r, g), b);
+				const __m128i min = Min(Min(r, g), b);
+				const __m128i delta = _mm_sub_epi32(max, min);
+				const __m128i sum = _mm_add_epi32(max, min);
+
+				// With a delta of 0 the dividend is below the divisor, so the
+				// saturation is 0 like in the scalar version.
+				__m128i range = Select(_mm_cmpgt_epi32(sum, _mm_set1_epi32(255)), _mm_sub_epi32(_mm_set1_epi32(510), sum), sum);
+				range = Max(range, _mm_set1_epi32(1));
+
+				h[half] = GetHue(r, g, b, max, delta);
+				s[half] = Divide(_mm_add_epi32(Multiply(delta, _mm_set1_epi32(255)), _mm_srli_epi32(range, 1)), range);
+				l[half] = _mm_srli_epi32(_mm_add_epi32(sum, _mm_set1_epi32(1)), 1);
+			}
+
+			StoreWords(hue + i, h[0], h[1]);
+			StoreBytes(saturation + i, s[0], s[1]);
+			StoreBytes(lightness + i, l[0], l[1]);
+		}
+
+		ScalarConversion::RgbToHsl(pixels + i, hue + i, saturation + i, lightness + i, count - i);
+	}
+
+	static void HslToRgb(const uint16_t* hue, const uint8_t* saturation, const uint8_t* lightness, uint32_t* pixels, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m128i h[2];
+			__m128i s[2];
+			__m128i l[2];
+
+			LoadWords(hue + i, h[0], h[1]);
+			LoadBytes(saturation + i, s[0], s[1]);
+			LoadBytes(lightness + i, l[0], l[1]);
+
+			for (int half = 0; half < 2; ++half)
+			{
+				const __m128i distance = Abs(_mm_sub_epi32(_mm_add_epi32(l[half], l[half]), _mm_set1_epi32(255)));
+				const __m128i chroma = Div255(Multiply(_mm_sub_epi32(_mm_set1_epi32(255), distance), s[half]));
+				uint32_t* target = pixels + i + 4 * half;
+
+				Store(target, GetPixels(Load(target), h[half], chroma, _mm_sub_epi32(l[half], _mm_srli_epi32(chroma, 1))));
+			}
+		}
+
+		ScalarConversion::HslToRgb(hue + i, saturation + i, lightness + i, pixels + i, count - i);
+	}
+
+	static const ColorConversion::Functions Functions =
+	{
+		RgbToHsv, HsvToRgb, RgbToHsl, HslToRgb
+	};
+}
+
+// Eight pixels per register. AVX2 has the 32-bit operations SSE2 lacks.
+namespace Avx2Conversion
+{
+	CPUFEATURES_TARGET_AVX2
+	static inline __m256i Divide(__m256i dividend, __m256i divisor)
+	{
+		return _mm256_cvttps_epi32(_mm256_div_ps(_mm256_cvtepi32_ps(dividend), _mm256_cvtepi32_ps(divisor)));
+	}
+
+	CPUFEATURES_TARGET_AVX2
+	static inline __m256i Div255(__m256i x)
+	{
+		return _mm256_srli_epi32(_mm256_add_epi32(_mm256_add_epi32(_mm256_srli_epi32(x, 8), x), _mm256_set1_epi32(1)), 8);
+	}
+
+	CPUFEATURES_TARGET_AVX2
+	static inline __m256i Ramp(__m256i x)
+	{
+		x = _mm256_min_epi32(_mm256_max_epi32(x, _mm256_setzero_si256()), _mm256_set1_epi32(240));
+		return _mm256_srli_epi32(_mm256_mullo_epi32(x, _mm256_set1_epi32(17)), 4);
+	}
+
+	CPUFEATURES_TARGET_AVX2
+	static inline void GetChannels(__m256i pixels, __m256i& r, __m256i& g, __m256i& b)
+	{
+		const __m256i mask = _mm256_set1_epi32(0xFF);
+
+		r = _mm256_and_si256(_mm256_srli_epi32(pixels, 16), mask);
+		g = _mm256_and_si256(_mm256_srli_epi32(pixels, 8), mask);
+		b = _mm256_and_si256(pixels, mask);
+	}
+
+	CPUFEATURES_TARGET_AVX2
+	static inline __m256i GetHue(__m256i r, __m256i g, __m256i b, __m256i max, __m256i delta)
+	{
+		const __m256i isRed = _mm256_cmpeq_epi32(max, r);
+		const __m256i isGreen = _mm256_andnot_si256(isRed, _mm256_cmpeq_epi32(max, g));
+
+		__m256i base = _mm256_blendv_epi8(_mm256_set1_epi32(960), _mm256_set1_epi32(480), isGreen);
+		base = _mm256_blendv_epi8(base, _mm256_setzero_si256(), isRed);
+
+		__m256i difference = _mm256_blendv_epi8(_mm256_sub_epi32(r, g), _mm256_sub_epi32(b, r), isGreen);
+		difference = _mm256_blendv_epi8(difference, _mm256_sub_epi32(g, b), isRed);
+
+		const __m256i dividend = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_abs_epi32(difference), _mm256_set1_epi32(480)), delta);
+		const __m256i divisor = _mm256_max_epi32(_mm256_add_epi32(delta, delta), _mm256_set1_epi32(1));
+		const __m256i hue = _mm256_add_epi32(base, _mm256_sign_epi32(Divide(dividend, divisor), difference));
+
+		return _mm256_add_epi32(hue, _mm256_and_si256(_mm256_srai_epi32(hue, 31), _mm256_set1_epi32(HueTable::Size)));
+	}
+
+	CPUFEATURES_TARGET_AVX2
+	static inline __m256i GetPixels(__m256i pixels, __m256i hue, __m256i chroma, __m256i minimum)
+	{
+		const __m256i pureRed = Ramp(_mm256_sub_epi32(_mm256_abs_epi32(_mm256_sub_epi32(hue, _mm256_set1_epi32(720))), _mm256_set1_epi32(240)));
+		const __m256i pureGreen = Ramp(_mm256_sub_epi32(_mm256_set1_epi32(480), _mm256_abs_epi32(_mm256_sub_epi32(hue, _mm256_set1_epi32(480)))));
+		const __m256i pureBlue = Ramp(_mm256_sub_epi32(_mm256_set1_epi32(480), _mm256_abs_epi32(_mm256_sub_epi32(hue, _mm256_set1_epi32(960)))));
+
+		const __m256i r = _mm256_add_epi32(minimum, Div255(_mm256_mullo_epi32(chroma, pureRed)));
+		const __m256i g = _mm256_add_epi32(minimum, Div255(_mm256_mullo_epi32(chroma, pureGreen)));
+		const __m256i b = _mm256_add_epi32(minimum, Div255(_mm256_mullo_epi32(chroma, pureBlue)));
+
+		const __m256i rgb = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(r, 16), _mm256_slli_epi32(g, 8)), b);
+		return _mm256_or_si256(_mm256_and_si256(pixels, _mm256_set1_epi32(static_cast<int>(0xFF000000u))), rgb);
+	}
+
+	CPUFEATURES_TARGET_AVX2
+	static inline __m256i Load(const uint32_t* source)
+	{
+		return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source));
+	}
+
+	CPUFEATURES_TARGET_AVX2
+	static inline void Store(uint32_t* target, __m256i value)
+	{
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(target), value);
+	}
+
+	CPUFEATURES_TARGET_AVX2
+	static inline __m256i LoadWords(const uint16_t* source)
+	{
+		return _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source)));
+	}
+
+	CPUFEATURES_TARGET_AVX2
+	static inline __m256i LoadBytes(const uint8_t* source)
+	{
+		return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(source)));
+	}
+
+	// packs works within 128-bit lanes; the permute moves the two packed
+	// quarters of the register next to each other.
+	CPUFEATURES_TARGET_AVX2
+	static inline __m128i PackWords(__m256i values)
+	{
+		return _mm256_castsi256_si128(_mm256_permute4x64_epi64(_mm256_packs_epi32(values, values), _MM_SHUFFLE(3, 1, 2, 0)));
+	}
+
+	CPUFEATURES_TARGET_AVX2
+	static inline void StoreWords(uint16_t* target, __m256i values)
+	{
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(target), PackWords(values));
+	}
+
+	CPUFEATURES_TARGET_AVX2
+	static inline void StoreBytes(uint8_t* target, __m256i values)
+	{
+		const __m128i words = PackWords(values);
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(target), _mm_packus_epi16(words, words));
+	}
+
+	CPUFEATURES_TARGET_AVX2
+	static void RgbToHsv(const uint32_t* pixels, uint16_t* hue, uint8_t* saturation, uint8_t* value, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256i r, g, b;
+			GetChannels(Load(pixels + i), r, g, b);
+
+			const __m256i max = _mm256_max_epi32(_mm256_max_epi32(r, g), b);
+			const __m256i delta = _mm256_sub_epi32(max, _mm256_min_epi32(_mm256_min_epi32(r, g), b));
+			const __m256i dividend = _mm256_add_epi32(_mm256_mullo_epi32(delta, _mm256_set1_epi32(255)), _mm256_srli_epi32(max, 1));
+
+			StoreWords(hue + i, GetHue(r, g, b, max, delta));
+			StoreBytes(saturation + i, Divide(dividend, _mm256_max_epi32(max, _mm256_set1_epi32(1))));
+			StoreBytes(value + i, max);
+		}
+
+		ScalarConversion::RgbToHsv(pixels + i, hue + i, saturation + i, value + i, count - i);
+	}
+
+	CPUFEATURES_TARGET_AVX2
+	static void HsvToRgb(const uint16_t* hue, const uint8_t* saturation, const uint8_t* value, uint32_t* pixels, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m256i v = LoadBytes(value + i);
+			const __m256i chroma = Div255(_mm256_mullo_epi32(v, LoadBytes(saturation + i)));
+
+			Store(pixels + i, GetPixels(Load(pixels + i), LoadWords(hue + i), chroma, _mm256_sub_epi32(v, chroma)));
+		}
+
+		ScalarConversion::HsvToRgb(hue + i, saturation + i, value + i, pixels + i, count - i);
+	}
+
+	CPUFEATURES_TARGET_AVX2
+	static void RgbToHsl(const uint32_t* pixels, uint16_t* hue, uint8_t* saturation, uint8_t* lightness, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256i r, g, b;
+			GetChannels(Load(pixels + i), r, g, b);
+
+			const __m256i max = _mm256_max_epi32(_mm256_max_epi32(r, g), b);
+			const __m256i min = _mm256_min_epi32(_mm256_min_epi32(r, g), b);
+			const __m256i delta = _mm256_sub_epi32(max, min);
+			const __m256i sum = _mm256_add_epi32(max, min);
+
+			__m256i range = _mm256_min_epi32(sum, _mm256_sub_epi32(_mm256_set1_epi32(510), sum));
+			range = _mm256_max_epi32(range, _mm256_set1_epi32(1));
+
+			const __m256i dividend = _mm256_add_epi32(_mm256_mullo_epi32(delta, _mm256_set1_epi32(255)), _mm256_srli_epi32(range, 1));
+
+			StoreWords(hue + i, GetHue(r, g, b, max, delta));
+			StoreBytes(saturation + i, Divide(dividend, range));
+			StoreBytes(lightness + i, _mm256_srli_epi32(_mm256_add_epi32(sum, _mm256_set1_epi32(1)), 1));
+		}
+
+		ScalarConversion::RgbToHsl(pixels + i, hue + i, saturation + i, lightness + i, count - i);
+	}
+
+	CPUFEATURES_TARGET_AVX2
+	static void HslToRgb(const uint16_t* hue, const uint8_t* saturation, const uint8_t* lightness, uint32_t* pixels, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m256i l = LoadBytes(lightness + i);
+			const __m256i distance = _mm256_abs_epi32(_mm256_sub_epi32(_mm256_add_epi32(l, l), _mm256_set1_epi32(255)));
+			const __m256i chroma = Div255(_mm256_mullo_epi32(_mm256_sub_epi32(_mm256_set1_epi32(255), distance), LoadBytes(saturation + i)));
+
+			Store(pixels + i, GetPixels(Load(pixels + i), LoadWords(hue + i), chroma, _mm256_sub_epi32(l, _mm256_srli_epi32(chroma, 1))));
+		}
+
+		ScalarConversion::HslToRgb(hue + i, saturation + i, lightness + i, pixels + i, count - i);
+	}
+
+	static const ColorConversion::Functions Functions =
+	{
+		RgbToHsv, HsvToRgb, RgbToHsl, HslToRgb
+	};
+}
+
+#endif
+
+#if defined(CPUFEATURES_NEON)
+
+// Eight pixels per iteration, de-interleaved by vld4 and widened to two
+// registers of 32-bit lanes. 32-bit NEON has no float division, so Divide
+// refines a reciprocal estimate and corrects the truncated quotient.
+namespace NeonConversion
+{
+	static inline int32x4_t Divide(int32x4_t dividend, int32x4_t divisor)
+	{
+		const float32x4_t d = vcvtq_f32_s32(divisor);
+
+		float32x4_t reciprocal = vrecpeq_f32(d);
+		reciprocal = vmulq_f32(vrecpsq_f32(d, reciprocal), reciprocal);
+		reciprocal = vmulq_f32(vrecpsq_f32(d, reciprocal), reciprocal);
+
+		// The estimate is at most one away from the quotient.
+		int32x4_t quotient = vcvtq_s32_f32(vmulq_f32(vcvtq_f32_s32(dividend), reciprocal));
+		const int32x4_t product = vmulq_s32(quotient, divisor);
+
+		quotient = vaddq_s32(quotient, vreinterpretq_s32_u32(vcgtq_s32(product, dividend)));
+		quotient = vsubq_s32(quotient, vreinterpretq_s32_u32(vcleq_s32(vaddq_s32(product, divisor), dividend)));
+
+		return quotient;
+	}
+
+	static inline int32x4_t Div255(int32x4_t x)
+	{
+		return vshrq_n_s32(vaddq_s32(vaddq_s32(vshrq_n_s32(x, 8), x), vdupq_n_s32(1)), 8);
+	}
+
+	static inline int32x4_t Ramp(int32x4_t x)
+	{
+		x = vminq_s32(vmaxq_s32(x, vdupq_n_s32(0)), vdupq_n_s32(240));
+		return vshrq_n_s32(vmulq_n_s32(x, 17), 4);
+	}
+
+	static inline int32x4_t WidenLow(uint8x8_t values)
+	{
+		return vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(vmovl_u8(values))));
+	}
+
+	static inline int32x4_t WidenHigh(uint8x8_t values)
+	{
+		return vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(vmovl_u8(values))));
+	}
+
+	static inline uint8x8_t Narrow(int32x4_t low, int32x4_t high)
+	{
+		return vmovn_u16(vcombine_u16(vmovn_u32(vreinterpretq_u32_s32(low)), vmovn_u32(vreinterpretq_u32_s32(high))));
+	}
+
+	static inline int32x4_t GetHue(int32x4_t r, int32x4_t g, int32x4_t b, int32x4_t max, int32x4_t delta)
+	{
+		const uint32x4_t isRed = vceqq_s32(max, r);
+		const uint32x4_t isGreen = vbicq_u32(vceqq_s32(max, g), isRed);
+
+		const int32x4_t base = vbslq_s32(isRed, vdupq_n_s32(0), vbslq_s32(isGreen, vdupq_n_s32(480), vdupq_n_s32(960)));
+		const int32x4_t difference = vbslq_s32(isRed, vsubq_s32(g, b), vbslq_s32(isGreen, vsubq_s32(b, r), vsubq_s32(r, g)));
+
+		const int32x4_t dividend = vaddq_s32(vmulq_n_s32(vabsq_s32(difference), 480), delta);
+		const int32x4_t divisor = vmaxq_s32(vaddq_s32(delta, delta), vdupq_n_s32(1));
+		const int32x4_t offset = Divide(dividend, divisor);
+
+		const int32x4_t hue = vaddq_s32(base, vbslq_s32(vcltq_s32(difference, vdupq_n_s32(0)), vnegq_s32(offset), offset));
+
+		return vaddq_s32(hue, vandq_s32(vshrq_n_s32(hue, 31), vdupq_n_s32(HueTable::Size)));
+	}
+
+	static inline void GetChannels(int32x4_t hue, int32x4_t chroma, int32x4_t minimum, int32x4_t& r, int32x4_t& g, int32x4_t& b)
+	{
+		const int32x4_t pureRed = Ramp(vsubq_s32(vabsq_s32(vsubq_s32(hue, vdupq_n_s32(720))), vdupq_n_s32(240)));
+		const int32x4_t pureGreen = Ramp(vsubq_s32(vdupq_n_s32(480), vabsq_s32(vsubq_s32(hue, vdupq_n_s32(480)))));
+		const int32x4_t pureBlue = Ramp(vsubq_s32(vdupq_n_s32(480), vabsq_s32(vsubq_s32(hue, vdupq_n_s32(960)))));
+
+		r = vaddq_s32(minimum, Div255(vmulq_s32(chroma, pureRed)));
+		g = vaddq_s32(minimum, Div255(vmulq_s32(chroma, pureGreen)));
+		b = vaddq_s32(minimum, Div255(vmulq_s32(chroma, pureBlue)));
+	}
+
+	static inline void StoreWords(uint16_t* target, int32x4_t low, int32x4_t high)
+	{
+		vst1q_u16(target, vcombine_u16(vmovn_u32(vreinterpretq_u32_s32(low)), vmovn_u32(vreinterpretq_u32_s32(high))));
+	}
+
+	static inline void LoadWords(const uint16_t* source, int32x4_t& low, int32x4_t& high)
+	{
+		const uint16x8_t words = vld1q_u16(source);
+		low = vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(words)));
+		high = vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(words)));
+	}
+
+	static void RgbToHsv(const uint32_t* pixels, uint16_t* hue, uint8_t* saturation, uint8_t* value, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			const uint8x8x4_t bgra = vld4_u8(reinterpret_cast<const uint8_t*>(pixels + i));
+			const uint8x8_t max8 = vmax_u8(vmax_u8(bgra.val[0], bgra.val[1]), bgra.val[2]);
+			const uint8x8_t delta8 = vsub_u8(max8, vmin_u8(vmin_u8(bgra.val[0], bgra.val[1]), bgra.val[2]));
+
+			int32x4_t h[2];
+			int32x4_t s[2];
+
+			for (int half = 0; half < 2; ++half)
+			{
+				int32x4_t (*widen)(uint8x8_t) = (half == 0) ? WidenLow : WidenHigh;
+
+				const int32x4_t max = widen(max8);
+				const int32x4_t delta = widen(delta8);
+
+				h[half] = GetHue(widen(bgra.val[2]), widen(bgra.val[1]), widen(bgra.val[0]), max, delta);
+				s[half] = Divide(vaddq_s32(vmulq_n_s32(delta, 255), vshrq_n_s32(max, 1)), vmaxq_s32(max, vdupq_n_s32(1)));
+			}
+
+			StoreWords(hue + i, h[0], h[1]);
+			vst1_u8(saturation + i, Narrow(s[0], s[1]));
+			vst1_u8(value + i, max8);
+		}
+
+		ScalarConversion::RgbToHsv(pixels + i, hue + i, saturation + i, value + i, count - i);
+	}
+
+	static void HsvToRgb(const uint16_t* hue, const uint8_t* saturation, const uint8_t* value, uint32_t* pixels, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			uint8x8x4_t bgra = vld4_u8(reinterpret_cast<const uint8_t*>(pixels + i));
+			const uint8x8_t s8 = vld1_u8(saturation + i);
+			const uint8x8_t v8 = vld1_u8(value + i);
+
+			int32x4_t h[2];
+			LoadWords(hue + i, h[0], h[1]);
+
+			int32x4_t r[2];
+			int32x4_t g[2];
+			int32x4_t b[2];
+
+			for (int half = 0; half < 2; ++half)
+			{
+				int32x4_t (*widen)(uint8x8_t) = (half == 0) ? WidenLow : WidenHigh;
+
+				const int32x4_t v = widen(v8);
+				const int32x4_t chroma = Div255(vmulq_s32(v, widen(s8)));
+
+				GetChannels(h[half], chroma, vsubq_s32(v, chroma), r[half], g[half], b[half]);
+			}
+
+			bgra.val[0] = Narrow(b[0], b[1]);
+			bgra.val[1] = Narrow(g[0], g[1]);
+			bgra.val[2] = Narrow(r[0], r[1]);
+			vst4_u8(reinterpret_cast<uint8_t*>(pixels + i), bgra);
+		}
+
+		ScalarConversion::HsvToRgb(hue + i, saturation + i, value + i, pixels + i, count - i);
+	}
+
+	static void RgbToHsl(const uint32_t* pixels, uint16_t* hue, uint8_t* saturation, uint8_t* lightness, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			const uint8x8x4_t bgra = vld4_u8(reinterpret_cast<const uint8_t*>(pixels + i));
+			const uint8x8_t max8 = vmax_u8(vmax_u8(bgra.val[0], bgra.val[1]), bgra.val[2]);
+			const uint8x8_t min8 = vmin_u8(vmin_u8(bgra.val[0], bgra.val[1]), bgra.val[2]);
+
+			int32x4_t h[2];
+			int32x4_t s[2];
+			int32x4_t l[2];
+
+			for (int half = 0; half < 2; ++half)
+			{
+				int32x4_t (*widen)(uint8x8_t) = (half == 0) ? WidenLow : WidenHigh;
+
+				const int32x4_t max = widen(max8);
+				const int32x4_t min = widen(min8);
+				const int32x4_t delta = vsubq_s32(max, min);
+				const int32x4_t sum = vaddq_s32(max, min);
+
+				int32x4_t range = vminq_s32(sum, vsubq_s32(vdupq_n_s32(510), sum));
+				range = vmaxq_s32(range, vdupq_n_s32(1));
+
+				h[half] = GetHue(widen(bgra.val[2]), widen(bgra.val[1]), widen(bgra.val[0]), max, delta);
+				s[half] = Divide(vaddq_s32(vmulq_n_s32(delta, 255), vshrq_n_s32(range, 1)), range);
+				l[half] = vshrq_n_s32(vaddq_s32(sum, vdupq_n_s32(1)), 1);
+			}
+
+			StoreWords(hue + i, h[0], h[1]);
+			vst1_u8(saturation + i, Narrow(s[0], s[1]));
+			vst1_u8(lightness + i, Narrow(l[0], l[1]));
+		}
+
+		ScalarConversion::RgbToHsl(pixels + i, hue + i, saturation + i, lightness + i, count - i);
+	}
+
+	static void HslToRgb(const uint16_t* hue, const uint8_t* saturation, const uint8_t* lightness, uint32_t* pixels, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			uint8x8x4_t bgra = vld4_u8(reinterpret_cast<const uint8_t*>(pixels + i));
+			const uint8x8_t s8 = vld1_u8(saturation + i);
+			const uint8x8_t l8 = vld1_u8(lightness + i);
+
+			int32x4_t h[2];
+			LoadWords(hue + i, h[0], h[1]);
+
+			int32x4_t r[2];
+			int32x4_t g[2];
+			int32x4_t b[2];
+
+			for (int half = 0; half < 2; ++half)
+			{
+				int32x4_t (*widen)(uint8x8_t) = (half == 0) ? WidenLow : WidenHigh;
+
+				const int32x4_t l = widen(l8);
+				const int32x4_t distance = vabsq_s32(vsubq_s32(vaddq_s32(l, l), vdupq_n_s32(255)));
+				const int32x4_t chroma = Div255(vmulq_s32(vsubq_s32(vdupq_n_s32(255), distance), widen(s8)));
+
+				GetChannels(h[half], chroma, vsubq_s32(l, vshrq_n_s32(chroma, 1)), r[half], g[half], b[half]);
+			}
+
+			bgra.val[0] = Narrow(b[0], b[1]);
+			bgra.val[1] = Narrow(g[0], g[1]);
+			bgra.val[2] = Narrow(r[0], r[1]);
+			vst4_u8(reinterpret_cast<uint8_t*>(pixels + i), bgra);
+		}
+
+		ScalarConversion::HslToRgb(hue + i, saturation + i, lightness + i, pixels + i, count - i);
+	}
+
+	static const ColorConversion::Functions Functions =
+	{
+		RgbToHsv, HsvToRgb, RgbToHsl, HslToRgb
+	};
+}
+
+#endif
+
+const ColorConversion::Functions* ColorConversion::GetFunctions(InstructionSet instructionSet)
+{
+	if (!IsSupported(instructionSet))
+	{
+		return nullptr;
+	}
+
+	switch (instructionSet)
+	{
+#if defined(CPUFEATURES_X86)
+	case InstructionSet::Sse2:
+		return &Sse2Conversion::Functions;
+	case InstructionSet::Avx2:
+		return &Avx2Conversion::Functions;
+#endif
+#if defined(CPUFEATURES_NEON)
+	case InstructionSet::Neon:
+		return &NeonConversion::Functions;
+#endif
+	default:
+		return &ScalarConversion::Functions;
+	}
+}
+
+static const ColorConversion::Functions& GetPreferredFunctions()
+{
+	static const ColorConversion::Functions* preferred = ColorConversion::GetFunctions(GetPreferredInstructionSet());
+	return *preferred;
+}
+
+void ColorConversion::RgbToHsv(const uint32_t* pixels, uint16_t* hue, uint8_t* saturation, uint8_t* value, uint32_t count)
+{
+	GetPreferredFunctions().RgbToHsv(pixels, hue, saturation, value, count);
+}
+
+void ColorConversion::HsvToRgb(const uint16_t* hue, const uint8_t* saturation, const uint8_t* value, uint32_t* pixels, uint32_t count)
+{
+	GetPreferredFunctions().HsvToRgb(hue, saturation, value, pixels, count);
+}
+
+void ColorConversion::RgbToHsl(const uint32_t* pixels, uint16_t* hue, uint8_t* saturation, uint8_t* lightness, uint32_t count)
+{
+	GetPreferredFunctions().RgbToHsl(pixels, hue, saturation, lightness, count);
+}
+
+void ColorConversion::HslToRgb(const uint16_t* hue, const uint8_t* saturation, const uint8_t* lightness, uint32_t* pixels, uint32_t count)
+{
+	GetPreferredFunctions().HslToRgb(hue, saturation, lightness, pixels, count);
+}
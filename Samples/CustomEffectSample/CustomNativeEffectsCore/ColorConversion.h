@@ -0,0 +1,47 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <cstdint>
+#include "CpuFeatures.h"
+
+namespace CustomNativeEffects {
+
+	// Span conversions between BGRA8888 pixels and planar HSV or HSL.
+	//
+	// Hue is in quarter degrees [0, HueTable::Size), saturation, value and
+	// lightness are in [0, 255]. Conversions to RGB take the pure color of the
+	// hue from HueTable and leave the alpha channel of the target pixels as it
+	// is, so a span can be converted, adjusted and converted back in place.
+	// Every implementation gives the same results as the scalar one.
+	namespace ColorConversion {
+
+		void RgbToHsv(const uint32_t* pixels, uint16_t* hue, uint8_t* saturation, uint8_t* value, uint32_t count);
+		void HsvToRgb(const uint16_t* hue, const uint8_t* saturation, const uint8_t* value, uint32_t* pixels, uint32_t count);
+
+		void RgbToHsl(const uint32_t* pixels, uint16_t* hue, uint8_t* saturation, uint8_t* lightness, uint32_t count);
+		void HslToRgb(const uint16_t* hue, const uint8_t* saturation, const uint8_t* lightness, uint32_t* pixels, uint32_t count);
+
+		// One implementation of every conversion.
+		struct Functions
+		{
+			void (*RgbToHsv)(const uint32_t* pixels, uint16_t* hue, uint8_t* saturation, uint8_t* value, uint32_t count);
+			void (*HsvToRgb)(const uint16_t* hue, const uint8_t* saturation, const uint8_t* value, uint32_t* pixels, uint32_t count);
+			void (*RgbToHsl)(const uint32_t* pixels, uint16_t* hue, uint8_t* saturation, uint8_t* lightness, uint32_t count);
+			void (*HslToRgb)(const uint16_t* hue, const uint8_t* saturation, const uint8_t* lightness, uint32_t* pixels, uint32_t count);
+		};
+
+		// Returns the implementations for the given instruction set, or nullptr if
+		// the current processor does not support it. The free functions above use
+		// the table for CpuFeatures::GetPreferredInstructionSet().
+		const Functions* GetFunctions(CpuFeatures::InstructionSet instructionSet);
+	}
+}
@@ -0,0 +1,268 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "ColorLut3D.h"
+#include <cmath>
+#include <locale>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using namespace CustomNativeEffects;
+
+ColorLut3D::ColorLut3D(int32_t size) :
+	m_size(size)
+{
+	if (size < MinimumSize || size > MaximumSize)
+	{
+		throw std::invalid_argument("size");
+	}
+
+	m_entries.resize(static_cast<size_t>(size) * size * size);
+
+	for (int32_t blue = 0; blue < size; ++blue)
+	{
+		for (int32_t green = 0; green < size; ++green)
+		{
+			for (int32_t red = 0; red < size; ++red)
+			{
+				Entry& entry = At(red, green, blue);
+				entry.Blue = GetNodeValue(blue);
+				entry.Green = GetNodeValue(green);
+				entry.Red = GetNodeValue(red);
+				entry.Reserved = 0;
+			}
+		}
+	}
+
+	BuildAxisTables();
+}
+
+int32_t ColorLut3D::GetSize() const
+{
+	return m_size;
+}
+
+ColorLut3D::Entry& ColorLut3D::At(int32_t red, int32_t green, int32_t blue)
+{
+	return m_entries[(static_cast<size_t>(blue) * m_size + green) * m_size + red];
+}
+
+const ColorLut3D::Entry& ColorLut3D::At(int32_t red, int32_t green, int32_t blue) const
+{
+	return m_entries[(static_cast<size_t>(blue) * m_size + green) * m_size + red];
+}
+
+const ColorLut3D::Entry* ColorLut3D::GetEntries() const
+{
+	return m_entries.data();
+}
+
+int32_t ColorLut3D::GetNodeLevel(int32_t node) const
+{
+	return (node * 255 * 2 + (m_size - 1)) / (2 * (m_size - 1));
+}
+
+int16_t ColorLut3D::GetNodeValue(int32_t node) const
+{
+	return static_cast<int16_t>((node * MaximumValue * 2 + (m_size - 1)) / (2 * (m_size - 1)));
+}
+
+void ColorLut3D::BuildAxisTables()
+{
+	const int32_t cells = m_size - 1;
+
+	for (int32_t level = 0; level < 256; ++level)
+	{
+		// level * cells / 255 as a cell index and a rounded fraction.
+		const int32_t position = level * cells;
+		int32_t cell = position / 255;
+		int32_t fraction = ((position % 255) * (1 << FractionShift) + 127) / 255;
+
+		if (cell == cells)
+		{
+			cell = cells - 1;
+			fraction = 1 << FractionShift;
+		}
+
+		m_redOffsets[level] = cell;
+		m_greenOffsets[level] = cell * m_size;
+		m_blueOffsets[level] = cell * m_size * m_size;
+		m_fractions[level] = fraction;
+	}
+}
+
+void ColorLut3D::Compile(const PointwiseChain& chain)
+{
+	const size_t count = m_entries.size();
+	std::vector<uint32_t> pixels(count);
+
+	for (int32_t blue = 0; blue < m_size; ++blue)
+	{
+		for (int32_t green = 0; green < m_size; ++green)
+		{
+			for (int32_t red = 0; red < m_size; ++red)
+			{
+				pixels[(static_cast<size_t>(blue) * m_size + green) * m_size + red] = 0xFF000000 |
+					(static_cast<uint32_t>(GetNodeLevel(red)) << 16) |
+					(static_cast<uint32_t>(GetNodeLevel(green)) << 8) |
+					static_cast<uint32_t>(GetNodeLevel(blue));
+			}
+		}
+	}
+
+	chain.ApplyRow(pixels.data(), pixels.data(), static_cast<uint32_t>(count));
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		const uint32_t pixel = pixels[i];
+
+		Entry& entry = m_entries[i];
+		entry.Blue = static_cast<int16_t>((pixel & 0xFF) << ValueShift);
+		entry.Green = static_cast<int16_t>(((pixel >> 8) & 0xFF) << ValueShift);
+		entry.Red = static_cast<int16_t>(((pixel >> 16) & 0xFF) << ValueShift);
+		entry.Reserved = 0;
+	}
+}
+
+static bool ReadTriple(std::istringstream& tokens, double values[3])
+{
+	return static_cast<bool>(tokens >> values[0] >> values[1] >> values[2]);
+}
+
+// Output values are in 0..1. The format allows values outside it, which are
+// clamped.
+static int16_t ToValue(double value)
+{
+	value = value < 0.0 ? 0.0 : (value > 1.0 ? 1.0 : value);
+
+	return static_cast<int16_t>(std::floor(value * ColorLut3D::MaximumValue + 0.5));
+}
+
+// The nodes are spread over input levels 0..255, which is the default 0..1
+// domain. Tables over any other input domain are rejected rather than
+// applied to the wrong colors.
+static bool IsDefaultDomain(const double minimum[3], const double maximum[3])
+{
+	for (int32_t channel = 0; channel < 3; ++channel)
+	{
+		if (minimum[channel] != 0.0 || maximum[channel] != 1.0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+ColorLut3D ColorLut3D::LoadCube(std::istream& stream)
+{
+	double minimum[3] = { 0.0, 0.0, 0.0 };
+	double maximum[3] = { 1.0, 1.0, 1.0 };
+	int32_t size = 0;
+
+	std::vector<Entry> entries;
+	std::string line;
+
+	while (std::getline(stream, line))
+	{
+		std::istringstream tokens(line);
+		tokens.imbue(std::locale::classic());
+
+		std::string keyword;
+
+		if (!(tokens >> keyword) || keyword[0] == '#')
+		{
+			continue;
+		}
+
+		const char first = keyword[0];
+
+		if ((first >= '0' && first <= '9') || first == '-' || first == '+' || first == '.')
+		{
+			if (size == 0)
+			{
+				throw std::invalid_argument("cube: data before LUT_3D_SIZE");
+			}
+
+			if (entries.empty() && !IsDefaultDomain(minimum, maximum))
+			{
+				throw std::invalid_argument("cube: only the 0..1 input domain is supported");
+			}
+
+			tokens.clear();
+			tokens.seekg(0);
+
+			double values[3];
+
+			if (!ReadTriple(tokens, values))
+			{
+				throw std::invalid_argument("cube: malformed data line");
+			}
+
+			if (entries.size() == static_cast<size_t>(size) * size * size)
+			{
+				throw std::invalid_argument("cube: too many data lines");
+			}
+
+			Entry entry;
+			entry.Red = ToValue(values[0]);
+			entry.Green = ToValue(values[1]);
+			entry.Blue = ToValue(values[2]);
+			entry.Reserved = 0;
+			entries.push_back(entry);
+		}
+		else if (keyword == "LUT_3D_SIZE")
+		{
+			if (size != 0 || !(tokens >> size) || size < MinimumSize || size > MaximumSize)
+			{
+				throw std::invalid_argument("cube: invalid LUT_3D_SIZE");
+			}
+
+			entries.reserve(static_cast<size_t>(size) * size * size);
+		}
+		else if (keyword == "DOMAIN_MIN" || keyword == "DOMAIN_MAX")
+		{
+			if (!entries.empty() || !ReadTriple(tokens, keyword == "DOMAIN_MIN" ? minimum : maximum))
+			{
+				throw std::invalid_argument("cube: invalid domain");
+			}
+		}
+		else if (keyword == "LUT_3D_INPUT_RANGE")
+		{
+			double range[2];
+
+			if (!entries.empty() || !(tokens >> range[0] >> range[1]))
+			{
+				throw std::invalid_argument("cube: invalid LUT_3D_INPUT_RANGE");
+			}
+
+			minimum[0] = minimum[1] = minimum[2] = range[0];
+			maximum[0] = maximum[1] = maximum[2] = range[1];
+		}
+		else if (keyword == "LUT_1D_SIZE" || keyword == "LUT_1D_INPUT_RANGE")
+		{
+			throw std::invalid_argument("cube: 1D tables are not supported");
+		}
+		else if (keyword != "TITLE")
+		{
+			throw std::invalid_argument("cube: unknown keyword");
+		}
+	}
+
+	if (size == 0 || entries.size() != static_cast<size_t>(size) * size * size)
+	{
+		throw std::invalid_argument("cube: missing data lines");
+	}
+
+	ColorLut3D lut(size);
+	lut.m_entries.swap(entries);
+	return lut;
+}
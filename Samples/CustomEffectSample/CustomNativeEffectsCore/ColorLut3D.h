@@ -0,0 +1,107 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <vector>
+#include "PointwiseChain.h"
+
+namespace CustomNativeEffects {
+
+	// A 3D color lookup table: the output color for every node of a
+	// Size x Size x Size grid over the input RGB cube, from which
+	// ColorLutKernel interpolates the colors in between.
+	//
+	// Nodes are stored in .cube order, red varying fastest, then green, then
+	// blue. Along every axis, node i stands for the input level
+	// round(i * 255 / (Size - 1)). Output channels are kept in 1/16 levels so
+	// that tables loaded from .cube files keep some of their precision.
+	class ColorLut3D final
+	{
+	public:
+		static const int32_t MinimumSize = 2;
+
+		// The largest size the .cube format allows.
+		static const int32_t MaximumSize = 256;
+
+		// Sizes with a node on every 8th and every 4th input level.
+		static const int32_t DefaultSize = 33;
+		static const int32_t LargeSize = 65;
+
+		static const int32_t ValueShift = 4;
+		static const int32_t MaximumValue = 255 << ValueShift;
+
+		// Interpolation fractions are in 1/256 of a cell.
+		static const int32_t FractionShift = 8;
+
+		struct Entry
+		{
+			int16_t Blue;
+			int16_t Green;
+			int16_t Red;
+			int16_t Reserved;
+		};
+
+		// The identity table of the given size, exact to the output precision. Throws std::invalid_argument if
+		// the size is outside [MinimumSize, MaximumSize].
+		explicit ColorLut3D(int32_t size);
+
+		int32_t GetSize() const;
+
+		Entry& At(int32_t red, int32_t green, int32_t blue);
+		const Entry& At(int32_t red, int32_t green, int32_t blue) const;
+
+		const Entry* GetEntries() const;
+
+		// The input level node i stands for.
+		int32_t GetNodeLevel(int32_t node) const;
+
+		// Where an input level falls on the grid: the offset of the cell's
+		// first node along an axis, which already includes the axis stride, and
+		// the fraction of the cell past it. The last node is reached as
+		// fraction 1 << FractionShift of the cell before it, so that the cell's
+		// far corner is always inside the table.
+		int32_t GetRedOffset(uint32_t level) const { return m_redOffsets[level]; }
+		int32_t GetGreenOffset(uint32_t level) const { return m_greenOffsets[level]; }
+		int32_t GetBlueOffset(uint32_t level) const { return m_blueOffsets[level]; }
+		int32_t GetFraction(uint32_t level) const { return m_fractions[level]; }
+
+		// Replaces every node with the chain's result for the node's color.
+		//
+		// A chain of any length then costs one lookup per pixel. The chain only
+		// takes 8-bit colors, so it is sampled at the nearest input level of
+		// every node. For the sample's color effects the interpolated result is
+		// within 2 levels of running the chain for nearly all colors, and never
+		// more than 3 off.
+		void Compile(const PointwiseChain& chain);
+
+		// Reads a table in the Adobe/Resolve .cube format: an optional TITLE,
+		// LUT_3D_SIZE, optional DOMAIN_MIN/DOMAIN_MAX or LUT_3D_INPUT_RANGE, then
+		// one "r g b" line per node. Output values are clamped to 0..1.
+		// Throws std::invalid_argument if the stream is not a valid 3D .cube
+		// table; 1D tables and input domains other than 0..1 are not supported.
+		static ColorLut3D LoadCube(std::istream& stream);
+
+	private:
+		// The exact output value of the identity table at node i.
+		int16_t GetNodeValue(int32_t node) const;
+
+		void BuildAxisTables();
+
+		int32_t m_size;
+		std::vector<Entry> m_entries;
+		int32_t m_redOffsets[256];
+		int32_t m_greenOffsets[256];
+		int32_t m_blueOffsets[256];
+		int32_t m_fractions[256];
+	};
+}
@@ -0,0 +1,61 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "ColorLutCache.h"
+
+using namespace CustomNativeEffects;
+
+size_t ColorLutCache::KeyHash::operator()(const Key& key) const
+{
+	return static_cast<size_t>(key.ParameterHash ^ (static_cast<uint64_t>(key.Size) * 0x9E3779B97F4A7C15ull));
+}
+
+ColorLutCache& ColorLutCache::GetInstance()
+{
+	static ColorLutCache instance;
+	return instance;
+}
+
+ColorLutCache::ColorLutCache() :
+	m_luts(DefaultCapacity)
+{
+}
+
+ColorLutCache::SharedLut ColorLutCache::GetLut(const PointwiseChain& chain, int32_t size)
+{
+	const Key key = { chain.GetParameterHash(), size };
+
+	return m_luts.GetOrCreate(key, [&chain, size]()
+	{
+		auto lut = std::make_shared<ColorLut3D>(size);
+		lut->Compile(chain);
+		return SharedLut(lut);
+	});
+}
+
+size_t ColorLutCache::GetCapacity() const
+{
+	return m_luts.GetCapacity();
+}
+
+void ColorLutCache::SetCapacity(size_t capacity)
+{
+	m_luts.SetCapacity(capacity);
+}
+
+void ColorLutCache::Clear()
+{
+	m_luts.Clear();
+}
+
+ColorLutCache::Statistics ColorLutCache::GetStatistics() const
+{
+	return m_luts.GetStatistics();
+}
@@ -0,0 +1,74 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "ColorLut3D.h"
+#include "LruCache.h"
+#include "PointwiseChain.h"
+
+namespace CustomNativeEffects {
+
+	// Process-wide cache of the 3D lookup tables compiled from pointwise
+	// chains, keyed on the chain's parameter hash and the table size.
+	//
+	// Renders of the same preset share one immutable table instead of each
+	// sampling the chain again. A 65-node table takes about 2 MB, so only a
+	// few are kept.
+	class ColorLutCache final
+	{
+	public:
+		typedef std::shared_ptr<const ColorLut3D> SharedLut;
+
+		struct Key
+		{
+			uint64_t ParameterHash;
+			int32_t Size;
+
+			bool operator==(const Key& other) const
+			{
+				return ParameterHash == other.ParameterHash && Size == other.Size;
+			}
+		};
+
+		struct KeyHash
+		{
+			size_t operator()(const Key& key) const;
+		};
+
+		typedef LruCache<Key, SharedLut, KeyHash>::Statistics Statistics;
+
+		static const size_t DefaultCapacity = 8;
+
+		static ColorLutCache& GetInstance();
+
+		ColorLutCache();
+
+		ColorLutCache(const ColorLutCache&) = delete;
+
+		ColorLutCache& operator=(const ColorLutCache&) = delete;
+
+		// The table of the given size compiled from chain, compiling it on a miss.
+		SharedLut GetLut(const PointwiseChain& chain, int32_t size);
+
+		size_t GetCapacity() const;
+		void SetCapacity(size_t capacity);
+
+		void Clear();
+
+		Statistics GetStatistics() const;
+
+	private:
+		LruCache<Key, SharedLut, KeyHash> m_luts;
+	};
+}
@@ -0,0 +1,292 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "ColorLutKernel.h"
+
+#if defined(CPUFEATURES_X86)
+#include <emmintrin.h>
+#elif defined(CPUFEATURES_NEON)
+#include <arm_neon.h>
+#endif
+
+using namespace CustomNativeEffects;
+using namespace CustomNativeEffects::ColorLutKernel;
+using namespace CpuFeatures;
+
+static const uint32_t AlphaMask = 0xFF000000;
+static const int32_t ResultShift = ColorLut3D::FractionShift + ColorLut3D::ValueShift;
+static const int32_t Rounding = 1 << (ResultShift - 1);
+
+namespace {
+
+	// The four corners of the tetrahedron a color falls in, from the cell's
+	// first node to its last, and the weights of the three steps between
+	// them, in decreasing order.
+	struct Tetrahedron
+	{
+		const ColorLut3D::Entry* Corners[4];
+		int32_t Weights[3];
+	};
+}
+
+static inline void Locate(const ColorLut3D& lut, uint32_t pixel, Tetrahedron& tetrahedron)
+{
+	const uint32_t red = (pixel >> 16) & 0xFF;
+	const uint32_t green = (pixel >> 8) & 0xFF;
+	const uint32_t blue = pixel & 0xFF;
+
+	const int32_t redStep = 1;
+	const int32_t greenStep = lut.GetSize();
+	const int32_t blueStep = greenStep * greenStep;
+
+	const int32_t fractionRed = lut.GetFraction(red);
+	const int32_t fractionGreen = lut.GetFraction(green);
+	const int32_t fractionBlue = lut.GetFraction(blue);
+
+	const ColorLut3D::Entry* first = lut.GetEntries() + lut.GetRedOffset(red) + lut.GetGreenOffset(green) + lut.GetBlueOffset(blue);
+
+	int32_t firstStep;
+	int32_t secondStep;
+
+	if (fractionRed > fractionGreen)
+	{
+		if (fractionGreen > fractionBlue)
+		{
+			firstStep = redStep;
+			secondStep = greenStep;
+			tetrahedron.Weights[0] = fractionRed;
+			tetrahedron.Weights[1] = fractionGreen;
+			tetrahedron.Weights[2] = fractionBlue;
+		}
+		else if (fractionRed > fractionBlue)
+		{
+			firstStep = redStep;
+			secondStep = blueStep;
+			tetrahedron.Weights[0] = fractionRed;
+			tetrahedron.Weights[1] = fractionBlue;
+			tetrahedron.Weights[2] = fractionGreen;
+		}
+		else
+		{
+			firstStep = blueStep;
+			secondStep = redStep;
+			tetrahedron.Weights[0] = fractionBlue;
+			tetrahedron.Weights[1] = fractionRed;
+			tetrahedron.Weights[2] = fractionGreen;
+		}
+	}
+	else
+	{
+		if (fractionBlue > fractionGreen)
+		{
+			firstStep = blueStep;
+			secondStep = greenStep;
+			tetrahedron.Weights[0] = fractionBlue;
+			tetrahedron.Weights[1] = fractionGreen;
+			tetrahedron.Weights[2] = fractionRed;
+		}
+		else if (fractionBlue > fractionRed)
+		{
+			firstStep = greenStep;
+			secondStep = blueStep;
+			tetrahedron.Weights[0] = fractionGreen;
+			tetrahedron.Weights[1] = fractionBlue;
+			tetrahedron.Weights[2] = fractionRed;
+		}
+		else
+		{
+			firstStep = greenStep;
+			secondStep = redStep;
+			tetrahedron.Weights[0] = fractionGreen;
+			tetrahedron.Weights[1] = fractionRed;
+			tetrahedron.Weights[2] = fractionBlue;
+		}
+	}
+
+	tetrahedron.Corners[0] = first;
+	tetrahedron.Corners[1] = first + firstStep;
+	tetrahedron.Corners[2] = first + firstStep + secondStep;
+	tetrahedron.Corners[3] = first + redStep + greenStep + blueStep;
+}
+
+// first * 2^FractionShift + w0 * (c1 - c0) + w1 * (c2 - c1) + w2 * (c3 - c2),
+// rounded. The weights decrease, so this is a convex blend of the corners
+// and stays within [0, MaximumValue] before the shift.
+static inline uint32_t Blend(int32_t c0, int32_t c1, int32_t c2, int32_t c3, const int32_t weights[3])
+{
+	const int32_t sum = (c0 << ColorLut3D::FractionShift) + weights[0] * (c1 - c0) + weights[1] * (c2 - c1) + weights[2] * (c3 - c2);
+	return static_cast<uint32_t>((sum + Rounding) >> ResultShift);
+}
+
+void ColorLutKernel::ApplyRowReference(const ColorLut3D& lut, const uint32_t* sourcePixels, uint32_t* targetPixels, uint32_t count)
+{
+	for (uint32_t x = 0; x < count; ++x)
+	{
+		const uint32_t pixel = sourcePixels[x];
+
+		Tetrahedron tetrahedron;
+		Locate(lut, pixel, tetrahedron);
+
+		const ColorLut3D::Entry* const* corners = tetrahedron.Corners;
+
+		const uint32_t red = Blend(corners[0]->Red, corners[1]->Red, corners[2]->Red, corners[3]->Red, tetrahedron.Weights);
+		const uint32_t green = Blend(corners[0]->Green, corners[1]->Green, corners[2]->Green, corners[3]->Green, tetrahedron.Weights);
+		const uint32_t blue = Blend(corners[0]->Blue, corners[1]->Blue, corners[2]->Blue, corners[3]->Blue, tetrahedron.Weights);
+
+		targetPixels[x] = (pixel & AlphaMask) | (red << 16) | (green << 8) | blue;
+	}
+}
+
+#if defined(CPUFEATURES_X86)
+
+// The four channels of one pixel as 32-bit sums, blended with two
+// _mm_madd_epi16: the corner entries are (blue, green, red, 0) words, which
+// is also the pixel's byte order.
+static inline __m128i BlendSse2(const Tetrahedron& tetrahedron, __m128i rounding)
+{
+	__m128i c0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(tetrahedron.Corners[0]));
+	__m128i c1 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(tetrahedron.Corners[1]));
+	__m128i c2 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(tetrahedron.Corners[2]));
+	__m128i c3 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(tetrahedron.Corners[3]));
+
+	__m128i firstSteps = _mm_unpacklo_epi16(_mm_sub_epi16(c1, c0), _mm_sub_epi16(c2, c1));
+	__m128i lastSteps = _mm_unpacklo_epi16(_mm_sub_epi16(c3, c2), c0);
+
+	__m128i firstWeights = _mm_set1_epi32((tetrahedron.Weights[1] << 16) | tetrahedron.Weights[0]);
+	__m128i lastWeights = _mm_set1_epi32((1 << (16 + ColorLut3D::FractionShift)) | tetrahedron.Weights[2]);
+
+	__m128i sums = _mm_add_epi32(_mm_madd_epi16(firstSteps, firstWeights), _mm_madd_epi16(lastSteps, lastWeights));
+	return _mm_srai_epi32(_mm_add_epi32(sums, rounding), ResultShift);
+}
+
+// Four pixels per iteration.
+static void ApplyRowSse2(const ColorLut3D& lut, const uint32_t* sourcePixels, uint32_t* targetPixels, uint32_t count)
+{
+	const __m128i rounding = _mm_set1_epi32(Rounding);
+	const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(AlphaMask));
+
+	uint32_t x = 0;
+
+	for (; x + 4 <= count; x += 4)
+	{
+		__m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sourcePixels + x));
+
+		__m128i results[4];
+
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			Tetrahedron tetrahedron;
+			Locate(lut, sourcePixels[x + i], tetrahedron);
+			results[i] = BlendSse2(tetrahedron, rounding);
+		}
+
+		__m128i colors = _mm_packus_epi16(_mm_packs_epi32(results[0], results[1]), _mm_packs_epi32(results[2], results[3]));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(targetPixels + x), _mm_or_si128(colors, _mm_and_si128(pixels, alphaMask)));
+	}
+
+	ApplyRowReference(lut, sourcePixels + x, targetPixels + x, count - x);
+}
+
+#endif
+
+#if defined(CPUFEATURES_NEON)
+
+static inline int16x4_t BlendNeon(const Tetrahedron& tetrahedron)
+{
+	int16x4_t c0 = vld1_s16(&tetrahedron.Corners[0]->Blue);
+	int16x4_t c1 = vld1_s16(&tetrahedron.Corners[1]->Blue);
+	int16x4_t c2 = vld1_s16(&tetrahedron.Corners[2]->Blue);
+	int16x4_t c3 = vld1_s16(&tetrahedron.Corners[3]->Blue);
+
+	int32x4_t sums = vshll_n_s16(c0, ColorLut3D::FractionShift);
+	sums = vmlal_n_s16(sums, vsub_s16(c1, c0), static_cast<int16_t>(tetrahedron.Weights[0]));
+	sums = vmlal_n_s16(sums, vsub_s16(c2, c1), static_cast<int16_t>(tetrahedron.Weights[1]));
+	sums = vmlal_n_s16(sums, vsub_s16(c3, c2), static_cast<int16_t>(tetrahedron.Weights[2]));
+
+	return vrshrn_n_s32(sums, ResultShift);
+}
+
+// Four pixels per iteration.
+static void ApplyRowNeon(const ColorLut3D& lut, const uint32_t* sourcePixels, uint32_t* targetPixels, uint32_t count)
+{
+	const uint32x4_t alphaMask = vdupq_n_u32(AlphaMask);
+
+	uint32_t x = 0;
+
+	for (; x + 4 <= count; x += 4)
+	{
+		uint32x4_t pixels = vld1q_u32(sourcePixels + x);
+
+		int16x4_t results[4];
+
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			Tetrahedron tetrahedron;
+			Locate(lut, sourcePixels[x + i], tetrahedron);
+			results[i] = BlendNeon(tetrahedron);
+		}
+
+		uint8x8_t low = vqmovun_s16(vcombine_s16(results[0], results[1]));
+		uint8x8_t high = vqmovun_s16(vcombine_s16(results[2], results[3]));
+		uint32x4_t colors = vreinterpretq_u32_u8(vcombine_u8(low, high));
+
+		vst1q_u32(targetPixels + x, vorrq_u32(colors, vandq_u32(pixels, alphaMask)));
+	}
+
+	ApplyRowReference(lut, sourcePixels + x, targetPixels + x, count - x);
+}
+
+#endif
+
+RowFunction ColorLutKernel::GetRowFunction(InstructionSet instructionSet)
+{
+	if (!IsSupported(instructionSet))
+	{
+		return nullptr;
+	}
+
+	switch (instructionSet)
+	{
+#if defined(CPUFEATURES_X86)
+	case InstructionSet::Sse2:
+	case InstructionSet::Avx2:
+		// The nodes are read one pixel at a time, so wider vectors would only
+		// add shuffles; AVX2 uses the SSE2 path.
+		return ApplyRowSse2;
+#endif
+#if defined(CPUFEATURES_NEON)
+	case InstructionSet::Neon:
+		return ApplyRowNeon;
+#endif
+	default:
+		return ApplyRowReference;
+	}
+}
+
+RowFunction ColorLutKernel::GetRowFunction()
+{
+	static const RowFunction preferred = GetRowFunction(GetPreferredInstructionSet());
+	return preferred;
+}
+
+void ColorLutKernel::ApplyRegion(const CpuWorkerRegion& region, const ColorLut3D& lut, RowFunction rowFunction)
+{
+	const uint32_t* sourcePixels = region.SourcePixels;
+	uint32_t* targetPixels = region.TargetPixels;
+
+	for (int32_t y = 0; y < region.Height; ++y)
+	{
+		rowFunction(lut, sourcePixels, targetPixels, region.GetVectorRowLength(y, VectorPixels));
+
+		sourcePixels += region.SourcePitch;
+		targetPixels += region.TargetPitch;
+	}
+}
@@ -0,0 +1,54 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <cstdint>
+#include "ColorLut3D.h"
+#include "CpuFeatures.h"
+#include "CpuWorkerRegion.h"
+
+namespace CustomNativeEffects {
+
+	// Maps BGRA8888 pixels through a ColorLut3D on the CPU.
+	//
+	// Colors between the nodes are interpolated tetrahedrally: the cell around
+	// the color is split into six tetrahedra along its gray diagonal, and the
+	// color is blended from the four corners of the one it falls in. That
+	// needs four nodes per pixel instead of the eight of trilinear
+	// interpolation and keeps neutral colors on the diagonal. Alpha is passed
+	// through.
+	//
+	// Finding the tetrahedron is scalar, as every pixel reads its own nodes;
+	// the vector paths blend all channels of a pixel at once and pack several
+	// pixels per store. All paths are bit-exact with
+	// ColorLutKernel::ApplyRowReference.
+	namespace ColorLutKernel {
+
+		typedef void (*RowFunction)(const ColorLut3D& lut, const uint32_t* sourcePixels, uint32_t* targetPixels, uint32_t count);
+
+		// Scalar reference implementation; every vector path must match it exactly.
+		void ApplyRowReference(const ColorLut3D& lut, const uint32_t* sourcePixels, uint32_t* targetPixels, uint32_t count);
+
+		// Returns the row function for the given instruction set, or nullptr if the
+		// current processor does not support it.
+		RowFunction GetRowFunction(CpuFeatures::InstructionSet instructionSet);
+
+		// Returns the fastest row function for the current processor.
+		RowFunction GetRowFunction();
+
+		// Row lengths are rounded up to a multiple of this, which every row
+		// function's vector width divides, so that no scalar tail is left.
+		const int32_t VectorPixels = 4;
+
+		// Maps every row of the region.
+		void ApplyRegion(const CpuWorkerRegion& region, const ColorLut3D& lut, RowFunction rowFunction);
+	}
+}
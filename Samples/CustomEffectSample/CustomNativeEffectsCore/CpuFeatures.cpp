@@ -0,0 +1,139 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+
+#include "CpuFeatures.h"
+
+#if defined(CPUFEATURES_X86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+using namespace CustomNativeEffects;
+using namespace CustomNativeEffects::CpuFeatures;
+
+#if defined(CPUFEATURES_X86)
+
+static void QueryCpuId(unsigned int leaf, unsigned int subLeaf, unsigned int registers[4])
+{
+#if defined(_MSC_VER)
+	int values[4];
+	__cpuidex(values, static_cast<int>(leaf), static_cast<int>(subLeaf));
+
+	for (int i = 0; i < 4; ++i)
+	{
+		registers[i] = static_cast<unsigned int>(values[i]);
+	}
+#else
+	if (!__get_cpuid_count(leaf, subLeaf, &registers[0], &registers[1], &registers[2], &registers[3]))
+	{
+		registers[0] = registers[1] = registers[2] = registers[3] = 0;
+	}
+#endif
+}
+
+static unsigned long long ReadExtendedControlRegister()
+{
+#if defined(_MSC_VER)
+	return _xgetbv(0);
+#else
+	unsigned int eax = 0;
+	unsigned int edx = 0;
+	__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+	return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+}
+
+static bool DetectAvx2()
+{
+	unsigned int registers[4];
+
+	QueryCpuId(0, 0, registers);
+	if (registers[0] < 7)
+	{
+		return false;
+	}
+
+	// AVX needs both the CPU flag and the OS saving the YMM state (OSXSAVE + XCR0 bits 1 and 2).
+	QueryCpuId(1, 0, registers);
+	const bool osxsave = (registers[2] & (1u << 27)) != 0;
+	const bool avx = (registers[2] & (1u << 28)) != 0;
+
+	if (!osxsave || !avx || (ReadExtendedControlRegister() & 0x6) != 0x6)
+	{
+		return false;
+	}
+
+	QueryCpuId(7, 0, registers);
+	return (registers[1] & (1u << 5)) != 0;
+}
+
+#endif
+
+bool CpuFeatures::IsSupported(InstructionSet instructionSet)
+{
+	switch (instructionSet)
+	{
+	case InstructionSet::Scalar:
+		return true;
+
+#if defined(CPUFEATURES_X86)
+	case InstructionSet::Sse2:
+		// SSE2 is part of the baseline for every x86 target we build for.
+		return true;
+
+	case InstructionSet::Avx2:
+	{
+		static const bool hasAvx2 = DetectAvx2();
+		return hasAvx2;
+	}
+#endif
+
+#if defined(CPUFEATURES_NEON)
+	case InstructionSet::Neon:
+		// NEON is mandatory on Windows on ARM, and CPUFEATURES_NEON is only
+		// defined elsewhere when the compiler already targets it.
+		return true;
+#endif
+
+	default:
+		return false;
+	}
+}
+
+InstructionSet CpuFeatures::GetPreferredInstructionSet()
+{
+	static const InstructionSet preferred =
+		IsSupported(InstructionSet::Avx2) ? InstructionSet::Avx2 :
+		IsSupported(InstructionSet::Neon) ? InstructionSet::Neon :
+		IsSupported(InstructionSet::Sse2) ? InstructionSet::Sse2 :
+		InstructionSet::Scalar;
+
+	return preferred;
+}
+
+const char* CpuFeatures::GetName(InstructionSet instructionSet)
+{
+	switch (instructionSet)
+	{
+	case InstructionSet::Sse2:
+		return "SSE2";
+	case InstructionSet::Avx2:
+		return "AVX2";
+	case InstructionSet::Neon:
+		return "NEON";
+	default:
+		return "Scalar";
+	}
+}
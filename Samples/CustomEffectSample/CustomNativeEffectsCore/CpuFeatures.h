@@ -0,0 +1,51 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define CPUFEATURES_X86 1
+#elif defined(_M_ARM) || defined(_M_ARM64) || defined(__ARM_NEON)
+#define CPUFEATURES_NEON 1
+#endif
+
+// Marks a function that is compiled for AVX2 even when the rest of the
+// translation unit targets the baseline instruction set. MSVC accepts AVX2
+// intrinsics anywhere, GCC and Clang need the per-function target.
+#if defined(CPUFEATURES_X86) && (defined(__GNUC__) || defined(__clang__))
+#define CPUFEATURES_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define CPUFEATURES_TARGET_AVX2
+#endif
+
+namespace CustomNativeEffects {
+
+	namespace CpuFeatures {
+		// Instruction sets the pixel kernels have implementations for, ordered
+		// from the most portable to the most capable.
+		enum class InstructionSet
+		{
+			Scalar,
+			Sse2,
+			Avx2,
+			Neon
+		};
+
+		// Returns true if the current processor (and OS) can execute code
+		// compiled for the given instruction set.
+		bool IsSupported(InstructionSet instructionSet);
+
+		// Returns the most capable instruction set supported by the current
+		// processor. The result is detected once and cached.
+		InstructionSet GetPreferredInstructionSet();
+
+		const char* GetName(InstructionSet instructionSet);
+	}
+}
@@ -0,0 +1,114 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <cstdint>
+
+namespace CustomNativeEffects {
+
+	// The source and target pixels a CPU worker processes in one call.
+	// Pitches are in pixels. The source usually lives inside a larger image
+	// (SourceStartIndex/SourcePitch), the target is normally packed.
+	//
+	// Besides the layout, SourceTailPixels/TargetTailPixels tell kernels how
+	// many pixels past the end of the last row may be read (source) or
+	// overwritten (target). Kernels use GetVectorRowLength to run full vectors
+	// over a row instead of finishing it with a scalar epilogue.
+	struct CpuWorkerRegion
+	{
+		CpuWorkerRegion() :
+			SourcePixels(nullptr),
+			SourcePitch(0),
+			TargetPixels(nullptr),
+			TargetPitch(0),
+			Width(0),
+			Height(0),
+			SourceTailPixels(0),
+			TargetTailPixels(0)
+		{
+		}
+
+		const uint32_t* SourcePixels;
+		int32_t SourcePitch;
+		uint32_t* TargetPixels;
+		int32_t TargetPitch;
+		int32_t Width;
+		int32_t Height;
+		int32_t SourceTailPixels;
+		int32_t TargetTailPixels;
+
+		// Describes width x height pixels read from source and written to target.
+		// The tails count the pixels past the end of each last row that may be
+		// touched.
+		static CpuWorkerRegion Create(
+			const uint32_t* sourcePixels, int32_t sourcePitch, int32_t sourceTailPixels,
+			uint32_t* targetPixels, int32_t targetPitch, int32_t targetTailPixels,
+			int32_t width, int32_t height)
+		{
+			CpuWorkerRegion region;
+			region.SourcePixels = sourcePixels;
+			region.SourcePitch = sourcePitch;
+			region.TargetPixels = targetPixels;
+			region.TargetPitch = targetPitch;
+			region.Width = width;
+			region.Height = height;
+			region.SourceTailPixels = sourceTailPixels;
+			region.TargetTailPixels = targetTailPixels;
+			return region;
+		}
+
+		// Returns the given rows as a region of their own. Rows after the slice may
+		// belong to another thread, so the target tail is only kept for the slice
+		// that ends the region; the source tail grows by the rows that follow.
+		CpuWorkerRegion Rows(int32_t firstRow, int32_t rowCount) const
+		{
+			CpuWorkerRegion rows = *this;
+			rows.SourcePixels += static_cast<intptr_t>(firstRow) * SourcePitch;
+			rows.TargetPixels += static_cast<intptr_t>(firstRow) * TargetPitch;
+			rows.Height = rowCount;
+
+			const int32_t rowsAfter = Height - firstRow - rowCount;
+			if (rowsAfter > 0)
+			{
+				rows.SourceTailPixels = SourceTailPixels + rowsAfter * SourcePitch;
+				rows.TargetTailPixels = 0;
+			}
+
+			return rows;
+		}
+
+		// Number of pixels a kernel may process for the given row: the width rounded
+		// up to vectorPixels when the overrun stays within the region and its tails,
+		// the exact width otherwise. Overrun pixels of one row land in the rows that
+		// follow it, which the same thread overwrites afterwards.
+		//
+		// That does not hold in place: the overrun would update the next row's
+		// pixels before that row reads them, so they would be processed twice.
+		// In-place rows other than the last only round up into their own pitch
+		// padding.
+		int32_t GetVectorRowLength(int32_t row, int32_t vectorPixels) const
+		{
+			const int32_t padded = (Width + vectorPixels - 1) / vectorPixels * vectorPixels;
+			const int64_t overrun = padded - Width;
+
+			if (SourcePixels == TargetPixels && row < Height - 1)
+			{
+				const int64_t padding = static_cast<int64_t>(SourcePitch < TargetPitch ? SourcePitch : TargetPitch) - Width;
+				return (overrun <= padding) ? padded : Width;
+			}
+
+			const int64_t sourceSlack = static_cast<int64_t>(Height - 1 - row) * SourcePitch + SourceTailPixels;
+			const int64_t targetSlack = static_cast<int64_t>(Height - 1 - row) * TargetPitch + TargetTailPixels;
+
+			return (overrun <= sourceSlack && overrun <= targetSlack) ? padded : Width;
+		}
+	};
+}
@@ -0,0 +1,316 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "FramePipeline.h"
+#include <algorithm>
+#include <stdexcept>
+
+using namespace CustomNativeEffects;
+
+const std::chrono::microseconds FramePipeline::LatencyResolution(250);
+
+namespace {
+
+	// Latencies of a second and more share the last bucket.
+	const size_t LatencyBucketCount = 4000;
+}
+
+FramePipeline::FramePipeline(int32_t width, int32_t height, const FrameFunction& process, const OutputFunction& output, const Options& options) :
+	m_slots(std::max<uint32_t>(options.FrameCount, 1)),
+	m_freeSlots(m_slots.size()),
+	m_pendingSlots(m_slots.size()),
+	m_processedSlots(m_slots.size()),
+	m_process(process),
+	m_output(output),
+	m_latencyBudget(options.LatencyBudget),
+	m_nextSequence(0),
+	m_submittedCount(0),
+	m_completedCount(0),
+	m_statistics(),
+	m_totalLatency(0),
+	m_latencyHistogram(LatencyBucketCount, 0)
+{
+	if (!process || !output)
+	{
+		throw std::invalid_argument("FramePipeline");
+	}
+
+	for (uint32_t i = 0; i < m_slots.size(); ++i)
+	{
+		m_slots[i].Frame.Resize(width, height);
+		m_freeSlots.TryPush(i);
+	}
+
+	m_effectThread = std::thread([this] { RunEffect(); });
+
+	try
+	{
+		m_outputThread = std::thread([this] { RunOutput(); });
+	}
+	catch (...)
+	{
+		m_pendingSlots.Close();
+		m_effectThread.join();
+		throw;
+	}
+}
+
+FramePipeline::~FramePipeline()
+{
+	// The effect thread drains the pending frames and then closes the ring to
+	// the output thread, which drains that in turn.
+	m_pendingSlots.Close();
+	m_effectThread.join();
+	m_outputThread.join();
+}
+
+bool FramePipeline::Submit(const FrameFunction& convert)
+{
+	RethrowError();
+
+	uint32_t index;
+
+	if (!m_freeSlots.TryPop(index))
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		++m_statistics.Submitted;
+		++m_statistics.DroppedBusy;
+		return false;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		++m_statistics.Submitted;
+		++m_submittedCount;
+	}
+
+	Slot& slot = m_slots[index];
+	slot.Info = FrameInfo();
+	slot.Info.Sequence = m_nextSequence++;
+	slot.Info.SubmitTime = Clock::now();
+	slot.State = FrameState::Pending;
+
+	std::exception_ptr error;
+
+	try
+	{
+		convert(slot.Frame);
+	}
+	catch (...)
+	{
+		// The buffer still goes round, so that it returns to the free ring.
+		slot.State = FrameState::Failed;
+		error = std::current_exception();
+	}
+
+	slot.Info.ConvertedTime = Clock::now();
+	m_pendingSlots.TryPush(index);
+
+	if (error)
+	{
+		std::rethrow_exception(error);
+	}
+
+	return true;
+}
+
+void FramePipeline::Flush()
+{
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_completed.wait(lock, [this] { return m_completedCount == m_submittedCount; });
+	}
+
+	RethrowError();
+}
+
+FramePipeline::Statistics FramePipeline::GetStatistics() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	Statistics statistics = m_statistics;
+
+	if (statistics.Delivered == 0)
+	{
+		return statistics;
+	}
+
+	statistics.AverageLatency = m_totalLatency / static_cast<Clock::rep>(statistics.Delivered);
+
+	// The bucket of the frame at each percentile, rounded up to its end and
+	// capped at the largest latency actually seen.
+	auto getPercentile = [&](uint64_t rank)
+	{
+		uint64_t count = 0;
+
+		for (size_t bucket = 0; bucket < m_latencyHistogram.size(); ++bucket)
+		{
+			count += m_latencyHistogram[bucket];
+
+			if (count >= rank)
+			{
+				const Clock::duration end = std::chrono::duration_cast<Clock::duration>(LatencyResolution * static_cast<int64_t>(bucket + 1));
+				return std::min(end, statistics.MaximumLatency);
+			}
+		}
+
+		return statistics.MaximumLatency;
+	};
+
+	statistics.MedianLatency = getPercentile((statistics.Delivered + 1) / 2);
+	statistics.Percentile99Latency = getPercentile((statistics.Delivered * 99 + 99) / 100);
+	return statistics;
+}
+
+void FramePipeline::FillTestPattern(BatchFrame& frame, uint64_t sequence)
+{
+	const uint32_t phase = static_cast<uint32_t>(sequence);
+
+	for (int32_t y = 0; y < frame.GetHeight(); ++y)
+	{
+		uint32_t* row = frame.GetPixels() + static_cast<intptr_t>(y) * frame.GetPitch();
+
+		for (int32_t x = 0; x < frame.GetWidth(); ++x)
+		{
+			const uint32_t blue = (x + phase * 4) & 0xFF;
+			const uint32_t green = (y + phase * 2) & 0xFF;
+			const uint32_t red = ((x + y) / 2 + phase) & 0xFF;
+
+			row[x] = 0xFF000000 | (red << 16) | (green << 8) | blue;
+		}
+	}
+}
+
+void FramePipeline::RunEffect()
+{
+	uint32_t index;
+
+	while (m_pendingSlots.Pop(index))
+	{
+		Slot& slot = m_slots[index];
+
+		if (slot.State == FrameState::Pending)
+		{
+			if (m_latencyBudget > Clock::duration::zero() && Clock::now() - slot.Info.SubmitTime > m_latencyBudget)
+			{
+				slot.State = FrameState::Late;
+			}
+			else
+			{
+				try
+				{
+					m_process(slot.Frame);
+				}
+				catch (...)
+				{
+					slot.State = FrameState::Failed;
+					SetError(std::current_exception());
+				}
+			}
+		}
+
+		slot.Info.ProcessedTime = Clock::now();
+		m_processedSlots.TryPush(index);
+	}
+
+	m_processedSlots.Close();
+}
+
+void FramePipeline::RunOutput()
+{
+	uint32_t index;
+
+	while (m_processedSlots.Pop(index))
+	{
+		Slot& slot = m_slots[index];
+
+		if (slot.State == FrameState::Pending)
+		{
+			slot.Info.OutputTime = Clock::now();
+
+			try
+			{
+				m_output(slot.Frame, slot.Info);
+			}
+			catch (...)
+			{
+				slot.State = FrameState::Failed;
+				SetError(std::current_exception());
+			}
+		}
+
+		// The buffer is free again before the frame counts as completed, so that
+		// Submit finds it after Flush. Submit may reuse it right away.
+		const FrameState state = slot.State;
+		const Clock::duration latency = slot.Info.OutputTime - slot.Info.SubmitTime;
+
+		m_freeSlots.TryPush(index);
+		RecordCompletion(state, latency);
+	}
+}
+
+void FramePipeline::RecordCompletion(FrameState state, Clock::duration latency)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		switch (state)
+		{
+		case FrameState::Pending:
+		{
+			const uint64_t bucket = static_cast<uint64_t>(latency / LatencyResolution);
+
+			m_statistics.MinimumLatency = (m_statistics.Delivered == 0) ? latency : std::min(m_statistics.MinimumLatency, latency);
+			m_statistics.MaximumLatency = std::max(m_statistics.MaximumLatency, latency);
+			++m_statistics.Delivered;
+			m_totalLatency += latency;
+			++m_latencyHistogram[static_cast<size_t>(std::min<uint64_t>(bucket, LatencyBucketCount - 1))];
+			break;
+		}
+
+		case FrameState::Late:
+			++m_statistics.DroppedLate;
+			break;
+
+		case FrameState::Failed:
+			++m_statistics.Failed;
+			break;
+		}
+
+		++m_completedCount;
+	}
+
+	m_completed.notify_all();
+}
+
+void FramePipeline::SetError(std::exception_ptr error)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (!m_error)
+	{
+		m_error = error;
+	}
+}
+
+void FramePipeline::RethrowError()
+{
+	std::exception_ptr error;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		std::swap(error, m_error);
+	}
+
+	if (error)
+	{
+		std::rethrow_exception(error);
+	}
+}
@@ -0,0 +1,168 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "BatchPipeline.h"
+#include "SpscRing.h"
+
+namespace CustomNativeEffects {
+
+	// Runs live video frames through an effect with converting, processing
+	// and output of consecutive frames overlapping on different cores.
+	//
+	// Frames live in FrameCount buffers allocated up front and circulate
+	// through three lock-free rings: free buffers go to Submit, which converts
+	// the incoming frame on the caller's thread, then to the effect thread,
+	// then to the output thread, which hands them back to Submit. With the
+	// default three buffers, each stage can work on one frame while the others
+	// work on theirs.
+	//
+	// A live source must never wait for the effect, so Submit drops a frame
+	// when every buffer is busy, and the effect thread drops frames that have
+	// already exceeded the latency budget instead of processing them late.
+	class FramePipeline final
+	{
+	public:
+		typedef std::chrono::steady_clock Clock;
+
+		struct Options
+		{
+			Options() :
+				FrameCount(3),
+				LatencyBudget(std::chrono::milliseconds(100))
+			{
+			}
+
+			uint32_t FrameCount;
+
+			// Frames older than this when the effect would start on them are
+			// dropped. Zero never drops frames for being late.
+			Clock::duration LatencyBudget;
+		};
+
+		// When a frame passed each stage.
+		struct FrameInfo
+		{
+			uint64_t Sequence;
+			Clock::time_point SubmitTime;
+			Clock::time_point ConvertedTime;
+			Clock::time_point ProcessedTime;
+			Clock::time_point OutputTime;
+		};
+
+		struct Statistics
+		{
+			uint64_t Submitted;
+			uint64_t Delivered;
+
+			// Dropped by Submit because every buffer was busy.
+			uint64_t DroppedBusy;
+
+			// Dropped by the effect thread for exceeding the latency budget.
+			uint64_t DroppedLate;
+
+			// Dropped because converting, processing or output threw.
+			uint64_t Failed;
+
+			// From Submit to the start of output, over the delivered frames.
+			// Median and 99th percentile are accurate to LatencyResolution.
+			Clock::duration MinimumLatency;
+			Clock::duration AverageLatency;
+			Clock::duration MedianLatency;
+			Clock::duration Percentile99Latency;
+			Clock::duration MaximumLatency;
+		};
+
+		static const std::chrono::microseconds LatencyResolution;
+
+		typedef std::function<void(BatchFrame& frame)> FrameFunction;
+		typedef std::function<void(const BatchFrame& frame, const FrameInfo& info)> OutputFunction;
+
+		// Allocates the width x height frame buffers and starts the effect and
+		// output threads. process runs the effect in place on the effect
+		// thread; output delivers processed frames on the output thread.
+		FramePipeline(int32_t width, int32_t height, const FrameFunction& process, const OutputFunction& output, const Options& options = Options());
+
+		FramePipeline(const FramePipeline&) = delete;
+
+		FramePipeline& operator=(const FramePipeline&) = delete;
+
+		// Stops the pipeline, dropping no frame that was already submitted.
+		~FramePipeline();
+
+		// Converts the next frame into a free buffer with convert, on the calling
+		// thread, and queues it for the effect. Returns false without calling
+		// convert if every buffer is busy. Only one thread may submit at a time.
+		// Rethrows the first exception processing or output threw since the
+		// previous call, or one thrown by convert.
+		bool Submit(const FrameFunction& convert);
+
+		// Waits until every submitted frame has been delivered or dropped, then
+		// rethrows as Submit does.
+		void Flush();
+
+		Statistics GetStatistics() const;
+
+		// Fills frame with a moving color gradient, as a stand-in for a camera
+		// when measuring a pipeline.
+		static void FillTestPattern(BatchFrame& frame, uint64_t sequence);
+
+	private:
+		enum class FrameState
+		{
+			Pending,
+			Late,
+			Failed
+		};
+
+		struct Slot
+		{
+			BatchFrame Frame;
+			FrameInfo Info;
+			FrameState State;
+		};
+
+		void RunEffect();
+		void RunOutput();
+		void SetError(std::exception_ptr error);
+		void RethrowError();
+		void RecordCompletion(FrameState state, Clock::duration latency);
+
+		std::vector<Slot> m_slots;
+		SpscRing<uint32_t> m_freeSlots;
+		SpscRing<uint32_t> m_pendingSlots;
+		SpscRing<uint32_t> m_processedSlots;
+		FrameFunction m_process;
+		OutputFunction m_output;
+		Clock::duration m_latencyBudget;
+		uint64_t m_nextSequence;
+
+		mutable std::mutex m_mutex;
+		std::condition_variable m_completed;
+		uint64_t m_submittedCount;
+		uint64_t m_completedCount;
+		Statistics m_statistics;
+		Clock::duration m_totalLatency;
+		std::vector<uint32_t> m_latencyHistogram;
+		std::exception_ptr m_error;
+
+		std::thread m_effectThread;
+		std::thread m_outputThread;
+	};
+}
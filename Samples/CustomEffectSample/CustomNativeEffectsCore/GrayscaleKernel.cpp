@@ -0,0 +1,193 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "GrayscaleKernel.h"
+
+#if defined(CPUFEATURES_X86)
+#include <emmintrin.h>
+#include <immintrin.h>
+#elif defined(CPUFEATURES_NEON)
+#include <arm_neon.h>
+#endif
+
+using namespace CustomNativeEffects;
+using namespace CustomNativeEffects::GrayscaleKernel;
+using namespace CpuFeatures;
+
+static const uint32_t OpaqueAlpha = 0xFF000000;
+static const int32_t Rounding = 1 << (WeightShift - 1);
+
+void GrayscaleKernel::ConvertRowReference(const uint32_t* sourcePixels, uint32_t* targetPixels, uint32_t count)
+{
+	for (uint32_t x = 0; x < count; ++x)
+	{
+		uint32_t pixel = sourcePixels[x];
+
+		int32_t red = (pixel >> 16) & 0x000000FF;
+		int32_t green = (pixel >> 8) & 0x000000FF;
+		int32_t blue = pixel & 0x000000FF;
+
+		uint32_t luma = static_cast<uint32_t>((WeightBlue * blue + WeightGreen * green + WeightRed * red + Rounding) >> WeightShift);
+		targetPixels[x] = OpaqueAlpha | luma | (luma << 8) | (luma << 16);
+	}
+}
+
+#if defined(CPUFEATURES_X86)
+
+// Four pixels per iteration. The pixels are widened to 16 bits so that one
+// _mm_madd_epi16 produces (B * wB + G * wG) and (R * wR + A * 0) per pixel; the
+// two partial sums are then gathered into separate registers and added.
+static void ConvertRowSse2(const uint32_t* sourcePixels, uint32_t* targetPixels, uint32_t count)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i weights = _mm_setr_epi16(WeightBlue, WeightGreen, WeightRed, 0, WeightBlue, WeightGreen, WeightRed, 0);
+	const __m128i rounding = _mm_set1_epi32(Rounding);
+	const __m128i alpha = _mm_set1_epi32(static_cast<int>(OpaqueAlpha));
+
+	uint32_t x = 0;
+
+	for (; x + 4 <= count; x += 4)
+	{
+		__m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sourcePixels + x));
+
+		__m128 low = _mm_castsi128_ps(_mm_madd_epi16(_mm_unpacklo_epi8(pixels, zero), weights));
+		__m128 high = _mm_castsi128_ps(_mm_madd_epi16(_mm_unpackhi_epi8(pixels, zero), weights));
+
+		__m128i blueGreen = _mm_castps_si128(_mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0)));
+		__m128i redAlpha = _mm_castps_si128(_mm_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1)));
+
+		__m128i luma = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(blueGreen, redAlpha), rounding), WeightShift);
+		__m128i gray = _mm_or_si128(_mm_or_si128(luma, _mm_slli_epi32(luma, 8)), _mm_or_si128(_mm_slli_epi32(luma, 16), alpha));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(targetPixels + x), gray);
+	}
+
+	ConvertRowReference(sourcePixels + x, targetPixels + x, count - x);
+}
+
+// Same scheme as the SSE2 kernel on eight pixels. The unpack and shuffle
+// instructions work within 128-bit lanes, which keeps the pixels in order.
+CPUFEATURES_TARGET_AVX2
+static void ConvertRowAvx2(const uint32_t* sourcePixels, uint32_t* targetPixels, uint32_t count)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i weights = _mm256_setr_epi16(
+		WeightBlue, WeightGreen, WeightRed, 0, WeightBlue, WeightGreen, WeightRed, 0,
+		WeightBlue, WeightGreen, WeightRed, 0, WeightBlue, WeightGreen, WeightRed, 0);
+	const __m256i rounding = _mm256_set1_epi32(Rounding);
+	const __m256i alpha = _mm256_set1_epi32(static_cast<int>(OpaqueAlpha));
+
+	uint32_t x = 0;
+
+	for (; x + 8 <= count; x += 8)
+	{
+		__m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sourcePixels + x));
+
+		__m256 low = _mm256_castsi256_ps(_mm256_madd_epi16(_mm256_unpacklo_epi8(pixels, zero), weights));
+		__m256 high = _mm256_castsi256_ps(_mm256_madd_epi16(_mm256_unpackhi_epi8(pixels, zero), weights));
+
+		__m256i blueGreen = _mm256_castps_si256(_mm256_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0)));
+		__m256i redAlpha = _mm256_castps_si256(_mm256_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1)));
+
+		__m256i luma = _mm256_srli_epi32(_mm256_add_epi32(_mm256_add_epi32(blueGreen, redAlpha), rounding), WeightShift);
+		__m256i gray = _mm256_or_si256(_mm256_or_si256(luma, _mm256_slli_epi32(luma, 8)), _mm256_or_si256(_mm256_slli_epi32(luma, 16), alpha));
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(targetPixels + x), gray);
+	}
+
+	ConvertRowReference(sourcePixels + x, targetPixels + x, count - x);
+}
+
+#endif
+
+#if defined(CPUFEATURES_NEON)
+
+// Eight pixels per iteration. vld4 de-interleaves the channels, the weighted
+// sum is accumulated in 32 bits and vrshrn applies the same round-to-nearest
+// shift as the reference.
+static void ConvertRowNeon(const uint32_t* sourcePixels, uint32_t* targetPixels, uint32_t count)
+{
+	uint32_t x = 0;
+
+	for (; x + 8 <= count; x += 8)
+	{
+		uint8x8x4_t bgra = vld4_u8(reinterpret_cast<const uint8_t*>(sourcePixels + x));
+
+		uint16x8_t blue = vmovl_u8(bgra.val[0]);
+		uint16x8_t green = vmovl_u8(bgra.val[1]);
+		uint16x8_t red = vmovl_u8(bgra.val[2]);
+
+		uint32x4_t low = vmull_n_u16(vget_low_u16(blue), WeightBlue);
+		low = vmlal_n_u16(low, vget_low_u16(green), WeightGreen);
+		low = vmlal_n_u16(low, vget_low_u16(red), WeightRed);
+
+		uint32x4_t high = vmull_n_u16(vget_high_u16(blue), WeightBlue);
+		high = vmlal_n_u16(high, vget_high_u16(green), WeightGreen);
+		high = vmlal_n_u16(high, vget_high_u16(red), WeightRed);
+
+		uint8x8_t luma = vmovn_u16(vcombine_u16(vrshrn_n_u32(low, WeightShift), vrshrn_n_u32(high, WeightShift)));
+
+		uint8x8x4_t gray;
+		gray.val[0] = luma;
+		gray.val[1] = luma;
+		gray.val[2] = luma;
+		gray.val[3] = vdup_n_u8(0xFF);
+
+		vst4_u8(reinterpret_cast<uint8_t*>(targetPixels + x), gray);
+	}
+
+	ConvertRowReference(sourcePixels + x, targetPixels + x, count - x);
+}
+
+#endif
+
+RowFunction GrayscaleKernel::GetRowFunction(InstructionSet instructionSet)
+{
+	if (!IsSupported(instructionSet))
+	{
+		return nullptr;
+	}
+
+	switch (instructionSet)
+	{
+#if defined(CPUFEATURES_X86)
+	case InstructionSet::Sse2:
+		return ConvertRowSse2;
+	case InstructionSet::Avx2:
+		return ConvertRowAvx2;
+#endif
+#if defined(CPUFEATURES_NEON)
+	case InstructionSet::Neon:
+		return ConvertRowNeon;
+#endif
+	default:
+		return ConvertRowReference;
+	}
+}
+
+RowFunction GrayscaleKernel::GetRowFunction()
+{
+	static const RowFunction preferred = GetRowFunction(GetPreferredInstructionSet());
+	return preferred;
+}
+
+void GrayscaleKernel::ConvertRegion(const CpuWorkerRegion& region, RowFunction rowFunction)
+{
+	const uint32_t* sourcePixels = region.SourcePixels;
+	uint32_t* targetPixels = region.TargetPixels;
+
+	for (int32_t y = 0; y < region.Height; ++y)
+	{
+		rowFunction(sourcePixels, targetPixels, region.GetVectorRowLength(y, VectorPixels));
+
+		sourcePixels += region.SourcePitch;
+		targetPixels += region.TargetPitch;
+	}
+}
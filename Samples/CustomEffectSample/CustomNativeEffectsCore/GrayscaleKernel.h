@@ -0,0 +1,56 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <cstdint>
+#include "CpuFeatures.h"
+#include "CpuWorkerRegion.h"
+
+namespace CustomNativeEffects {
+
+	// Converts BGRA8888 pixels to opaque gray using the Rec. 709 luma weights.
+	//
+	// All paths use the same Q15 fixed-point weights and round to nearest, so the
+	// SSE2, AVX2 and NEON kernels are bit-exact with GrayscaleKernel::ConvertRowReference.
+	// Compared with the exact weighted sum 0.0722 * B + 0.7152 * G + 0.2126 * R the
+	// result is within 0.51 of a level: 0.5 from rounding plus the error of the
+	// Q15 weights, which reaches 0.0032 for a channel at 255. Compared with the
+	// previous truncating double-precision implementation it differs by at most
+	// 1 level.
+	namespace GrayscaleKernel {
+
+		// Q15 weights, chosen so that they sum to exactly 1 << 15 and white stays white.
+		const int32_t WeightBlue = 2366;	// 0.0722
+		const int32_t WeightGreen = 23436;	// 0.7152
+		const int32_t WeightRed = 6966;		// 0.2126
+		const int32_t WeightShift = 15;
+
+		typedef void (*RowFunction)(const uint32_t* sourcePixels, uint32_t* targetPixels, uint32_t count);
+
+		// Scalar reference implementation; every vector path must match it exactly.
+		void ConvertRowReference(const uint32_t* sourcePixels, uint32_t* targetPixels, uint32_t count);
+
+		// Returns the row function for the given instruction set, or nullptr if the
+		// current processor does not support it.
+		RowFunction GetRowFunction(CpuFeatures::InstructionSet instructionSet);
+
+		// Returns the fastest row function for the current processor.
+		RowFunction GetRowFunction();
+
+		// Row lengths are rounded up to a multiple of this, which every row
+		// function's vector width divides, so that no scalar tail is left.
+		const int32_t VectorPixels = 16;
+
+		// Converts every row of the region. Rows are processed as whole vectors
+		// whenever the region's tail guarantees allow it.
+		void ConvertRegion(const CpuWorkerRegion& region, RowFunction rowFunction);
+	}
+}
@@ -0,0 +1,69 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <cstdint>
+#include <utility>
+
+namespace CustomNativeEffects {
+
+	// The pure colors of HueToRgb as a table generated at compile time, with
+	// quarter degree steps. Entry StepsPerDegree * hue is HueToRgb(hue).
+	namespace HueTable {
+
+		const int32_t StepsPerDegree = 4;
+		const int32_t Size = 360 * StepsPerDegree;
+
+		constexpr int32_t Abs(int32_t x)
+		{
+			return (x < 0) ? -x : x;
+		}
+
+		// One channel of a pure color rises from 0 to 255 over 60 degrees. The
+		// slope of 255 / 240 quarter degrees is 17 / 16, which truncates to the
+		// same values as hue * 4.25 did for whole degrees.
+		constexpr uint32_t Ramp(int32_t x)
+		{
+			return (x <= 0) ? 0u : (x >= 240 ? 255u : static_cast<uint32_t>(x * 17 / 16));
+		}
+
+		// Pure color of a hue in quarter degrees [0, Size), as 0xFFRRGGBB. Each
+		// channel is a ramp of the distance to the hue where it is strongest,
+		// so this has no branches on the color circle sector.
+		constexpr uint32_t Entry(int32_t quarterDegrees)
+		{
+			return 0xFF000000u
+				| (Ramp(Abs(quarterDegrees - 720) - 240) << 16)
+				| (Ramp(480 - Abs(quarterDegrees - 480)) << 8)
+				| Ramp(480 - Abs(quarterDegrees - 960));
+		}
+
+		struct Table
+		{
+			uint32_t Colors[Size];
+		};
+
+		template <int32_t... QuarterDegrees>
+		constexpr Table MakeTable(std::integer_sequence<int32_t, QuarterDegrees...>)
+		{
+			return Table{ { Entry(QuarterDegrees)... } };
+		}
+
+		// Entry() for every quarter degree, defined in ImageProcessingUtils.cpp.
+		extern const Table Colors;
+
+		// quarterDegrees must be in [0, Size).
+		inline uint32_t Lookup(int32_t quarterDegrees)
+		{
+			return Colors.Colors[quarterDegrees];
+		}
+	}
+}
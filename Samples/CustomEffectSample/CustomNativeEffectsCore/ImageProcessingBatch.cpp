@@ -0,0 +1,716 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+
+#include "ImageProcessingBatch.h"
+#include "ImageProcessingUtils.h"
+
+#if defined(CPUFEATURES_X86)
+#include <emmintrin.h>
+#include <immintrin.h>
+#elif defined(CPUFEATURES_NEON)
+#include <arm_neon.h>
+#endif
+
+using namespace CustomNativeEffects;
+using namespace CustomNativeEffects::CpuFeatures;
+using namespace ImageProcessingUtils;
+
+// Scalar implementations. The vector implementations finish every span with
+// these, and must match them exactly.
+namespace ScalarBatch
+{
+	static void Sat255(const int32_t* values, uint8_t* result, uint32_t count)
+	{
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			result[i] = static_cast<uint8_t>(SAT255(values[i]));
+		}
+	}
+
+	static void Div255(const int32_t* values, int32_t* result, uint32_t count)
+	{
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			result[i] = DIV255(values[i]);
+		}
+	}
+
+	static void MultiplyDiv255(const uint8_t* a, const uint8_t* b, uint8_t* result, uint32_t count)
+	{
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			result[i] = static_cast<uint8_t>(DIV255(a[i] * b[i]));
+		}
+	}
+
+	static void Luma(const uint32_t* pixels, uint8_t* result, uint32_t count)
+	{
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const uint32_t pixel = pixels[i];
+			result[i] = static_cast<uint8_t>(BW((pixel >> 16) & 0xFF, (pixel >> 8) & 0xFF, pixel & 0xFF));
+		}
+	}
+
+	static void Clamp(const int32_t* values, int32_t* result, uint32_t count, int32_t min, int32_t max)
+	{
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			result[i] = SAT(values[i], min, max);
+		}
+	}
+
+	static void Min(const int32_t* a, const int32_t* b, int32_t* result, uint32_t count)
+	{
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			result[i] = MIN(a[i], b[i]);
+		}
+	}
+
+	static void Max(const int32_t* a, const int32_t* b, int32_t* result, uint32_t count)
+	{
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			result[i] = MAX(a[i], b[i]);
+		}
+	}
+
+	static void MinRgb(const uint32_t* pixels, uint8_t* result, uint32_t count)
+	{
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const uint32_t pixel = pixels[i];
+			result[i] = static_cast<uint8_t>(MIN(static_cast<int>((pixel >> 16) & 0xFF), static_cast<int>((pixel >> 8) & 0xFF), static_cast<int>(pixel & 0xFF)));
+		}
+	}
+
+	static void MaxRgb(const uint32_t* pixels, uint8_t* result, uint32_t count)
+	{
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const uint32_t pixel = pixels[i];
+			result[i] = static_cast<uint8_t>(MAX(static_cast<int>((pixel >> 16) & 0xFF), static_cast<int>((pixel >> 8) & 0xFF), static_cast<int>(pixel & 0xFF)));
+		}
+	}
+
+	static const ImageProcessingBatch::Functions Functions =
+	{
+		Sat255, Div255, MultiplyDiv255, Luma, Clamp, Min, Max, MinRgb, MaxRgb
+	};
+}
+
+#if defined(CPUFEATURES_X86)
+
+// SSE2 has no 32-bit min/max or blend, so selections are done with compare
+// masks. Packing 32-bit lanes to bytes goes through the saturating 16-bit packs.
+namespace Sse2Batch
+{
+	static inline __m128i Select(__m128i mask, __m128i ifTrue, __m128i ifFalse)
+	{
+		return _mm_or_si128(_mm_and_si128(mask, ifTrue), _mm_andnot_si128(mask, ifFalse));
+	}
+
+	static inline __m128i PackToBytes(__m128i a, __m128i b, __m128i c, __m128i d)
+	{
+		return _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+	}
+
+	// BW of four pixels as 32-bit lanes, using the same madd scheme as GrayscaleKernel.
+	static inline __m128i Luma4(__m128i pixels)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i weights = _mm_setr_epi16(28, 151, 77, 0, 28, 151, 77, 0);
+
+		__m128 low = _mm_castsi128_ps(_mm_madd_epi16(_mm_unpacklo_epi8(pixels, zero), weights));
+		__m128 high = _mm_castsi128_ps(_mm_madd_epi16(_mm_unpackhi_epi8(pixels, zero), weights));
+
+		__m128i blueGreen = _mm_castps_si128(_mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0)));
+		__m128i redAlpha = _mm_castps_si128(_mm_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1)));
+
+		return _mm_srli_epi32(_mm_add_epi32(blueGreen, redAlpha), 8);
+	}
+
+	// The low byte of each lane ends up holding the minimum or maximum of B, G and R.
+	static inline __m128i MinRgb4(__m128i pixels)
+	{
+		__m128i m = _mm_min_epu8(pixels, _mm_srli_epi32(pixels, 8));
+		m = _mm_min_epu8(m, _mm_srli_epi32(pixels, 16));
+		return _mm_and_si128(m, _mm_set1_epi32(0xFF));
+	}
+
+	static inline __m128i MaxRgb4(__m128i pixels)
+	{
+		__m128i m = _mm_max_epu8(pixels, _mm_srli_epi32(pixels, 8));
+		m = _mm_max_epu8(m, _mm_srli_epi32(pixels, 16));
+		return _mm_and_si128(m, _mm_set1_epi32(0xFF));
+	}
+
+	static inline __m128i Load(const void* source)
+	{
+		return _mm_loadu_si128(static_cast<const __m128i*>(source));
+	}
+
+	static inline void Store(void* target, __m128i value)
+	{
+		_mm_storeu_si128(static_cast<__m128i*>(target), value);
+	}
+
+	static void Sat255(const int32_t* values, uint8_t* result, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			Store(result + i, PackToBytes(Load(values + i), Load(values + i + 4), Load(values + i + 8), Load(values + i + 12)));
+		}
+
+		ScalarBatch::Sat255(values + i, result + i, count - i);
+	}
+
+	static void Div255(const int32_t* values, int32_t* result, uint32_t count)
+	{
+		const __m128i one = _mm_set1_epi32(1);
+
+		uint32_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i v = Load(values + i);
+			__m128i t = _mm_add_epi32(_mm_add_epi32(_mm_srai_epi32(v, 8), v), one);
+			Store(result + i, _mm_srai_epi32(t, 8));
+		}
+
+		ScalarBatch::Div255(values + i, result + i, count - i);
+	}
+
+	// a * b fits in 16 bits, and so does p + (p >> 8) + 1 for p <= 255 * 255.
+	static inline __m128i MultiplyDiv255Words(__m128i a, __m128i b)
+	{
+		__m128i p = _mm_mullo_epi16(a, b);
+		__m128i t = _mm_add_epi16(_mm_add_epi16(p, _mm_srli_epi16(p, 8)), _mm_set1_epi16(1));
+		return _mm_srli_epi16(t, 8);
+	}
+
+	static void MultiplyDiv255(const uint8_t* a, const uint8_t* b, uint8_t* result, uint32_t count)
+	{
+		const __m128i zero = _mm_setzero_si128();
+
+		uint32_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			__m128i va = Load(a + i);
+			__m128i vb = Load(b + i);
+
+			__m128i low = MultiplyDiv255Words(_mm_unpacklo_epi8(va, zero), _mm_unpacklo_epi8(vb, zero));
+			__m128i high = MultiplyDiv255Words(_mm_unpackhi_epi8(va, zero), _mm_unpackhi_epi8(vb, zero));
+
+			Store(result + i, _mm_packus_epi16(low, high));
+		}
+
+		ScalarBatch::MultiplyDiv255(a + i, b + i, result + i, count - i);
+	}
+
+	static void Luma(const uint32_t* pixels, uint8_t* result, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			Store(result + i, PackToBytes(Luma4(Load(pixels + i)), Luma4(Load(pixels + i + 4)), Luma4(Load(pixels + i + 8)), Luma4(Load(pixels + i + 12))));
+		}
+
+		ScalarBatch::Luma(pixels + i, result + i, count - i);
+	}
+
+	static void Clamp(const int32_t* values, int32_t* result, uint32_t count, int32_t min, int32_t max)
+	{
+		const __m128i minimum = _mm_set1_epi32(min);
+		const __m128i maximum = _mm_set1_epi32(max);
+
+		uint32_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			// Same order of tests as SAT, so the result also matches when min > max.
+			__m128i v = Load(values + i);
+			__m128i clamped = Select(_mm_cmpgt_epi32(v, maximum), maximum, v);
+			Store(result + i, Select(_mm_cmplt_epi32(v, minimum), minimum, clamped));
+		}
+
+		ScalarBatch::Clamp(values + i, result + i, count - i, min, max);
+	}
+
+	static void Min(const int32_t* a, const int32_t* b, int32_t* result, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i va = Load(a + i);
+			__m128i vb = Load(b + i);
+			Store(result + i, Select(_mm_cmplt_epi32(va, vb), va, vb));
+		}
+
+		ScalarBatch::Min(a + i, b + i, result + i, count - i);
+	}
+
+	static void Max(const int32_t* a, const int32_t* b, int32_t* result, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i va = Load(a + i);
+			__m128i vb = Load(b + i);
+			Store(result + i, Select(_mm_cmpgt_epi32(va, vb), va, vb));
+		}
+
+		ScalarBatch::Max(a + i, b + i, result + i, count - i);
+	}
+
+	static void MinRgb(const uint32_t* pixels, uint8_t* result, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			Store(result + i, PackToBytes(MinRgb4(Load(pixels + i)), MinRgb4(Load(pixels + i + 4)), MinRgb4(Load(pixels + i + 8)), MinRgb4(Load(pixels + i + 12))));
+		}
+
+		ScalarBatch::MinRgb(pixels + i, result + i, count - i);
+	}
+
+	static void MaxRgb(const uint32_t* pixels, uint8_t* result, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			Store(result + i, PackToBytes(MaxRgb4(Load(pixels + i)), MaxRgb4(Load(pixels + i + 4)), MaxRgb4(Load(pixels + i + 8)), MaxRgb4(Load(pixels + i + 12))));
+		}
+
+		ScalarBatch::MaxRgb(pixels + i, result + i, count - i);
+	}
+
+	static const ImageProcessingBatch::Functions Functions =
+	{
+		Sat255, Div255, MultiplyDiv255, Luma, Clamp, Min, Max, MinRgb, MaxRgb
+	};
+}
+
+// The AVX2 versions mirror the SSE2 ones on 256-bit registers. The 16-bit packs
+// work within 128-bit lanes, so packed bytes are put back in order with one
+// cross-lane permute.
+namespace Avx2Batch
+{
+	CPUFEATURES_TARGET_AVX2
+	static inline __m256i Load(const void* source)
+	{
+		return _mm256_loadu_si256(static_cast<const __m256i*>(source));
+	}
+
+	CPUFEATURES_TARGET_AVX2
+	static inline void Store(void* target, __m256i value)
+	{
+		_mm256_storeu_si256(static_cast<__m256i*>(target), value);
+	}
+
+	CPUFEATURES_TARGET_AVX2
+	static inline __m256i PackToBytes(__m256i a, __m256i b, __m256i c, __m256i d)
+	{
+		__m256i packed = _mm256_packus_epi16(_mm256_packs_epi32(a, b), _mm256_packs_epi32(c, d));
+		return _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+	}
+
+	CPUFEATURES_TARGET_AVX2
+	static inline __m256i Luma8(__m256i pixels)
+	{
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i weights = _mm256_setr_epi16(28, 151, 77, 0, 28, 151, 77, 0, 28, 151, 77, 0, 28, 151, 77, 0);
+
+		__m256 low = _mm256_castsi256_ps(_mm256_madd_epi16(_mm256_unpacklo_epi8(pixels, zero), weights));
+		__m256 high = _mm256_castsi256_ps(_mm256_madd_epi16(_mm256_unpackhi_epi8(pixels, zero), weights));
+
+		__m256i blueGreen = _mm256_castps_si256(_mm256_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0)));
+		__m256i redAlpha = _mm256_castps_si256(_mm256_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1)));
+
+		return _mm256_srli_epi32(_mm256_add_epi32(blueGreen, redAlpha), 8);
+	}
+
+	CPUFEATURES_TARGET_AVX2
+	static inline __m256i MinRgb8(__m256i pixels)
+	{
+		__m256i m = _mm256_min_epu8(pixels, _mm256_srli_epi32(pixels, 8));
+		m = _mm256_min_epu8(m, _mm256_srli_epi32(pixels, 16));
+		return _mm256_and_si256(m, _mm256_set1_epi32(0xFF));
+	}
+
+	CPUFEATURES_TARGET_AVX2
+	static inline __m256i MaxRgb8(__m256i pixels)
+	{
+		__m256i m = _mm256_max_epu8(pixels, _mm256_srli_epi32(pixels, 8));
+		m = _mm256_max_epu8(m, _mm256_srli_epi32(pixels, 16));
+		return _mm256_and_si256(m, _mm256_set1_epi32(0xFF));
+	}
+
+	CPUFEATURES_TARGET_AVX2
+	static void Sat255(const int32_t* values, uint8_t* result, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 32 <= count; i += 32)
+		{
+			Store(result + i, PackToBytes(Load(values + i), Load(values + i + 8), Load(values + i + 16), Load(values + i + 24)));
+		}
+
+		ScalarBatch::Sat255(values + i, result + i, count - i);
+	}
+
+	CPUFEATURES_TARGET_AVX2
+	static void Div255(const int32_t* values, int32_t* result, uint32_t count)
+	{
+		const __m256i one = _mm256_set1_epi32(1);
+
+		uint32_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256i v = Load(values + i);
+			__m256i t = _mm256_add_epi32(_mm256_add_epi32(_mm256_srai_epi32(v, 8), v), one);
+			Store(result + i, _mm256_srai_epi32(t, 8));
+		}
+
+		ScalarBatch::Div255(values + i, result + i, count - i);
+	}
+
+	CPUFEATURES_TARGET_AVX2
+	static inline __m256i MultiplyDiv255Words(__m256i a, __m256i b)
+	{
+		__m256i p = _mm256_mullo_epi16(a, b);
+		__m256i t = _mm256_add_epi16(_mm256_add_epi16(p, _mm256_srli_epi16(p, 8)), _mm256_set1_epi16(1));
+		return _mm256_srli_epi16(t, 8);
+	}
+
+	CPUFEATURES_TARGET_AVX2
+	static void MultiplyDiv255(const uint8_t* a, const uint8_t* b, uint8_t* result, uint32_t count)
+	{
+		const __m256i zero = _mm256_setzero_si256();
+
+		uint32_t i = 0;
+		for (; i + 32 <= count; i += 32)
+		{
+			__m256i va = Load(a + i);
+			__m256i vb = Load(b + i);
+
+			// unpack and packus both work per 128-bit lane, so the bytes stay in order.
+			__m256i low = MultiplyDiv255Words(_mm256_unpacklo_epi8(va, zero), _mm256_unpacklo_epi8(vb, zero));
+			__m256i high = MultiplyDiv255Words(_mm256_unpackhi_epi8(va, zero), _mm256_unpackhi_epi8(vb, zero));
+
+			Store(result + i, _mm256_packus_epi16(low, high));
+		}
+
+		ScalarBatch::MultiplyDiv255(a + i, b + i, result + i, count - i);
+	}
+
+	CPUFEATURES_TARGET_AVX2
+	static void Luma(const uint32_t* pixels, uint8_t* result, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 32 <= count; i += 32)
+		{
+			Store(result + i, PackToBytes(Luma8(Load(pixels + i)), Luma8(Load(pixels + i + 8)), Luma8(Load(pixels + i + 16)), Luma8(Load(pixels + i + 24))));
+		}
+
+		ScalarBatch::Luma(pixels + i, result + i, count - i);
+	}
+
+	CPUFEATURES_TARGET_AVX2
+	static void Clamp(const int32_t* values, int32_t* result, uint32_t count, int32_t min, int32_t max)
+	{
+		const __m256i minimum = _mm256_set1_epi32(min);
+		const __m256i maximum = _mm256_set1_epi32(max);
+
+		uint32_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256i v = Load(values + i);
+			__m256i clamped = _mm256_blendv_epi8(v, maximum, _mm256_cmpgt_epi32(v, maximum));
+			Store(result + i, _mm256_blendv_epi8(clamped, minimum, _mm256_cmpgt_epi32(minimum, v)));
+		}
+
+		ScalarBatch::Clamp(values + i, result + i, count - i, min, max);
+	}
+
+	CPUFEATURES_TARGET_AVX2
+	static void Min(const int32_t* a, const int32_t* b, int32_t* result, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			Store(result + i, _mm256_min_epi32(Load(a + i), Load(b + i)));
+		}
+
+		ScalarBatch::Min(a + i, b + i, result + i, count - i);
+	}
+
+	CPUFEATURES_TARGET_AVX2
+	static void Max(const int32_t* a, const int32_t* b, int32_t* result, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			Store(result + i, _mm256_max_epi32(Load(a + i), Load(b + i)));
+		}
+
+		ScalarBatch::Max(a + i, b + i, result + i, count - i);
+	}
+
+	CPUFEATURES_TARGET_AVX2
+	static void MinRgb(const uint32_t* pixels, uint8_t* result, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 32 <= count; i += 32)
+		{
+			Store(result + i, PackToBytes(MinRgb8(Load(pixels + i)), MinRgb8(Load(pixels + i + 8)), MinRgb8(Load(pixels + i + 16)), MinRgb8(Load(pixels + i + 24))));
+		}
+
+		ScalarBatch::MinRgb(pixels + i, result + i, count - i);
+	}
+
+	CPUFEATURES_TARGET_AVX2
+	static void MaxRgb(const uint32_t* pixels, uint8_t* result, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 32 <= count; i += 32)
+		{
+			Store(result + i, PackToBytes(MaxRgb8(Load(pixels + i)), MaxRgb8(Load(pixels + i + 8)), MaxRgb8(Load(pixels + i + 16)), MaxRgb8(Load(pixels + i + 24))));
+		}
+
+		ScalarBatch::MaxRgb(pixels + i, result + i, count - i);
+	}
+
+	static const ImageProcessingBatch::Functions Functions =
+	{
+		Sat255, Div255, MultiplyDiv255, Luma, Clamp, Min, Max, MinRgb, MaxRgb
+	};
+}
+
+#endif
+
+#if defined(CPUFEATURES_NEON)
+
+// NEON has saturating narrows and de-interleaving loads, so the pixel functions
+// work on separate channel registers.
+namespace NeonBatch
+{
+	static void Sat255(const int32_t* values, uint8_t* result, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			int16x8_t low = vcombine_s16(vqmovn_s32(vld1q_s32(values + i)), vqmovn_s32(vld1q_s32(values + i + 4)));
+			int16x8_t high = vcombine_s16(vqmovn_s32(vld1q_s32(values + i + 8)), vqmovn_s32(vld1q_s32(values + i + 12)));
+			vst1q_u8(result + i, vcombine_u8(vqmovun_s16(low), vqmovun_s16(high)));
+		}
+
+		ScalarBatch::Sat255(values + i, result + i, count - i);
+	}
+
+	static void Div255(const int32_t* values, int32_t* result, uint32_t count)
+	{
+		const int32x4_t one = vdupq_n_s32(1);
+
+		uint32_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			int32x4_t v = vld1q_s32(values + i);
+			int32x4_t t = vaddq_s32(vaddq_s32(vshrq_n_s32(v, 8), v), one);
+			vst1q_s32(result + i, vshrq_n_s32(t, 8));
+		}
+
+		ScalarBatch::Div255(values + i, result + i, count - i);
+	}
+
+	static inline uint8x8_t MultiplyDiv255x8(uint8x8_t a, uint8x8_t b)
+	{
+		uint16x8_t p = vmull_u8(a, b);
+		uint16x8_t t = vaddq_u16(vaddq_u16(p, vshrq_n_u16(p, 8)), vdupq_n_u16(1));
+		return vshrn_n_u16(t, 8);
+	}
+
+	static void MultiplyDiv255(const uint8_t* a, const uint8_t* b, uint8_t* result, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			uint8x16_t va = vld1q_u8(a + i);
+			uint8x16_t vb = vld1q_u8(b + i);
+			vst1q_u8(result + i, vcombine_u8(
+				MultiplyDiv255x8(vget_low_u8(va), vget_low_u8(vb)),
+				MultiplyDiv255x8(vget_high_u8(va), vget_high_u8(vb))));
+		}
+
+		ScalarBatch::MultiplyDiv255(a + i, b + i, result + i, count - i);
+	}
+
+	static void Luma(const uint32_t* pixels, uint8_t* result, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			uint8x8x4_t bgra = vld4_u8(reinterpret_cast<const uint8_t*>(pixels + i));
+
+			// 77 + 151 + 28 = 256, so the weighted sum fits in 16 bits.
+			uint16x8_t sum = vmull_u8(bgra.val[2], vdup_n_u8(77));
+			sum = vmlal_u8(sum, bgra.val[1], vdup_n_u8(151));
+			sum = vmlal_u8(sum, bgra.val[0], vdup_n_u8(28));
+
+			vst1_u8(result + i, vshrn_n_u16(sum, 8));
+		}
+
+		ScalarBatch::Luma(pixels + i, result + i, count - i);
+	}
+
+	static void Clamp(const int32_t* values, int32_t* result, uint32_t count, int32_t min, int32_t max)
+	{
+		const int32x4_t minimum = vdupq_n_s32(min);
+		const int32x4_t maximum = vdupq_n_s32(max);
+
+		uint32_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			int32x4_t v = vld1q_s32(values + i);
+			int32x4_t clamped = vbslq_s32(vcgtq_s32(v, maximum), maximum, v);
+			vst1q_s32(result + i, vbslq_s32(vcltq_s32(v, minimum), minimum, clamped));
+		}
+
+		ScalarBatch::Clamp(values + i, result + i, count - i, min, max);
+	}
+
+	static void Min(const int32_t* a, const int32_t* b, int32_t* result, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			vst1q_s32(result + i, vminq_s32(vld1q_s32(a + i), vld1q_s32(b + i)));
+		}
+
+		ScalarBatch::Min(a + i, b + i, result + i, count - i);
+	}
+
+	static void Max(const int32_t* a, const int32_t* b, int32_t* result, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			vst1q_s32(result + i, vmaxq_s32(vld1q_s32(a + i), vld1q_s32(b + i)));
+		}
+
+		ScalarBatch::Max(a + i, b + i, result + i, count - i);
+	}
+
+	static void MinRgb(const uint32_t* pixels, uint8_t* result, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			uint8x8x4_t bgra = vld4_u8(reinterpret_cast<const uint8_t*>(pixels + i));
+			vst1_u8(result + i, vmin_u8(vmin_u8(bgra.val[0], bgra.val[1]), bgra.val[2]));
+		}
+
+		ScalarBatch::MinRgb(pixels + i, result + i, count - i);
+	}
+
+	static void MaxRgb(const uint32_t* pixels, uint8_t* result, uint32_t count)
+	{
+		uint32_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			uint8x8x4_t bgra = vld4_u8(reinterpret_cast<const uint8_t*>(pixels + i));
+			vst1_u8(result + i, vmax_u8(vmax_u8(bgra.val[0], bgra.val[1]), bgra.val[2]));
+		}
+
+		ScalarBatch::MaxRgb(pixels + i, result + i, count - i);
+	}
+
+	static const ImageProcessingBatch::Functions Functions =
+	{
+		Sat255, Div255, MultiplyDiv255, Luma, Clamp, Min, Max, MinRgb, MaxRgb
+	};
+}
+
+#endif
+
+const ImageProcessingBatch::Functions* ImageProcessingBatch::GetFunctions(InstructionSet instructionSet)
+{
+	if (!IsSupported(instructionSet))
+	{
+		return nullptr;
+	}
+
+	switch (instructionSet)
+	{
+#if defined(CPUFEATURES_X86)
+	case InstructionSet::Sse2:
+		return &Sse2Batch::Functions;
+	case InstructionSet::Avx2:
+		return &Avx2Batch::Functions;
+#endif
+#if defined(CPUFEATURES_NEON)
+	case InstructionSet::Neon:
+		return &NeonBatch::Functions;
+#endif
+	default:
+		return &ScalarBatch::Functions;
+	}
+}
+
+static const ImageProcessingBatch::Functions& GetPreferredFunctions()
+{
+	static const ImageProcessingBatch::Functions* preferred = ImageProcessingBatch::GetFunctions(GetPreferredInstructionSet());
+	return *preferred;
+}
+
+void ImageProcessingBatch::Sat255(const int32_t* values, uint8_t* result, uint32_t count)
+{
+	GetPreferredFunctions().Sat255(values, result, count);
+}
+
+void ImageProcessingBatch::Div255(const int32_t* values, int32_t* result, uint32_t count)
+{
+	GetPreferredFunctions().Div255(values, result, count);
+}
+
+void ImageProcessingBatch::MultiplyDiv255(const uint8_t* a, const uint8_t* b, uint8_t* result, uint32_t count)
+{
+	GetPreferredFunctions().MultiplyDiv255(a, b, result, count);
+}
+
+void ImageProcessingBatch::Luma(const uint32_t* pixels, uint8_t* result, uint32_t count)
+{
+	GetPreferredFunctions().Luma(pixels, result, count);
+}
+
+void ImageProcessingBatch::Clamp(const int32_t* values, int32_t* result, uint32_t count, int32_t min, int32_t max)
+{
+	GetPreferredFunctions().Clamp(values, result, count, min, max);
+}
+
+void ImageProcessingBatch::Min(const int32_t* a, const int32_t* b, int32_t* result, uint32_t count)
+{
+	GetPreferredFunctions().Min(a, b, result, count);
+}
+
+void ImageProcessingBatch::Max(const int32_t* a, const int32_t* b, int32_t* result, uint32_t count)
+{
+	GetPreferredFunctions().Max(a, b, result, count);
+}
+
+void ImageProcessingBatch::MinRgb(const uint32_t* pixels, uint8_t* result, uint32_t count)
+{
+	GetPreferredFunctions().MinRgb(pixels, result, count);
+}
+
+void ImageProcessingBatch::MaxRgb(const uint32_t* pixels, uint8_t* result, uint32_t count)
+{
+	GetPreferredFunctions().MaxRgb(pixels, result, count);
+}
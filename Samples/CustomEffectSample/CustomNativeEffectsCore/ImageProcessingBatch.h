@@ -0,0 +1,67 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <cstdint>
+#include "CpuFeatures.h"
+
+namespace CustomNativeEffects {
+
+	// Span versions of the ImageProcessingUtils helpers. Each function applies
+	// the helper of the same name to count consecutive elements and is
+	// bit-exact with calling that helper in a loop. Pixels are BGRA8888.
+	//
+	// Sources and results may be the same span but must not otherwise overlap.
+	namespace ImageProcessingBatch {
+
+		// result[i] = SAT255(values[i])
+		void Sat255(const int32_t* values, uint8_t* result, uint32_t count);
+
+		// result[i] = DIV255(values[i]) for values in [0, 255 * 255]
+		void Div255(const int32_t* values, int32_t* result, uint32_t count);
+
+		// result[i] = DIV255(a[i] * b[i])
+		void MultiplyDiv255(const uint8_t* a, const uint8_t* b, uint8_t* result, uint32_t count);
+
+		// result[i] = BW(r, g, b) of pixels[i]
+		void Luma(const uint32_t* pixels, uint8_t* result, uint32_t count);
+
+		// result[i] = SAT(values[i], min, max)
+		void Clamp(const int32_t* values, int32_t* result, uint32_t count, int32_t min, int32_t max);
+
+		// result[i] = MIN(a[i], b[i]) and MAX(a[i], b[i])
+		void Min(const int32_t* a, const int32_t* b, int32_t* result, uint32_t count);
+		void Max(const int32_t* a, const int32_t* b, int32_t* result, uint32_t count);
+
+		// result[i] = MIN(r, g, b) and MAX(r, g, b) of pixels[i]
+		void MinRgb(const uint32_t* pixels, uint8_t* result, uint32_t count);
+		void MaxRgb(const uint32_t* pixels, uint8_t* result, uint32_t count);
+
+		// One implementation of every batch function.
+		struct Functions
+		{
+			void (*Sat255)(const int32_t* values, uint8_t* result, uint32_t count);
+			void (*Div255)(const int32_t* values, int32_t* result, uint32_t count);
+			void (*MultiplyDiv255)(const uint8_t* a, const uint8_t* b, uint8_t* result, uint32_t count);
+			void (*Luma)(const uint32_t* pixels, uint8_t* result, uint32_t count);
+			void (*Clamp)(const int32_t* values, int32_t* result, uint32_t count, int32_t min, int32_t max);
+			void (*Min)(const int32_t* a, const int32_t* b, int32_t* result, uint32_t count);
+			void (*Max)(const int32_t* a, const int32_t* b, int32_t* result, uint32_t count);
+			void (*MinRgb)(const uint32_t* pixels, uint8_t* result, uint32_t count);
+			void (*MaxRgb)(const uint32_t* pixels, uint8_t* result, uint32_t count);
+		};
+
+		// Returns the implementations for the given instruction set, or nullptr if
+		// the current processor does not support it. The free functions above use
+		// the table for CpuFeatures::GetPreferredInstructionSet().
+		const Functions* GetFunctions(CpuFeatures::InstructionSet instructionSet);
+	}
+}
@@ -0,0 +1,44 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+
+#include "ImageProcessingUtils.h"
+#include "HueTable.h"
+
+using namespace ImageProcessingUtils;
+using namespace CustomNativeEffects;
+
+// Evaluated by the compiler; the table is constant data in the binary.
+static constexpr HueTable::Table GeneratedHueColors = HueTable::MakeTable(std::make_integer_sequence<int32_t, HueTable::Size>());
+
+static_assert(HueTable::Entry(0) == 0xFFFF0000u, "Hue 0 must be red");
+static_assert(HueTable::Entry(60 * HueTable::StepsPerDegree) == 0xFFFFFF00u, "Hue 60 must be yellow");
+static_assert(HueTable::Entry(180 * HueTable::StepsPerDegree) == 0xFF00FFFFu, "Hue 180 must be cyan");
+static_assert(HueTable::Entry(270 * HueTable::StepsPerDegree) == 0xFF7F00FFu, "Hue 270 must match (int)(30 * 4.25)");
+
+const HueTable::Table HueTable::Colors = GeneratedHueColors;
+
+int ImageProcessingUtils::HueToRgb(int hue)
+{
+    if (hue < 0 || hue >= 360)
+    {
+        hue = 0;
+    }
+
+    return static_cast<int>(HueTable::Lookup(hue * HueTable::StepsPerDegree));
+}
+
+bool ImageProcessingUtils::IsPureColor(int color)
+{
+    int r = (color >> 16) & 0x000000FF;
+    int g = (color >> 8) & 0x000000FF;
+    int b = color & 0x000000FF;
+    return ((r == 0 || g == 0 || b == 0) && (r == 255 || g == 255 || b == 255));
+}
@@ -21,6 +21,7 @@ namespace ImageProcessingUtils
     // Converts a hue into a "pure" color (one that is on the top edge of
     // the HSV color cylinder)
     // hue - The angle on the color circle [0, 360]
+    // HueTable.h has the same colors in quarter degree steps.
     int HueToRgb(int hue);
 
     // Checks if the given color is a "pure" color (one that is on the top
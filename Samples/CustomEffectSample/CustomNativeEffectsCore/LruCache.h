@@ -0,0 +1,152 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace CustomNativeEffects {
+
+	// Thread-safe map holding at most a fixed number of values, dropping the least
+	// recently used value when full. Values are returned by copy, so they should be
+	// cheap to copy, like a shared_ptr or a ref class handle.
+	template <typename Key, typename Value, typename Hash = std::hash<Key>>
+	class LruCache final
+	{
+	public:
+		struct Statistics
+		{
+			uint64_t Hits;
+			uint64_t Misses;
+			uint64_t Evictions;
+			size_t Count;
+		};
+
+		explicit LruCache(size_t capacity) :
+			m_capacity(capacity),
+			m_statistics()
+		{
+		}
+
+		LruCache(const LruCache&) = delete;
+
+		LruCache& operator=(const LruCache&) = delete;
+
+		// Returns the value cached for key, or the value returned by create. create
+		// runs without the lock held, so concurrent misses on the same key may each
+		// call it; the first value stored is the one every caller gets.
+		template <typename Create>
+		Value GetOrCreate(const Key& key, Create&& create)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+
+				if (const Value* value = FindLocked(key))
+				{
+					++m_statistics.Hits;
+					return *value;
+				}
+
+				++m_statistics.Misses;
+			}
+
+			Value value = create();
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			if (const Value* cached = FindLocked(key))
+			{
+				return *cached;
+			}
+
+			if (m_capacity == 0)
+			{
+				return value;
+			}
+
+			m_entries.emplace_front(key, std::move(value));
+			m_index.emplace(key, m_entries.begin());
+			EvictLocked();
+
+			return m_entries.front().second;
+		}
+
+		void Clear()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			m_statistics.Evictions += m_entries.size();
+			m_index.clear();
+			m_entries.clear();
+		}
+
+		size_t GetCapacity() const
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			return m_capacity;
+		}
+
+		void SetCapacity(size_t capacity)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			m_capacity = capacity;
+			EvictLocked();
+		}
+
+		Statistics GetStatistics() const
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			Statistics statistics = m_statistics;
+			statistics.Count = m_entries.size();
+			return statistics;
+		}
+
+	private:
+		typedef std::list<std::pair<Key, Value>> EntryList;
+
+		// Moves a found entry to the front of the list.
+		const Value* FindLocked(const Key& key)
+		{
+			auto found = m_index.find(key);
+
+			if (found == m_index.end())
+			{
+				return nullptr;
+			}
+
+			m_entries.splice(m_entries.begin(), m_entries, found->second);
+			return &found->second->second;
+		}
+
+		void EvictLocked()
+		{
+			while (m_entries.size() > m_capacity)
+			{
+				m_index.erase(m_entries.back().first);
+				m_entries.pop_back();
+				++m_statistics.Evictions;
+			}
+		}
+
+		mutable std::mutex m_mutex;
+		EntryList m_entries;
+		std::unordered_map<Key, typename EntryList::iterator, Hash> m_index;
+		size_t m_capacity;
+		Statistics m_statistics;
+	};
+}
@@ -0,0 +1,580 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "MagnifySmoothKernel.h"
+#include <cstring>
+
+#if defined(CPUFEATURES_X86)
+#include <emmintrin.h>
+#include <immintrin.h>
+#elif defined(CPUFEATURES_NEON)
+#include <arm_neon.h>
+#endif
+
+using namespace CustomNativeEffects;
+using namespace CustomNativeEffects::MagnifySmoothKernel;
+using namespace CpuFeatures;
+
+// Bilinear weights have 8 fractional bits.
+static const int32_t WeightShift = 8;
+static const int32_t WeightOne = 1 << WeightShift;
+static const int32_t WeightMask = WeightOne - 1;
+static const int32_t Rounding = 1 << (WeightShift - 1);
+
+static float GetNormalizedCoordinate(int32_t pixel, int32_t size)
+{
+	return (static_cast<float>(pixel) + 0.5f) / static_cast<float>(size);
+}
+
+// Converts a normalized sample coordinate to the two source pixels around it
+// and the weight of the second, clamping to the edges of the image. NaN maps
+// to the first pixel. The position is rounded to the nearest 1/256 of a pixel,
+// so a pixel center that went through MapSamplePoint with a ratio of 1 samples
+// exactly that pixel despite float rounding.
+static void GetSamplePixels(float coordinate, int32_t size, int32_t& first, int32_t& second, int32_t& weight)
+{
+	const float limit = static_cast<float>((size - 1) * WeightOne);
+
+	float fixed = (coordinate * static_cast<float>(size) - 0.5f) * static_cast<float>(WeightOne);
+	fixed = (fixed > 0.0f) ? fixed : 0.0f;
+	fixed = (fixed < limit) ? fixed : limit;
+
+	const int32_t position = static_cast<int32_t>(fixed + 0.5f);
+	first = position >> WeightShift;
+	second = first + ((first < size - 1) ? 1 : 0);
+	weight = position & WeightMask;
+}
+
+static const uint32_t* GetSourceRow(const SourceImage& source, int32_t y)
+{
+	return source.Pixels + static_cast<intptr_t>(y - source.FirstRow) * source.Pitch;
+}
+
+static uint32_t Interpolate(uint32_t first, uint32_t second, int32_t weight)
+{
+	uint32_t result = 0;
+
+	for (int32_t shift = 0; shift < 32; shift += 8)
+	{
+		const int32_t a = static_cast<int32_t>((first >> shift) & 0xFF);
+		const int32_t b = static_cast<int32_t>((second >> shift) & 0xFF);
+
+		result |= static_cast<uint32_t>((a * (WeightOne - weight) + b * weight + Rounding) >> WeightShift) << shift;
+	}
+
+	return result;
+}
+
+// Fixed-point sample position of one target pixel.
+struct SamplePosition
+{
+	int32_t X0;
+	int32_t X1;
+	int32_t WeightX;
+	int32_t Y0;
+	int32_t Y1;
+	int32_t WeightY;
+};
+
+static void GetSamplePosition(const MagnifySmoothMath::Parameters& parameters, const SourceImage& source, int32_t x, float normalizedY, SamplePosition& position)
+{
+	float sampleX;
+	float sampleY;
+	MagnifySmoothMath::MapSamplePoint(parameters, GetNormalizedCoordinate(x, source.Width), normalizedY, sampleX, sampleY);
+
+	GetSamplePixels(sampleX, source.Width, position.X0, position.X1, position.WeightX);
+	GetSamplePixels(sampleY, source.Height, position.Y0, position.Y1, position.WeightY);
+}
+
+// Renders targetPixels [first, count) of target row y; the vector paths
+// finish their rows with it.
+static void RenderRowReferenceFrom(const MagnifySmoothMath::Parameters& parameters, const SourceImage& source, int32_t y, int32_t x0, uint32_t* targetPixels, uint32_t first, uint32_t count)
+{
+	const float normalizedY = GetNormalizedCoordinate(y, source.Height);
+
+	for (uint32_t x = first; x < count; ++x)
+	{
+		SamplePosition position;
+		GetSamplePosition(parameters, source, x0 + static_cast<int32_t>(x), normalizedY, position);
+
+		const uint32_t* row0 = GetSourceRow(source, position.Y0);
+		const uint32_t* row1 = GetSourceRow(source, position.Y1);
+
+		const uint32_t top = Interpolate(row0[position.X0], row0[position.X1], position.WeightX);
+		const uint32_t bottom = Interpolate(row1[position.X0], row1[position.X1], position.WeightX);
+
+		targetPixels[x] = Interpolate(top, bottom, position.WeightY);
+	}
+}
+
+void MagnifySmoothKernel::RenderRowReference(const MagnifySmoothMath::Parameters& parameters, const SourceImage& source, int32_t y, int32_t x0, uint32_t* targetPixels, uint32_t count)
+{
+	RenderRowReferenceFrom(parameters, source, y, x0, targetPixels, 0, count);
+}
+
+#if defined(CPUFEATURES_X86)
+
+// MagnifySmoothMath::MapSamplePoint and the fixed-point conversion of
+// GetSamplePixels on four pixels. The min/max operand order reproduces the
+// scalar comparisons, including for NaN.
+struct Sse2Mapping
+{
+	Sse2Mapping(const MagnifySmoothMath::Parameters& parameters, const SourceImage& source, int32_t y) :
+		Width(_mm_set1_ps(static_cast<float>(source.Width))),
+		Height(_mm_set1_ps(static_cast<float>(source.Height))),
+		LimitX(_mm_set1_ps(static_cast<float>((source.Width - 1) * WeightOne))),
+		LimitY(_mm_set1_ps(static_cast<float>((source.Height - 1) * WeightOne))),
+		NormalizedY(_mm_set1_ps(GetNormalizedCoordinate(y, source.Height))),
+		CenterX(_mm_set1_ps(parameters.HorizontalPosition)),
+		CenterY(_mm_set1_ps(parameters.VerticalPosition)),
+		AspectRatio(_mm_set1_ps(parameters.AspectRatio)),
+		Magnification(_mm_set1_ps(parameters.MagnificationAmount)),
+		InnerRadius(_mm_set1_ps(parameters.InnerRadius)),
+		HasRamp(parameters.OuterRadius > parameters.InnerRadius),
+		RampWidth(_mm_set1_ps(parameters.OuterRadius - parameters.InnerRadius))
+	{
+	}
+
+	void Map(__m128 normalizedX, __m128& sampleX, __m128& sampleY) const
+	{
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.0f);
+
+		__m128 centerToPixelX = _mm_sub_ps(normalizedX, CenterX);
+		__m128 centerToPixelY = _mm_sub_ps(NormalizedY, CenterY);
+		__m128 scaledY = _mm_div_ps(centerToPixelY, AspectRatio);
+		__m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(centerToPixelX, centerToPixelX), _mm_mul_ps(scaledY, scaledY)));
+
+		__m128 t = HasRamp
+			? _mm_div_ps(_mm_sub_ps(distance, InnerRadius), RampWidth)
+			: _mm_andnot_ps(_mm_cmplt_ps(distance, InnerRadius), one);
+		t = _mm_min_ps(one, _mm_max_ps(zero, t));
+		__m128 ratio = _mm_mul_ps(_mm_mul_ps(t, t), _mm_sub_ps(_mm_set1_ps(3.0f), _mm_mul_ps(_mm_set1_ps(2.0f), t)));
+
+		__m128 magnifiedX = _mm_add_ps(CenterX, _mm_div_ps(centerToPixelX, Magnification));
+		__m128 magnifiedY = _mm_add_ps(CenterY, _mm_div_ps(centerToPixelY, Magnification));
+
+		sampleX = _mm_add_ps(magnifiedX, _mm_mul_ps(_mm_sub_ps(normalizedX, magnifiedX), ratio));
+		sampleY = _mm_add_ps(magnifiedY, _mm_mul_ps(_mm_sub_ps(NormalizedY, magnifiedY), ratio));
+	}
+
+	static __m128i ToFixed(__m128 coordinate, __m128 size, __m128 limit)
+	{
+		__m128 fixed = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(coordinate, size), _mm_set1_ps(0.5f)), _mm_set1_ps(static_cast<float>(WeightOne)));
+		fixed = _mm_min_ps(_mm_max_ps(fixed, _mm_setzero_ps()), limit);
+		return _mm_cvttps_epi32(_mm_add_ps(fixed, _mm_set1_ps(0.5f)));
+	}
+
+	__m128 Width;
+	__m128 Height;
+	__m128 LimitX;
+	__m128 LimitY;
+	__m128 NormalizedY;
+	__m128 CenterX;
+	__m128 CenterY;
+	__m128 AspectRatio;
+	__m128 Magnification;
+	__m128 InnerRadius;
+	bool HasRamp;
+	__m128 RampWidth;
+};
+
+// Weights of two pixels for one half of a vector unpacked to 16 bits:
+// (256 - w) * first + w * second + 128, shifted down by 8, never exceeds 16 bits.
+static __m128i InterpolateSse2(__m128i first, __m128i second, __m128i weight)
+{
+	__m128i inverse = _mm_sub_epi16(_mm_set1_epi16(WeightOne), weight);
+	__m128i sum = _mm_add_epi16(_mm_mullo_epi16(first, inverse), _mm_mullo_epi16(second, weight));
+	return _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(Rounding)), WeightShift);
+}
+
+// Bilinear blend of four pixels. Each 32-bit weight is repeated in both 16-bit
+// halves, so unpacking it against itself gives one weight per channel in the
+// same order _mm_unpacklo/hi_epi8 give the channels.
+static __m128i BlendSse2(__m128i p00, __m128i p01, __m128i p10, __m128i p11, __m128i weightX, __m128i weightY)
+{
+	const __m128i zero = _mm_setzero_si128();
+
+	weightX = _mm_or_si128(weightX, _mm_slli_epi32(weightX, 16));
+	weightY = _mm_or_si128(weightY, _mm_slli_epi32(weightY, 16));
+
+	__m128i weightXLow = _mm_unpacklo_epi32(weightX, weightX);
+	__m128i weightXHigh = _mm_unpackhi_epi32(weightX, weightX);
+	__m128i weightYLow = _mm_unpacklo_epi32(weightY, weightY);
+	__m128i weightYHigh = _mm_unpackhi_epi32(weightY, weightY);
+
+	__m128i topLow = InterpolateSse2(_mm_unpacklo_epi8(p00, zero), _mm_unpacklo_epi8(p01, zero), weightXLow);
+	__m128i topHigh = InterpolateSse2(_mm_unpackhi_epi8(p00, zero), _mm_unpackhi_epi8(p01, zero), weightXHigh);
+	__m128i bottomLow = InterpolateSse2(_mm_unpacklo_epi8(p10, zero), _mm_unpacklo_epi8(p11, zero), weightXLow);
+	__m128i bottomHigh = InterpolateSse2(_mm_unpackhi_epi8(p10, zero), _mm_unpackhi_epi8(p11, zero), weightXHigh);
+
+	return _mm_packus_epi16(InterpolateSse2(topLow, bottomLow, weightYLow), InterpolateSse2(topHigh, bottomHigh, weightYHigh));
+}
+
+// Four pixels per iteration. SSE2 has no gather, so the corner pixels are
+// loaded one by one from the fixed-point positions.
+static void RenderRowSse2(const MagnifySmoothMath::Parameters& parameters, const SourceImage& source, int32_t y, int32_t x0, uint32_t* targetPixels, uint32_t count)
+{
+	const Sse2Mapping mapping(parameters, source, y);
+	const __m128i mask = _mm_set1_epi32(WeightMask);
+	const __m128i lastColumn = _mm_set1_epi32(source.Width - 1);
+	const __m128i lastRow = _mm_set1_epi32(source.Height - 1);
+	const __m128i offsets = _mm_setr_epi32(0, 1, 2, 3);
+
+	uint32_t x = 0;
+
+	for (; x + 4 <= count; x += 4)
+	{
+		__m128 normalizedX = _mm_div_ps(_mm_add_ps(_mm_cvtepi32_ps(_mm_add_epi32(_mm_set1_epi32(x0 + static_cast<int>(x)), offsets)), _mm_set1_ps(0.5f)), mapping.Width);
+
+		__m128 sampleX;
+		__m128 sampleY;
+		mapping.Map(normalizedX, sampleX, sampleY);
+
+		__m128i fixedX = Sse2Mapping::ToFixed(sampleX, mapping.Width, mapping.LimitX);
+		__m128i fixedY = Sse2Mapping::ToFixed(sampleY, mapping.Height, mapping.LimitY);
+
+		__m128i column0 = _mm_srai_epi32(fixedX, WeightShift);
+		__m128i y0 = _mm_srai_epi32(fixedY, WeightShift);
+
+		// Adding 1 is subtracting the all-ones compare mask.
+		__m128i column1 = _mm_sub_epi32(column0, _mm_cmplt_epi32(column0, lastColumn));
+		__m128i y1 = _mm_sub_epi32(y0, _mm_cmplt_epi32(y0, lastRow));
+
+		int32_t columns0[4];
+		int32_t columns1[4];
+		int32_t rows0[4];
+		int32_t rows1[4];
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(columns0), column0);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(columns1), column1);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(rows0), y0);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(rows1), y1);
+
+		uint32_t corners[4][4];
+
+		for (int32_t i = 0; i < 4; ++i)
+		{
+			const uint32_t* row0 = GetSourceRow(source, rows0[i]);
+			const uint32_t* row1 = GetSourceRow(source, rows1[i]);
+
+			corners[0][i] = row0[columns0[i]];
+			corners[1][i] = row0[columns1[i]];
+			corners[2][i] = row1[columns0[i]];
+			corners[3][i] = row1[columns1[i]];
+		}
+
+		__m128i result = BlendSse2(
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(corners[0])),
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(corners[1])),
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(corners[2])),
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(corners[3])),
+			_mm_and_si128(fixedX, mask),
+			_mm_and_si128(fixedY, mask));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(targetPixels + x), result);
+	}
+
+	RenderRowReferenceFrom(parameters, source, y, x0, targetPixels, x, count);
+}
+
+CPUFEATURES_TARGET_AVX2
+static __m256i InterpolateAvx2(__m256i first, __m256i second, __m256i weight)
+{
+	__m256i inverse = _mm256_sub_epi16(_mm256_set1_epi16(WeightOne), weight);
+	__m256i sum = _mm256_add_epi16(_mm256_mullo_epi16(first, inverse), _mm256_mullo_epi16(second, weight));
+	return _mm256_srli_epi16(_mm256_add_epi16(sum, _mm256_set1_epi16(Rounding)), WeightShift);
+}
+
+// Same scheme as the SSE2 kernel on eight pixels, with the corner pixels
+// fetched by gathers. The unpack and pack instructions work within 128-bit
+// lanes, so the weights line up with the channels as they do for SSE2.
+CPUFEATURES_TARGET_AVX2
+static void RenderRowAvx2(const MagnifySmoothMath::Parameters& parameters, const SourceImage& source, int32_t y, int32_t x0, uint32_t* targetPixels, uint32_t count)
+{
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 half = _mm256_set1_ps(0.5f);
+	const __m256 weightOne = _mm256_set1_ps(static_cast<float>(WeightOne));
+	const __m256 width = _mm256_set1_ps(static_cast<float>(source.Width));
+	const __m256 height = _mm256_set1_ps(static_cast<float>(source.Height));
+	const __m256 limitX = _mm256_set1_ps(static_cast<float>((source.Width - 1) * WeightOne));
+	const __m256 limitY = _mm256_set1_ps(static_cast<float>((source.Height - 1) * WeightOne));
+	const __m256 normalizedY = _mm256_set1_ps(GetNormalizedCoordinate(y, source.Height));
+	const __m256 centerX = _mm256_set1_ps(parameters.HorizontalPosition);
+	const __m256 centerY = _mm256_set1_ps(parameters.VerticalPosition);
+	const __m256 aspectRatio = _mm256_set1_ps(parameters.AspectRatio);
+	const __m256 magnification = _mm256_set1_ps(parameters.MagnificationAmount);
+	const __m256 innerRadius = _mm256_set1_ps(parameters.InnerRadius);
+	const bool hasRamp = parameters.OuterRadius > parameters.InnerRadius;
+	const __m256 rampWidth = _mm256_set1_ps(parameters.OuterRadius - parameters.InnerRadius);
+
+	const __m256i zeroInteger = _mm256_setzero_si256();
+	const __m256i mask = _mm256_set1_epi32(WeightMask);
+	const __m256i lastColumn = _mm256_set1_epi32(source.Width - 1);
+	const __m256i lastRow = _mm256_set1_epi32(source.Height - 1);
+	const __m256i pitch = _mm256_set1_epi32(source.Pitch);
+	const __m256i firstRow = _mm256_set1_epi32(source.FirstRow);
+	const __m256i offsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	const int* pixels = reinterpret_cast<const int*>(source.Pixels);
+
+	uint32_t x = 0;
+
+	for (; x + 8 <= count; x += 8)
+	{
+		__m256 normalizedX = _mm256_div_ps(_mm256_add_ps(_mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_set1_epi32(x0 + static_cast<int>(x)), offsets)), half), width);
+
+		__m256 centerToPixelX = _mm256_sub_ps(normalizedX, centerX);
+		__m256 centerToPixelY = _mm256_sub_ps(normalizedY, centerY);
+		__m256 scaledY = _mm256_div_ps(centerToPixelY, aspectRatio);
+		__m256 distance = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(centerToPixelX, centerToPixelX), _mm256_mul_ps(scaledY, scaledY)));
+
+		__m256 t = hasRamp
+			? _mm256_div_ps(_mm256_sub_ps(distance, innerRadius), rampWidth)
+			: _mm256_andnot_ps(_mm256_cmp_ps(distance, innerRadius, _CMP_LT_OQ), one);
+		t = _mm256_min_ps(one, _mm256_max_ps(zero, t));
+		__m256 ratio = _mm256_mul_ps(_mm256_mul_ps(t, t), _mm256_sub_ps(_mm256_set1_ps(3.0f), _mm256_mul_ps(_mm256_set1_ps(2.0f), t)));
+
+		__m256 magnifiedX = _mm256_add_ps(centerX, _mm256_div_ps(centerToPixelX, magnification));
+		__m256 magnifiedY = _mm256_add_ps(centerY, _mm256_div_ps(centerToPixelY, magnification));
+
+		__m256 sampleX = _mm256_add_ps(magnifiedX, _mm256_mul_ps(_mm256_sub_ps(normalizedX, magnifiedX), ratio));
+		__m256 sampleY = _mm256_add_ps(magnifiedY, _mm256_mul_ps(_mm256_sub_ps(normalizedY, magnifiedY), ratio));
+
+		__m256 fixedXFloat = _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(sampleX, width), half), weightOne);
+		__m256 fixedYFloat = _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(sampleY, height), half), weightOne);
+		__m256i fixedX = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_min_ps(_mm256_max_ps(fixedXFloat, zero), limitX), half));
+		__m256i fixedY = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_min_ps(_mm256_max_ps(fixedYFloat, zero), limitY), half));
+
+		__m256i column0 = _mm256_srai_epi32(fixedX, WeightShift);
+		__m256i y0 = _mm256_srai_epi32(fixedY, WeightShift);
+		__m256i column1 = _mm256_sub_epi32(column0, _mm256_cmpgt_epi32(lastColumn, column0));
+		__m256i y1 = _mm256_sub_epi32(y0, _mm256_cmpgt_epi32(lastRow, y0));
+
+		__m256i row0 = _mm256_mullo_epi32(_mm256_sub_epi32(y0, firstRow), pitch);
+		__m256i row1 = _mm256_mullo_epi32(_mm256_sub_epi32(y1, firstRow), pitch);
+
+		__m256i p00 = _mm256_i32gather_epi32(pixels, _mm256_add_epi32(row0, column0), 4);
+		__m256i p01 = _mm256_i32gather_epi32(pixels, _mm256_add_epi32(row0, column1), 4);
+		__m256i p10 = _mm256_i32gather_epi32(pixels, _mm256_add_epi32(row1, column0), 4);
+		__m256i p11 = _mm256_i32gather_epi32(pixels, _mm256_add_epi32(row1, column1), 4);
+
+		__m256i weightX = _mm256_and_si256(fixedX, mask);
+		__m256i weightY = _mm256_and_si256(fixedY, mask);
+		weightX = _mm256_or_si256(weightX, _mm256_slli_epi32(weightX, 16));
+		weightY = _mm256_or_si256(weightY, _mm256_slli_epi32(weightY, 16));
+
+		__m256i weightXLow = _mm256_unpacklo_epi32(weightX, weightX);
+		__m256i weightXHigh = _mm256_unpackhi_epi32(weightX, weightX);
+		__m256i weightYLow = _mm256_unpacklo_epi32(weightY, weightY);
+		__m256i weightYHigh = _mm256_unpackhi_epi32(weightY, weightY);
+
+		__m256i topLow = InterpolateAvx2(_mm256_unpacklo_epi8(p00, zeroInteger), _mm256_unpacklo_epi8(p01, zeroInteger), weightXLow);
+		__m256i topHigh = InterpolateAvx2(_mm256_unpackhi_epi8(p00, zeroInteger), _mm256_unpackhi_epi8(p01, zeroInteger), weightXHigh);
+		__m256i bottomLow = InterpolateAvx2(_mm256_unpacklo_epi8(p10, zeroInteger), _mm256_unpacklo_epi8(p11, zeroInteger), weightXLow);
+		__m256i bottomHigh = InterpolateAvx2(_mm256_unpackhi_epi8(p10, zeroInteger), _mm256_unpackhi_epi8(p11, zeroInteger), weightXHigh);
+
+		__m256i result = _mm256_packus_epi16(InterpolateAvx2(topLow, bottomLow, weightYLow), InterpolateAvx2(topHigh, bottomHigh, weightYHigh));
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(targetPixels + x), result);
+	}
+
+	RenderRowReferenceFrom(parameters, source, y, x0, targetPixels, x, count);
+}
+
+#endif
+
+#if defined(CPUFEATURES_NEON)
+
+static uint16x8_t InterpolateNeon(uint16x8_t first, uint16x8_t second, uint16x8_t weight)
+{
+	uint16x8_t sum = vmulq_u16(first, vsubq_u16(vdupq_n_u16(WeightOne), weight));
+	sum = vmlaq_u16(sum, second, weight);
+	return vshrq_n_u16(vaddq_u16(sum, vdupq_n_u16(Rounding)), WeightShift);
+}
+
+// Weights of pixels 0 and 1 (low) or 2 and 3 (high), one per channel.
+static void SpreadWeightsNeon(const int32_t* weights, uint16x8_t& low, uint16x8_t& high)
+{
+	low = vcombine_u16(vdup_n_u16(static_cast<uint16_t>(weights[0])), vdup_n_u16(static_cast<uint16_t>(weights[1])));
+	high = vcombine_u16(vdup_n_u16(static_cast<uint16_t>(weights[2])), vdup_n_u16(static_cast<uint16_t>(weights[3])));
+}
+
+// Four pixels per iteration. 32-bit ARM has no vector division or square
+// root, so the sample positions come from the scalar mapping; the bilinear
+// blend is done with NEON.
+static void RenderRowNeon(const MagnifySmoothMath::Parameters& parameters, const SourceImage& source, int32_t y, int32_t x0, uint32_t* targetPixels, uint32_t count)
+{
+	const float normalizedY = GetNormalizedCoordinate(y, source.Height);
+
+	uint32_t x = 0;
+
+	for (; x + 4 <= count; x += 4)
+	{
+		uint32_t corners[4][4];
+		int32_t weightsX[4];
+		int32_t weightsY[4];
+
+		for (int32_t i = 0; i < 4; ++i)
+		{
+			SamplePosition position;
+			GetSamplePosition(parameters, source, x0 + static_cast<int32_t>(x) + i, normalizedY, position);
+
+			const uint32_t* row0 = GetSourceRow(source, position.Y0);
+			const uint32_t* row1 = GetSourceRow(source, position.Y1);
+
+			corners[0][i] = row0[position.X0];
+			corners[1][i] = row0[position.X1];
+			corners[2][i] = row1[position.X0];
+			corners[3][i] = row1[position.X1];
+			weightsX[i] = position.WeightX;
+			weightsY[i] = position.WeightY;
+		}
+
+		uint16x8_t weightXLow, weightXHigh, weightYLow, weightYHigh;
+		SpreadWeightsNeon(weightsX, weightXLow, weightXHigh);
+		SpreadWeightsNeon(weightsY, weightYLow, weightYHigh);
+
+		uint8x16_t p00 = vreinterpretq_u8_u32(vld1q_u32(corners[0]));
+		uint8x16_t p01 = vreinterpretq_u8_u32(vld1q_u32(corners[1]));
+		uint8x16_t p10 = vreinterpretq_u8_u32(vld1q_u32(corners[2]));
+		uint8x16_t p11 = vreinterpretq_u8_u32(vld1q_u32(corners[3]));
+
+		uint16x8_t topLow = InterpolateNeon(vmovl_u8(vget_low_u8(p00)), vmovl_u8(vget_low_u8(p01)), weightXLow);
+		uint16x8_t topHigh = InterpolateNeon(vmovl_u8(vget_high_u8(p00)), vmovl_u8(vget_high_u8(p01)), weightXHigh);
+		uint16x8_t bottomLow = InterpolateNeon(vmovl_u8(vget_low_u8(p10)), vmovl_u8(vget_low_u8(p11)), weightXLow);
+		uint16x8_t bottomHigh = InterpolateNeon(vmovl_u8(vget_high_u8(p10)), vmovl_u8(vget_high_u8(p11)), weightXHigh);
+
+		uint8x16_t result = vcombine_u8(
+			vmovn_u16(InterpolateNeon(topLow, bottomLow, weightYLow)),
+			vmovn_u16(InterpolateNeon(topHigh, bottomHigh, weightYHigh)));
+
+		vst1q_u32(targetPixels + x, vreinterpretq_u32_u8(result));
+	}
+
+	RenderRowReferenceFrom(parameters, source, y, x0, targetPixels, x, count);
+}
+
+#endif
+
+RowFunction MagnifySmoothKernel::GetRowFunction(InstructionSet instructionSet)
+{
+	if (!IsSupported(instructionSet))
+	{
+		return nullptr;
+	}
+
+	switch (instructionSet)
+	{
+#if defined(CPUFEATURES_X86)
+	case InstructionSet::Sse2:
+		return RenderRowSse2;
+	case InstructionSet::Avx2:
+		return RenderRowAvx2;
+#endif
+#if defined(CPUFEATURES_NEON)
+	case InstructionSet::Neon:
+		return RenderRowNeon;
+#endif
+	default:
+		return RenderRowReference;
+	}
+}
+
+RowFunction MagnifySmoothKernel::GetRowFunction()
+{
+	static const RowFunction preferred = GetRowFunction(GetPreferredInstructionSet());
+	return preferred;
+}
+
+void MagnifySmoothKernel::GetSampleRows(const MagnifySmoothMath::Parameters& parameters, int32_t width, int32_t height, int32_t& first, int32_t& last)
+{
+	MagnifySmoothMath::Bounds bounds;
+
+	if (MagnifySmoothMath::GetSampleBounds(parameters, bounds))
+	{
+		const MagnifySmoothMath::PixelRect rect = MagnifySmoothMath::ToPixelRect(bounds, width, height);
+		first = rect.Top;
+		last = rect.Bottom;
+	}
+	else
+	{
+		first = 0;
+		last = height;
+	}
+}
+
+// Columns [first, first + count) of a row to render: the influence span
+// rounded up to whole vectors, or the whole row. Whole rows only run past the
+// width when the next row is rewritten afterwards, which is not the case in place.
+static void GetRenderedColumns(const CpuWorkerRegion& region, int32_t row, bool inPlace, int32_t spanFirst, int32_t spanLast, int32_t& first, int32_t& count)
+{
+	count = (spanLast - spanFirst + VectorPixels - 1) / VectorPixels * VectorPixels;
+	first = spanFirst;
+
+	if (count >= region.Width)
+	{
+		first = 0;
+		count = inPlace ? region.Width : region.GetVectorRowLength(row, VectorPixels);
+	}
+	else if (first + count > region.Width)
+	{
+		first = region.Width - count;
+	}
+}
+
+void MagnifySmoothKernel::RenderRegion(const CpuWorkerRegion& region, int32_t firstRow, const MagnifySmoothMath::Parameters& parameters, const SourceImage& source, RowFunction rowFunction)
+{
+	const bool bounded = MagnifySmoothMath::IsBounded(parameters);
+	const bool inPlace = region.SourcePixels == region.TargetPixels && region.SourcePitch == region.TargetPitch;
+
+	const uint32_t* sourcePixels = region.SourcePixels;
+	uint32_t* targetPixels = region.TargetPixels;
+
+	for (int32_t y = 0; y < region.Height; ++y)
+	{
+		int32_t spanFirst = 0;
+		int32_t spanLast = region.Width;
+
+		if (bounded)
+		{
+			float left;
+			float right;
+
+			if (MagnifySmoothMath::GetInfluenceSpan(parameters, GetNormalizedCoordinate(firstRow + y, source.Height), left, right))
+			{
+				MagnifySmoothMath::ToPixelRange(left, right, source.Width, spanFirst, spanLast);
+			}
+			else
+			{
+				spanFirst = spanLast = 0;
+			}
+		}
+
+		int32_t first = 0;
+		int32_t count = 0;
+
+		if (spanLast > spanFirst)
+		{
+			GetRenderedColumns(region, y, inPlace, spanFirst, spanLast, first, count);
+			rowFunction(parameters, source, firstRow + y, first, targetPixels + first, static_cast<uint32_t>(count));
+		}
+
+		if (!inPlace)
+		{
+			const int32_t last = (first + count < region.Width) ? first + count : region.Width;
+
+			std::memcpy(targetPixels, sourcePixels, first * sizeof(uint32_t));
+			std::memcpy(targetPixels + last, sourcePixels + last, (region.Width - last) * sizeof(uint32_t));
+		}
+
+		sourcePixels += region.SourcePitch;
+		targetPixels += region.TargetPitch;
+	}
+}
@@ -0,0 +1,82 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <cstdint>
+#include "CpuFeatures.h"
+#include "CpuWorkerRegion.h"
+#include "MagnifySmoothMath.h"
+
+namespace CustomNativeEffects {
+
+	// Renders MagnifySmooth.hlsl on the CPU.
+	//
+	// Every target pixel center is mapped with MagnifySmoothMath::MapSamplePoint,
+	// with positions normalized to the source image, and the source is sampled
+	// bilinearly with 8-bit weights and edge clamping, which stays within 2
+	// levels of an exact float bilinear sample. The vector paths evaluate the
+	// mapping four or eight pixels at a time with the same float operations in
+	// the same order, so they are bit-exact with
+	// MagnifySmoothKernel::RenderRowReference.
+	//
+	// A target row samples source rows far from its own, so the kernels always
+	// read from the whole source image rather than from the rows of the region
+	// they write.
+	//
+	// Outside the influence ellipse (MagnifySmoothMath::GetInfluenceBounds)
+	// every pixel samples itself, so only the part of each row inside it is
+	// rendered and the rest is copied, or left alone when rendering in place.
+	// Sample positions are rounded to the nearest 1/256 of a pixel so that
+	// rendering those pixels would give the same copy.
+	namespace MagnifySmoothKernel {
+
+		// Width and Height are the size of the whole image, which positions are
+		// normalized to. Pixels points at the first pixel of row FirstRow; only
+		// the rows the samples reach need to be present.
+		struct SourceImage
+		{
+			const uint32_t* Pixels;
+			int32_t Pitch;
+			int32_t Width;
+			int32_t Height;
+			int32_t FirstRow;
+		};
+
+		// Writes count pixels of target row y starting at column x0. Rows and
+		// columns are in the coordinates of the source image, which has the same
+		// size as the target.
+		typedef void (*RowFunction)(const MagnifySmoothMath::Parameters& parameters, const SourceImage& source, int32_t y, int32_t x0, uint32_t* targetPixels, uint32_t count);
+
+		// Scalar reference implementation; every vector path must match it exactly.
+		void RenderRowReference(const MagnifySmoothMath::Parameters& parameters, const SourceImage& source, int32_t y, int32_t x0, uint32_t* targetPixels, uint32_t count);
+
+		// Returns the row function for the given instruction set, or nullptr if the
+		// current processor does not support it.
+		RowFunction GetRowFunction(CpuFeatures::InstructionSet instructionSet);
+
+		// Returns the fastest row function for the current processor.
+		RowFunction GetRowFunction();
+
+		// Row lengths are rounded up to a multiple of this, which every row
+		// function's vector width divides, so that no scalar tail is left.
+		const int32_t VectorPixels = 8;
+
+		// Rows [first, last) of the source image that rendering reads.
+		void GetSampleRows(const MagnifySmoothMath::Parameters& parameters, int32_t width, int32_t height, int32_t& first, int32_t& last);
+
+		// Renders the target rows of a region. firstRow is the row of the source
+		// image the region's first target row corresponds to. The region's own
+		// source pixels are only copied to the target outside the influence
+		// ellipse; if they are the target pixels, source must be a copy of the
+		// image that covers MagnifySmoothMath::GetSampleBounds.
+		void RenderRegion(const CpuWorkerRegion& region, int32_t firstRow, const MagnifySmoothMath::Parameters& parameters, const SourceImage& source, RowFunction rowFunction);
+	}
+}
@@ -0,0 +1,209 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace CustomNativeEffects {
+
+	// The coordinate mapping of MagnifySmooth.hlsl, for use outside the shader.
+	namespace MagnifySmoothMath {
+
+		// Same layout as the shader's constant buffer. Positions and radii are in
+		// normalized image coordinates.
+		struct Parameters
+		{
+			float InnerRadius;
+			float OuterRadius;
+			float MagnificationAmount;
+			float HorizontalPosition;
+			float VerticalPosition;
+			float AspectRatio;
+		};
+
+		static_assert(sizeof(Parameters) == 6 * sizeof(float), "Parameters must match the shader constant buffer");
+
+		inline float SmoothStep(float edge0, float edge1, float x)
+		{
+			float t = (edge1 > edge0) ? (x - edge0) / (edge1 - edge0) : (x < edge0 ? 0.0f : 1.0f);
+			t = (t < 0.0f) ? 0.0f : (t > 1.0f ? 1.0f : t);
+			return t * t * (3.0f - 2.0f * t);
+		}
+
+		// Maps the normalized output coordinate (x, y) to the normalized input
+		// coordinate the shader samples for it.
+		inline void MapSamplePoint(const Parameters& parameters, float x, float y, float& sampleX, float& sampleY)
+		{
+			const float centerToPixelX = x - parameters.HorizontalPosition;
+			const float centerToPixelY = y - parameters.VerticalPosition;
+
+			const float scaledY = centerToPixelY / parameters.AspectRatio;
+			const float distance = std::sqrt(centerToPixelX * centerToPixelX + scaledY * scaledY);
+
+			const float outerRadius = (parameters.OuterRadius > parameters.InnerRadius) ? parameters.OuterRadius : parameters.InnerRadius;
+			const float ratio = SmoothStep(parameters.InnerRadius, outerRadius, distance);
+
+			const float magnifiedX = parameters.HorizontalPosition + centerToPixelX / parameters.MagnificationAmount;
+			const float magnifiedY = parameters.VerticalPosition + centerToPixelY / parameters.MagnificationAmount;
+
+			sampleX = magnifiedX + (x - magnifiedX) * ratio;
+			sampleY = magnifiedY + (y - magnifiedY) * ratio;
+		}
+
+		// Axis-aligned rectangle in normalized image coordinates.
+		struct Bounds
+		{
+			float Left;
+			float Top;
+			float Right;
+			float Bottom;
+		};
+
+		// Radius beyond which the ratio is 1, so that a pixel samples itself.
+		inline float GetInfluenceRadius(const Parameters& parameters)
+		{
+			const float radius = (parameters.OuterRadius > parameters.InnerRadius) ? parameters.OuterRadius : parameters.InnerRadius;
+			return (radius > 0.0f) ? radius : 0.0f;
+		}
+
+		// Returns false if the parameters do not bound the region of influence,
+		// in which case every pixel has to be processed.
+		inline bool IsBounded(const Parameters& parameters)
+		{
+			const float radius = GetInfluenceRadius(parameters);
+
+			return std::isfinite(radius) && std::isfinite(parameters.AspectRatio) && parameters.AspectRatio != 0.0f &&
+				std::isfinite(parameters.HorizontalPosition) && std::isfinite(parameters.VerticalPosition);
+		}
+
+		// Bounding box of the ellipse outside which MapSamplePoint returns the
+		// point itself: the influence radius around the center, scaled vertically
+		// by the aspect ratio.
+		inline bool GetInfluenceBounds(const Parameters& parameters, Bounds& bounds)
+		{
+			if (!IsBounded(parameters))
+			{
+				return false;
+			}
+
+			const float radius = GetInfluenceRadius(parameters);
+			const float verticalRadius = radius * std::fabs(parameters.AspectRatio);
+
+			bounds.Left = parameters.HorizontalPosition - radius;
+			bounds.Top = parameters.VerticalPosition - verticalRadius;
+			bounds.Right = parameters.HorizontalPosition + radius;
+			bounds.Bottom = parameters.VerticalPosition + verticalRadius;
+			return std::isfinite(verticalRadius);
+		}
+
+		// Bounding box of the points pixels inside the influence ellipse sample.
+		// They lie between the pixel and its magnified position, so the ellipse
+		// only grows when the magnification is below 1.
+		inline bool GetSampleBounds(const Parameters& parameters, Bounds& bounds)
+		{
+			const float magnification = std::fabs(parameters.MagnificationAmount);
+
+			if (!GetInfluenceBounds(parameters, bounds) || !(magnification > 0.0f))
+			{
+				return false;
+			}
+
+			const float scale = (magnification < 1.0f) ? 1.0f / magnification : 1.0f;
+			const float horizontalRadius = (bounds.Right - bounds.Left) * 0.5f * scale;
+			const float verticalRadius = (bounds.Bottom - bounds.Top) * 0.5f * scale;
+
+			bounds.Left = parameters.HorizontalPosition - horizontalRadius;
+			bounds.Top = parameters.VerticalPosition - verticalRadius;
+			bounds.Right = parameters.HorizontalPosition + horizontalRadius;
+			bounds.Bottom = parameters.VerticalPosition + verticalRadius;
+			return std::isfinite(horizontalRadius) && std::isfinite(verticalRadius);
+		}
+
+		// Horizontal extent of the influence ellipse on the row at normalized y.
+		// Returns false if the row does not cross it.
+		inline bool GetInfluenceSpan(const Parameters& parameters, float y, float& left, float& right)
+		{
+			const float radius = GetInfluenceRadius(parameters);
+			const float scaledY = (y - parameters.VerticalPosition) / parameters.AspectRatio;
+
+			if (!(std::fabs(scaledY) < radius))
+			{
+				return false;
+			}
+
+			const float halfWidth = std::sqrt(radius * radius - scaledY * scaledY);
+			left = parameters.HorizontalPosition - halfWidth;
+			right = parameters.HorizontalPosition + halfWidth;
+			return true;
+		}
+
+		// Pixels [Left, Right) x [Top, Bottom).
+		struct PixelRect
+		{
+			int32_t Left;
+			int32_t Top;
+			int32_t Right;
+			int32_t Bottom;
+		};
+
+		// Converts a normalized extent to the pixels [first, last) of an axis
+		// with size pixels whose centers it covers, plus a margin of one pixel
+		// for rounding, clamped to the axis.
+		inline void ToPixelRange(float first, float last, int32_t size, int32_t& firstPixel, int32_t& lastPixel)
+		{
+			const float limit = static_cast<float>(size);
+			float firstCenter = std::floor(first * limit - 0.5f) - 1.0f;
+			float lastCenter = std::ceil(last * limit - 0.5f) + 2.0f;
+
+			firstCenter = (firstCenter > 0.0f) ? firstCenter : 0.0f;
+			lastCenter = (lastCenter < limit) ? lastCenter : limit;
+
+			firstPixel = (firstCenter < limit) ? static_cast<int32_t>(firstCenter) : size;
+			lastPixel = (lastCenter > 0.0f) ? static_cast<int32_t>(lastCenter) : 0;
+			lastPixel = (lastPixel > firstPixel) ? lastPixel : firstPixel;
+		}
+
+		inline PixelRect ToPixelRect(const Bounds& bounds, int32_t width, int32_t height)
+		{
+			PixelRect rect;
+			ToPixelRange(bounds.Left, bounds.Right, width, rect.Left, rect.Right);
+			ToPixelRange(bounds.Top, bounds.Bottom, height, rect.Top, rect.Bottom);
+			return rect;
+		}
+
+		// Pixels of inputRect whose value the shader can change, with positions
+		// normalized to inputRect. Every other pixel samples its own center, so
+		// drawing the shader over this rectangle alone and passing the input
+		// through elsewhere gives the same image. Returns inputRect if the
+		// parameters do not bound the influence, or if inputRect is infinite and
+		// has no size to normalize against.
+		inline PixelRect GetInfluenceRect(const Parameters& parameters, const PixelRect& inputRect)
+		{
+			const int64_t width = static_cast<int64_t>(inputRect.Right) - inputRect.Left;
+			const int64_t height = static_cast<int64_t>(inputRect.Bottom) - inputRect.Top;
+
+			Bounds bounds;
+
+			if (width <= 0 || height <= 0 || width > INT32_MAX || height > INT32_MAX || !GetInfluenceBounds(parameters, bounds))
+			{
+				return inputRect;
+			}
+
+			PixelRect rect = ToPixelRect(bounds, static_cast<int32_t>(width), static_cast<int32_t>(height));
+			rect.Left += inputRect.Left;
+			rect.Top += inputRect.Top;
+			rect.Right += inputRect.Left;
+			rect.Bottom += inputRect.Top;
+			return rect;
+		}
+	}
+}
@@ -0,0 +1,99 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace CustomNativeEffects {
+
+	// The parameter block last sent to Direct2D, so that a worker only uploads
+	// it when it actually changed.
+	//
+	// Values are compared bytewise, so T should have no padding. A value starts
+	// out pending, and stays pending until an upload succeeds.
+	template <typename T>
+	class ParameterCache final
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "ParameterCache needs a trivially copyable type");
+
+	public:
+		ParameterCache() :
+			m_value(),
+			m_isPending(true)
+		{
+		}
+
+		// Stores value and returns true if it still has to be uploaded.
+		bool Update(const T& value)
+		{
+			if (std::memcmp(&value, &m_value, sizeof(T)) != 0)
+			{
+				m_value = value;
+				m_isPending = true;
+			}
+
+			return m_isPending;
+		}
+
+		const T& GetValue() const
+		{
+			return m_value;
+		}
+
+		bool IsPending() const
+		{
+			return m_isPending;
+		}
+
+		// Makes the next upload send the value even if it has not changed, for
+		// example because the receiver was recreated.
+		void Invalidate()
+		{
+			m_isPending = true;
+		}
+
+		void MarkUploaded()
+		{
+			m_isPending = false;
+		}
+
+		// Sends the value as a pixel shader constant buffer if it is pending.
+		// Sink is ID2D1DrawInfo, or anything else with its
+		// SetPixelShaderConstantBuffer(const BYTE*, UINT32) returning an
+		// HRESULT-like result that is negative on failure. Returns the sink's
+		// result, or a value-initialized (S_OK) result if nothing was sent.
+		template <typename Sink>
+		auto Upload(Sink& sink) -> decltype(sink.SetPixelShaderConstantBuffer(static_cast<const uint8_t*>(nullptr), uint32_t()))
+		{
+			typedef decltype(sink.SetPixelShaderConstantBuffer(static_cast<const uint8_t*>(nullptr), uint32_t())) Result;
+
+			if (!m_isPending)
+			{
+				return Result();
+			}
+
+			const Result result = sink.SetPixelShaderConstantBuffer(reinterpret_cast<const uint8_t*>(&m_value), static_cast<uint32_t>(sizeof(T)));
+
+			if (!(result < 0))
+			{
+				m_isPending = false;
+			}
+
+			return result;
+		}
+
+	private:
+		T m_value;
+		bool m_isPending;
+	};
+}
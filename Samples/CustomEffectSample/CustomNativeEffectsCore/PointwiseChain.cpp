@@ -0,0 +1,159 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "PointwiseChain.h"
+#include <cstring>
+#include <stdexcept>
+
+using namespace CustomNativeEffects;
+
+static_assert(PointwiseChain::VectorPixels % GrayscaleKernel::VectorPixels == 0, "Every stage must run full vectors");
+static_assert(PointwiseChain::VectorPixels % SaturationKernel::VectorPixels == 0, "Every stage must run full vectors");
+static_assert(PointwiseChain::VectorPixels % SplitToneKernel::VectorPixels == 0, "Every stage must run full vectors");
+static_assert(PointwiseChain::TilePixels % PointwiseChain::VectorPixels == 0, "Tiles must hold whole vectors");
+
+PointwiseChain::PointwiseChain() :
+	m_stages(),
+	m_stageCount(0)
+{
+}
+
+void PointwiseChain::Clear()
+{
+	m_stageCount = 0;
+}
+
+int32_t PointwiseChain::GetStageCount() const
+{
+	return m_stageCount;
+}
+
+void PointwiseChain::AddGrayscale(GrayscaleKernel::RowFunction rowFunction)
+{
+	AddStage(StageKind::Grayscale, nullptr).Function.Grayscale = rowFunction;
+}
+
+void PointwiseChain::AddSaturation(const SaturationKernel::Matrix& matrix, SaturationKernel::RowFunction rowFunction)
+{
+	AddStage(StageKind::Saturation, &matrix).Function.Saturation = rowFunction;
+}
+
+void PointwiseChain::AddSplitTone(const SplitToneKernel::Adjustments& adjustments, SplitToneKernel::RowFunction rowFunction)
+{
+	AddStage(StageKind::SplitTone, &adjustments).Function.SplitTone = rowFunction;
+}
+
+PointwiseChain::Stage& PointwiseChain::AddStage(StageKind kind, const void* parameters)
+{
+	if (m_stageCount == MaximumStages)
+	{
+		throw std::length_error("PointwiseChain");
+	}
+
+	Stage& stage = m_stages[m_stageCount++];
+	stage.Kind = kind;
+	stage.Parameters = parameters;
+	return stage;
+}
+
+// 64-bit FNV-1a.
+static uint64_t HashBytes(uint64_t hash, const void* data, size_t length)
+{
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+
+	for (size_t i = 0; i < length; ++i)
+	{
+		hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+	}
+
+	return hash;
+}
+
+uint64_t PointwiseChain::GetParameterHash() const
+{
+	uint64_t hash = 0xCBF29CE484222325ull;
+
+	for (int32_t i = 0; i < m_stageCount; ++i)
+	{
+		const Stage& stage = m_stages[i];
+		const int32_t kind = static_cast<int32_t>(stage.Kind);
+
+		hash = HashBytes(hash, &kind, sizeof(kind));
+
+		switch (stage.Kind)
+		{
+		case StageKind::Grayscale:
+			break;
+		case StageKind::Saturation:
+			hash = HashBytes(hash, stage.Parameters, sizeof(SaturationKernel::Matrix));
+			break;
+		case StageKind::SplitTone:
+			hash = HashBytes(hash, stage.Parameters, sizeof(SplitToneKernel::Adjustments));
+			break;
+		}
+	}
+
+	return hash;
+}
+
+void PointwiseChain::ApplyStage(const Stage& stage, const uint32_t* sourcePixels, uint32_t* targetPixels, uint32_t count)
+{
+	switch (stage.Kind)
+	{
+	case StageKind::Grayscale:
+		stage.Function.Grayscale(sourcePixels, targetPixels, count);
+		break;
+	case StageKind::Saturation:
+		stage.Function.Saturation(*static_cast<const SaturationKernel::Matrix*>(stage.Parameters), sourcePixels, targetPixels, count);
+		break;
+	case StageKind::SplitTone:
+		stage.Function.SplitTone(*static_cast<const SplitToneKernel::Adjustments*>(stage.Parameters), sourcePixels, targetPixels, count);
+		break;
+	}
+}
+
+void PointwiseChain::ApplyRow(const uint32_t* sourcePixels, uint32_t* targetPixels, uint32_t count) const
+{
+	if (m_stageCount == 0)
+	{
+		if (sourcePixels != targetPixels)
+		{
+			std::memmove(targetPixels, sourcePixels, count * sizeof(uint32_t));
+		}
+
+		return;
+	}
+
+	for (uint32_t x = 0; x < count; x += TilePixels)
+	{
+		const uint32_t tileCount = (count - x < static_cast<uint32_t>(TilePixels)) ? count - x : static_cast<uint32_t>(TilePixels);
+
+		ApplyStage(m_stages[0], sourcePixels + x, targetPixels + x, tileCount);
+
+		for (int32_t i = 1; i < m_stageCount; ++i)
+		{
+			ApplyStage(m_stages[i], targetPixels + x, targetPixels + x, tileCount);
+		}
+	}
+}
+
+void PointwiseChain::ApplyRegion(const CpuWorkerRegion& region) const
+{
+	const uint32_t* sourcePixels = region.SourcePixels;
+	uint32_t* targetPixels = region.TargetPixels;
+
+	for (int32_t y = 0; y < region.Height; ++y)
+	{
+		ApplyRow(sourcePixels, targetPixels, region.GetVectorRowLength(y, VectorPixels));
+
+		sourcePixels += region.SourcePitch;
+		targetPixels += region.TargetPitch;
+	}
+}
@@ -0,0 +1,97 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <cstdint>
+#include "CpuWorkerRegion.h"
+#include "GrayscaleKernel.h"
+#include "SaturationKernel.h"
+#include "SplitToneKernel.h"
+
+namespace CustomNativeEffects {
+
+	// Runs several per-pixel kernels over an image in a single pass.
+	//
+	// Applying N effects one after the other writes and reads back N - 1 full
+	// intermediate images. The chain instead walks every row in tiles small
+	// enough to stay in the L1 cache, and runs all stages over one tile before
+	// moving to the next: the first stage reads the source tile and writes the
+	// target tile, the others update the target tile in place. Only the source
+	// is read from and the target written to memory, once each.
+	//
+	// Every stage is bit-exact with its kernel applied on its own, so the chain
+	// gives the same pixels as the separate passes. Stage parameters are
+	// referenced, not copied, and must outlive the chain's use of them.
+	class PointwiseChain final
+	{
+	public:
+		static const int32_t MaximumStages = 8;
+
+		// Pixels per tile: 2 KB of source and 2 KB of target.
+		static const int32_t TilePixels = 512;
+
+		// Row lengths are rounded up to a multiple of this, which the vector
+		// width of every stage's kernel divides.
+		static const int32_t VectorPixels = 16;
+
+		PointwiseChain();
+
+		void Clear();
+
+		int32_t GetStageCount() const;
+
+		// Append a stage that runs after the ones already added. Throw
+		// std::length_error when the chain already has MaximumStages stages.
+		void AddGrayscale(GrayscaleKernel::RowFunction rowFunction = GrayscaleKernel::GetRowFunction());
+		void AddSaturation(const SaturationKernel::Matrix& matrix, SaturationKernel::RowFunction rowFunction = SaturationKernel::GetRowFunction());
+		void AddSplitTone(const SplitToneKernel::Adjustments& adjustments, SplitToneKernel::RowFunction rowFunction = SplitToneKernel::GetRowFunction());
+
+		// A hash of the stage kinds and the contents of their parameters, equal for
+		// chains that map every color the same way, such as the chains a
+		// ColorLut3D compiled from can be cached under.
+		uint64_t GetParameterHash() const;
+
+		// Runs every stage over count pixels. Without stages the pixels are copied.
+		void ApplyRow(const uint32_t* sourcePixels, uint32_t* targetPixels, uint32_t count) const;
+
+		// ApplyRow for every row of the region, using the region's tail
+		// guarantees to run full vectors.
+		void ApplyRegion(const CpuWorkerRegion& region) const;
+
+	private:
+		enum class StageKind
+		{
+			Grayscale,
+			Saturation,
+			SplitTone
+		};
+
+		struct Stage
+		{
+			StageKind Kind;
+			const void* Parameters;
+
+			union
+			{
+				GrayscaleKernel::RowFunction Grayscale;
+				SaturationKernel::RowFunction Saturation;
+				SplitToneKernel::RowFunction SplitTone;
+			} Function;
+		};
+
+		Stage& AddStage(StageKind kind, const void* parameters);
+
+		static void ApplyStage(const Stage& stage, const uint32_t* sourcePixels, uint32_t* targetPixels, uint32_t count);
+
+		Stage m_stages[MaximumStages];
+		int32_t m_stageCount;
+	};
+}
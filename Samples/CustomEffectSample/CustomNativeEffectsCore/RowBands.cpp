@@ -0,0 +1,73 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "RowBands.h"
+#include <atomic>
+
+using namespace CustomNativeEffects;
+
+static std::atomic<uint32_t> s_bandBytes(RowBands::Options().BandBytes);
+static std::atomic<uint32_t> s_minimumParallelPixels(RowBands::Options().MinimumParallelPixels);
+
+RowBands::Options RowBands::GetDefaultOptions()
+{
+	Options options;
+	options.BandBytes = s_bandBytes.load(std::memory_order_relaxed);
+	options.MinimumParallelPixels = s_minimumParallelPixels.load(std::memory_order_relaxed);
+	return options;
+}
+
+void RowBands::SetDefaultOptions(const Options& options)
+{
+	s_bandBytes.store(options.BandBytes, std::memory_order_relaxed);
+	s_minimumParallelPixels.store(options.MinimumParallelPixels, std::memory_order_relaxed);
+}
+
+int32_t RowBands::GetBandHeight(int32_t width, const Options& options)
+{
+	// Each row is read from the source and written to the target.
+	const uint64_t bytesPerRow = static_cast<uint64_t>(width > 0 ? width : 1) * sizeof(uint32_t) * 2;
+	const uint64_t rows = options.BandBytes / bytesPerRow;
+
+	return rows > 0 ? static_cast<int32_t>(rows < INT32_MAX ? rows : INT32_MAX) : 1;
+}
+
+bool RowBands::ForEach(const CpuWorkerRegion& region, const Options& options, const BandFunction& processBand)
+{
+	if (region.Width <= 0 || region.Height <= 0)
+	{
+		return true;
+	}
+
+	const uint64_t pixelCount = static_cast<uint64_t>(region.Width) * region.Height;
+	const int32_t bandHeight = GetBandHeight(region.Width, options);
+	const int32_t bandCount = (region.Height + bandHeight - 1) / bandHeight;
+
+	if (pixelCount < options.MinimumParallelPixels || bandCount == 1)
+	{
+		if (options.Cancellation && options.Cancellation->IsCanceled())
+		{
+			return false;
+		}
+
+		processBand(region);
+		return true;
+	}
+
+	TileScheduler& scheduler = options.Scheduler ? *options.Scheduler : TileScheduler::GetDefault();
+
+	return scheduler.Run(bandCount, [&](int32_t band)
+	{
+		const int32_t firstRow = band * bandHeight;
+		const int32_t rowCount = (region.Height - firstRow < bandHeight) ? region.Height - firstRow : bandHeight;
+
+		processBand(region.Rows(firstRow, rowCount));
+	}, options.Cancellation);
+}
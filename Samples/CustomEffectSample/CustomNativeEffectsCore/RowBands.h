@@ -0,0 +1,66 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include "CpuWorkerRegion.h"
+#include "TileScheduler.h"
+
+namespace CustomNativeEffects {
+
+	// Splits a CpuWorkerRegion into horizontal bands and runs them as the
+	// tiles of a TileScheduler.
+	namespace RowBands {
+
+		struct Options
+		{
+			Options() :
+				BandBytes(256 * 1024),
+				MinimumParallelPixels(512 * 512),
+				Scheduler(nullptr),
+				Cancellation(nullptr)
+			{
+			}
+
+			// Approximate number of source plus target bytes touched by one band,
+			// sized to stay resident in a per-core L2 cache.
+			uint32_t BandBytes;
+
+			// Regions with fewer pixels than this are processed on the calling
+			// thread, so thumbnails and previews do not pay for scheduling.
+			uint32_t MinimumParallelPixels;
+
+			// The scheduler that runs the bands, or nullptr for
+			// TileScheduler::GetDefault(). Not part of the process-wide defaults.
+			TileScheduler* Scheduler;
+
+			// Checked before every band, if set. Not part of the process-wide
+			// defaults.
+			const CancellationToken* Cancellation;
+		};
+
+		typedef std::function<void(const CpuWorkerRegion& band)> BandFunction;
+
+		// Process-wide defaults used by workers that do not override them.
+		Options GetDefaultOptions();
+		void SetDefaultOptions(const Options& options);
+
+		// Number of rows per band for rows of the given width.
+		int32_t GetBandHeight(int32_t width, const Options& options);
+
+		// Calls processBand once per band, in parallel when the region is large
+		// enough. Returns after every band has been processed; an exception thrown
+		// by any band is rethrown on the calling thread. Returns false if the
+		// bands were canceled before all of them had started.
+		bool ForEach(const CpuWorkerRegion& region, const Options& options, const BandFunction& processBand);
+	}
+}
@@ -0,0 +1,261 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "SaturationKernel.h"
+#include <cmath>
+
+#if defined(CPUFEATURES_X86)
+#include <emmintrin.h>
+#include <immintrin.h>
+#elif defined(CPUFEATURES_NEON)
+#include <arm_neon.h>
+#endif
+
+using namespace CustomNativeEffects;
+using namespace CustomNativeEffects::SaturationKernel;
+using namespace CpuFeatures;
+
+static const uint32_t AlphaMask = 0xFF000000;
+static const int32_t Rounding = 1 << (WeightShift - 1);
+
+// Rounds one row of the matrix to Q14 and folds the rounding error into the
+// diagonal, so that the row sums to exactly 1 << WeightShift.
+static void RoundRow(double blue, double green, double red, int32_t diagonal, int16_t weights[3])
+{
+	const double scale = static_cast<double>(1 << WeightShift);
+	const double exact[3] = { blue, green, red };
+
+	int32_t sum = 0;
+
+	for (int32_t i = 0; i < 3; ++i)
+	{
+		weights[i] = static_cast<int16_t>(std::floor(exact[i] * scale + 0.5));
+		sum += weights[i];
+	}
+
+	weights[diagonal] = static_cast<int16_t>(weights[diagonal] + (1 << WeightShift) - sum);
+}
+
+void SaturationKernel::BuildMatrix(float saturation, Matrix& matrix)
+{
+	const double s = (saturation < 0.0f) ? 0.0 : (saturation > 1.0f ? 1.0 : static_cast<double>(saturation));
+
+	RoundRow(0.072 + 0.928 * s, 0.715 - 0.715 * s, 0.213 - 0.213 * s, 0, matrix.Blue);
+	RoundRow(0.072 - 0.072 * s, 0.715 + 0.285 * s, 0.213 - 0.213 * s, 1, matrix.Green);
+	RoundRow(0.072 - 0.072 * s, 0.715 - 0.715 * s, 0.213 + 0.787 * s, 2, matrix.Red);
+}
+
+static uint32_t ApplyWeights(const int16_t weights[3], int32_t blue, int32_t green, int32_t red)
+{
+	return static_cast<uint32_t>((weights[0] * blue + weights[1] * green + weights[2] * red + Rounding) >> WeightShift);
+}
+
+void SaturationKernel::ApplyRowReference(const Matrix& matrix, const uint32_t* sourcePixels, uint32_t* targetPixels, uint32_t count)
+{
+	for (uint32_t x = 0; x < count; ++x)
+	{
+		const uint32_t pixel = sourcePixels[x];
+
+		const int32_t red = (pixel >> 16) & 0xFF;
+		const int32_t green = (pixel >> 8) & 0xFF;
+		const int32_t blue = pixel & 0xFF;
+
+		targetPixels[x] = (pixel & AlphaMask) |
+			(ApplyWeights(matrix.Red, blue, green, red) << 16) |
+			(ApplyWeights(matrix.Green, blue, green, red) << 8) |
+			ApplyWeights(matrix.Blue, blue, green, red);
+	}
+}
+
+#if defined(CPUFEATURES_X86)
+
+static __m128i GetWeights(const int16_t weights[3])
+{
+	return _mm_setr_epi16(weights[0], weights[1], weights[2], 0, weights[0], weights[1], weights[2], 0);
+}
+
+// One output channel of four pixels, with the _mm_madd_epi16 scheme of the
+// grayscale kernel.
+static __m128i ApplyWeightsSse2(__m128i low, __m128i high, __m128i weights, __m128i rounding)
+{
+	__m128 lowSums = _mm_castsi128_ps(_mm_madd_epi16(low, weights));
+	__m128 highSums = _mm_castsi128_ps(_mm_madd_epi16(high, weights));
+
+	__m128i blueGreen = _mm_castps_si128(_mm_shuffle_ps(lowSums, highSums, _MM_SHUFFLE(2, 0, 2, 0)));
+	__m128i redAlpha = _mm_castps_si128(_mm_shuffle_ps(lowSums, highSums, _MM_SHUFFLE(3, 1, 3, 1)));
+
+	return _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(blueGreen, redAlpha), rounding), WeightShift);
+}
+
+// Four pixels per iteration.
+static void ApplyRowSse2(const Matrix& matrix, const uint32_t* sourcePixels, uint32_t* targetPixels, uint32_t count)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i rounding = _mm_set1_epi32(Rounding);
+	const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(AlphaMask));
+	const __m128i blueWeights = GetWeights(matrix.Blue);
+	const __m128i greenWeights = GetWeights(matrix.Green);
+	const __m128i redWeights = GetWeights(matrix.Red);
+
+	uint32_t x = 0;
+
+	for (; x + 4 <= count; x += 4)
+	{
+		__m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sourcePixels + x));
+		__m128i low = _mm_unpacklo_epi8(pixels, zero);
+		__m128i high = _mm_unpackhi_epi8(pixels, zero);
+
+		__m128i blue = ApplyWeightsSse2(low, high, blueWeights, rounding);
+		__m128i green = ApplyWeightsSse2(low, high, greenWeights, rounding);
+		__m128i red = ApplyWeightsSse2(low, high, redWeights, rounding);
+
+		__m128i result = _mm_or_si128(_mm_or_si128(blue, _mm_slli_epi32(green, 8)), _mm_or_si128(_mm_slli_epi32(red, 16), _mm_and_si128(pixels, alphaMask)));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(targetPixels + x), result);
+	}
+
+	ApplyRowReference(matrix, sourcePixels + x, targetPixels + x, count - x);
+}
+
+CPUFEATURES_TARGET_AVX2
+static __m256i ApplyWeightsAvx2(__m256i low, __m256i high, __m256i weights, __m256i rounding)
+{
+	__m256 lowSums = _mm256_castsi256_ps(_mm256_madd_epi16(low, weights));
+	__m256 highSums = _mm256_castsi256_ps(_mm256_madd_epi16(high, weights));
+
+	__m256i blueGreen = _mm256_castps_si256(_mm256_shuffle_ps(lowSums, highSums, _MM_SHUFFLE(2, 0, 2, 0)));
+	__m256i redAlpha = _mm256_castps_si256(_mm256_shuffle_ps(lowSums, highSums, _MM_SHUFFLE(3, 1, 3, 1)));
+
+	return _mm256_srli_epi32(_mm256_add_epi32(_mm256_add_epi32(blueGreen, redAlpha), rounding), WeightShift);
+}
+
+// Same scheme on eight pixels; unpack and shuffle stay within 128-bit lanes,
+// which keeps the pixels in order.
+CPUFEATURES_TARGET_AVX2
+static void ApplyRowAvx2(const Matrix& matrix, const uint32_t* sourcePixels, uint32_t* targetPixels, uint32_t count)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i rounding = _mm256_set1_epi32(Rounding);
+	const __m256i alphaMask = _mm256_set1_epi32(static_cast<int>(AlphaMask));
+	const __m256i blueWeights = _mm256_broadcastsi128_si256(GetWeights(matrix.Blue));
+	const __m256i greenWeights = _mm256_broadcastsi128_si256(GetWeights(matrix.Green));
+	const __m256i redWeights = _mm256_broadcastsi128_si256(GetWeights(matrix.Red));
+
+	uint32_t x = 0;
+
+	for (; x + 8 <= count; x += 8)
+	{
+		__m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sourcePixels + x));
+		__m256i low = _mm256_unpacklo_epi8(pixels, zero);
+		__m256i high = _mm256_unpackhi_epi8(pixels, zero);
+
+		__m256i blue = ApplyWeightsAvx2(low, high, blueWeights, rounding);
+		__m256i green = ApplyWeightsAvx2(low, high, greenWeights, rounding);
+		__m256i red = ApplyWeightsAvx2(low, high, redWeights, rounding);
+
+		__m256i result = _mm256_or_si256(_mm256_or_si256(blue, _mm256_slli_epi32(green, 8)), _mm256_or_si256(_mm256_slli_epi32(red, 16), _mm256_and_si256(pixels, alphaMask)));
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(targetPixels + x), result);
+	}
+
+	ApplyRowReference(matrix, sourcePixels + x, targetPixels + x, count - x);
+}
+
+#endif
+
+#if defined(CPUFEATURES_NEON)
+
+// One output channel of eight de-interleaved pixels, accumulated in 32 bits
+// and narrowed with the reference's round-to-nearest shift.
+static uint8x8_t ApplyWeightsNeon(const int16_t weights[3], uint16x8_t blue, uint16x8_t green, uint16x8_t red)
+{
+	const uint16_t weightBlue = static_cast<uint16_t>(weights[0]);
+	const uint16_t weightGreen = static_cast<uint16_t>(weights[1]);
+	const uint16_t weightRed = static_cast<uint16_t>(weights[2]);
+
+	uint32x4_t low = vmull_n_u16(vget_low_u16(blue), weightBlue);
+	low = vmlal_n_u16(low, vget_low_u16(green), weightGreen);
+	low = vmlal_n_u16(low, vget_low_u16(red), weightRed);
+
+	uint32x4_t high = vmull_n_u16(vget_high_u16(blue), weightBlue);
+	high = vmlal_n_u16(high, vget_high_u16(green), weightGreen);
+	high = vmlal_n_u16(high, vget_high_u16(red), weightRed);
+
+	return vmovn_u16(vcombine_u16(vrshrn_n_u32(low, WeightShift), vrshrn_n_u32(high, WeightShift)));
+}
+
+// Eight pixels per iteration.
+static void ApplyRowNeon(const Matrix& matrix, const uint32_t* sourcePixels, uint32_t* targetPixels, uint32_t count)
+{
+	uint32_t x = 0;
+
+	for (; x + 8 <= count; x += 8)
+	{
+		uint8x8x4_t bgra = vld4_u8(reinterpret_cast<const uint8_t*>(sourcePixels + x));
+
+		uint16x8_t blue = vmovl_u8(bgra.val[0]);
+		uint16x8_t green = vmovl_u8(bgra.val[1]);
+		uint16x8_t red = vmovl_u8(bgra.val[2]);
+
+		bgra.val[0] = ApplyWeightsNeon(matrix.Blue, blue, green, red);
+		bgra.val[1] = ApplyWeightsNeon(matrix.Green, blue, green, red);
+		bgra.val[2] = ApplyWeightsNeon(matrix.Red, blue, green, red);
+
+		vst4_u8(reinterpret_cast<uint8_t*>(targetPixels + x), bgra);
+	}
+
+	ApplyRowReference(matrix, sourcePixels + x, targetPixels + x, count - x);
+}
+
+#endif
+
+RowFunction SaturationKernel::GetRowFunction(InstructionSet instructionSet)
+{
+	if (!IsSupported(instructionSet))
+	{
+		return nullptr;
+	}
+
+	switch (instructionSet)
+	{
+#if defined(CPUFEATURES_X86)
+	case InstructionSet::Sse2:
+		return ApplyRowSse2;
+	case InstructionSet::Avx2:
+		return ApplyRowAvx2;
+#endif
+#if defined(CPUFEATURES_NEON)
+	case InstructionSet::Neon:
+		return ApplyRowNeon;
+#endif
+	default:
+		return ApplyRowReference;
+	}
+}
+
+RowFunction SaturationKernel::GetRowFunction()
+{
+	static const RowFunction preferred = GetRowFunction(GetPreferredInstructionSet());
+	return preferred;
+}
+
+void SaturationKernel::ApplyRegion(const CpuWorkerRegion& region, const Matrix& matrix, RowFunction rowFunction)
+{
+	const uint32_t* sourcePixels = region.SourcePixels;
+	uint32_t* targetPixels = region.TargetPixels;
+
+	for (int32_t y = 0; y < region.Height; ++y)
+	{
+		rowFunction(matrix, sourcePixels, targetPixels, region.GetVectorRowLength(y, VectorPixels));
+
+		sourcePixels += region.SourcePitch;
+		targetPixels += region.TargetPitch;
+	}
+}
@@ -0,0 +1,67 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <cstdint>
+#include "CpuFeatures.h"
+#include "CpuWorkerRegion.h"
+
+namespace CustomNativeEffects {
+
+	// Changes the saturation of BGRA8888 pixels on the CPU, as the Direct2D
+	// saturation effect does.
+	//
+	// The color matrix is the one of the SVG feColorMatrix "saturate" type that
+	// Direct2D documents for the effect. The weights are rounded to Q14 with
+	// every row summing to exactly 1 << 14, so gray stays gray and no channel
+	// can overflow; the result is within 0.5 of a level of the exact matrix
+	// product plus the weight rounding, at most 1 level in total. Alpha is
+	// passed through, which suits premultiplied pixels as well since the
+	// matrix is linear.
+	//
+	// All paths are bit-exact with SaturationKernel::ApplyRowReference.
+	namespace SaturationKernel {
+
+		const int32_t WeightShift = 14;
+
+		// Q14 weights of every output channel, each given as the weights of the
+		// blue, green and red input channels. All weights are non-negative.
+		struct Matrix
+		{
+			int16_t Blue[3];
+			int16_t Green[3];
+			int16_t Red[3];
+		};
+
+		// Saturation 0 gives gray and 1 leaves the pixels unchanged. Values
+		// outside that range are clamped to it, as Direct2D does.
+		void BuildMatrix(float saturation, Matrix& matrix);
+
+		typedef void (*RowFunction)(const Matrix& matrix, const uint32_t* sourcePixels, uint32_t* targetPixels, uint32_t count);
+
+		// Scalar reference implementation; every vector path must match it exactly.
+		void ApplyRowReference(const Matrix& matrix, const uint32_t* sourcePixels, uint32_t* targetPixels, uint32_t count);
+
+		// Returns the row function for the given instruction set, or nullptr if the
+		// current processor does not support it.
+		RowFunction GetRowFunction(CpuFeatures::InstructionSet instructionSet);
+
+		// Returns the fastest row function for the current processor.
+		RowFunction GetRowFunction();
+
+		// Row lengths are rounded up to a multiple of this, which every row
+		// function's vector width divides, so that no scalar tail is left.
+		const int32_t VectorPixels = 8;
+
+		// Applies the matrix to every row of the region.
+		void ApplyRegion(const CpuWorkerRegion& region, const Matrix& matrix, RowFunction rowFunction);
+	}
+}
@@ -0,0 +1,242 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "SplitToneKernel.h"
+
+#if defined(CPUFEATURES_X86)
+#include <emmintrin.h>
+#include <immintrin.h>
+#elif defined(CPUFEATURES_NEON)
+#include <arm_neon.h>
+#endif
+
+using namespace CustomNativeEffects;
+using namespace CustomNativeEffects::SplitToneKernel;
+using namespace CpuFeatures;
+
+static const uint32_t ColorMask = 0x00FFFFFF;
+
+// Texel the shader's point sampler picks for an intensity of sum / 765.
+static int32_t GetTexelIndex(int32_t sum)
+{
+	const int32_t index = sum * 256 / MaximumSum;
+	return index < 255 ? index : 255;
+}
+
+void SplitToneKernel::BuildAdjustments(const SplitToneTable::LookupTable& lookupTable, Adjustments& adjustments)
+{
+	for (int32_t sum = 0; sum <= MaximumSum; ++sum)
+	{
+		const int32_t index = GetTexelIndex(sum);
+		const uint32_t shadows = lookupTable[index];
+		const uint32_t highlights = lookupTable[256 + index];
+
+		uint32_t raise = 0;
+		uint32_t lower = 0;
+
+		for (int32_t shift = 0; shift < 24; shift += 8)
+		{
+			const int32_t delta = static_cast<int32_t>((shadows >> shift) & 0xFF) + static_cast<int32_t>((highlights >> shift) & 0xFF) - 255;
+
+			if (delta > 0)
+			{
+				raise |= static_cast<uint32_t>(delta) << shift;
+			}
+			else
+			{
+				lower |= static_cast<uint32_t>(-delta) << shift;
+			}
+		}
+
+		adjustments.Raise[sum] = raise;
+		adjustments.Lower[sum] = lower;
+	}
+}
+
+void SplitToneKernel::ApplyRowReference(const Adjustments& adjustments, const uint32_t* sourcePixels, uint32_t* targetPixels, uint32_t count)
+{
+	for (uint32_t x = 0; x < count; ++x)
+	{
+		const uint32_t pixel = sourcePixels[x];
+		const int32_t sum = static_cast<int32_t>(((pixel >> 16) & 0xFF) + ((pixel >> 8) & 0xFF) + (pixel & 0xFF));
+		const uint32_t raise = adjustments.Raise[sum];
+		const uint32_t lower = adjustments.Lower[sum];
+
+		uint32_t result = pixel & ~ColorMask;
+
+		for (int32_t shift = 0; shift < 24; shift += 8)
+		{
+			int32_t channel = static_cast<int32_t>((pixel >> shift) & 0xFF) + static_cast<int32_t>((raise >> shift) & 0xFF);
+			channel = channel < 255 ? channel : 255;
+			channel -= static_cast<int32_t>((lower >> shift) & 0xFF);
+			channel = channel > 0 ? channel : 0;
+
+			result |= static_cast<uint32_t>(channel) << shift;
+		}
+
+		targetPixels[x] = result;
+	}
+}
+
+#if defined(CPUFEATURES_X86)
+
+// Four pixels per iteration. R + G + B is computed with the _mm_madd_epi16
+// scheme of the grayscale kernel using unit weights, the adjustments are
+// fetched with scalar loads and applied with saturating byte arithmetic.
+static void ApplyRowSse2(const Adjustments& adjustments, const uint32_t* sourcePixels, uint32_t* targetPixels, uint32_t count)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i ones = _mm_setr_epi16(1, 1, 1, 0, 1, 1, 1, 0);
+
+	uint32_t x = 0;
+
+	for (; x + 4 <= count; x += 4)
+	{
+		__m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sourcePixels + x));
+
+		__m128 low = _mm_castsi128_ps(_mm_madd_epi16(_mm_unpacklo_epi8(pixels, zero), ones));
+		__m128 high = _mm_castsi128_ps(_mm_madd_epi16(_mm_unpackhi_epi8(pixels, zero), ones));
+
+		__m128i blueGreen = _mm_castps_si128(_mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0)));
+		__m128i red = _mm_castps_si128(_mm_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1)));
+		__m128i sums = _mm_add_epi32(blueGreen, red);
+
+		const int32_t sum0 = _mm_cvtsi128_si32(sums);
+		const int32_t sum1 = _mm_cvtsi128_si32(_mm_srli_si128(sums, 4));
+		const int32_t sum2 = _mm_cvtsi128_si32(_mm_srli_si128(sums, 8));
+		const int32_t sum3 = _mm_cvtsi128_si32(_mm_srli_si128(sums, 12));
+
+		__m128i raise = _mm_setr_epi32(
+			static_cast<int>(adjustments.Raise[sum0]), static_cast<int>(adjustments.Raise[sum1]),
+			static_cast<int>(adjustments.Raise[sum2]), static_cast<int>(adjustments.Raise[sum3]));
+		__m128i lower = _mm_setr_epi32(
+			static_cast<int>(adjustments.Lower[sum0]), static_cast<int>(adjustments.Lower[sum1]),
+			static_cast<int>(adjustments.Lower[sum2]), static_cast<int>(adjustments.Lower[sum3]));
+
+		__m128i result = _mm_subs_epu8(_mm_adds_epu8(pixels, raise), lower);
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(targetPixels + x), result);
+	}
+
+	ApplyRowReference(adjustments, sourcePixels + x, targetPixels + x, count - x);
+}
+
+// Same scheme on eight pixels, with the adjustments fetched by two gathers.
+CPUFEATURES_TARGET_AVX2
+static void ApplyRowAvx2(const Adjustments& adjustments, const uint32_t* sourcePixels, uint32_t* targetPixels, uint32_t count)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i ones = _mm256_setr_epi16(1, 1, 1, 0, 1, 1, 1, 0, 1, 1, 1, 0, 1, 1, 1, 0);
+	const int* raiseTable = reinterpret_cast<const int*>(adjustments.Raise);
+	const int* lowerTable = reinterpret_cast<const int*>(adjustments.Lower);
+
+	uint32_t x = 0;
+
+	for (; x + 8 <= count; x += 8)
+	{
+		__m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sourcePixels + x));
+
+		__m256 low = _mm256_castsi256_ps(_mm256_madd_epi16(_mm256_unpacklo_epi8(pixels, zero), ones));
+		__m256 high = _mm256_castsi256_ps(_mm256_madd_epi16(_mm256_unpackhi_epi8(pixels, zero), ones));
+
+		__m256i blueGreen = _mm256_castps_si256(_mm256_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0)));
+		__m256i red = _mm256_castps_si256(_mm256_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1)));
+		__m256i sums = _mm256_add_epi32(blueGreen, red);
+
+		__m256i raise = _mm256_i32gather_epi32(raiseTable, sums, 4);
+		__m256i lower = _mm256_i32gather_epi32(lowerTable, sums, 4);
+
+		__m256i result = _mm256_subs_epu8(_mm256_adds_epu8(pixels, raise), lower);
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(targetPixels + x), result);
+	}
+
+	ApplyRowReference(adjustments, sourcePixels + x, targetPixels + x, count - x);
+}
+
+#endif
+
+#if defined(CPUFEATURES_NEON)
+
+// Four pixels per iteration. Masking alpha and adding bytes pairwise twice
+// leaves R + G + B in each 32-bit lane.
+static void ApplyRowNeon(const Adjustments& adjustments, const uint32_t* sourcePixels, uint32_t* targetPixels, uint32_t count)
+{
+	const uint32x4_t colorMask = vdupq_n_u32(ColorMask);
+
+	uint32_t x = 0;
+
+	for (; x + 4 <= count; x += 4)
+	{
+		uint32x4_t pixels = vld1q_u32(sourcePixels + x);
+		uint32x4_t sums = vpaddlq_u16(vpaddlq_u8(vreinterpretq_u8_u32(vandq_u32(pixels, colorMask))));
+
+		const uint32_t sum0 = vgetq_lane_u32(sums, 0);
+		const uint32_t sum1 = vgetq_lane_u32(sums, 1);
+		const uint32_t sum2 = vgetq_lane_u32(sums, 2);
+		const uint32_t sum3 = vgetq_lane_u32(sums, 3);
+
+		const uint32_t raiseValues[4] = { adjustments.Raise[sum0], adjustments.Raise[sum1], adjustments.Raise[sum2], adjustments.Raise[sum3] };
+		const uint32_t lowerValues[4] = { adjustments.Lower[sum0], adjustments.Lower[sum1], adjustments.Lower[sum2], adjustments.Lower[sum3] };
+
+		uint8x16_t result = vqaddq_u8(vreinterpretq_u8_u32(pixels), vreinterpretq_u8_u32(vld1q_u32(raiseValues)));
+		result = vqsubq_u8(result, vreinterpretq_u8_u32(vld1q_u32(lowerValues)));
+
+		vst1q_u32(targetPixels + x, vreinterpretq_u32_u8(result));
+	}
+
+	ApplyRowReference(adjustments, sourcePixels + x, targetPixels + x, count - x);
+}
+
+#endif
+
+RowFunction SplitToneKernel::GetRowFunction(InstructionSet instructionSet)
+{
+	if (!IsSupported(instructionSet))
+	{
+		return nullptr;
+	}
+
+	switch (instructionSet)
+	{
+#if defined(CPUFEATURES_X86)
+	case InstructionSet::Sse2:
+		return ApplyRowSse2;
+	case InstructionSet::Avx2:
+		return ApplyRowAvx2;
+#endif
+#if defined(CPUFEATURES_NEON)
+	case InstructionSet::Neon:
+		return ApplyRowNeon;
+#endif
+	default:
+		return ApplyRowReference;
+	}
+}
+
+RowFunction SplitToneKernel::GetRowFunction()
+{
+	static const RowFunction preferred = GetRowFunction(GetPreferredInstructionSet());
+	return preferred;
+}
+
+void SplitToneKernel::ApplyRegion(const CpuWorkerRegion& region, const Adjustments& adjustments, RowFunction rowFunction)
+{
+	const uint32_t* sourcePixels = region.SourcePixels;
+	uint32_t* targetPixels = region.TargetPixels;
+
+	for (int32_t y = 0; y < region.Height; ++y)
+	{
+		rowFunction(adjustments, sourcePixels, targetPixels, region.GetVectorRowLength(y, VectorPixels));
+
+		sourcePixels += region.SourcePitch;
+		targetPixels += region.TargetPitch;
+	}
+}
@@ -0,0 +1,69 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <cstdint>
+#include "CpuFeatures.h"
+#include "CpuWorkerRegion.h"
+#include "SplitToneTable.h"
+
+namespace CustomNativeEffects {
+
+	// Applies a split tone lookup table to BGRA8888 pixels on the CPU.
+	//
+	// SplitTonePixelShader.hlsl point-samples texel floor(256 * (R + G + B) / 765)
+	// of both table rows and adds (row0 - 0.5) + (row1 - 0.5) to every color
+	// channel. With 8-bit channels that is exactly
+	//
+	//     out = clamp(in + row0 + row1 - 255, 0, 255)
+	//
+	// which this kernel computes in integers; alpha is passed through. Given
+	// 8-bit unorm input and output the result equals the shader's, so the
+	// tolerance against the GPU path is the +-1 level a driver may introduce
+	// when it quantizes float output or samples at a texel boundary.
+	//
+	// All paths are bit-exact with SplitToneKernel::ApplyRowReference.
+	namespace SplitToneKernel {
+
+		// Largest R + G + B.
+		const int32_t MaximumSum = 3 * 255;
+
+		// The per-channel adjustment for every R + G + B, split into the amount
+		// to add and the amount to subtract so that both can be applied with
+		// saturating unsigned byte arithmetic. Alpha bytes are zero.
+		struct Adjustments
+		{
+			uint32_t Raise[MaximumSum + 1];
+			uint32_t Lower[MaximumSum + 1];
+		};
+
+		void BuildAdjustments(const SplitToneTable::LookupTable& lookupTable, Adjustments& adjustments);
+
+		typedef void (*RowFunction)(const Adjustments& adjustments, const uint32_t* sourcePixels, uint32_t* targetPixels, uint32_t count);
+
+		// Scalar reference implementation; every vector path must match it exactly.
+		void ApplyRowReference(const Adjustments& adjustments, const uint32_t* sourcePixels, uint32_t* targetPixels, uint32_t count);
+
+		// Returns the row function for the given instruction set, or nullptr if the
+		// current processor does not support it.
+		RowFunction GetRowFunction(CpuFeatures::InstructionSet instructionSet);
+
+		// Returns the fastest row function for the current processor.
+		RowFunction GetRowFunction();
+
+		// Row lengths are rounded up to a multiple of this, which every row
+		// function's vector width divides, so that no scalar tail is left.
+		const int32_t VectorPixels = 16;
+
+		// Applies the adjustments to every row of the region.
+		void ApplyRegion(const CpuWorkerRegion& region, const Adjustments& adjustments, RowFunction rowFunction);
+	}
+}
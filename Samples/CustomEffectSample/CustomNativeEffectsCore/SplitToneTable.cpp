@@ -0,0 +1,219 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "SplitToneTable.h"
+#include "CpuFeatures.h"
+#include "ImageProcessingUtils.h"
+#include <functional>
+
+#if defined(CPUFEATURES_X86)
+#include <emmintrin.h>
+#elif defined(CPUFEATURES_NEON)
+#include <arm_neon.h>
+#endif
+
+using namespace CustomNativeEffects;
+using namespace ImageProcessingUtils;
+using namespace CpuFeatures;
+
+// Builds a table row from the curve deltas, which are in [-255, 255]. Every
+// implementation matches the scalar one.
+namespace ScalarSplitTone
+{
+	// Blends the negative and positive deltas by how much of the channel the tint
+	// color contains, and returns the result biased by 128 and clamped to a byte.
+	static int32_t GetChannelDelta(int32_t negativeDelta, int32_t positiveDelta, int32_t channel)
+	{
+		const int32_t delta = (negativeDelta * (255 - channel) + positiveDelta * channel) / 255;
+
+		// Since the 8 bit per color format is unsigned, bias by 128.
+		// This will be subtracted in the shader.
+		return MIN(255, MAX(0, 128 + delta));
+	}
+
+	static void MixRow(const int32_t* negativeDeltas, const int32_t* positiveDeltas, int32_t color, uint32_t* row)
+	{
+		const int32_t red = (color >> 16) & 0xFF;
+		const int32_t green = (color >> 8) & 0xFF;
+		const int32_t blue = color & 0xFF;
+
+		for (int i = 0; i < 256; i++)
+		{
+			const int32_t r = GetChannelDelta(negativeDeltas[i], positiveDeltas[i], red);
+			const int32_t g = GetChannelDelta(negativeDeltas[i], positiveDeltas[i], green);
+			const int32_t b = GetChannelDelta(negativeDeltas[i], positiveDeltas[i], blue);
+
+			row[i] = static_cast<uint32_t>((r << 16) | (g << 8) | b);
+		}
+	}
+}
+
+#if defined(CPUFEATURES_X86)
+
+// Four entries per register. Every product fits the 16-bit halves of a lane,
+// so _mm_madd_epi16 does the multiplies SSE2 lacks for 32-bit lanes.
+namespace Sse2SplitTone
+{
+	static inline __m128i Load(const int32_t* source)
+	{
+		return _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+	}
+
+	static inline void Store(void* target, __m128i value)
+	{
+		_mm_storeu_si128(static_cast<__m128i*>(target), value);
+	}
+
+	// Negates the lanes where sign is all ones.
+	static inline __m128i ApplySign(__m128i value, __m128i sign)
+	{
+		return _mm_sub_epi32(_mm_xor_si128(value, sign), sign);
+	}
+
+	// The weights for one channel, matching the (negative, positive) pairs.
+	static inline __m128i GetWeights(int32_t channel)
+	{
+		return _mm_set1_epi32((channel << 16) | (255 - channel));
+	}
+
+	static inline __m128i GetChannelDelta(__m128i pairs, __m128i weights)
+	{
+		const __m128i sum = _mm_madd_epi16(pairs, weights);
+		const __m128i sign = _mm_srai_epi32(sum, 31);
+		const __m128i magnitude = ApplySign(sum, sign);
+
+		// DIV255 divides exactly for values up to 255 * 255.
+		const __m128i quotient = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(_mm_srli_epi32(magnitude, 8), magnitude), _mm_set1_epi32(1)), 8);
+		const __m128i biased = _mm_add_epi32(ApplySign(quotient, sign), _mm_set1_epi32(128));
+
+		// biased is in [-127, 383], where the 16-bit min and max give the 32-bit result.
+		return _mm_min_epi16(_mm_max_epi16(biased, _mm_setzero_si128()), _mm_set1_epi32(255));
+	}
+
+	static void MixRow(const int32_t* negativeDeltas, const int32_t* positiveDeltas, int32_t color, uint32_t* row)
+	{
+		const __m128i redWeights = GetWeights((color >> 16) & 0xFF);
+		const __m128i greenWeights = GetWeights((color >> 8) & 0xFF);
+		const __m128i blueWeights = GetWeights(color & 0xFF);
+
+		for (int i = 0; i < 256; i += 4)
+		{
+			// The negative delta in the low half of each lane, the positive one in the high half.
+			const __m128i pairs = _mm_or_si128(
+				_mm_and_si128(Load(negativeDeltas + i), _mm_set1_epi32(0xFFFF)),
+				_mm_slli_epi32(Load(positiveDeltas + i), 16));
+
+			const __m128i r = GetChannelDelta(pairs, redWeights);
+			const __m128i g = GetChannelDelta(pairs, greenWeights);
+			const __m128i b = GetChannelDelta(pairs, blueWeights);
+
+			Store(row + i, _mm_or_si128(_mm_or_si128(_mm_slli_epi32(r, 16), _mm_slli_epi32(g, 8)), b));
+		}
+	}
+}
+
+#endif
+
+#if defined(CPUFEATURES_NEON)
+
+namespace NeonSplitTone
+{
+	static inline int32x4_t ApplySign(int32x4_t magnitude, int32x4_t value)
+	{
+		return vbslq_s32(vcltq_s32(value, vdupq_n_s32(0)), vnegq_s32(magnitude), magnitude);
+	}
+
+	static inline int32x4_t GetChannelDelta(int32x4_t negativeDelta, int32x4_t positiveDelta, int32_t channel)
+	{
+		const int32x4_t sum = vmlaq_n_s32(vmulq_n_s32(negativeDelta, 255 - channel), positiveDelta, channel);
+		const int32x4_t magnitude = vabsq_s32(sum);
+
+		// DIV255 divides exactly for values up to 255 * 255.
+		const int32x4_t quotient = vshrq_n_s32(vaddq_s32(vaddq_s32(vshrq_n_s32(magnitude, 8), magnitude), vdupq_n_s32(1)), 8);
+		const int32x4_t biased = vaddq_s32(ApplySign(quotient, sum), vdupq_n_s32(128));
+
+		return vminq_s32(vmaxq_s32(biased, vdupq_n_s32(0)), vdupq_n_s32(255));
+	}
+
+	static void MixRow(const int32_t* negativeDeltas, const int32_t* positiveDeltas, int32_t color, uint32_t* row)
+	{
+		const int32_t red = (color >> 16) & 0xFF;
+		const int32_t green = (color >> 8) & 0xFF;
+		const int32_t blue = color & 0xFF;
+
+		for (int i = 0; i < 256; i += 4)
+		{
+			const int32x4_t negativeDelta = vld1q_s32(negativeDeltas + i);
+			const int32x4_t positiveDelta = vld1q_s32(positiveDeltas + i);
+
+			const int32x4_t r = GetChannelDelta(negativeDelta, positiveDelta, red);
+			const int32x4_t g = GetChannelDelta(negativeDelta, positiveDelta, green);
+			const int32x4_t b = GetChannelDelta(negativeDelta, positiveDelta, blue);
+
+			const int32x4_t rgb = vorrq_s32(vorrq_s32(vshlq_n_s32(r, 16), vshlq_n_s32(g, 8)), b);
+			vst1q_u32(row + i, vreinterpretq_u32_s32(rgb));
+		}
+	}
+}
+
+#endif
+
+typedef void (*MixRowFunction)(const int32_t* negativeDeltas, const int32_t* positiveDeltas, int32_t color, uint32_t* row);
+
+static MixRowFunction GetMixRowFunction()
+{
+#if defined(CPUFEATURES_X86)
+	static const MixRowFunction mixRow = IsSupported(InstructionSet::Sse2) ? Sse2SplitTone::MixRow : ScalarSplitTone::MixRow;
+#elif defined(CPUFEATURES_NEON)
+	static const MixRowFunction mixRow = IsSupported(InstructionSet::Neon) ? NeonSplitTone::MixRow : ScalarSplitTone::MixRow;
+#else
+	static const MixRowFunction mixRow = ScalarSplitTone::MixRow;
+#endif
+
+	return mixRow;
+}
+
+size_t SplitToneTable::ParametersHash::operator()(const Parameters& parameters) const
+{
+	// Normalized hues need 9 bits and saturations 7 bits.
+	const uint32_t packed =
+		(static_cast<uint32_t>(parameters.HighlightsHue) << 23) ^
+		(static_cast<uint32_t>(parameters.HighlightsSaturation) << 16) ^
+		(static_cast<uint32_t>(parameters.ShadowsHue) << 7) ^
+		static_cast<uint32_t>(parameters.ShadowsSaturation);
+
+	return std::hash<uint32_t>()(packed);
+}
+
+SplitToneTable::Parameters SplitToneTable::Normalize(int32_t highlightsHue, int32_t highlightsSaturation, int32_t shadowsHue, int32_t shadowsSaturation)
+{
+	shadowsHue %= 360;
+	highlightsHue %= 360;
+
+	shadowsHue += (shadowsHue < 0) ? 360 : 0;
+	highlightsHue += (highlightsHue < 0) ? 360 : 0;
+
+	Parameters parameters;
+	parameters.HighlightsHue = highlightsHue;
+	parameters.HighlightsSaturation = SAT(highlightsSaturation, MinimumSaturation, MaximumSaturation);
+	parameters.ShadowsHue = shadowsHue;
+	parameters.ShadowsSaturation = SAT(shadowsSaturation, MinimumSaturation, MaximumSaturation);
+	return parameters;
+}
+
+void SplitToneTable::Generate(const ToneDeltas& deltas, int32_t highlightsHue, int32_t shadowsHue, LookupTable& lookupTable)
+{
+	const Parameters parameters = Normalize(highlightsHue, MaximumSaturation, shadowsHue, MaximumSaturation);
+	const MixRowFunction mixRow = GetMixRowFunction();
+
+	// Row 0 is tinted with the shadows color, row 1 with the highlights color.
+	mixRow(deltas.NegativeShadows.data(), deltas.PositiveShadows.data(), HueToRgb(parameters.ShadowsHue), lookupTable.data());
+	mixRow(deltas.NegativeHighlights.data(), deltas.PositiveHighlights.data(), HueToRgb(parameters.HighlightsHue), lookupTable.data() + 256);
+}
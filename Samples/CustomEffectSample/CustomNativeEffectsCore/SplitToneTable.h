@@ -0,0 +1,76 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace CustomNativeEffects {
+
+	// Builds the 256x2 lookup texture used by the split tone pixel shader.
+	//
+	// Row 0 holds the shadow deltas and row 1 the highlight deltas, one BGRA
+	// pixel per input level with each channel biased by 128.
+	namespace SplitToneTable {
+
+		const int32_t MinimumSaturation = 0;
+		const int32_t MaximumSaturation = 100;
+
+		// Output level minus input level of a tone curve, for every input level.
+		typedef std::array<int32_t, 256> CurveDeltas;
+
+		// The four tone curves a table is derived from, as deltas already scaled
+		// by the saturations. The positive curve is applied to channels the tint
+		// color contains, the negative curve to the channels it lacks.
+		struct ToneDeltas
+		{
+			CurveDeltas PositiveHighlights;
+			CurveDeltas NegativeHighlights;
+			CurveDeltas PositiveShadows;
+			CurveDeltas NegativeShadows;
+		};
+
+		typedef std::array<uint32_t, 2 * 256> LookupTable;
+
+		// The effect properties a lookup table depends on.
+		struct Parameters
+		{
+			int32_t HighlightsHue;
+			int32_t HighlightsSaturation;
+			int32_t ShadowsHue;
+			int32_t ShadowsSaturation;
+
+			bool operator==(const Parameters& other) const
+			{
+				return HighlightsHue == other.HighlightsHue && HighlightsSaturation == other.HighlightsSaturation &&
+					ShadowsHue == other.ShadowsHue && ShadowsSaturation == other.ShadowsSaturation;
+			}
+		};
+
+		struct ParametersHash
+		{
+			size_t operator()(const Parameters& parameters) const;
+		};
+
+		// Wraps the hues into [0, 360) and clamps the saturations the way Generate
+		// does, so parameters that give the same table compare equal.
+		Parameters Normalize(int32_t highlightsHue, int32_t highlightsSaturation, int32_t shadowsHue, int32_t shadowsSaturation);
+
+		// Mixes the deltas for the tint colors of the hues, which are in degrees
+		// and wrap around. Deltas must be in [-255, 255].
+		//
+		// The curves and their scaling by saturation are left to the caller, so
+		// the component can evaluate them with the Lumia Imaging SDK's Curve
+		// class exactly as the effect always has.
+		void Generate(const ToneDeltas& deltas, int32_t highlightsHue, int32_t shadowsHue, LookupTable& lookupTable);
+	}
+}
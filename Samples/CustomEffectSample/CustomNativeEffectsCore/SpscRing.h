@@ -0,0 +1,154 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace CustomNativeEffects {
+
+	// Bounded first-in first-out queue between one producer thread and one
+	// consumer thread.
+	//
+	// Pushing and popping are lock-free: each side only writes its own index
+	// and reads the other's. A consumer that finds the ring empty can wait for
+	// the next push; the producer only takes the lock to wake a consumer that
+	// is actually waiting.
+	template <typename T>
+	class SpscRing final
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "SpscRing needs a trivially copyable type");
+
+	public:
+		explicit SpscRing(size_t capacity) :
+			m_items(capacity > 0 ? capacity : 1),
+			m_head(0),
+			m_tail(0),
+			m_isWaiting(false),
+			m_isClosed(false)
+		{
+		}
+
+		SpscRing(const SpscRing&) = delete;
+
+		SpscRing& operator=(const SpscRing&) = delete;
+
+		size_t GetCapacity() const
+		{
+			return m_items.size();
+		}
+
+		// Producer only. Returns false if the ring is full.
+		bool TryPush(const T& item)
+		{
+			const uint64_t tail = m_tail.load(std::memory_order_relaxed);
+
+			if (tail - m_head.load(std::memory_order_acquire) == m_items.size())
+			{
+				return false;
+			}
+
+			m_items[tail % m_items.size()] = item;
+
+			// Sequentially consistent with the consumer's announcement that it
+			// waits, so that either the consumer sees the item or this sees the
+			// consumer waiting.
+			m_tail.store(tail + 1, std::memory_order_seq_cst);
+
+			if (m_isWaiting.load(std::memory_order_seq_cst))
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_condition.notify_one();
+			}
+
+			return true;
+		}
+
+		// Consumer only. Returns false if the ring is empty.
+		bool TryPop(T& item)
+		{
+			const uint64_t head = m_head.load(std::memory_order_relaxed);
+
+			if (head == m_tail.load(std::memory_order_seq_cst))
+			{
+				return false;
+			}
+
+			item = m_items[head % m_items.size()];
+			m_head.store(head + 1, std::memory_order_release);
+			return true;
+		}
+
+		// Consumer only. Waits for an item; returns false once the ring has been
+		// closed and is empty.
+		bool Pop(T& item)
+		{
+			for (;;)
+			{
+				if (TryPop(item))
+				{
+					return true;
+				}
+
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_isWaiting.store(true, std::memory_order_seq_cst);
+
+				if (TryPop(item))
+				{
+					m_isWaiting.store(false, std::memory_order_relaxed);
+					return true;
+				}
+
+				if (m_isClosed)
+				{
+					m_isWaiting.store(false, std::memory_order_relaxed);
+					return false;
+				}
+
+				m_condition.wait(lock);
+				m_isWaiting.store(false, std::memory_order_relaxed);
+			}
+		}
+
+		// Wakes the consumer for good once it has drained the ring. Any thread.
+		void Close()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_isClosed = true;
+			m_condition.notify_all();
+		}
+
+		bool IsEmpty() const
+		{
+			return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+		}
+
+	private:
+		std::vector<T> m_items;
+
+		// Items popped and pushed so far. Padded apart, as each is written by a
+		// different thread.
+		std::atomic<uint64_t> m_head;
+		uint8_t m_headPadding[64];
+		std::atomic<uint64_t> m_tail;
+		uint8_t m_tailPadding[64];
+		std::atomic<bool> m_isWaiting;
+
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+		bool m_isClosed;
+	};
+}
@@ -0,0 +1,304 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "StripPipeline.h"
+#include "AlignedBuffer.h"
+#include "ColorLutKernel.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+using namespace CustomNativeEffects;
+
+namespace {
+
+	// Rows are padded to a whole number of cache lines, so every row is
+	// 64-byte aligned and kernels may overrun it by up to 15 pixels.
+	const int32_t PitchPixels = AlignedBuffer::DefaultAlignment / sizeof(uint32_t);
+
+	// The output rows [FirstRow, EndRow) of one level of the pipeline, the
+	// source being level 0, in a buffer of Capacity rows.
+	class RowWindow final
+	{
+	public:
+		RowWindow(int32_t width, int32_t pitch, int32_t capacity, int32_t imageHeight) :
+			m_buffer(static_cast<uint32_t>(static_cast<uint64_t>(pitch) * capacity * sizeof(uint32_t))),
+			m_width(width),
+			m_pitch(pitch),
+			m_capacity(capacity),
+			m_imageHeight(imageHeight),
+			m_firstRow(0),
+			m_endRow(0)
+		{
+		}
+
+		int32_t GetEndRow() const
+		{
+			return m_endRow;
+		}
+
+		uint64_t GetBytes() const
+		{
+			return m_buffer.GetCapacity();
+		}
+
+		uint32_t* GetRow(int32_t row) const
+		{
+			return reinterpret_cast<uint32_t*>(m_buffer.GetData()) + static_cast<intptr_t>(row - m_firstRow) * m_pitch;
+		}
+
+		StripRows GetRows() const
+		{
+			StripRows rows;
+			rows.Pixels = GetRow(m_firstRow);
+			rows.Pitch = m_pitch;
+			rows.FirstRow = m_firstRow;
+			rows.RowCount = m_endRow - m_firstRow;
+			rows.Width = m_width;
+			rows.ImageHeight = m_imageHeight;
+			return rows;
+		}
+
+		// Forgets the rows before firstRow and moves the others to the start of
+		// the buffer, making room for the rows up to endRow.
+		void Advance(int32_t firstRow, int32_t endRow)
+		{
+			if (firstRow > m_endRow)
+			{
+				firstRow = m_endRow;
+			}
+
+			if (firstRow > m_firstRow)
+			{
+				const int32_t keptRows = m_endRow - firstRow;
+
+				if (keptRows > 0)
+				{
+					std::memmove(GetRow(m_firstRow), GetRow(firstRow), static_cast<size_t>(keptRows) * m_pitch * sizeof(uint32_t));
+				}
+
+				m_firstRow = firstRow;
+			}
+
+			if (endRow - m_firstRow > m_capacity)
+			{
+				throw std::logic_error("strip window overflow");
+			}
+		}
+
+		void Append(int32_t endRow)
+		{
+			m_endRow = endRow;
+		}
+
+	private:
+		AlignedBuffer m_buffer;
+		int32_t m_width;
+		int32_t m_pitch;
+		int32_t m_capacity;
+		int32_t m_imageHeight;
+		int32_t m_firstRow;
+		int32_t m_endRow;
+	};
+
+	// Lets a kernel treat the output rows of a stage as a CpuWorkerRegion.
+	// Every row of a window is followed by its pitch padding, so kernels may
+	// overrun the last row as well.
+	CpuWorkerRegion GetRegion(const StripRows& input, int32_t firstRow, int32_t rowCount, uint32_t* target, int32_t targetPitch)
+	{
+		return CpuWorkerRegion::Create(
+			input.GetRow(firstRow), input.Pitch, input.Pitch - input.Width,
+			target, targetPitch, targetPitch - input.Width,
+			input.Width, rowCount);
+	}
+
+	int32_t GetDefaultStripRows(int32_t width, const RowBands::Options& bands)
+	{
+		// One band per thread, but at least enough pixels for RowBands to
+		// process the strip in parallel at all.
+		const TileScheduler& scheduler = bands.Scheduler ? *bands.Scheduler : TileScheduler::GetDefault();
+		const int64_t threadCount = static_cast<int64_t>(scheduler.GetWorkerCount()) + 1;
+		int64_t rows = RowBands::GetBandHeight(width, bands) * threadCount;
+
+		if (threadCount > 1)
+		{
+			rows = std::max<int64_t>(rows, (bands.MinimumParallelPixels + width - 1) / width);
+		}
+
+		return static_cast<int32_t>(std::min<int64_t>(rows, INT32_MAX / 2));
+	}
+}
+
+PointwiseStripStage::PointwiseStripStage(const PointwiseChain& chain) :
+	m_chain(chain)
+{
+}
+
+int32_t PointwiseStripStage::GetHaloRows() const
+{
+	return 0;
+}
+
+void PointwiseStripStage::ProcessRows(const StripRows& input, int32_t firstRow, int32_t rowCount, uint32_t* target, int32_t targetPitch, const RowBands::Options& bandOptions)
+{
+	const PointwiseChain& chain = m_chain;
+
+	RowBands::ForEach(GetRegion(input, firstRow, rowCount, target, targetPitch), bandOptions, [&chain](const CpuWorkerRegion& band)
+	{
+		chain.ApplyRegion(band);
+	});
+}
+
+ColorLutStripStage::ColorLutStripStage(const ColorLut3D& lut) :
+	m_lut(lut)
+{
+}
+
+int32_t ColorLutStripStage::GetHaloRows() const
+{
+	return 0;
+}
+
+void ColorLutStripStage::ProcessRows(const StripRows& input, int32_t firstRow, int32_t rowCount, uint32_t* target, int32_t targetPitch, const RowBands::Options& bandOptions)
+{
+	const ColorLut3D& lut = m_lut;
+	auto rowFunction = ColorLutKernel::GetRowFunction();
+
+	RowBands::ForEach(GetRegion(input, firstRow, rowCount, target, targetPitch), bandOptions, [&lut, rowFunction](const CpuWorkerRegion& band)
+	{
+		ColorLutKernel::ApplyRegion(band, lut, rowFunction);
+	});
+}
+
+bool StripPipeline::Run(int32_t width, int32_t height, StripSource& source, StripStage* const* stages, int32_t stageCount, StripSink& sink, const Options& options, Statistics* statistics)
+{
+	if (width < 0 || height < 0 || stageCount < 0 || options.StripRows < 0)
+	{
+		throw std::invalid_argument("StripPipeline::Run");
+	}
+
+	if (statistics)
+	{
+		*statistics = Statistics();
+	}
+
+	if (width == 0 || height == 0)
+	{
+		return true;
+	}
+
+	const int32_t stripRows = std::min(options.StripRows > 0 ? options.StripRows : GetDefaultStripRows(width, options.Bands), height);
+	const int32_t pitch = (width + PitchPixels - 1) / PitchPixels * PitchPixels;
+
+	if (static_cast<uint64_t>(pitch) * sizeof(uint32_t) * stripRows > UINT32_MAX)
+	{
+		throw std::length_error("StripPipeline::Run");
+	}
+
+	// halos[level] is how far the output of level reaches beyond the final
+	// rows it contributes to, summed over every stage that reads it directly
+	// or indirectly.
+	std::vector<int32_t> halos(stageCount + 1, 0);
+
+	for (int32_t level = stageCount - 1; level >= 0; --level)
+	{
+		const int32_t halo = stages[level]->GetHaloRows();
+
+		if (halo < 0)
+		{
+			throw std::invalid_argument("StripStage::GetHaloRows");
+		}
+
+		halos[level] = static_cast<int32_t>(std::min<int64_t>(static_cast<int64_t>(halos[level + 1]) + halo, height));
+	}
+
+	std::vector<RowWindow> windows;
+	windows.reserve(stageCount + 1);
+
+	uint64_t windowBytes = 0;
+
+	for (int32_t level = 0; level <= stageCount; ++level)
+	{
+		const int32_t capacity = static_cast<int32_t>(std::min<int64_t>(static_cast<int64_t>(stripRows) + 2 * static_cast<int64_t>(halos[level]), height));
+
+		windows.emplace_back(width, pitch, capacity, height);
+		windowBytes += windows.back().GetBytes();
+	}
+
+	if (statistics)
+	{
+		statistics->StripRows = stripRows;
+		statistics->WindowBytes = windowBytes;
+	}
+
+	std::vector<int32_t> firstRows(stageCount + 1);
+	std::vector<int32_t> endRows(stageCount + 1);
+
+	for (int32_t stripRow = 0; stripRow < height; stripRow += stripRows)
+	{
+		if (options.Bands.Cancellation && options.Bands.Cancellation->IsCanceled())
+		{
+			return false;
+		}
+
+		// The rows every level must hold for this strip, from the sink back to
+		// the source.
+		firstRows[stageCount] = stripRow;
+		endRows[stageCount] = std::min(stripRow + stripRows, height);
+
+		for (int32_t level = stageCount; level > 0; --level)
+		{
+			const int32_t halo = stages[level - 1]->GetHaloRows();
+
+			firstRows[level - 1] = std::max(firstRows[level] - halo, 0);
+			endRows[level - 1] = static_cast<int32_t>(std::min<int64_t>(static_cast<int64_t>(endRows[level]) + halo, height));
+		}
+
+		for (int32_t level = 0; level <= stageCount; ++level)
+		{
+			RowWindow& window = windows[level];
+			const int32_t firstNewRow = window.GetEndRow();
+			const int32_t newRows = endRows[level] - firstNewRow;
+
+			window.Advance(firstRows[level], endRows[level]);
+
+			if (newRows <= 0)
+			{
+				continue;
+			}
+
+			if (level == 0)
+			{
+				source.ReadRows(firstNewRow, newRows, window.GetRow(firstNewRow), pitch);
+			}
+			else
+			{
+				stages[level - 1]->ProcessRows(windows[level - 1].GetRows(), firstNewRow, newRows, window.GetRow(firstNewRow), pitch, options.Bands);
+
+				if (options.Bands.Cancellation && options.Bands.Cancellation->IsCanceled())
+				{
+					return false;
+				}
+			}
+
+			window.Append(endRows[level]);
+		}
+
+		sink.WriteRows(stripRow, endRows[stageCount] - stripRow, windows[stageCount].GetRow(stripRow), pitch);
+
+		if (statistics)
+		{
+			++statistics->StripCount;
+		}
+	}
+
+	return true;
+}
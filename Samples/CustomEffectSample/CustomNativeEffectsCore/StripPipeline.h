@@ -0,0 +1,149 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <cstdint>
+#include "ColorLut3D.h"
+#include "PointwiseChain.h"
+#include "RowBands.h"
+
+namespace CustomNativeEffects {
+
+	// Consecutive rows of an image held in memory: rows [FirstRow,
+	// FirstRow + RowCount) of an image ImageHeight rows high.
+	struct StripRows
+	{
+		const uint32_t* Pixels;
+		int32_t Pitch;
+		int32_t FirstRow;
+		int32_t RowCount;
+		int32_t Width;
+		int32_t ImageHeight;
+
+		const uint32_t* GetRow(int32_t row) const
+		{
+			return Pixels + static_cast<intptr_t>(row - FirstRow) * Pitch;
+		}
+	};
+
+	// Produces the rows of the image a StripPipeline processes, top to bottom.
+	class StripSource
+	{
+	public:
+		virtual ~StripSource()
+		{
+		}
+
+		// Writes rows [firstRow, firstRow + rowCount) as BGRA8888, pitch pixels
+		// apart. Every call continues where the previous one ended.
+		virtual void ReadRows(int32_t firstRow, int32_t rowCount, uint32_t* pixels, int32_t pitch) = 0;
+	};
+
+	// Consumes the rows a StripPipeline produces, top to bottom.
+	class StripSink
+	{
+	public:
+		virtual ~StripSink()
+		{
+		}
+
+		virtual void WriteRows(int32_t firstRow, int32_t rowCount, const uint32_t* pixels, int32_t pitch) = 0;
+	};
+
+	// One effect of a StripPipeline.
+	class StripStage
+	{
+	public:
+		virtual ~StripStage()
+		{
+		}
+
+		// How many rows above and below an output row the stage reads. 0 for
+		// pointwise effects.
+		virtual int32_t GetHaloRows() const = 0;
+
+		// Writes rows [firstRow, firstRow + rowCount) of the stage's output.
+		// input holds every input row within GetHaloRows() of them that lies
+		// inside the image; rows beyond the image edges are for the stage to
+		// clamp or mirror.
+		virtual void ProcessRows(const StripRows& input, int32_t firstRow, int32_t rowCount, uint32_t* target, int32_t targetPitch, const RowBands::Options& bandOptions) = 0;
+	};
+
+	// Runs a PointwiseChain, which must outlive the stage.
+	class PointwiseStripStage final : public StripStage
+	{
+	public:
+		explicit PointwiseStripStage(const PointwiseChain& chain);
+
+		virtual int32_t GetHaloRows() const override;
+		virtual void ProcessRows(const StripRows& input, int32_t firstRow, int32_t rowCount, uint32_t* target, int32_t targetPitch, const RowBands::Options& bandOptions) override;
+
+	private:
+		const PointwiseChain& m_chain;
+	};
+
+	// Maps colors through a ColorLut3D, which must outlive the stage.
+	class ColorLutStripStage final : public StripStage
+	{
+	public:
+		explicit ColorLutStripStage(const ColorLut3D& lut);
+
+		virtual int32_t GetHaloRows() const override;
+		virtual void ProcessRows(const StripRows& input, int32_t firstRow, int32_t rowCount, uint32_t* target, int32_t targetPitch, const RowBands::Options& bandOptions) override;
+
+	private:
+		const ColorLut3D& m_lut;
+	};
+
+	// Renders an image strip by strip, so that peak memory depends on the
+	// image width, the strip height and the stages' halos but not on the
+	// image height.
+	//
+	// Every stage keeps a window of its output rows: the current strip plus
+	// the halo rows the stages after it still need. For each strip, the
+	// windows are advanced from the source to the last stage, reading only
+	// the rows no window holds yet, and the last stage's strip goes to the
+	// sink. Within a strip, stages split their rows into bands through
+	// RowBands, so strips are processed in parallel as well.
+	namespace StripPipeline {
+
+		struct Options
+		{
+			Options() :
+				StripRows(0)
+			{
+			}
+
+			// Output rows per strip. 0 gives every scheduler thread one band of
+			// Bands.BandBytes per strip.
+			int32_t StripRows;
+
+			// How stages split strips into bands, and the cancellation checked
+			// between bands and strips.
+			RowBands::Options Bands;
+		};
+
+		struct Statistics
+		{
+			int32_t StripCount;
+			int32_t StripRows;
+
+			// Memory held by all windows together.
+			uint64_t WindowBytes;
+		};
+
+		// Renders width x height pixels from source through stages[0] to
+		// stages[stageCount - 1] into sink. Returns false if canceled. Exceptions
+		// from the source, stages or sink propagate once the strip that threw
+		// has been abandoned.
+		bool Run(int32_t width, int32_t height, StripSource& source, StripStage* const* stages, int32_t stageCount, StripSink& sink, const Options& options, Statistics* statistics = nullptr);
+	}
+}
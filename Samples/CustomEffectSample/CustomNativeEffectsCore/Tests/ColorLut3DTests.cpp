@@ -0,0 +1,278 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "TestCheck.h"
+#include "ColorLutCache.h"
+#include "ColorLutKernel.h"
+#include "SaturationKernel.h"
+#include "SplitToneTable.h"
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace CustomNativeEffects;
+
+static const uint32_t PixelCount = 1 << 16;
+
+static std::vector<uint32_t> MakePixels()
+{
+	std::vector<uint32_t> pixels(PixelCount);
+	uint32_t state = 1905;
+
+	for (uint32_t& pixel : pixels)
+	{
+		state = state * 1664525u + 1013904223u;
+		pixel = state;
+	}
+
+	// Every gray level, so the grid nodes themselves are covered.
+	for (uint32_t i = 0; i < 256; ++i)
+	{
+		pixels[i] = 0xFF000000u | (i * 0x010101u);
+	}
+
+	return pixels;
+}
+
+// The largest difference of any channel, alpha included.
+static int32_t MaximumDifference(const uint32_t* a, const uint32_t* b, uint32_t count)
+{
+	int32_t maximum = 0;
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		for (int32_t shift = 0; shift < 32; shift += 8)
+		{
+			const int32_t difference = std::abs(static_cast<int32_t>((a[i] >> shift) & 0xFF) - static_cast<int32_t>((b[i] >> shift) & 0xFF));
+			if (difference > maximum)
+			{
+				maximum = difference;
+			}
+		}
+	}
+
+	return maximum;
+}
+
+static void TestIdentity()
+{
+	const std::vector<uint32_t> source = MakePixels();
+	std::vector<uint32_t> target(PixelCount);
+
+	for (int32_t size : { 2, 17, ColorLut3D::DefaultSize, ColorLut3D::LargeSize })
+	{
+		const ColorLut3D lut(size);
+		TEST_CHECK(lut.GetSize() == size);
+
+		ColorLutKernel::ApplyRowReference(lut, source.data(), target.data(), PixelCount);
+		TEST_CHECK(MaximumDifference(source.data(), target.data(), PixelCount) == 0);
+	}
+
+	TEST_CHECK_THROWS(ColorLut3D(ColorLut3D::MinimumSize - 1), std::invalid_argument);
+	TEST_CHECK_THROWS(ColorLut3D(ColorLut3D::MaximumSize + 1), std::invalid_argument);
+}
+
+static void TestRowFunctionsMatchReference()
+{
+	const std::vector<uint32_t> source = MakePixels();
+	std::vector<uint32_t> expected(PixelCount);
+	std::vector<uint32_t> actual(PixelCount);
+
+	ColorLut3D lut(17);
+	for (int32_t blue = 0; blue < 17; ++blue)
+	{
+		for (int32_t green = 0; green < 17; ++green)
+		{
+			for (int32_t red = 0; red < 17; ++red)
+			{
+				ColorLut3D::Entry& entry = lut.At(red, green, blue);
+				entry.Red = static_cast<int16_t>(ColorLut3D::MaximumValue - entry.Red);
+				entry.Green = static_cast<int16_t>((entry.Green * 3) / 4);
+				entry.Blue = static_cast<int16_t>((entry.Blue + entry.Red) / 2);
+			}
+		}
+	}
+
+	ColorLutKernel::ApplyRowReference(lut, source.data(), expected.data(), PixelCount);
+
+	const CpuFeatures::InstructionSet instructionSets[] = { CpuFeatures::InstructionSet::Scalar, CpuFeatures::InstructionSet::Sse2,
+		CpuFeatures::InstructionSet::Avx2, CpuFeatures::InstructionSet::Neon };
+
+	for (CpuFeatures::InstructionSet instructionSet : instructionSets)
+	{
+		const ColorLutKernel::RowFunction rowFunction = ColorLutKernel::GetRowFunction(instructionSet);
+		if (rowFunction == nullptr)
+		{
+			continue;
+		}
+
+		// Counts that are not a multiple of the vector width exercise the tails.
+		for (uint32_t count : { PixelCount, PixelCount - 3, 1u })
+		{
+			std::fill(actual.begin(), actual.end(), 0);
+			rowFunction(lut, source.data(), actual.data(), count);
+			TEST_CHECK(MaximumDifference(expected.data(), actual.data(), count) == 0);
+		}
+	}
+}
+
+static void TestCompiledChain()
+{
+	const std::vector<uint32_t> source = MakePixels();
+	std::vector<uint32_t> chained(PixelCount);
+	std::vector<uint32_t> expected(PixelCount);
+	std::vector<uint32_t> actual(PixelCount);
+
+	SaturationKernel::Matrix matrix;
+	SaturationKernel::BuildMatrix(0.4f, matrix);
+
+	SplitToneTable::ToneDeltas deltas;
+	for (int32_t i = 0; i < 256; ++i)
+	{
+		const int32_t bump = i * (255 - i) / 255;
+		deltas.PositiveHighlights[i] = bump;
+		deltas.NegativeHighlights[i] = -bump / 2;
+		deltas.PositiveShadows[i] = bump / 2;
+		deltas.NegativeShadows[i] = -bump / 4;
+	}
+
+	SplitToneTable::LookupTable lookupTable;
+	SplitToneTable::Generate(deltas, 30, 200, lookupTable);
+
+	std::unique_ptr<SplitToneKernel::Adjustments> adjustments(new SplitToneKernel::Adjustments);
+	SplitToneKernel::BuildAdjustments(lookupTable, *adjustments);
+
+	// The sample's color effects; the table is documented to stay within 3
+	// levels of running them directly.
+	PointwiseChain chain;
+	chain.AddSaturation(matrix);
+	chain.AddSplitTone(*adjustments);
+	chain.ApplyRow(source.data(), chained.data(), PixelCount);
+
+	ColorLutCache cache;
+
+	for (int32_t size : { ColorLut3D::DefaultSize, ColorLut3D::LargeSize })
+	{
+		const ColorLutCache::SharedLut lut = cache.GetLut(chain, size);
+		TEST_CHECK(lut->GetSize() == size);
+
+		ColorLutKernel::ApplyRowReference(*lut, source.data(), expected.data(), PixelCount);
+		ColorLutKernel::GetRowFunction()(*lut, source.data(), actual.data(), PixelCount);
+
+		TEST_CHECK(MaximumDifference(expected.data(), actual.data(), PixelCount) == 0);
+		TEST_CHECK(MaximumDifference(chained.data(), actual.data(), PixelCount) <= 3);
+	}
+
+	ColorLutCache::Statistics statistics = cache.GetStatistics();
+	TEST_CHECK(statistics.Hits == 0);
+	TEST_CHECK(statistics.Misses == 2);
+
+	const ColorLutCache::SharedLut first = cache.GetLut(chain, ColorLut3D::DefaultSize);
+	const ColorLutCache::SharedLut second = cache.GetLut(chain, ColorLut3D::DefaultSize);
+	TEST_CHECK(first == second);
+
+	statistics = cache.GetStatistics();
+	TEST_CHECK(statistics.Hits == 2);
+	TEST_CHECK(statistics.Misses == 2);
+}
+
+static void TestLoadCube()
+{
+	// An inverting table with a comment, a title, CRLF line ends and an
+	// explicit default domain.
+	std::ostringstream text;
+	text << "# comment\r\nTITLE \"Invert\"\r\nLUT_3D_SIZE 2\r\nDOMAIN_MIN 0 0 0\nDOMAIN_MAX 1 1 1\n";
+
+	for (int32_t blue = 0; blue < 2; ++blue)
+	{
+		for (int32_t green = 0; green < 2; ++green)
+		{
+			for (int32_t red = 0; red < 2; ++red)
+			{
+				text << (1 - red) << " " << (1.0 - green) << " " << (1 - blue) << "\n";
+			}
+		}
+	}
+
+	std::istringstream stream(text.str());
+	const ColorLut3D lut = ColorLut3D::LoadCube(stream);
+	TEST_CHECK(lut.GetSize() == 2);
+
+	const uint32_t source = 0x80102030u;
+	uint32_t target = 0;
+	ColorLutKernel::ApplyRowReference(lut, &source, &target, 1);
+	TEST_CHECK(target == 0x80EFDFCFu);
+}
+
+static void TestLoadCubeDomain()
+{
+	// An explicit 0..1 range is the default and loads. The node values are
+	// outputs, so those past 0..1 are clamped rather than rescaled.
+	std::ostringstream text;
+	text << "LUT_3D_SIZE 2\nLUT_3D_INPUT_RANGE 0 1\n";
+
+	for (int32_t i = 0; i < 8; ++i)
+	{
+		text << "2 -1 0.5\n";
+	}
+
+	std::istringstream stream(text.str());
+	const ColorLut3D lut = ColorLut3D::LoadCube(stream);
+
+	const ColorLut3D::Entry& entry = lut.At(1, 0, 1);
+	TEST_CHECK(entry.Red == ColorLut3D::MaximumValue);
+	TEST_CHECK(entry.Green == 0);
+	TEST_CHECK(entry.Blue == (ColorLut3D::MaximumValue + 1) / 2);
+}
+
+static void TestLoadCubeRejectsInvalidTables()
+{
+	const char* const tables[] =
+	{
+		// Too few nodes.
+		"LUT_3D_SIZE 2\n0 0 0\n",
+		// 1D tables.
+		"LUT_1D_SIZE 4\n",
+		// No size.
+		"0 0 0\n",
+		// Size out of range.
+		"LUT_3D_SIZE 1\n",
+		// Unknown keyword.
+		"FOO\n",
+		// Empty domain.
+		"LUT_3D_SIZE 2\nDOMAIN_MIN 1 1 1\nDOMAIN_MAX 1 1 1\n0 0 0\n",
+		// Input domains other than 0..1, which the nodes cannot stand for.
+		"LUT_3D_SIZE 2\nDOMAIN_MAX 2 2 2\n0 0 0\n",
+		"LUT_3D_SIZE 2\nDOMAIN_MIN -0.5 0 0\n0 0 0\n",
+		"LUT_3D_SIZE 2\nLUT_3D_INPUT_RANGE 0 4095\n0 0 0\n",
+	};
+
+	for (const char* table : tables)
+	{
+		std::istringstream stream(table);
+		TEST_CHECK_THROWS(ColorLut3D::LoadCube(stream), std::invalid_argument);
+	}
+}
+
+int main()
+{
+	TestIdentity();
+	TestRowFunctionsMatchReference();
+	TestCompiledChain();
+	TestLoadCube();
+	TestLoadCubeDomain();
+	TestLoadCubeRejectsInvalidTables();
+
+	return TestCheck::GetExitCode();
+}
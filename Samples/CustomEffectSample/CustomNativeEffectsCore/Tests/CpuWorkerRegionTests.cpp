@@ -0,0 +1,130 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "TestCheck.h"
+#include "CpuFeatures.h"
+#include "CpuWorkerRegion.h"
+#include "PointwiseChain.h"
+#include "SaturationKernel.h"
+#include <vector>
+
+using namespace CustomNativeEffects;
+using namespace CustomNativeEffects::CpuFeatures;
+
+static const InstructionSet AllInstructionSets[] = { InstructionSet::Scalar, InstructionSet::Sse2, InstructionSet::Avx2, InstructionSet::Neon };
+
+static std::vector<uint32_t> MakePixels(size_t count)
+{
+	std::vector<uint32_t> pixels(count);
+	uint32_t state = 12345;
+
+	for (uint32_t& pixel : pixels)
+	{
+		state = state * 1664525u + 1013904223u;
+		pixel = state;
+	}
+
+	return pixels;
+}
+
+static CpuWorkerRegion MakeRegion(const uint32_t* source, uint32_t* target, int32_t width, int32_t height, int32_t pitch, int32_t tailPixels)
+{
+	return CpuWorkerRegion::Create(source, pitch, tailPixels, target, pitch, tailPixels, width, height);
+}
+
+static void TestVectorRowLength()
+{
+	std::vector<uint32_t> source(17 * 4 + 16);
+	std::vector<uint32_t> target(17 * 4 + 16);
+
+	// Separate buffers: every row may run into the next one.
+	const CpuWorkerRegion copy = MakeRegion(source.data(), target.data(), 17, 4, 17, 15);
+	for (int32_t row = 0; row < 4; ++row)
+	{
+		TEST_CHECK(copy.GetVectorRowLength(row, 16) == 32);
+	}
+
+	// In place and packed: only the last row may run into the tail.
+	const CpuWorkerRegion inPlace = MakeRegion(target.data(), target.data(), 17, 4, 17, 15);
+	for (int32_t row = 0; row < 3; ++row)
+	{
+		TEST_CHECK(inPlace.GetVectorRowLength(row, 16) == 17);
+	}
+
+	TEST_CHECK(inPlace.GetVectorRowLength(3, 16) == 32);
+	TEST_CHECK(MakeRegion(target.data(), target.data(), 17, 4, 17, 14).GetVectorRowLength(3, 16) == 17);
+
+	// In place with enough pitch padding for the overrun of every row.
+	const CpuWorkerRegion padded = MakeRegion(target.data(), target.data(), 17, 2, 32, 0);
+	TEST_CHECK(padded.GetVectorRowLength(0, 16) == 32);
+	TEST_CHECK(padded.GetVectorRowLength(1, 16) == 17);
+
+	// A band of an in-place region keeps the rule.
+	TEST_CHECK(inPlace.Rows(1, 2).GetVectorRowLength(0, 16) == 17);
+}
+
+// Applies the saturation kernel and a saturation chain in place to packed
+// rows of every width up to 40 and compares them with the reference
+// implementation run into another buffer.
+static void TestInPlacePackedSaturation()
+{
+	SaturationKernel::Matrix matrix;
+	SaturationKernel::BuildMatrix(0.35f, matrix);
+
+	const int32_t height = 4;
+	const int32_t tailPixels = PointwiseChain::VectorPixels;
+
+	for (InstructionSet instructionSet : AllInstructionSets)
+	{
+		if (!IsSupported(instructionSet))
+		{
+			continue;
+		}
+
+		const SaturationKernel::RowFunction rowFunction = SaturationKernel::GetRowFunction(instructionSet);
+
+		PointwiseChain chain;
+		chain.AddSaturation(matrix, rowFunction);
+
+		for (int32_t width = 1; width <= 40; ++width)
+		{
+			const size_t count = static_cast<size_t>(width) * height;
+			const std::vector<uint32_t> original = MakePixels(count + tailPixels);
+
+			std::vector<uint32_t> expected(count);
+			SaturationKernel::ApplyRowReference(matrix, original.data(), expected.data(), static_cast<uint32_t>(count));
+
+			std::vector<uint32_t> kernelPixels = original;
+			SaturationKernel::ApplyRegion(MakeRegion(kernelPixels.data(), kernelPixels.data(), width, height, width, tailPixels), matrix, rowFunction);
+
+			std::vector<uint32_t> chainPixels = original;
+			chain.ApplyRegion(MakeRegion(chainPixels.data(), chainPixels.data(), width, height, width, tailPixels));
+
+			int32_t kernelMismatches = 0;
+			int32_t chainMismatches = 0;
+			for (size_t i = 0; i < count; ++i)
+			{
+				kernelMismatches += (kernelPixels[i] != expected[i]) ? 1 : 0;
+				chainMismatches += (chainPixels[i] != expected[i]) ? 1 : 0;
+			}
+
+			TEST_CHECK(kernelMismatches == 0);
+			TEST_CHECK(chainMismatches == 0);
+		}
+	}
+}
+
+int main()
+{
+	TestVectorRowLength();
+	TestInPlacePackedSaturation();
+
+	return TestCheck::GetExitCode();
+}
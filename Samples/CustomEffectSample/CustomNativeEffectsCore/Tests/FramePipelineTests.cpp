@@ -0,0 +1,197 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "TestCheck.h"
+#include "FramePipeline.h"
+#include "PointwiseChain.h"
+#include "SpscRing.h"
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+using namespace CustomNativeEffects;
+
+// One producer and one consumer through a ring much smaller than the stream.
+// Build with CUSTOMNATIVEEFFECTS_THREAD_SANITIZER to check the ring's memory
+// ordering as well.
+static void TestRingDeliversEveryItem()
+{
+	const int64_t itemCount = 200000;
+
+	SpscRing<int64_t> ring(4);
+	int64_t sum = 0;
+	int64_t outOfOrder = 0;
+
+	std::thread consumer([&]()
+	{
+		int64_t item = 0;
+		int64_t previous = 0;
+
+		while (ring.Pop(item))
+		{
+			outOfOrder += (item != previous + 1) ? 1 : 0;
+			previous = item;
+			sum += item;
+		}
+	});
+
+	for (int64_t i = 1; i <= itemCount; ++i)
+	{
+		while (!ring.TryPush(i))
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	ring.Close();
+	consumer.join();
+
+	TEST_CHECK(sum == itemCount * (itemCount + 1) / 2);
+	TEST_CHECK(outOfOrder == 0);
+}
+
+// Frames arrive in order and processed, and every submitted frame is
+// either delivered or counted as dropped.
+static void TestFramesInOrder()
+{
+	PointwiseChain chain;
+	chain.AddGrayscale();
+
+	std::atomic<uint64_t> lastSequence(0);
+	std::atomic<int32_t> outOfOrder(0);
+	std::atomic<int32_t> notGray(0);
+
+	FramePipeline::Options options;
+	options.LatencyBudget = std::chrono::milliseconds(0);
+
+	FramePipeline::Statistics statistics;
+	{
+		FramePipeline pipeline(320, 240,
+			[&](BatchFrame& frame)
+			{
+				chain.ApplyRegion(frame.GetRegion());
+			},
+			[&](const BatchFrame& frame, const FramePipeline::FrameInfo& info)
+			{
+				outOfOrder += (info.Sequence != 0 && info.Sequence <= lastSequence) ? 1 : 0;
+				lastSequence = info.Sequence;
+
+				const uint32_t pixel = frame.GetPixels()[5];
+				const uint32_t blue = pixel & 0xFF;
+				const uint32_t green = (pixel >> 8) & 0xFF;
+				const uint32_t red = (pixel >> 16) & 0xFF;
+				notGray += (blue != green || green != red) ? 1 : 0;
+			},
+			options);
+
+		for (uint64_t sequence = 0; sequence < 500; ++sequence)
+		{
+			pipeline.Submit([sequence](BatchFrame& frame) { FramePipeline::FillTestPattern(frame, sequence); });
+		}
+
+		pipeline.Flush();
+		statistics = pipeline.GetStatistics();
+	}
+
+	TEST_CHECK(outOfOrder == 0);
+	TEST_CHECK(notGray == 0);
+	TEST_CHECK(statistics.Submitted == 500);
+	TEST_CHECK(statistics.Delivered > 0);
+	TEST_CHECK(statistics.DroppedLate == 0);
+	TEST_CHECK(statistics.Delivered + statistics.DroppedBusy + statistics.Failed == statistics.Submitted);
+	TEST_CHECK(statistics.MinimumLatency <= statistics.MedianLatency && statistics.MedianLatency <= statistics.MaximumLatency);
+}
+
+// An effect slower than the frame rate: frames past the budget are dropped
+// instead of delivered late.
+static void TestLateFramesDropped()
+{
+	FramePipeline::Options options;
+	options.LatencyBudget = std::chrono::milliseconds(20);
+
+	FramePipeline pipeline(64, 64,
+		[](BatchFrame&)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(25));
+		},
+		[](const BatchFrame&, const FramePipeline::FrameInfo&)
+		{
+		},
+		options);
+
+	for (uint64_t sequence = 0; sequence < 30; ++sequence)
+	{
+		pipeline.Submit([sequence](BatchFrame& frame) { FramePipeline::FillTestPattern(frame, sequence); });
+		std::this_thread::sleep_for(std::chrono::microseconds(16667));
+	}
+
+	pipeline.Flush();
+	const FramePipeline::Statistics statistics = pipeline.GetStatistics();
+
+	TEST_CHECK(statistics.DroppedBusy + statistics.DroppedLate > 0);
+	TEST_CHECK(statistics.Delivered + statistics.DroppedBusy + statistics.DroppedLate == statistics.Submitted);
+}
+
+static void TestErrorsAreRethrown()
+{
+	FramePipeline pipeline(8, 8,
+		[](BatchFrame&)
+		{
+			throw std::runtime_error("effect");
+		},
+		[](const BatchFrame&, const FramePipeline::FrameInfo&)
+		{
+		});
+
+	pipeline.Submit([](BatchFrame&) {});
+	TEST_CHECK_THROWS(pipeline.Flush(), std::runtime_error);
+	TEST_CHECK(pipeline.GetStatistics().Failed == 1);
+
+	TEST_CHECK_THROWS(pipeline.Submit([](BatchFrame&) { throw std::runtime_error("convert"); }), std::runtime_error);
+	pipeline.Flush();
+}
+
+// Destroying the pipeline with frames still queued must neither hang nor
+// lose them.
+static void TestDestroyWithPendingFrames()
+{
+	std::atomic<int32_t> delivered(0);
+	uint32_t accepted = 0;
+
+	{
+		FramePipeline pipeline(8, 8,
+			[](BatchFrame&)
+			{
+			},
+			[&](const BatchFrame&, const FramePipeline::FrameInfo&)
+			{
+				delivered++;
+			});
+
+		for (int32_t i = 0; i < 10; ++i)
+		{
+			accepted += pipeline.Submit([](BatchFrame&) {}) ? 1 : 0;
+		}
+	}
+
+	TEST_CHECK(delivered == static_cast<int32_t>(accepted));
+}
+
+int main()
+{
+	TestRingDeliversEveryItem();
+	TestFramesInOrder();
+	TestLateFramesDropped();
+	TestErrorsAreRethrown();
+	TestDestroyWithPendingFrames();
+
+	return TestCheck::GetExitCode();
+}
@@ -0,0 +1,223 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "TestCheck.h"
+#include "CpuFeatures.h"
+#include "MagnifySmoothKernel.h"
+#include <climits>
+#include <vector>
+
+using namespace CustomNativeEffects;
+using namespace CustomNativeEffects::CpuFeatures;
+
+static const InstructionSet AllInstructionSets[] = { InstructionSet::Scalar, InstructionSet::Sse2, InstructionSet::Avx2, InstructionSet::Neon };
+
+static const int32_t Width = 67;
+static const int32_t Height = 41;
+static const int32_t BandRows = 6;
+
+// Small and large lenses, one at a corner, one shrinking the image, and one
+// that does not bound its influence.
+static const MagnifySmoothMath::Parameters ParameterSets[] =
+{
+	{ 0.2f, 0.4f, 2.0f, 0.5f, 0.5f, 1.0f },
+	{ 0.1f, 0.7f, 3.5f, 0.3f, 0.6f, 1.6f },
+	{ 0.05f, 0.15f, 2.0f, 0.95f, 0.05f, 1.0f },
+	{ 0.1f, 0.2f, 0.5f, 0.4f, 0.5f, 0.75f },
+	{ 0.3f, 0.3f, 1.0f, 0.9f, 0.1f, 0.5f },
+	{ 0.2f, 0.4f, 2.0f, 0.5f, 0.5f, 0.0f }
+};
+
+static std::vector<uint32_t> MakePixels(size_t count)
+{
+	std::vector<uint32_t> pixels(count);
+	uint32_t state = 777;
+
+	for (uint32_t& pixel : pixels)
+	{
+		state = state * 1664525u + 1013904223u;
+		pixel = state;
+	}
+
+	return pixels;
+}
+
+// Every vector path, including the ones only an ARM build compiles, must be
+// bit-exact with the reference, both over whole vectors and in the scalar tail.
+static void TestRowFunctionsMatchReference()
+{
+	const std::vector<uint32_t> pixels = MakePixels(static_cast<size_t>(Width) * Height);
+	const MagnifySmoothKernel::SourceImage source = { pixels.data(), Width, Width, Height, 0 };
+
+	const int32_t columns[][2] = { { 0, Width }, { 3, 64 }, { 10, 13 } };
+
+	for (InstructionSet instructionSet : AllInstructionSets)
+	{
+		if (!IsSupported(instructionSet))
+		{
+			continue;
+		}
+
+		const MagnifySmoothKernel::RowFunction rowFunction = MagnifySmoothKernel::GetRowFunction(instructionSet);
+		TEST_CHECK(rowFunction != nullptr);
+
+		int32_t mismatches = 0;
+
+		for (const MagnifySmoothMath::Parameters& parameters : ParameterSets)
+		{
+			if (!MagnifySmoothMath::IsBounded(parameters))
+			{
+				continue;
+			}
+
+			for (const auto& span : columns)
+			{
+				const uint32_t count = static_cast<uint32_t>(span[1]);
+
+				for (int32_t y = 0; y < Height; ++y)
+				{
+					std::vector<uint32_t> expected(count);
+					std::vector<uint32_t> actual(count);
+					MagnifySmoothKernel::RenderRowReference(parameters, source, y, span[0], expected.data(), count);
+					rowFunction(parameters, source, y, span[0], actual.data(), count);
+
+					if (expected != actual)
+					{
+						mismatches++;
+					}
+				}
+			}
+		}
+
+		if (!TEST_CHECK(mismatches == 0))
+		{
+			std::fprintf(stderr, "%s: %d mismatched rows\n", GetName(instructionSet), mismatches);
+		}
+	}
+}
+
+// Every pixel rendered with the reference, which is what the shader gives
+// without a region of influence.
+static std::vector<uint32_t> RenderEveryPixel(const MagnifySmoothMath::Parameters& parameters, const std::vector<uint32_t>& pixels)
+{
+	const MagnifySmoothKernel::SourceImage source = { pixels.data(), Width, Width, Height, 0 };
+	std::vector<uint32_t> image(static_cast<size_t>(Width) * Height);
+
+	for (int32_t y = 0; y < Height; ++y)
+	{
+		MagnifySmoothKernel::RenderRowReference(parameters, source, y, 0, image.data() + static_cast<size_t>(y) * Width, Width);
+	}
+
+	return image;
+}
+
+static void RenderBands(const CpuWorkerRegion& region, const MagnifySmoothMath::Parameters& parameters, const MagnifySmoothKernel::SourceImage& source, MagnifySmoothKernel::RowFunction rowFunction)
+{
+	for (int32_t firstRow = 0; firstRow < region.Height; firstRow += BandRows)
+	{
+		const int32_t rowCount = (region.Height - firstRow < BandRows) ? region.Height - firstRow : BandRows;
+		MagnifySmoothKernel::RenderRegion(region.Rows(firstRow, rowCount), firstRow, parameters, source, rowFunction);
+	}
+}
+
+// Rendering only the influence ellipse in bands, into another buffer or in
+// place from a copy of the rows the samples reach, changes no pixel.
+static void TestRegionMatchesEveryPixel()
+{
+	const std::vector<uint32_t> pixels = MakePixels(static_cast<size_t>(Width) * Height + MagnifySmoothKernel::VectorPixels);
+
+	for (InstructionSet instructionSet : AllInstructionSets)
+	{
+		if (!IsSupported(instructionSet))
+		{
+			continue;
+		}
+
+		const MagnifySmoothKernel::RowFunction rowFunction = MagnifySmoothKernel::GetRowFunction(instructionSet);
+
+		for (const MagnifySmoothMath::Parameters& parameters : ParameterSets)
+		{
+			const std::vector<uint32_t> expected = RenderEveryPixel(parameters, pixels);
+
+			std::vector<uint32_t> target(pixels.size());
+			const MagnifySmoothKernel::SourceImage source = { pixels.data(), Width, Width, Height, 0 };
+			RenderBands(CpuWorkerRegion::Create(pixels.data(), Width, MagnifySmoothKernel::VectorPixels, target.data(), Width, MagnifySmoothKernel::VectorPixels, Width, Height),
+				parameters, source, rowFunction);
+			target.resize(expected.size());
+			TEST_CHECK(target == expected);
+
+			int32_t firstSampleRow;
+			int32_t lastSampleRow;
+			MagnifySmoothKernel::GetSampleRows(parameters, Width, Height, firstSampleRow, lastSampleRow);
+
+			const std::vector<uint32_t> sampleRows(pixels.begin() + static_cast<size_t>(firstSampleRow) * Width, pixels.begin() + static_cast<size_t>(lastSampleRow) * Width);
+			const MagnifySmoothKernel::SourceImage sampleSource = { sampleRows.data(), Width, Width, Height, firstSampleRow };
+
+			std::vector<uint32_t> image = pixels;
+			RenderBands(CpuWorkerRegion::Create(image.data(), Width, MagnifySmoothKernel::VectorPixels, image.data(), Width, MagnifySmoothKernel::VectorPixels, Width, Height),
+				parameters, sampleSource, rowFunction);
+			image.resize(expected.size());
+
+			if (!TEST_CHECK(image == expected))
+			{
+				std::fprintf(stderr, "%s: in-place render differs\n", GetName(instructionSet));
+			}
+		}
+	}
+}
+
+// The Direct2D path draws the shader over GetInfluenceRect only and blends
+// it over the unchanged input, so every pixel outside must be one the
+// shader leaves as it is, wherever the input rectangle lies.
+static void TestInfluenceRectCoversChanges()
+{
+	const std::vector<uint32_t> pixels = MakePixels(static_cast<size_t>(Width) * Height);
+	const MagnifySmoothMath::PixelRect inputRect = { -20, 35, -20 + Width, 35 + Height };
+
+	for (const MagnifySmoothMath::Parameters& parameters : ParameterSets)
+	{
+		const std::vector<uint32_t> expected = RenderEveryPixel(parameters, pixels);
+		const MagnifySmoothMath::PixelRect rect = MagnifySmoothMath::GetInfluenceRect(parameters, inputRect);
+
+		TEST_CHECK(rect.Left >= inputRect.Left && rect.Right <= inputRect.Right && rect.Left <= rect.Right);
+		TEST_CHECK(rect.Top >= inputRect.Top && rect.Bottom <= inputRect.Bottom && rect.Top <= rect.Bottom);
+
+		std::vector<uint32_t> blended = pixels;
+
+		for (int32_t y = rect.Top; y < rect.Bottom; ++y)
+		{
+			for (int32_t x = rect.Left; x < rect.Right; ++x)
+			{
+				const size_t index = static_cast<size_t>(y - inputRect.Top) * Width + (x - inputRect.Left);
+				blended[index] = expected[index];
+			}
+		}
+
+		TEST_CHECK(blended == expected);
+	}
+
+	// Bounded lenses do not cover the whole image.
+	const MagnifySmoothMath::PixelRect lens = MagnifySmoothMath::GetInfluenceRect(ParameterSets[2], inputRect);
+	TEST_CHECK(lens.Right - lens.Left < Width && lens.Bottom - lens.Top < Height);
+
+	// An infinite input, such as a flood fill, has no size to normalize against.
+	const MagnifySmoothMath::PixelRect infinite = { INT32_MIN, INT32_MIN, INT32_MAX, INT32_MAX };
+	const MagnifySmoothMath::PixelRect unchanged = MagnifySmoothMath::GetInfluenceRect(ParameterSets[0], infinite);
+	TEST_CHECK(unchanged.Left == INT32_MIN && unchanged.Top == INT32_MIN && unchanged.Right == INT32_MAX && unchanged.Bottom == INT32_MAX);
+}
+
+int main()
+{
+	TestRowFunctionsMatchReference();
+	TestRegionMatchesEveryPixel();
+	TestInfluenceRectCoversChanges();
+
+	return TestCheck::GetExitCode();
+}
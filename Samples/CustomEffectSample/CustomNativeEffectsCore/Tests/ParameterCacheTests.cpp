@@ -0,0 +1,119 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "TestCheck.h"
+#include "MagnifySmoothMath.h"
+#include "ParameterCache.h"
+
+using namespace CustomNativeEffects;
+
+// Stands in for ID2D1DrawInfo and records what was uploaded.
+struct MockDrawInfo
+{
+	MockDrawInfo() :
+		Calls(0),
+		Size(0),
+		NextResult(0)
+	{
+	}
+
+	long SetPixelShaderConstantBuffer(const uint8_t*, uint32_t size)
+	{
+		Calls++;
+		Size = size;
+		return NextResult;
+	}
+
+	int32_t Calls;
+	uint32_t Size;
+	long NextResult;
+};
+
+static void TestUploadsOnlyChanges()
+{
+	ParameterCache<MagnifySmoothMath::Parameters> cache;
+	MockDrawInfo drawInfo;
+
+	MagnifySmoothMath::Parameters parameters = { 0.2f, 0.4f, 2.0f, 0.5f, 0.5f, 1.0f };
+
+	TEST_CHECK(cache.Update(parameters));
+	TEST_CHECK(cache.Upload(drawInfo) == 0);
+	TEST_CHECK(drawInfo.Calls == 1);
+	TEST_CHECK(drawInfo.Size == sizeof(MagnifySmoothMath::Parameters));
+
+	// The same value again is not uploaded.
+	TEST_CHECK(!cache.Update(parameters));
+	TEST_CHECK(cache.Upload(drawInfo) == 0);
+	TEST_CHECK(drawInfo.Calls == 1);
+
+	// A changed value is.
+	parameters.InnerRadius = 0.3f;
+	TEST_CHECK(cache.Update(parameters));
+	TEST_CHECK(cache.Upload(drawInfo) == 0);
+	TEST_CHECK(drawInfo.Calls == 2);
+	TEST_CHECK(!cache.IsPending());
+}
+
+static void TestFailedUploadStaysPending()
+{
+	ParameterCache<MagnifySmoothMath::Parameters> cache;
+	MockDrawInfo drawInfo;
+
+	const MagnifySmoothMath::Parameters parameters = { 0.2f, 0.4f, 2.0f, 0.5f, 0.5f, 1.0f };
+	cache.Update(parameters);
+
+	drawInfo.NextResult = -5;
+	TEST_CHECK(cache.Upload(drawInfo) == -5);
+	TEST_CHECK(cache.IsPending());
+
+	// Still pending although the value did not change, so the retry sends it.
+	drawInfo.NextResult = 0;
+	TEST_CHECK(cache.Update(parameters));
+	TEST_CHECK(cache.Upload(drawInfo) == 0);
+	TEST_CHECK(drawInfo.Calls == 2);
+	TEST_CHECK(!cache.IsPending());
+}
+
+static void TestInvalidate()
+{
+	ParameterCache<MagnifySmoothMath::Parameters> cache;
+	MockDrawInfo drawInfo;
+
+	const MagnifySmoothMath::Parameters parameters = { 0.2f, 0.4f, 2.0f, 0.5f, 0.5f, 1.0f };
+	cache.Update(parameters);
+	cache.Upload(drawInfo);
+
+	cache.Invalidate();
+	TEST_CHECK(cache.IsPending());
+	cache.Upload(drawInfo);
+	TEST_CHECK(drawInfo.Calls == 2);
+}
+
+static void TestMarkUploaded()
+{
+	// The first value is pending even if it equals the default.
+	ParameterCache<float> cache;
+	TEST_CHECK(cache.Update(0.0f));
+
+	cache.MarkUploaded();
+	TEST_CHECK(!cache.Update(0.0f));
+	TEST_CHECK(cache.Update(1.0f));
+	TEST_CHECK(cache.GetValue() == 1.0f);
+}
+
+int main()
+{
+	TestUploadsOnlyChanges();
+	TestFailedUploadStaysPending();
+	TestInvalidate();
+	TestMarkUploaded();
+
+	return TestCheck::GetExitCode();
+}
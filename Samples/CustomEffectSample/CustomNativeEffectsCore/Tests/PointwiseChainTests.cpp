@@ -0,0 +1,171 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "TestCheck.h"
+#include "PointwiseChain.h"
+#include "SplitToneTable.h"
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+using namespace CustomNativeEffects;
+
+static const int32_t Width = 1333;
+static const int32_t Height = 7;
+static const int32_t Pitch = 1400;
+static const int32_t TailPixels = 64;
+
+static std::vector<uint32_t> MakePixels(size_t count)
+{
+	std::vector<uint32_t> pixels(count);
+	uint32_t state = 2024;
+
+	for (uint32_t& pixel : pixels)
+	{
+		state = state * 1664525u + 1013904223u;
+		pixel = state;
+	}
+
+	return pixels;
+}
+
+static CpuWorkerRegion MakeRegion(const uint32_t* source, uint32_t* target)
+{
+	return CpuWorkerRegion::Create(source, Pitch, TailPixels, target, Pitch, TailPixels, Width, Height);
+}
+
+static bool RegionsMatch(const std::vector<uint32_t>& expected, const std::vector<uint32_t>& actual)
+{
+	for (int32_t y = 0; y < Height; ++y)
+	{
+		for (int32_t x = 0; x < Width; ++x)
+		{
+			if (expected[y * Pitch + x] != actual[y * Pitch + x])
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+static std::unique_ptr<SplitToneKernel::Adjustments> BuildAdjustments()
+{
+	SplitToneTable::ToneDeltas deltas;
+	for (int32_t i = 0; i < 256; ++i)
+	{
+		const int32_t bump = i * (255 - i) / 255;
+		deltas.PositiveHighlights[i] = bump;
+		deltas.NegativeHighlights[i] = -bump / 2;
+		deltas.PositiveShadows[i] = bump / 2;
+		deltas.NegativeShadows[i] = -bump / 4;
+	}
+
+	SplitToneTable::LookupTable lookupTable;
+	SplitToneTable::Generate(deltas, 30, 200, lookupTable);
+
+	std::unique_ptr<SplitToneKernel::Adjustments> adjustments(new SplitToneKernel::Adjustments);
+	SplitToneKernel::BuildAdjustments(lookupTable, *adjustments);
+	return adjustments;
+}
+
+// Saturation, grayscale and split tone as one chain give the same pixels as
+// the three kernels run one after the other, into another buffer and in place.
+static void TestChainMatchesSeparatePasses()
+{
+	const std::vector<uint32_t> source = MakePixels(Pitch * Height + TailPixels);
+
+	SaturationKernel::Matrix matrix;
+	SaturationKernel::BuildMatrix(0.4f, matrix);
+	const std::unique_ptr<SplitToneKernel::Adjustments> adjustments = BuildAdjustments();
+
+	std::vector<uint32_t> expected(source.size());
+	SaturationKernel::ApplyRegion(MakeRegion(source.data(), expected.data()), matrix, SaturationKernel::GetRowFunction());
+	GrayscaleKernel::ConvertRegion(MakeRegion(expected.data(), expected.data()), GrayscaleKernel::GetRowFunction());
+	SplitToneKernel::ApplyRegion(MakeRegion(expected.data(), expected.data()), *adjustments, SplitToneKernel::GetRowFunction());
+
+	PointwiseChain chain;
+	chain.AddSaturation(matrix);
+	chain.AddGrayscale();
+	chain.AddSplitTone(*adjustments);
+	TEST_CHECK(chain.GetStageCount() == 3);
+
+	std::vector<uint32_t> copy(source.size());
+	chain.ApplyRegion(MakeRegion(source.data(), copy.data()));
+	TEST_CHECK(RegionsMatch(expected, copy));
+
+	std::vector<uint32_t> inPlace = source;
+	chain.ApplyRegion(MakeRegion(inPlace.data(), inPlace.data()));
+	TEST_CHECK(RegionsMatch(expected, inPlace));
+}
+
+static void TestEmptyChainCopies()
+{
+	const std::vector<uint32_t> source = MakePixels(Pitch * Height + TailPixels);
+	std::vector<uint32_t> target(source.size());
+
+	PointwiseChain chain;
+	chain.ApplyRegion(MakeRegion(source.data(), target.data()));
+	TEST_CHECK(RegionsMatch(source, target));
+}
+
+static void TestParameterHash()
+{
+	SaturationKernel::Matrix matrix;
+	SaturationKernel::BuildMatrix(0.4f, matrix);
+	SaturationKernel::Matrix sameMatrix = matrix;
+	SaturationKernel::Matrix otherMatrix;
+	SaturationKernel::BuildMatrix(0.5f, otherMatrix);
+
+	PointwiseChain chain;
+	chain.AddSaturation(matrix);
+	chain.AddGrayscale();
+
+	PointwiseChain sameChain;
+	sameChain.AddSaturation(sameMatrix);
+	sameChain.AddGrayscale();
+
+	PointwiseChain otherOrder;
+	otherOrder.AddGrayscale();
+	otherOrder.AddSaturation(matrix);
+
+	PointwiseChain otherParameters;
+	otherParameters.AddSaturation(otherMatrix);
+	otherParameters.AddGrayscale();
+
+	TEST_CHECK(chain.GetParameterHash() == sameChain.GetParameterHash());
+	TEST_CHECK(chain.GetParameterHash() != otherOrder.GetParameterHash());
+	TEST_CHECK(chain.GetParameterHash() != otherParameters.GetParameterHash());
+}
+
+static void TestStageLimit()
+{
+	PointwiseChain chain;
+	for (int32_t i = 0; i < PointwiseChain::MaximumStages; ++i)
+	{
+		chain.AddGrayscale();
+	}
+
+	TEST_CHECK_THROWS(chain.AddGrayscale(), std::length_error);
+
+	chain.Clear();
+	TEST_CHECK(chain.GetStageCount() == 0);
+}
+
+int main()
+{
+	TestChainMatchesSeparatePasses();
+	TestEmptyChainCopies();
+	TestParameterHash();
+	TestStageLimit();
+
+	return TestCheck::GetExitCode();
+}
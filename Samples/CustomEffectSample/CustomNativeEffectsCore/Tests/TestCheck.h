@@ -0,0 +1,69 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <cstdio>
+
+namespace CustomNativeEffects {
+
+	// Minimal checks for the core library's test executables. A failed check
+	// prints its expression and location and the test keeps going; main
+	// returns GetExitCode() so CTest sees every failure of a run at once.
+	namespace TestCheck {
+
+		inline int& GetFailureCount()
+		{
+			static int failures = 0;
+			return failures;
+		}
+
+		inline bool Check(bool condition, const char* expression, const char* file, int line)
+		{
+			if (!condition)
+			{
+				std::fprintf(stderr, "%s(%d): check failed: %s\n", file, line, expression);
+				GetFailureCount()++;
+			}
+
+			return condition;
+		}
+
+		inline int GetExitCode()
+		{
+			if (GetFailureCount() != 0)
+			{
+				std::fprintf(stderr, "%d check(s) failed\n", GetFailureCount());
+				return 1;
+			}
+
+			return 0;
+		}
+	}
+}
+
+#define TEST_CHECK(condition) \
+	CustomNativeEffects::TestCheck::Check((condition), #condition, __FILE__, __LINE__)
+
+// Checks that expression throws exceptionType.
+#define TEST_CHECK_THROWS(expression, exceptionType) \
+	do \
+	{ \
+		bool thrown = false; \
+		try \
+		{ \
+			expression; \
+		} \
+		catch (const exceptionType&) \
+		{ \
+			thrown = true; \
+		} \
+		CustomNativeEffects::TestCheck::Check(thrown, #expression " throws " #exceptionType, __FILE__, __LINE__); \
+	} while (false)
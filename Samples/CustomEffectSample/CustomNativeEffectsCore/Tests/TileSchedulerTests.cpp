@@ -0,0 +1,212 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "TestCheck.h"
+#include "RowBands.h"
+#include "TileScheduler.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace CustomNativeEffects;
+
+static TileScheduler::Options MakeOptions(uint32_t workerCount, bool pinThreads = false)
+{
+	TileScheduler::Options options;
+	options.WorkerCount = workerCount;
+	options.PinThreads = pinThreads;
+	return options;
+}
+
+// Every tile runs exactly once, also when tiles start nested runs of their own.
+static void TestEveryTileOnce(TileScheduler& scheduler)
+{
+	for (int32_t iteration = 0; iteration < 200; ++iteration)
+	{
+		const int32_t tileCount = 1 + iteration * 7 % 500;
+		std::unique_ptr<std::atomic<int32_t>[]> hits(new std::atomic<int32_t>[tileCount]);
+		for (int32_t i = 0; i < tileCount; ++i)
+		{
+			hits[i] = 0;
+		}
+
+		std::atomic<int32_t> nestedFailures(0);
+
+		scheduler.Run(tileCount, [&](int32_t tile)
+		{
+			hits[tile]++;
+
+			if (tile % 50 == 0)
+			{
+				std::atomic<int32_t> nestedTiles(0);
+				scheduler.Run(10, [&](int32_t) { nestedTiles++; });
+				nestedFailures += (nestedTiles != 10) ? 1 : 0;
+			}
+		});
+
+		int32_t wrongCounts = 0;
+		for (int32_t i = 0; i < tileCount; ++i)
+		{
+			wrongCounts += (hits[i] != 1) ? 1 : 0;
+		}
+
+		TEST_CHECK(wrongCounts == 0);
+		TEST_CHECK(nestedFailures == 0);
+	}
+}
+
+static void TestConcurrentCallers(TileScheduler& scheduler)
+{
+	std::atomic<int64_t> total(0);
+	std::vector<std::thread> callers;
+
+	for (int32_t i = 0; i < 4; ++i)
+	{
+		callers.emplace_back([&]()
+		{
+			for (int32_t run = 0; run < 100; ++run)
+			{
+				scheduler.Run(64, [&](int32_t) { total++; });
+			}
+		});
+	}
+
+	for (std::thread& caller : callers)
+	{
+		caller.join();
+	}
+
+	TEST_CHECK(total == 4 * 100 * 64);
+}
+
+static void TestExceptionIsRethrown(TileScheduler& scheduler)
+{
+	TEST_CHECK_THROWS(scheduler.Run(100, [](int32_t tile)
+	{
+		if (tile == 37)
+		{
+			throw std::runtime_error("tile");
+		}
+	}), std::runtime_error);
+
+	// The scheduler keeps working afterwards.
+	std::atomic<int32_t> tiles(0);
+	scheduler.Run(100, [&](int32_t) { tiles++; });
+	TEST_CHECK(tiles == 100);
+}
+
+static void TestCancellation(TileScheduler& scheduler)
+{
+	CancellationToken cancellation;
+	std::atomic<int32_t> started(0);
+
+	const bool completed = scheduler.Run(1000, [&](int32_t tile)
+	{
+		started++;
+		if (tile == 3)
+		{
+			cancellation.Cancel();
+		}
+
+		std::this_thread::sleep_for(std::chrono::microseconds(50));
+	}, &cancellation);
+
+	TEST_CHECK(!completed);
+	TEST_CHECK(started < 1000);
+}
+
+// Replacing the pool threads while another thread keeps running renders.
+static void TestConfigureWhileRunning(TileScheduler& scheduler)
+{
+	std::atomic<bool> stop(false);
+	std::atomic<int32_t> failures(0);
+
+	std::thread runner([&]()
+	{
+		while (!stop)
+		{
+			std::atomic<int32_t> tiles(0);
+			scheduler.Run(50, [&](int32_t) { tiles++; });
+			failures += (tiles != 50) ? 1 : 0;
+		}
+	});
+
+	for (uint32_t i = 0; i < 20; ++i)
+	{
+		scheduler.Configure(MakeOptions(i % 4, i % 2 != 0));
+	}
+
+	stop = true;
+	runner.join();
+
+	TEST_CHECK(failures == 0);
+	TEST_CHECK(scheduler.GetWorkerCount() == 3);
+}
+
+// Configure calls from several threads replace the pool one at a time, so
+// the last one decides the worker count.
+static void TestConcurrentConfigure(TileScheduler& scheduler)
+{
+	std::vector<std::thread> threads;
+
+	for (uint32_t t = 0; t < 4; ++t)
+	{
+		threads.emplace_back([&scheduler, t]()
+		{
+			for (uint32_t i = 0; i < 10; ++i)
+			{
+				scheduler.Configure(MakeOptions(1 + (t + i) % 3));
+			}
+		});
+	}
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	TEST_CHECK(scheduler.GetWorkerCount() == scheduler.GetOptions().WorkerCount);
+
+	scheduler.Configure(MakeOptions(2));
+	TEST_CHECK(scheduler.GetWorkerCount() == 2);
+}
+
+static void TestRowBandsCoverRegion(TileScheduler& scheduler)
+{
+	CpuWorkerRegion region;
+	region.Width = 2048;
+	region.Height = 1024;
+
+	RowBands::Options options;
+	options.Scheduler = &scheduler;
+
+	std::atomic<int32_t> rows(0);
+	RowBands::ForEach(region, options, [&](const CpuWorkerRegion& band) { rows += band.Height; });
+	TEST_CHECK(rows == region.Height);
+}
+
+int main()
+{
+	TileScheduler scheduler(MakeOptions(4));
+	TEST_CHECK(scheduler.GetWorkerCount() == 4);
+
+	TestEveryTileOnce(scheduler);
+	TestConcurrentCallers(scheduler);
+	TestExceptionIsRethrown(scheduler);
+	TestCancellation(scheduler);
+	TestConfigureWhileRunning(scheduler);
+	TestConcurrentConfigure(scheduler);
+	TestRowBandsCoverRegion(scheduler);
+
+	return TestCheck::GetExitCode();
+}
@@ -0,0 +1,410 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "TileScheduler.h"
+#include <algorithm>
+#include <exception>
+#include <memory>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
+using namespace CustomNativeEffects;
+
+// A range of tiles [begin, end) packed into one word, begin in the high half.
+static uint64_t PackRange(uint32_t begin, uint32_t end)
+{
+	return (static_cast<uint64_t>(begin) << 32) | end;
+}
+
+static uint32_t GetBegin(uint64_t range)
+{
+	return static_cast<uint32_t>(range >> 32);
+}
+
+static uint32_t GetEnd(uint64_t range)
+{
+	return static_cast<uint32_t>(range);
+}
+
+struct TileScheduler::Job
+{
+	Job(int32_t tileCount, uint32_t slotCount, const TileFunction& processTile, const CancellationToken* cancellation) :
+		Ranges(new std::atomic<uint64_t>[slotCount]),
+		SlotCount(slotCount),
+		NextSlot(1),
+		Remaining(tileCount),
+		Helpers(0),
+		Steals(0),
+		IsStopped(false),
+		IsCanceled(false),
+		ProcessTile(processTile),
+		Cancellation(cancellation)
+	{
+		for (uint32_t slot = 0; slot < slotCount; ++slot)
+		{
+			const uint32_t begin = static_cast<uint32_t>(static_cast<uint64_t>(tileCount) * slot / slotCount);
+			const uint32_t end = static_cast<uint32_t>(static_cast<uint64_t>(tileCount) * (slot + 1) / slotCount);
+			Ranges[slot].store(PackRange(begin, end), std::memory_order_relaxed);
+		}
+	}
+
+	// The tiles each participant has yet to start. Slot 0 belongs to the caller.
+	std::unique_ptr<std::atomic<uint64_t>[]> Ranges;
+	const uint32_t SlotCount;
+	std::atomic<uint32_t> NextSlot;
+
+	// Tiles not yet run or skipped, and pool threads still inside Participate.
+	std::atomic<int32_t> Remaining;
+	int32_t Helpers;
+	std::atomic<uint64_t> Steals;
+
+	std::atomic<bool> IsStopped;
+	std::atomic<bool> IsCanceled;
+	std::exception_ptr Exception;
+
+	const TileFunction& ProcessTile;
+	const CancellationToken* Cancellation;
+
+	// Guards Helpers and Exception, and signals the caller once both counts are 0.
+	std::mutex Mutex;
+	std::condition_variable Done;
+};
+
+TileScheduler& TileScheduler::GetDefault()
+{
+	// Never destroyed: joining threads while a module unloads can deadlock.
+	static TileScheduler* instance = new TileScheduler();
+	return *instance;
+}
+
+TileScheduler::TileScheduler(const Options& options) :
+	m_options(options),
+	m_isStopping(false),
+	m_runs(0),
+	m_tiles(0),
+	m_steals(0)
+{
+	StartWorkers();
+}
+
+TileScheduler::~TileScheduler()
+{
+	StopWorkers();
+}
+
+void TileScheduler::Configure(const Options& options)
+{
+	std::lock_guard<std::mutex> configureLock(m_configureMutex);
+
+	StopWorkers();
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_options = options;
+		m_isStopping = false;
+	}
+
+	StartWorkers();
+}
+
+TileScheduler::Options TileScheduler::GetOptions() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_options;
+}
+
+uint32_t TileScheduler::GetWorkerCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return static_cast<uint32_t>(m_threads.size());
+}
+
+TileScheduler::Statistics TileScheduler::GetStatistics() const
+{
+	Statistics statistics;
+	statistics.Runs = m_runs.load(std::memory_order_relaxed);
+	statistics.Tiles = m_tiles.load(std::memory_order_relaxed);
+	statistics.Steals = m_steals.load(std::memory_order_relaxed);
+	return statistics;
+}
+
+void TileScheduler::StartWorkers()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	uint32_t workerCount = m_options.WorkerCount;
+
+	if (workerCount == 0)
+	{
+		const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+		workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+	}
+
+	m_threads.reserve(workerCount);
+
+	for (uint32_t index = 0; index < workerCount; ++index)
+	{
+		m_threads.emplace_back(&TileScheduler::WorkerMain, this, index);
+	}
+}
+
+void TileScheduler::StopWorkers()
+{
+	std::vector<std::thread> threads;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_isStopping = true;
+		threads.swap(m_threads);
+	}
+
+	m_wake.notify_all();
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+}
+
+static void PinCurrentThread(uint32_t processor)
+{
+#if defined(__linux__)
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(processor % CPU_SETSIZE, &set);
+	pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#elif defined(_WIN32) && WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP)
+	SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << (processor % (sizeof(DWORD_PTR) * 8)));
+#else
+	// Store apps cannot set thread affinity.
+	(void)processor;
+#endif
+}
+
+void TileScheduler::WorkerMain(uint32_t index)
+{
+	bool pinned = false;
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	for (;;)
+	{
+		m_wake.wait(lock, [this] { return m_isStopping || !m_jobs.empty(); });
+
+		if (m_isStopping)
+		{
+			return;
+		}
+
+		if (m_options.PinThreads && !pinned)
+		{
+			const uint32_t hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+			PinCurrentThread((index + 1) % hardwareThreads);
+			pinned = true;
+		}
+
+		Job* job = m_jobs.front();
+		const uint32_t slot = job->NextSlot.fetch_add(1, std::memory_order_relaxed);
+
+		// Once every slot has a participant, the next pool thread looks at the
+		// next render instead.
+		if (slot + 1 >= job->SlotCount)
+		{
+			m_jobs.pop_front();
+
+			if (slot >= job->SlotCount)
+			{
+				continue;
+			}
+		}
+
+		{
+			std::lock_guard<std::mutex> jobLock(job->Mutex);
+			++job->Helpers;
+		}
+
+		lock.unlock();
+
+		Participate(*job, slot);
+
+		lock.lock();
+
+		// Every tile has been taken, so other pool threads need not look at it.
+		auto queued = std::find(m_jobs.begin(), m_jobs.end(), job);
+
+		if (queued != m_jobs.end())
+		{
+			m_jobs.erase(queued);
+		}
+
+		// The job lives on its caller's stack and may be gone as soon as
+		// Helpers drops to 0, so it is not touched after that.
+		std::lock_guard<std::mutex> jobLock(job->Mutex);
+
+		if (--job->Helpers == 0 && job->Remaining.load(std::memory_order_acquire) == 0)
+		{
+			job->Done.notify_all();
+		}
+	}
+}
+
+bool TileScheduler::TakeTile(Job& job, uint32_t slot, int32_t& tile)
+{
+	std::atomic<uint64_t>& own = job.Ranges[slot];
+	uint64_t range = own.load(std::memory_order_acquire);
+
+	while (GetBegin(range) < GetEnd(range))
+	{
+		if (own.compare_exchange_weak(range, PackRange(GetBegin(range) + 1, GetEnd(range)), std::memory_order_acq_rel))
+		{
+			tile = static_cast<int32_t>(GetBegin(range));
+			return true;
+		}
+	}
+
+	// Steal the far half of the first range that has tiles left, keep the
+	// first of them and make the rest this slot's range.
+	for (uint32_t offset = 1; offset < job.SlotCount; ++offset)
+	{
+		std::atomic<uint64_t>& victim = job.Ranges[(slot + offset) % job.SlotCount];
+		range = victim.load(std::memory_order_acquire);
+
+		while (GetBegin(range) < GetEnd(range))
+		{
+			const uint32_t begin = GetBegin(range);
+			const uint32_t end = GetEnd(range);
+			const uint32_t split = end - (end - begin + 1) / 2;
+
+			if (victim.compare_exchange_weak(range, PackRange(begin, split), std::memory_order_acq_rel))
+			{
+				own.store(PackRange(split + 1, end), std::memory_order_release);
+				job.Steals.fetch_add(1, std::memory_order_relaxed);
+
+				tile = static_cast<int32_t>(split);
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+void TileScheduler::RunTile(Job& job, int32_t tile)
+{
+	if (!job.IsStopped.load(std::memory_order_relaxed))
+	{
+		if (job.Cancellation && job.Cancellation->IsCanceled())
+		{
+			job.IsCanceled.store(true, std::memory_order_relaxed);
+			job.IsStopped.store(true, std::memory_order_relaxed);
+		}
+		else
+		{
+			try
+			{
+				job.ProcessTile(tile);
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock(job.Mutex);
+
+				if (!job.Exception)
+				{
+					job.Exception = std::current_exception();
+				}
+
+				job.IsStopped.store(true, std::memory_order_relaxed);
+			}
+		}
+	}
+
+	if (job.Remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		std::lock_guard<std::mutex> lock(job.Mutex);
+
+		if (job.Helpers == 0)
+		{
+			job.Done.notify_all();
+		}
+	}
+}
+
+void TileScheduler::Participate(Job& job, uint32_t slot)
+{
+	int32_t tile;
+
+	while (TakeTile(job, slot, tile))
+	{
+		RunTile(job, tile);
+	}
+}
+
+bool TileScheduler::Run(int32_t tileCount, const TileFunction& processTile, const CancellationToken* cancellation)
+{
+	if (tileCount <= 0)
+	{
+		return true;
+	}
+
+	uint32_t slotCount;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		slotCount = std::min(static_cast<uint32_t>(m_threads.size()) + 1, static_cast<uint32_t>(tileCount));
+	}
+
+	Job job(tileCount, slotCount, processTile, cancellation);
+
+	if (slotCount > 1)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_jobs.push_back(&job);
+		}
+
+		m_wake.notify_all();
+	}
+
+	Participate(job, 0);
+
+	if (slotCount > 1)
+	{
+		// No pool thread joins once the job has left the queue.
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			auto queued = std::find(m_jobs.begin(), m_jobs.end(), &job);
+
+			if (queued != m_jobs.end())
+			{
+				m_jobs.erase(queued);
+			}
+		}
+
+		std::unique_lock<std::mutex> lock(job.Mutex);
+		job.Done.wait(lock, [&job] { return job.Helpers == 0 && job.Remaining.load(std::memory_order_acquire) == 0; });
+	}
+
+	m_runs.fetch_add(1, std::memory_order_relaxed);
+	m_tiles.fetch_add(static_cast<uint64_t>(tileCount), std::memory_order_relaxed);
+	m_steals.fetch_add(job.Steals.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+	if (job.Exception)
+	{
+		std::rethrow_exception(job.Exception);
+	}
+
+	return !job.IsCanceled.load(std::memory_order_relaxed);
+}
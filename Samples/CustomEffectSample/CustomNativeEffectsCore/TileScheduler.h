@@ -0,0 +1,154 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace CustomNativeEffects {
+
+	// Lets the owner of a TileScheduler::Run stop it between tiles.
+	class CancellationToken final
+	{
+	public:
+		CancellationToken() :
+			m_isCanceled(false)
+		{
+		}
+
+		CancellationToken(const CancellationToken&) = delete;
+
+		CancellationToken& operator=(const CancellationToken&) = delete;
+
+		void Cancel()
+		{
+			m_isCanceled.store(true, std::memory_order_relaxed);
+		}
+
+		void Reset()
+		{
+			m_isCanceled.store(false, std::memory_order_relaxed);
+		}
+
+		bool IsCanceled() const
+		{
+			return m_isCanceled.load(std::memory_order_relaxed);
+		}
+
+	private:
+		std::atomic<bool> m_isCanceled;
+	};
+
+	// A pool of threads that run the tiles of CPU renders.
+	//
+	// Run splits the tiles into one contiguous range per participant, the
+	// calling thread included, so neighbouring tiles tend to run on the same
+	// core. A participant that runs out of tiles steals the far half of
+	// another participant's range. Ranges are single atomic words, so taking
+	// a tile or stealing never locks.
+	//
+	// Several renders can run at once. Pool threads help the oldest render
+	// that still has room for helpers, and every caller works on its own
+	// render until all of its tiles are done. A render therefore never waits
+	// for a thread another render keeps busy, and a render started from
+	// inside a tile cannot deadlock.
+	class TileScheduler final
+	{
+	public:
+		struct Options
+		{
+			Options() :
+				WorkerCount(0),
+				PinThreads(false)
+			{
+			}
+
+			// Number of pool threads. 0 means one less than the number of
+			// hardware threads, since the calling thread works as well.
+			uint32_t WorkerCount;
+
+			// Pins pool thread i to logical processor i + 1, leaving processor 0 to
+			// the caller, where the platform lets apps set thread affinity.
+			bool PinThreads;
+		};
+
+		struct Statistics
+		{
+			uint64_t Runs;
+			uint64_t Tiles;
+			uint64_t Steals;
+		};
+
+		typedef std::function<void(int32_t tile)> TileFunction;
+
+		// The scheduler RowBands uses unless told otherwise.
+		static TileScheduler& GetDefault();
+
+		explicit TileScheduler(const Options& options = Options());
+
+		TileScheduler(const TileScheduler&) = delete;
+
+		TileScheduler& operator=(const TileScheduler&) = delete;
+
+		~TileScheduler();
+
+		// Replaces the pool threads. Renders in progress keep running, on their
+		// calling threads until the new pool threads join them. Calls from
+		// several threads replace the pool one after another. Must not be
+		// called from inside a tile.
+		void Configure(const Options& options);
+
+		Options GetOptions() const;
+
+		uint32_t GetWorkerCount() const;
+
+		// Calls processTile(i) once for every i in [0, tileCount), in parallel,
+		// and returns once every call has returned. Returns false if
+		// cancellation was requested before every tile had started; the tiles
+		// not started by then are skipped. The first exception thrown by a tile
+		// is rethrown on the calling thread, and the tiles not started by then
+		// are skipped as well.
+		bool Run(int32_t tileCount, const TileFunction& processTile, const CancellationToken* cancellation = nullptr);
+
+		Statistics GetStatistics() const;
+
+	private:
+		struct Job;
+
+		void StartWorkers();
+		void StopWorkers();
+		void WorkerMain(uint32_t index);
+
+		static void Participate(Job& job, uint32_t slot);
+		static bool TakeTile(Job& job, uint32_t slot, int32_t& tile);
+		static void RunTile(Job& job, int32_t tile);
+
+		// Held for the whole of Configure, so that one call stops and starts the
+		// pool threads before the next one begins. Run never takes it.
+		std::mutex m_configureMutex;
+		mutable std::mutex m_mutex;
+		std::condition_variable m_wake;
+		std::deque<Job*> m_jobs;
+		std::vector<std::thread> m_threads;
+		Options m_options;
+		bool m_isStopping;
+
+		std::atomic<uint64_t> m_runs;
+		std::atomic<uint64_t> m_tiles;
+		std::atomic<uint64_t> m_steals;
+	};
+}
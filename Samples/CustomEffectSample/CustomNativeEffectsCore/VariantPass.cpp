@@ -0,0 +1,124 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "VariantPass.h"
+#include "ColorLutKernel.h"
+#include <stdexcept>
+
+using namespace CustomNativeEffects;
+
+namespace {
+
+	// Every chain stage's and the lookup table kernel's vector width divide it.
+	const int32_t VectorPixels = PointwiseChain::VectorPixels;
+
+	static_assert(PointwiseChain::VectorPixels % ColorLutKernel::VectorPixels == 0, "VariantPass needs a vector width every kernel divides");
+
+	// The row length every variant can process for row y of the rows ending at
+	// endRow: the width rounded up to VectorPixels if no overrun leaves the
+	// source or one of those rows of a target, the exact width otherwise.
+	int32_t GetRowLength(const VariantPass::SourceImage& source, const VariantPass::Variant* variants, int32_t variantCount, int32_t y, int32_t endRow)
+	{
+		const int32_t padded = (source.Width + VectorPixels - 1) / VectorPixels * VectorPixels;
+		const int64_t overrun = padded - source.Width;
+
+		if (overrun == 0)
+		{
+			return padded;
+		}
+
+		if (overrun > static_cast<int64_t>(source.Height - 1 - y) * source.Pitch + source.TailPixels)
+		{
+			return source.Width;
+		}
+
+		for (int32_t i = 0; i < variantCount; ++i)
+		{
+			const int64_t tail = (endRow == source.Height) ? variants[i].TargetTailPixels : 0;
+
+			if (overrun > static_cast<int64_t>(endRow - 1 - y) * variants[i].TargetPitch + tail)
+			{
+				return source.Width;
+			}
+		}
+
+		return padded;
+	}
+}
+
+void VariantPass::ApplyRows(const SourceImage& source, const Variant* variants, int32_t variantCount, int32_t firstRow, int32_t rowCount)
+{
+	const ColorLutKernel::RowFunction applyLut = ColorLutKernel::GetRowFunction();
+	const int32_t endRow = firstRow + rowCount;
+
+	for (int32_t y = firstRow; y < endRow; ++y)
+	{
+		const uint32_t* sourceRow = source.Pixels + static_cast<intptr_t>(y) * source.Pitch;
+		const uint32_t count = static_cast<uint32_t>(GetRowLength(source, variants, variantCount, y, endRow));
+
+		for (uint32_t x = 0; x < count; x += PointwiseChain::TilePixels)
+		{
+			const uint32_t tileCount = (count - x < static_cast<uint32_t>(PointwiseChain::TilePixels)) ? count - x : static_cast<uint32_t>(PointwiseChain::TilePixels);
+
+			for (int32_t i = 0; i < variantCount; ++i)
+			{
+				const Variant& variant = variants[i];
+				uint32_t* targetRow = variant.TargetPixels + static_cast<intptr_t>(y) * variant.TargetPitch;
+
+				if (variant.Lut)
+				{
+					applyLut(*variant.Lut, sourceRow + x, targetRow + x, tileCount);
+				}
+				else
+				{
+					variant.Chain->ApplyRow(sourceRow + x, targetRow + x, tileCount);
+				}
+			}
+		}
+	}
+}
+
+bool VariantPass::Apply(const SourceImage& source, const Variant* variants, int32_t variantCount, const RowBands::Options& options)
+{
+	if (variantCount < 0 || variantCount > MaximumVariants)
+	{
+		throw std::invalid_argument("variantCount");
+	}
+
+	for (int32_t i = 0; i < variantCount; ++i)
+	{
+		if (!variants[i].Chain && !variants[i].Lut)
+		{
+			throw std::invalid_argument("variants");
+		}
+	}
+
+	if (variantCount == 0 || source.Width <= 0 || source.Height <= 0)
+	{
+		return true;
+	}
+
+	// RowBands sizes bands for one source and one target row per row.
+	RowBands::Options bandOptions = options;
+	bandOptions.BandBytes = static_cast<uint32_t>(static_cast<uint64_t>(options.BandBytes) * 2 / (variantCount + 1));
+
+	const CpuWorkerRegion region = CpuWorkerRegion::Create(
+		source.Pixels, source.Pitch, 0,
+		variants[0].TargetPixels, variants[0].TargetPitch, 0,
+		source.Width, source.Height);
+
+	const SourceImage image = source;
+
+	return RowBands::ForEach(region, bandOptions, [&image, variants, variantCount](const CpuWorkerRegion& band)
+	{
+		const int32_t firstRow = image.Pitch > 0 ? static_cast<int32_t>((band.SourcePixels - image.Pixels) / image.Pitch) : 0;
+		ApplyRows(image, variants, variantCount, firstRow, band.Height);
+	});
+}
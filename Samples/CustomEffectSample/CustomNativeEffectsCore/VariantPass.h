@@ -0,0 +1,79 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <cstdint>
+#include "ColorLut3D.h"
+#include "PointwiseChain.h"
+#include "RowBands.h"
+
+namespace CustomNativeEffects {
+
+	// Renders one source image through several pointwise effects, the
+	// variants, in a single pass, as for a grid of filter previews.
+	//
+	// Rendering N variants one by one reads the source from memory N times.
+	// This pass walks the source in tiles of PointwiseChain::TilePixels
+	// instead, and runs every variant over a tile before moving on, so each
+	// source tile is read from memory once and from the L1 cache by the other
+	// variants. Every variant gives the same pixels as rendering it on its own.
+	namespace VariantPass {
+
+		const int32_t MaximumVariants = 64;
+
+		// The BGRA8888 pixels every variant reads. TailPixels is how many pixels
+		// past the end of the last row may be read.
+		struct SourceImage
+		{
+			const uint32_t* Pixels;
+			int32_t Pitch;
+			int32_t Width;
+			int32_t Height;
+			int32_t TailPixels;
+		};
+
+		// One output: the effect and the target it writes, which has the
+		// source's size and must not overlap the source or another target.
+		struct Variant
+		{
+			Variant() :
+				Chain(nullptr),
+				Lut(nullptr),
+				TargetPixels(nullptr),
+				TargetPitch(0),
+				TargetTailPixels(0)
+			{
+			}
+
+			// The effect, a chain or, if set, a lookup table. Either must outlive
+			// the pass.
+			const PointwiseChain* Chain;
+			const ColorLut3D* Lut;
+
+			uint32_t* TargetPixels;
+			int32_t TargetPitch;
+
+			// How many pixels past the end of the last row may be overwritten.
+			int32_t TargetTailPixels;
+		};
+
+		// Renders rows [firstRow, firstRow + rowCount) of source through every
+		// variant. Targets are overrun only within these rows, or past the last
+		// row of the image, so bands of rows can run in parallel.
+		void ApplyRows(const SourceImage& source, const Variant* variants, int32_t variantCount, int32_t firstRow, int32_t rowCount);
+
+		// Renders all rows, split into bands as RowBands does. Bands are sized
+		// for the source and all targets together. Throws std::invalid_argument
+		// if a variant has no effect or there are more than MaximumVariants.
+		// Returns false if canceled.
+		bool Apply(const SourceImage& source, const Variant* variants, int32_t variantCount, const RowBands::Options& options);
+	}
+}
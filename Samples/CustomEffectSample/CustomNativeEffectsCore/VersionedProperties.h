@@ -0,0 +1,161 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+namespace CustomNativeEffects {
+
+	// Holds an effect's property struct so that renderers can read all of it
+	// at once without taking a lock, and tell whether it changed since their
+	// last read.
+	//
+	// This is a sequence lock: the sequence number is odd while a writer is
+	// copying a new value in, and readers retry when it was odd or changed
+	// during their copy. The value is kept in atomic words so that a read
+	// racing a write is well defined. Writers exclude each other by claiming
+	// the sequence number. Every completed write increments the version, which
+	// starts at 1.
+	template <typename T>
+	class VersionedProperties final
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "VersionedProperties needs a trivially copyable type");
+
+	public:
+		struct Snapshot
+		{
+			T Value;
+			uint64_t Version;
+		};
+
+		VersionedProperties() :
+			VersionedProperties(T())
+		{
+		}
+
+		explicit VersionedProperties(const T& value) :
+			m_sequence(2)
+		{
+			StoreWords(value);
+		}
+
+		VersionedProperties(const VersionedProperties&) = delete;
+
+		VersionedProperties& operator=(const VersionedProperties&) = delete;
+
+		// A consistent copy of the value and the version it belongs to.
+		Snapshot Read() const
+		{
+			for (;;)
+			{
+				const uint64_t before = m_sequence.load(std::memory_order_acquire);
+
+				if ((before & 1) == 0)
+				{
+					Snapshot snapshot;
+					LoadWords(snapshot.Value);
+
+					std::atomic_thread_fence(std::memory_order_acquire);
+
+					if (m_sequence.load(std::memory_order_relaxed) == before)
+					{
+						snapshot.Version = before / 2;
+						return snapshot;
+					}
+				}
+
+				std::this_thread::yield();
+			}
+		}
+
+		T Get() const
+		{
+			return Read().Value;
+		}
+
+		uint64_t GetVersion() const
+		{
+			return (m_sequence.load(std::memory_order_acquire) + 1) / 2;
+		}
+
+		void Set(const T& value)
+		{
+			Modify([&value](T& current) { current = value; });
+		}
+
+		// Calls modify with a copy of the current value and publishes the result.
+		// Concurrent writers are serialized, so read-modify-write updates of
+		// different fields do not lose each other's changes.
+		template <typename Update>
+		void Modify(Update&& modify)
+		{
+			const uint64_t sequence = BeginWrite();
+
+			T value;
+			LoadWords(value);
+			modify(value);
+			StoreWords(value);
+
+			m_sequence.store(sequence + 2, std::memory_order_release);
+		}
+
+	private:
+		static const size_t WordCount = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+		// Makes the sequence number odd and returns its previous, even value.
+		uint64_t BeginWrite()
+		{
+			uint64_t sequence = m_sequence.load(std::memory_order_relaxed);
+
+			for (;;)
+			{
+				if ((sequence & 1) == 0 && m_sequence.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire, std::memory_order_relaxed))
+				{
+					std::atomic_thread_fence(std::memory_order_release);
+					return sequence;
+				}
+
+				std::this_thread::yield();
+				sequence = m_sequence.load(std::memory_order_relaxed);
+			}
+		}
+
+		void LoadWords(T& value) const
+		{
+			uint32_t words[WordCount];
+
+			for (size_t i = 0; i < WordCount; ++i)
+			{
+				words[i] = m_words[i].load(std::memory_order_relaxed);
+			}
+
+			std::memcpy(&value, words, sizeof(T));
+		}
+
+		void StoreWords(const T& value)
+		{
+			uint32_t words[WordCount] = {};
+			std::memcpy(words, &value, sizeof(T));
+
+			for (size_t i = 0; i < WordCount; ++i)
+			{
+				m_words[i].store(words[i], std::memory_order_relaxed);
+			}
+		}
+
+		std::atomic<uint64_t> m_sequence;
+		std::atomic<uint32_t> m_words[WordCount];
+	};
+}
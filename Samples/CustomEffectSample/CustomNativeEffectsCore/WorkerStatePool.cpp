@@ -0,0 +1,55 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#include "WorkerStatePool.h"
+#include <algorithm>
+
+using namespace CustomNativeEffects;
+
+namespace {
+
+	struct Registry
+	{
+		std::mutex Mutex;
+		std::vector<WorkerStatePoolBase*> Pools;
+	};
+
+	// Never destroyed, as the pools that stay registered until exit are not.
+	Registry& GetRegistry()
+	{
+		static Registry* registry = new Registry();
+		return *registry;
+	}
+}
+
+void WorkerStatePoolBase::TrimAll()
+{
+	Registry& registry = GetRegistry();
+	std::lock_guard<std::mutex> lock(registry.Mutex);
+
+	for (WorkerStatePoolBase* pool : registry.Pools)
+	{
+		pool->Trim();
+	}
+}
+
+void WorkerStatePoolBase::Register()
+{
+	Registry& registry = GetRegistry();
+	std::lock_guard<std::mutex> lock(registry.Mutex);
+	registry.Pools.push_back(this);
+}
+
+void WorkerStatePoolBase::Unregister()
+{
+	Registry& registry = GetRegistry();
+	std::lock_guard<std::mutex> lock(registry.Mutex);
+	registry.Pools.erase(std::remove(registry.Pools.begin(), registry.Pools.end(), this), registry.Pools.end());
+}
@@ -0,0 +1,163 @@
+//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+// This code is licensed under the MIT License (MIT).
+// THIS CODE IS PROVIDED *AS IS* WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING ANY
+// IMPLIED WARRANTIES OF FITNESS FOR A PARTICULAR
+// PURPOSE, MERCHANTABILITY, OR NON-INFRINGEMENT.
+//
+//*********************************************************
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace CustomNativeEffects {
+
+	// Registry of every WorkerStatePool, so that all of them can be trimmed at
+	// once when the app is asked to reduce its memory usage.
+	class WorkerStatePoolBase
+	{
+	public:
+		WorkerStatePoolBase(const WorkerStatePoolBase&) = delete;
+
+		WorkerStatePoolBase& operator=(const WorkerStatePoolBase&) = delete;
+
+		// Drops every idle state this pool holds.
+		virtual void Trim() = 0;
+
+		// Trims every pool in the process.
+		static void TrimAll();
+
+	protected:
+		WorkerStatePoolBase()
+		{
+		}
+
+		~WorkerStatePoolBase()
+		{
+		}
+
+		// Derived pools register once they are constructed and unregister before
+		// they start being destroyed, so that TrimAll never sees a partial pool.
+		void Register();
+		void Unregister();
+	};
+
+	// Idle per-worker state, such as grown pixel buffers and generated lookup
+	// tables, kept between renders.
+	//
+	// The renderer creates a worker for every render and releases it when the
+	// render completes. A worker takes its state from the pool when it is
+	// created and gives it back when it is destroyed, so that repeated renders
+	// start from warm buffers and tables instead of allocating them again. At
+	// most capacity states are kept; extra ones are destroyed.
+	//
+	// Workers allocate their pool once and never destroy it, like
+	// BufferPool::GetInstance, so that states released by workers that other
+	// static objects hold at exit still find a live pool.
+	template <typename State>
+	class WorkerStatePool final : public WorkerStatePoolBase
+	{
+	public:
+		struct Statistics
+		{
+			uint64_t Hits;
+			uint64_t Misses;
+			uint64_t Releases;
+			uint64_t Evictions;
+			size_t Count;
+		};
+
+		static const size_t DefaultCapacity = 2;
+
+		explicit WorkerStatePool(size_t capacity = DefaultCapacity) :
+			m_capacity(capacity),
+			m_statistics()
+		{
+			m_states.reserve(capacity);
+			Register();
+		}
+
+		~WorkerStatePool()
+		{
+			Unregister();
+		}
+
+		// Returns an idle state, or a new one if there is none.
+		std::unique_ptr<State> Acquire()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+
+				if (!m_states.empty())
+				{
+					std::unique_ptr<State> state = std::move(m_states.back());
+					m_states.pop_back();
+					++m_statistics.Hits;
+					return state;
+				}
+
+				++m_statistics.Misses;
+			}
+
+			return std::unique_ptr<State>(new State());
+		}
+
+		// Keeps the state for the next Acquire, or destroys it if the pool is full.
+		void Release(std::unique_ptr<State> state)
+		{
+			if (!state)
+			{
+				return;
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+
+				++m_statistics.Releases;
+
+				if (m_states.size() < m_capacity)
+				{
+					m_states.push_back(std::move(state));
+					return;
+				}
+
+				++m_statistics.Evictions;
+			}
+
+			// Destroyed here, outside the lock.
+		}
+
+		void Trim() override
+		{
+			std::vector<std::unique_ptr<State>> states;
+
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_statistics.Evictions += m_states.size();
+				states.swap(m_states);
+			}
+		}
+
+		Statistics GetStatistics() const
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			Statistics statistics = m_statistics;
+			statistics.Count = m_states.size();
+			return statistics;
+		}
+
+	private:
+		mutable std::mutex m_mutex;
+		std::vector<std::unique_ptr<State>> m_states;
+		size_t m_capacity;
+		Statistics m_statistics;
+	};
+}